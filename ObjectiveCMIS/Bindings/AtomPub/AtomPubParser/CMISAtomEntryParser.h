@@ -27,10 +27,11 @@
 #import "CMISAtomPubExtensionElementParser.h"
 #import "CMISAtomPubExtensionDataParserBase.h"
 #import "CMISAtomPubAclParser.h"
+#import "CMISXMLParser.h"
 
 @protocol CMISAtomEntryParserDelegate;
 
-@interface CMISAtomEntryParser : CMISAtomPubExtensionDataParserBase <NSXMLParserDelegate, CMISAtomPubAllowableActionsParserDelegate, CMISAtomPubAclParserDelegate>
+@interface CMISAtomEntryParser : CMISAtomPubExtensionDataParserBase <CMISXMLParserDelegate, CMISAtomPubAllowableActionsParserDelegate, CMISAtomPubAclParserDelegate>
 
 @property (nonatomic, strong, readonly) CMISObjectData *objectData;
 
@@ -40,7 +41,10 @@
 - (BOOL)parseAndReturnError:(NSError **)error;
 
 /// Initializes a child parser for an Atom Entry and takes over parsing control while parsing the Atom Entry
-+ (id)atomEntryParserWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(NSXMLParser *)parser;
++ (id)atomEntryParserWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(CMISXMLParser *)parser;
+
+/// Resets a child parser that has finished its Atom Entry and takes over parsing control for the next Atom Entry
+- (void)resetWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(CMISXMLParser *)parser;
 
 @end
 
@@ -27,14 +27,12 @@
 @property (nonatomic, strong, readwrite) CMISObjectData *objectData;
 
 @property (nonatomic, strong) NSData *atomData;
-@property (nonatomic, strong) NSString *currentPropertyType;
 @property (nonatomic, strong) CMISPropertyData *currentPropertyData;
 @property (nonatomic, strong) NSMutableArray *propertyValues;
 @property (nonatomic, strong) CMISProperties *currentObjectProperties;
 @property (nonatomic, strong) NSMutableSet *currentLinkRelations;
 @property (nonatomic, strong) CMISRenditionData *currentRendition;
 @property (nonatomic, strong) NSMutableArray *currentRenditions;
-@property (nonatomic, strong) NSMutableString *string;
 @property (nonatomic, assign) BOOL isExcatAcl;
 @property (nonatomic, assign) BOOL parsingRelationship;
 
@@ -44,7 +42,7 @@
 // Designated initializer
 - (id)init;
 // Initializer used if this parser is a delegated child parser
-- (id)initWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(NSXMLParser *)parser;
+- (id)initWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(CMISXMLParser *)parser;
 
 @end
 
@@ -81,8 +79,7 @@
     self.objectData = [[CMISObjectData alloc] init];
     
     // parse the AtomPub data
-    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:self.atomData];
-    [parser setShouldProcessNamespaces:YES];
+    CMISXMLParser *parser = [[CMISXMLParser alloc] initWithData:self.atomData];
     [parser setDelegate:self];
 
     parseSuccessful = [parser parse];
@@ -96,217 +93,142 @@
     return parseSuccessful;
 }
 
-- (id)initWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(NSXMLParser *)parser
+- (id)initWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(CMISXMLParser *)parser
 {
     self = [self init];
     if (self) {
-        self.objectData = [[CMISObjectData alloc] init];
-        self.entryAttributesDict = attributes;
-        self.parentDelegate = parentDelegate;
-        self.parsingRelationship = NO;
-        
-        // Setting ourself, the entry parser, as the delegate, we reset back to our parent when we're done
-        [parser setDelegate:self];
+        [self resetWithAtomEntryAttributes:attributes parentDelegate:parentDelegate parser:parser];
     }
     return self;
 }
 
+- (void)resetWithAtomEntryAttributes:(NSDictionary *)attributes parentDelegate:(id<NSXMLParserDelegate, CMISAtomEntryParserDelegate>)parentDelegate parser:(CMISXMLParser *)parser
+{
+    self.objectData = [[CMISObjectData alloc] init];
+    self.entryAttributesDict = attributes;
+    self.parentDelegate = parentDelegate;
+    self.parsingRelationship = NO;
+    self.isExcatAcl = NO;
+    
+    // the state of the previous entry has been handed over to its object data already
+    self.currentObjectProperties = nil;
+    self.currentPropertyData = nil;
+    self.propertyValues = nil;
+    [self.currentLinkRelations removeAllObjects];
+    self.currentRendition = nil;
+    self.currentRenditions = nil;
+    self.childParserDelegate = nil;
+    self.currentExtensionData = nil;
+    self.currentExtensions = nil;
+    [self.previousExtensionDataArray removeAllObjects];
+    
+    // Setting ourself, the entry parser, as the delegate, we reset back to our parent when we're done
+    [parser setDelegate:self];
+}
+
 + (id)atomEntryParserWithAtomEntryAttributes:(NSDictionary *)attributes
                               parentDelegate:(id<NSXMLParserDelegate,CMISAtomEntryParserDelegate>)parentDelegate
-                                      parser:(NSXMLParser *)parser
+                                      parser:(CMISXMLParser *)parser
 {
     return [[self alloc] initWithAtomEntryAttributes:attributes parentDelegate:parentDelegate parser:parser];
 }
 
 #pragma mark -
-#pragma mark NSXMLParser delegate methods
+#pragma mark CMISXMLParser delegate methods
 
-- (void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI
-                                            qualifiedName:(NSString *)qName attributes:(NSDictionary *)attributeDict
+- (void)parser:(CMISXMLParser *)parser didStartElement:(CMISXMLName)name inNamespace:(CMISXMLNamespace)ns
 {
-    if ([namespaceURI isEqualToString:kCMISNamespaceCmis] && !self.parsingRelationship) {
-        if ([elementName isEqualToString:kCMISAtomEntryPropertyId] ||
-            [elementName isEqualToString:kCMISAtomEntryPropertyString] ||
-            [elementName isEqualToString:kCMISAtomEntryPropertyInteger] ||
-            [elementName isEqualToString:kCMISAtomEntryPropertyDateTime] ||
-            [elementName isEqualToString:kCMISAtomEntryPropertyBoolean] ||
-            [elementName isEqualToString:kCMISAtomEntryPropertyUri] ||
-            [elementName isEqualToString:kCMISAtomEntryPropertyHtml] ||
-            [elementName isEqualToString:kCMISAtomEntryPropertyDecimal]) {
-            self.propertyValues = [NSMutableArray array];
-            // store attribute values in CMISPropertyData object
-            self.currentPropertyType = elementName;
-            self.currentPropertyData = [[CMISPropertyData alloc] init];
-            self.currentPropertyData.identifier = [attributeDict objectForKey:kCMISAtomEntryPropertyDefId];
-            self.currentPropertyData.queryName = [attributeDict objectForKey:kCMISAtomEntryQueryName];
-            self.currentPropertyData.displayName = [attributeDict objectForKey:kCMISAtomEntryDisplayName];
-            self.currentPropertyData.type = [CMISAtomPubParserUtil atomPubTypeToInternalType:self.currentPropertyType];
-        } else if ([elementName isEqualToString:kCMISCoreProperties]) {
-            // create the CMISProperties object to hold all property data
-            self.currentObjectProperties = [[CMISProperties alloc] init];
-            
-            // Set ObjectProperties as the current extensionData object
-            [self pushNewCurrentExtensionData:self.currentObjectProperties];
-        } else if ([elementName isEqualToString:kCMISCoreRendition]) {
-            self.currentRendition = [[CMISRenditionData alloc] init];
-        } else if ([elementName isEqualToString:kCMISAtomEntryAllowableActions]) {
-            // Delegate parsing to child parser for allowableActions element
-            self.childParserDelegate = [CMISAtomPubAllowableActionsParser allowableActionsParserWithParentDelegate:self parser:parser];
-        } else if ([elementName isEqualToString:kCMISAtomEntryAcl]) {
-            // Delegate parsing to child parser for acl element
-            self.childParserDelegate = [CMISAtomPubAclParser aclParserWithParentDelegate:self parser:parser];
-        } else if ([elementName isEqualToString:kCMISCoreRelationship]) {
-            // NOTE: we're currently ignoring the relationship element so set a flag to check
-            self.parsingRelationship = YES;
-        }
-    } else if ([namespaceURI isEqualToString:kCMISNamespaceCmisRestAtom]) {
-        if ([elementName isEqualToString:kCMISAtomEntryObject]) {
-            // Set object data as the current extensionData object
-            [self pushNewCurrentExtensionData:self.objectData];
-        }
-    } else if ([namespaceURI isEqualToString:kCMISNamespaceAtom]) {
-        if ([elementName isEqualToString:kCMISAtomEntryLink]) {
-            NSString *linkType = [attributeDict objectForKey:kCMISAtomEntryType];
-            NSString *rel = [attributeDict objectForKey:kCMISAtomEntryRel];
-            NSString *href = [attributeDict objectForKey:kCMISAtomEntryHref]; 
-            
-            CMISAtomLink *link = [[CMISAtomLink alloc] initWithRelation:rel type:linkType href:href];
-            [self.currentLinkRelations addObject:link];
-        } else if ([elementName isEqualToString:kCMISAtomEntryContent]) {
-            self.objectData.contentUrl = [NSURL URLWithString:[attributeDict objectForKey:kCMISAtomEntrySrc]];
-        }
-    } else if ([namespaceURI isEqualToString:kCMISNamespaceApp]) {
-        // Nothing to do in this namespace
-    } else {
-        if (self.currentExtensionData != nil) {
-            self.childParserDelegate = [CMISAtomPubExtensionElementParser extensionElementParserWithElementName:elementName namespaceUri:namespaceURI 
-                                                                                                     attributes:attributeDict parentDelegate:self parser:parser];
-        }
+    switch (ns) {
+        case CMISXMLNamespaceCmisRestAtom:
+            if (name == CMISXMLNameObject) {
+                // Set object data as the current extensionData object
+                [self pushNewCurrentExtensionData:self.objectData];
+            }
+            break;
+        case CMISXMLNamespaceAtom:
+            if (name == CMISXMLNameLink) {
+                CMISAtomLink *link = [[CMISAtomLink alloc] initWithRelation:[parser valueForAttribute:CMISXMLNameRel]
+                                                                       type:[parser valueForAttribute:CMISXMLNameType]
+                                                                       href:[parser valueForAttribute:CMISXMLNameHref]];
+                [self.currentLinkRelations addObject:link];
+            } else if (name == CMISXMLNameContent) {
+                self.objectData.contentUrl = [NSURL URLWithString:[parser valueForAttribute:CMISXMLNameSrc]];
+            }
+            break;
+        case CMISXMLNamespaceApp:
+            // Nothing to do in this namespace
+            break;
+        case CMISXMLNamespaceCmis:
+            if (!self.parsingRelationship) {
+                [self parser:parser didStartCmisElement:name];
+                break;
+            }
+            // NOTE: the content of the relationship element is kept as extension elements
+        default:
+            if (self.currentExtensionData != nil) {
+                self.childParserDelegate = [CMISAtomPubExtensionElementParser extensionElementParserWithElementName:parser.elementName namespaceUri:parser.namespaceURI
+                                                                                                         attributes:parser.attributes parentDelegate:self parser:parser];
+            }
+            break;
     }
-    
-    self.string = [NSMutableString string];
-}
-
-- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string
-{
-    [self.string appendString:string];
 }
 
-
-- (void)parser:(NSXMLParser *)parser didEndElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName 
+- (void)parser:(CMISXMLParser *)parser didEndElement:(CMISXMLName)name inNamespace:(CMISXMLNamespace)ns
 {
-   
-    if ([elementName isEqualToString:kCMISAtomEntryValue]) {
-        [CMISAtomPubParserUtil parsePropertyValue:self.string propertyType:self.currentPropertyType addToArray:self.propertyValues];
+    if (name == CMISXMLNameValue) {
+        [CMISAtomPubParserUtil parsePropertyValue:parser.text internalPropertyType:self.currentPropertyData.type addToArray:self.propertyValues];
     } else if (self.currentRendition != nil) {
-        if ([elementName isEqualToString:kCMISCoreStreamId]) {
-            self.currentRendition.streamId = self.string;
-        } else if ([elementName isEqualToString:kCMISCoreMimetype]) {
-            self.currentRendition.mimeType = self.string;
-        } else if ([elementName isEqualToString:kCMISCoreLength]) {
-            self.currentRendition.length = [NSNumber numberWithInteger:[self.string integerValue]];
-        } else if ([elementName isEqualToString:kCMISCoreTitle]) {
-            self.currentRendition.title = self.string;
-        } else if ([elementName isEqualToString:kCMISCoreKind]) {
-            self.currentRendition.kind = self.string;
-        } else if ([elementName isEqualToString:kCMISCoreHeight]) {
-            self.currentRendition.height = [NSNumber numberWithInteger:[self.string integerValue]];
-        } else if ([elementName isEqualToString:kCMISCoreWidth]) {
-            self.currentRendition.width = [NSNumber numberWithInteger:[self.string integerValue]];
-        } else if ([elementName isEqualToString:kCMISCoreRenditionDocumentId]) {
-            self.currentRendition.renditionDocumentId = self.string;
-        }
+        [self parser:parser didEndRenditionElement:name];
     }
     
-    if ([namespaceURI isEqualToString:kCMISNamespaceCmis]) {
-        if (!self.parsingRelationship)
-        {
+    if (ns == CMISXMLNamespaceCmis) {
+        if (name == CMISXMLNameRelationship) {
+            // the relationship element has ended
+            self.parsingRelationship = NO;
+        } else if (!self.parsingRelationship) {
             // ignore the properties within the relationship element
-            if ([elementName isEqualToString:kCMISAtomEntryPropertyId] ||
-                [elementName isEqualToString:kCMISAtomEntryPropertyString] ||
-                [elementName isEqualToString:kCMISAtomEntryPropertyInteger] ||
-                [elementName isEqualToString:kCMISAtomEntryPropertyDateTime] ||
-                [elementName isEqualToString:kCMISAtomEntryPropertyBoolean] ||
-                [elementName isEqualToString:kCMISAtomEntryPropertyUri] ||
-                [elementName isEqualToString:kCMISAtomEntryPropertyHtml] ||
-                [elementName isEqualToString:kCMISAtomEntryPropertyDecimal]) {            
-                // add the property to the properties dictionary
-                self.currentPropertyData.values = self.propertyValues;
-                self.propertyValues = nil;
-                [self.currentObjectProperties addProperty:self.currentPropertyData];
-                self.currentPropertyData = nil;
-            } else if ([elementName isEqualToString:kCMISCoreProperties]) {
-                // Finished parsing Properties & its ExtensionData
-                [self saveCurrentExtensionsAndPushPreviousExtensionData];
-            } else if ([elementName isEqualToString:kCMISCoreRendition]) {
-                if (self.currentRenditions == nil) {
-                    self.currentRenditions = [[NSMutableArray alloc] init];
-                }
-                if (self.currentRendition != nil) {
-                    [self.currentRenditions addObject:self.currentRendition];
-                }
-                self.currentRendition = nil;
-        	} else if ([elementName isEqualToString:kCMISAtomEntryExactACL]) {
-            	self.isExcatAcl = [self.string isEqualToString:@"true"] ? YES : NO;
-            	if(self.objectData.acl){
-                	[self.objectData.acl setIsExact:self.isExcatAcl];
-            	}
-			}
+            [self parser:parser didEndCmisElement:name];
         }
-        
-        // the relationship element has ended
-        if ([elementName isEqualToString:kCMISCoreRelationship]) {
-            self.parsingRelationship = NO;
+    } else if (ns == CMISXMLNamespaceAtom && name == CMISXMLNameEntry) {
+        // set the properties on the objectData object
+        self.objectData.properties = self.currentObjectProperties;
+
+        // set the link relations on the objectData object
+        self.objectData.linkRelations = [[CMISLinkRelations alloc] initWithLinkRelationSet:[self.currentLinkRelations copy]];
+
+        // set the renditions on the objectData object
+        self.objectData.renditions = self.currentRenditions;
+
+        // set the objectData identifier
+        CMISPropertyData *objectId = [self.currentObjectProperties.propertiesDictionary objectForKey:kCMISPropertyObjectId];
+        self.objectData.identifier = [objectId firstValue];
+
+        // set the objectData baseType
+        CMISPropertyData *baseTypeProperty = [self.currentObjectProperties.propertiesDictionary objectForKey:kCMISPropertyBaseTypeId];
+        NSString *baseType = [baseTypeProperty firstValue];
+        if ([baseType isEqualToString:kCMISPropertyObjectTypeIdValueDocument]) {
+            self.objectData.baseType = CMISBaseTypeDocument;
+        } else if ([baseType isEqualToString:kCMISPropertyObjectTypeIdValueFolder]) {
+            self.objectData.baseType = CMISBaseTypeFolder;
         }
-        
-    } else if ([namespaceURI isEqualToString:kCMISNamespaceAtom]) {
-        if ( [elementName isEqualToString:kCMISAtomEntry]) {
-            // set the properties on the objectData object
-            self.objectData.properties = self.currentObjectProperties;
-
-            // set the link relations on the objectData object
-            self.objectData.linkRelations = [[CMISLinkRelations alloc] initWithLinkRelationSet:[self.currentLinkRelations copy]];
-
-            // set the renditions on the objectData object
-            self.objectData.renditions = self.currentRenditions;
-
-            // set the objectData identifier
-            CMISPropertyData *objectId = [self.currentObjectProperties.propertiesDictionary objectForKey:kCMISPropertyObjectId];
-            self.objectData.identifier = [objectId firstValue];
-
-            // set the objectData baseType
-            CMISPropertyData *baseTypeProperty = [self.currentObjectProperties.propertiesDictionary objectForKey:kCMISPropertyBaseTypeId];
-            NSString *baseType = [baseTypeProperty firstValue];
-            if ([baseType isEqualToString:kCMISPropertyObjectTypeIdValueDocument]) {
-                self.objectData.baseType = CMISBaseTypeDocument;
-            } else if ([baseType isEqualToString:kCMISPropertyObjectTypeIdValueFolder]) {
-                self.objectData.baseType = CMISBaseTypeFolder;
-            }
 
-            // set the extensionData
-            [self saveCurrentExtensionsAndPushPreviousExtensionData];
-
-            self.currentObjectProperties = nil;
+        // set the extensionData
+        [self saveCurrentExtensionsAndPushPreviousExtensionData];
 
-            if (self.parentDelegate) {
-                if ([self.parentDelegate respondsToSelector:@selector(cmisAtomEntryParser:didFinishParsingCMISObjectData:)]) {
-                    // Message the parent delegate the parsed ObjectData
-                    [self.parentDelegate performSelector:@selector(cmisAtomEntryParser:didFinishParsingCMISObjectData:)
-                                              withObject:self withObject:self.objectData];
-                }
+        self.currentObjectProperties = nil;
 
-                // Resetting our parent as the delegate since we're done
-                parser.delegate = self.parentDelegate;
-                self.parentDelegate = nil;
+        if (self.parentDelegate) {
+            if ([self.parentDelegate respondsToSelector:@selector(cmisAtomEntryParser:didFinishParsingCMISObjectData:)]) {
+                // Message the parent delegate the parsed ObjectData
+                [self.parentDelegate performSelector:@selector(cmisAtomEntryParser:didFinishParsingCMISObjectData:)
+                                          withObject:self withObject:self.objectData];
             }
+
+            // Resetting our parent as the delegate since we're done
+            parser.delegate = self.parentDelegate;
+            self.parentDelegate = nil;
         }
-    } else if ([namespaceURI isEqualToString:kCMISNamespaceApp]) {
-        // Nothing to do in this namespace
-    } else {
-        // TODO other namespaces?
     }
-
-    self.string = nil;
 }
 
 #pragma mark -
@@ -323,4 +245,148 @@
     [self.objectData.acl setIsExact:self.isExcatAcl];
 }
 
+#pragma mark -
+#pragma mark Private helper methods
+
+- (void)parser:(CMISXMLParser *)parser didStartCmisElement:(CMISXMLName)name
+{
+    switch (name) {
+        case CMISXMLNamePropertyId:
+        case CMISXMLNamePropertyString:
+        case CMISXMLNamePropertyInteger:
+        case CMISXMLNamePropertyDateTime:
+        case CMISXMLNamePropertyBoolean:
+        case CMISXMLNamePropertyUri:
+        case CMISXMLNamePropertyHtml:
+        case CMISXMLNamePropertyDecimal:
+            self.propertyValues = [NSMutableArray array];
+            // store attribute values in CMISPropertyData object
+            self.currentPropertyData = [[CMISPropertyData alloc] init];
+            self.currentPropertyData.identifier = [parser valueForAttribute:CMISXMLNamePropertyDefinitionId];
+            self.currentPropertyData.queryName = [parser valueForAttribute:CMISXMLNameQueryName];
+            self.currentPropertyData.displayName = [parser valueForAttribute:CMISXMLNameDisplayName];
+            self.currentPropertyData.type = [self propertyTypeForName:name];
+            break;
+        case CMISXMLNameProperties:
+            // create the CMISProperties object to hold all property data
+            self.currentObjectProperties = [[CMISProperties alloc] init];
+            
+            // Set ObjectProperties as the current extensionData object
+            [self pushNewCurrentExtensionData:self.currentObjectProperties];
+            break;
+        case CMISXMLNameRendition:
+            self.currentRendition = [[CMISRenditionData alloc] init];
+            break;
+        case CMISXMLNameAllowableActions:
+            // Delegate parsing to child parser for allowableActions element
+            self.childParserDelegate = [CMISAtomPubAllowableActionsParser allowableActionsParserWithParentDelegate:self parser:parser];
+            break;
+        case CMISXMLNameAcl:
+            // Delegate parsing to child parser for acl element
+            self.childParserDelegate = [CMISAtomPubAclParser aclParserWithParentDelegate:self parser:parser];
+            break;
+        case CMISXMLNameRelationship:
+            // NOTE: we're currently ignoring the relationship element so set a flag to check
+            self.parsingRelationship = YES;
+            break;
+        default:
+            break;
+    }
+}
+
+- (void)parser:(CMISXMLParser *)parser didEndCmisElement:(CMISXMLName)name
+{
+    switch (name) {
+        case CMISXMLNamePropertyId:
+        case CMISXMLNamePropertyString:
+        case CMISXMLNamePropertyInteger:
+        case CMISXMLNamePropertyDateTime:
+        case CMISXMLNamePropertyBoolean:
+        case CMISXMLNamePropertyUri:
+        case CMISXMLNamePropertyHtml:
+        case CMISXMLNamePropertyDecimal:
+            // add the property to the properties dictionary
+            self.currentPropertyData.values = self.propertyValues;
+            self.propertyValues = nil;
+            [self.currentObjectProperties addProperty:self.currentPropertyData];
+            self.currentPropertyData = nil;
+            break;
+        case CMISXMLNameProperties:
+            // Finished parsing Properties & its ExtensionData
+            [self saveCurrentExtensionsAndPushPreviousExtensionData];
+            break;
+        case CMISXMLNameRendition:
+            if (self.currentRenditions == nil) {
+                self.currentRenditions = [[NSMutableArray alloc] init];
+            }
+            if (self.currentRendition != nil) {
+                [self.currentRenditions addObject:self.currentRendition];
+            }
+            self.currentRendition = nil;
+            break;
+        case CMISXMLNameExactACL:
+            self.isExcatAcl = [parser.text isEqualToString:kCMISAtomEntryValueTrue];
+            if (self.objectData.acl) {
+                [self.objectData.acl setIsExact:self.isExcatAcl];
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+- (void)parser:(CMISXMLParser *)parser didEndRenditionElement:(CMISXMLName)name
+{
+    switch (name) {
+        case CMISXMLNameStreamId:
+            self.currentRendition.streamId = parser.text;
+            break;
+        case CMISXMLNameMimetype:
+            self.currentRendition.mimeType = parser.text;
+            break;
+        case CMISXMLNameLength:
+            self.currentRendition.length = [NSNumber numberWithInteger:[parser.text integerValue]];
+            break;
+        case CMISXMLNameTitle:
+            self.currentRendition.title = parser.text;
+            break;
+        case CMISXMLNameKind:
+            self.currentRendition.kind = parser.text;
+            break;
+        case CMISXMLNameHeight:
+            self.currentRendition.height = [NSNumber numberWithInteger:[parser.text integerValue]];
+            break;
+        case CMISXMLNameWidth:
+            self.currentRendition.width = [NSNumber numberWithInteger:[parser.text integerValue]];
+            break;
+        case CMISXMLNameRenditionDocumentId:
+            self.currentRendition.renditionDocumentId = parser.text;
+            break;
+        default:
+            break;
+    }
+}
+
+- (CMISPropertyType)propertyTypeForName:(CMISXMLName)name
+{
+    switch (name) {
+        case CMISXMLNamePropertyId:
+            return CMISPropertyTypeId;
+        case CMISXMLNamePropertyInteger:
+            return CMISPropertyTypeInteger;
+        case CMISXMLNamePropertyBoolean:
+            return CMISPropertyTypeBoolean;
+        case CMISXMLNamePropertyDateTime:
+            return CMISPropertyTypeDateTime;
+        case CMISXMLNamePropertyDecimal:
+            return CMISPropertyTypeDecimal;
+        case CMISXMLNamePropertyHtml:
+            return CMISPropertyTypeHtml;
+        case CMISXMLNamePropertyUri:
+            return CMISPropertyTypeUri;
+        default:
+            return CMISPropertyTypeString;
+    }
+}
+
 @end
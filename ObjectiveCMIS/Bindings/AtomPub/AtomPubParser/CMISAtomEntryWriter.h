@@ -35,6 +35,9 @@
  * If NO: the xml will be streamed to a file on disk.
  *
  * Defaults to YES;
+ *
+ * NOTE: to upload large content, send entryStartData, the base64 encoded content and entryEndData as
+ * the request body instead, which needs neither memory nor a temporary file for the whole entry.
  */
 @property BOOL generateXmlInMemory;
 
@@ -58,4 +61,13 @@
 
 - (NSString *)xmlPropertiesElements;
 
+/**
+ * Returns the XML of the entry up to the opening base64 element of the content, as UTF-8 encoded data.
+ * The base64 encoded content is to be followed by entryEndData.
+ */
+- (NSData *)entryStartData;
+
+/// Returns the XML of the entry from the closing base64 element of the content on, as UTF-8 encoded data.
+- (NSData *)entryEndData;
+
 @end
\ No newline at end of file
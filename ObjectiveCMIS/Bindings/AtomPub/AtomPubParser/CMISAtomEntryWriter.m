@@ -280,6 +280,20 @@
     }
 }
 
+- (NSData *)entryStartData
+{
+    NSMutableString *start = [NSMutableString stringWithString:[self xmlStartElement]];
+    [start appendString:[self xmlContentStartElement]];
+    return [start dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)entryEndData
+{
+    NSMutableString *end = [NSMutableString stringWithString:[self xmlContentEndElement]];
+    [end appendString:[self xmlPropertiesElements]];
+    return [end dataUsingEncoding:NSUTF8StringEncoding];
+}
+
 
 - (void)addEntryStartElement
 {
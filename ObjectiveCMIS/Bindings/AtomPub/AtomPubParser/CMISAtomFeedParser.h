@@ -23,11 +23,13 @@
 #import "CMISPropertyData.h"
 #import "CMISProperties.h"
 #import "CMISAtomEntryParser.h"
+#import "CMISXMLParser.h"
 
-@interface CMISAtomFeedParser : NSObject <NSXMLParserDelegate, CMISAtomEntryParserDelegate>
+@interface CMISAtomFeedParser : NSObject <CMISXMLParserDelegate, CMISAtomEntryParserDelegate>
 
 /**
  * The entries contained in the feed (array of CMISObjectData objects).
+ * Entries parsed incrementally are handed to the entry block instead and are not kept.
  */
 @property (nonatomic, strong, readonly) NSArray *entries;
 
@@ -46,4 +48,20 @@
 /// parses the atom XML data. returns NO if unsuccessful
 - (BOOL)parseAndReturnError:(NSError **)error;
 
+/**
+ * Initialises the parser for a feed that is parsed while it is received.
+ * Each chunk is parsed as soon as it is appended, and each entry is handed to the entry block as soon as it has been
+ * parsed, so only the entry being parsed is kept. All methods must be called on the same thread.
+ */
+- (id)initWithEntryBlock:(void (^)(CMISObjectData *objectData))entryBlock;
+
+/// parses the next chunk of the feed, handing the entries it completes to the entry block before returning
+- (void)appendData:(NSData *)data;
+
+/// signals the end of the feed, the completion block is called once the rest of the feed has been parsed
+- (void)finishWithCompletionBlock:(void (^)(NSError *error))completionBlock;
+
+/// stops parsing, no more entries are handed over
+- (void)cancel;
+
 @end
@@ -19,6 +19,7 @@
 
 #import "CMISAtomFeedParser.h"
 #import "CMISAtomLink.h"
+#import "CMISErrors.h"
 
 @interface CMISAtomFeedParser ()
 @property (nonatomic, strong, readwrite) NSData *feedData;
@@ -26,7 +27,9 @@
 @property (readwrite) int numItems;
 @property (nonatomic, strong, readwrite) NSMutableSet *feedLinkRelations;
 @property (nonatomic, strong, readwrite) id childParserDelegate;
-@property (nonatomic, strong) NSMutableString *string;
+@property (nonatomic, strong) CMISXMLParser *xmlParser;
+@property (nonatomic, copy) void (^entryBlock)(CMISObjectData *objectData);
+@property (nonatomic, assign) BOOL cancelled;
 @end
 
 @implementation CMISAtomFeedParser
@@ -43,6 +46,18 @@
     return self;
 }
 
+- (id)initWithEntryBlock:(void (^)(CMISObjectData *objectData))entryBlock
+{
+    self = [self initWithData:nil];
+    if (self) {
+        self.entryBlock = entryBlock;
+        self.xmlParser = [[CMISXMLParser alloc] init];
+        [self.xmlParser setDelegate:self];
+    }
+    
+    return self;
+}
+
 - (NSArray *)entries
 {
     if (self.internalEntries != nil) {
@@ -65,8 +80,7 @@
     self.internalEntries = [NSMutableArray array];
     
     // parse the AtomPub data
-    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:self.feedData];
-    [parser setShouldProcessNamespaces:YES];
+    CMISXMLParser *parser = [[CMISXMLParser alloc] initWithData:self.feedData];
     [parser setDelegate:self];
     parseSuccessful = [parser parse];
     
@@ -79,36 +93,67 @@
     return parseSuccessful;
 }
 
-#pragma mark -
-#pragma mark NSXMLParser delegate methods
+- (void)appendData:(NSData *)data
+{
+    if (!self.cancelled) {
+        [self.xmlParser appendData:data];
+    }
+}
 
-- (void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName attributes:(NSDictionary *)attributeDict 
+- (void)finishWithCompletionBlock:(void (^)(NSError *error))completionBlock
 {
-    if ([elementName isEqualToString:kCMISAtomEntry]) {
-        // Delegate parsing of AtomEntry element to the entry child parser
-        self.childParserDelegate = [CMISAtomEntryParser atomEntryParserWithAtomEntryAttributes:attributeDict parentDelegate:self parser:parser];
-    } else if ([elementName isEqualToString:kCMISAtomEntryLink]) {
-        CMISAtomLink *link = [[CMISAtomLink alloc] init];
-        [link setValuesForKeysWithDictionary:attributeDict];
-        [self.feedLinkRelations addObject:link];
+    NSError *error = nil;
+    if (self.cancelled) {
+        error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled detailedDescription:@"Parsing was cancelled"];
+    } else if (![self.xmlParser finishParsing]) {
+        error = [self.xmlParser parserError];
     }
+    self.xmlParser = nil;
+    self.childParserDelegate = nil;
+    self.entryBlock = nil;
     
-    self.string = [NSMutableString string];
+    if (completionBlock) {
+        completionBlock(error);
+    }
 }
 
-- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string
+- (void)cancel
 {
-    [self.string appendString:string];
+    self.cancelled = YES;
+    [self.xmlParser abortParsing];
 }
 
+#pragma mark -
+#pragma mark CMISXMLParser delegate methods
 
-- (void)parser:(NSXMLParser *)parser didEndElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName 
+- (void)parser:(CMISXMLParser *)parser didStartElement:(CMISXMLName)name inNamespace:(CMISXMLNamespace)ns
 {
-    if ([elementName isEqualToString:kCMISAtomFeedNumItems]) {
-        self.numItems = [self.string intValue];
+    switch (name) {
+        case CMISXMLNameEntry:
+            // Delegate parsing of AtomEntry element to the entry child parser, one child parser is reused for all entries
+            if (self.childParserDelegate) {
+                [self.childParserDelegate resetWithAtomEntryAttributes:parser.attributes parentDelegate:self parser:parser];
+            } else {
+                self.childParserDelegate = [CMISAtomEntryParser atomEntryParserWithAtomEntryAttributes:parser.attributes parentDelegate:self parser:parser];
+            }
+            break;
+        case CMISXMLNameLink: {
+            CMISAtomLink *link = [[CMISAtomLink alloc] initWithRelation:[parser valueForAttribute:CMISXMLNameRel]
+                                                                   type:[parser valueForAttribute:CMISXMLNameType]
+                                                                   href:[parser valueForAttribute:CMISXMLNameHref]];
+            [self.feedLinkRelations addObject:link];
+            break;
+        }
+        default:
+            break;
     }
+}
 
-    self.string = nil;
+- (void)parser:(CMISXMLParser *)parser didEndElement:(CMISXMLName)name inNamespace:(CMISXMLNamespace)ns
+{
+    if (name == CMISXMLNameNumItems) {
+        self.numItems = [parser.text intValue];
+    }
 }
 
 
@@ -117,7 +162,13 @@
 
 - (void)cmisAtomEntryParser:(CMISAtomEntryParser *)entryParser didFinishParsingCMISObjectData:(CMISObjectData *)cmisObjectData
 {
-    [self.internalEntries addObject:cmisObjectData];
+    if (self.entryBlock) {
+        if (!self.cancelled) {
+            self.entryBlock(cmisObjectData);
+        }
+    } else {
+        [self.internalEntries addObject:cmisObjectData];
+    }
 }
 
 @end
@@ -19,6 +19,7 @@
 
 #import "CMISAtomPubAllowableActionsParser.h"
 #import "CMISAtomPubConstants.h"
+#import "CMISXMLParser.h"
 
 @interface CMISAtomPubAllowableActionsParser ()
 
@@ -74,8 +75,7 @@
     BOOL parseSuccessful = YES;
     
     // parse the AtomPub data
-    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:self.atomData];
-    [parser setShouldProcessNamespaces:YES];
+    CMISXMLParser *parser = [[CMISXMLParser alloc] initWithData:self.atomData];
     [parser setDelegate:self];
     
     parseSuccessful = [parser parse];
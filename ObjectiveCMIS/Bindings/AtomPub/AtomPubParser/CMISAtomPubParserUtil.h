@@ -35,4 +35,9 @@
  */
 + (void)parsePropertyValue:(NSString *)stringValue propertyType:(NSString *)propertyType addToArray:(NSMutableArray*)array;
 
+/**
+ * parses the property value of the given internal property type and adds it to an array
+ */
++ (void)parsePropertyValue:(NSString *)stringValue internalPropertyType:(CMISPropertyType)propertyType addToArray:(NSMutableArray *)array;
+
 @end
\ No newline at end of file
@@ -72,5 +72,34 @@
     }
 }
 
++ (void)parsePropertyValue:(NSString *)stringValue internalPropertyType:(CMISPropertyType)propertyType addToArray:(NSMutableArray *)array
+{
+    switch (propertyType) {
+        case CMISPropertyTypeString:
+        case CMISPropertyTypeId:
+        case CMISPropertyTypeHtml:
+            [array addObject:stringValue];
+            break;
+        case CMISPropertyTypeInteger:
+            [array addObject:[NSNumber numberWithInt:[stringValue intValue]]];
+            break;
+        case CMISPropertyTypeBoolean:
+            [array addObject:[NSNumber numberWithBool:[stringValue isEqualToString:kCMISAtomEntryValueTrue]]];
+            break;
+        case CMISPropertyTypeDateTime:
+            [array addObject:[CMISDateUtil dateFromString:stringValue]];
+            break;
+        case CMISPropertyTypeDecimal:
+            [array addObject:[NSDecimalNumber decimalNumberWithString:stringValue]];
+            break;
+        case CMISPropertyTypeUri:
+            [array addObject:[NSURL URLWithString:stringValue]];
+            break;
+        default:
+            CMISLogDebug(@"Unknown property type %ld. Go tell a developer to fix this.", (long)propertyType);
+            break;
+    }
+}
+
 
 @end
\ No newline at end of file
@@ -22,6 +22,7 @@
 #import "CMISAtomCollection.h"
 #import "CMISAtomLink.h"
 #import "CMISAtomPubConstants.h"
+#import "CMISXMLParser.h"
 #import "CMISLinkRelations.h"
 #import "CMISLog.h"
 
@@ -73,8 +74,7 @@
     self.internalWorkspaces = [NSMutableArray array];
     
     // parse the AtomPub data
-    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:self.atomData];
-    [parser setShouldProcessNamespaces:YES];
+    CMISXMLParser *parser = [[CMISXMLParser alloc] initWithData:self.atomData];
     [parser setDelegate:self];
     BOOL parseSuccessful = [parser parse];
     
@@ -21,6 +21,7 @@
 #import "CMISTypeDefinition.h"
 #import "CMISDocumentTypeDefinition.h"
 #import "CMISAtomPubConstants.h"
+#import "CMISXMLParser.h"
 #import "CMISConstants.h"
 
 @interface CMISTypeDefinitionAtomEntryParser ()
@@ -51,8 +52,7 @@
     BOOL parseSuccessful = YES;
 
     // parse the AtomPub data
-    NSXMLParser *parser = [[NSXMLParser alloc] initWithData:self.atomData];
-    [parser setShouldProcessNamespaces:YES];
+    CMISXMLParser *parser = [[CMISXMLParser alloc] initWithData:self.atomData];
     [parser setDelegate:self];
 
     parseSuccessful = [parser parse];
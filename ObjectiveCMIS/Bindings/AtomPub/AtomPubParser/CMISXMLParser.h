@@ -0,0 +1,133 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+/// The namespaces CMISXMLParser interns into tokens
+typedef NS_ENUM(NSInteger, CMISXMLNamespace)
+{
+    CMISXMLNamespaceOther,
+    CMISXMLNamespaceAtom,
+    CMISXMLNamespaceApp,
+    CMISXMLNamespaceCmis,
+    CMISXMLNamespaceCmisRestAtom
+};
+
+/// The element and attribute names CMISXMLParser interns into tokens
+typedef NS_ENUM(NSInteger, CMISXMLName)
+{
+    CMISXMLNameOther,
+    CMISXMLNameEntry,
+    CMISXMLNameLink,
+    CMISXMLNameContent,
+    CMISXMLNameRel,
+    CMISXMLNameType,
+    CMISXMLNameHref,
+    CMISXMLNameSrc,
+    CMISXMLNameNumItems,
+    CMISXMLNameObject,
+    CMISXMLNameProperties,
+    CMISXMLNamePropertyId,
+    CMISXMLNamePropertyString,
+    CMISXMLNamePropertyInteger,
+    CMISXMLNamePropertyDecimal,
+    CMISXMLNamePropertyDateTime,
+    CMISXMLNamePropertyBoolean,
+    CMISXMLNamePropertyUri,
+    CMISXMLNamePropertyHtml,
+    CMISXMLNamePropertyDefinitionId,
+    CMISXMLNameQueryName,
+    CMISXMLNameDisplayName,
+    CMISXMLNameValue,
+    CMISXMLNameAllowableActions,
+    CMISXMLNameAcl,
+    CMISXMLNameExactACL,
+    CMISXMLNameRelationship,
+    CMISXMLNameRendition,
+    CMISXMLNameStreamId,
+    CMISXMLNameMimetype,
+    CMISXMLNameLength,
+    CMISXMLNameTitle,
+    CMISXMLNameKind,
+    CMISXMLNameHeight,
+    CMISXMLNameWidth,
+    CMISXMLNameRenditionDocumentId
+};
+
+@class CMISXMLParser;
+
+/**
+ * A parser delegate that dispatches on interned tokens. When the delegate implements these methods, CMISXMLParser calls
+ * them instead of the NSXMLParserDelegate element and character methods. The text, names and attributes of the current
+ * element are available from the parser.
+ */
+@protocol CMISXMLParserDelegate <NSXMLParserDelegate>
+
+- (void)parser:(CMISXMLParser *)parser didStartElement:(CMISXMLName)name inNamespace:(CMISXMLNamespace)ns;
+
+- (void)parser:(CMISXMLParser *)parser didEndElement:(CMISXMLName)name inNamespace:(CMISXMLNamespace)ns;
+
+@end
+
+/**
+ * A drop-in replacement for NSXMLParser built on the libxml2 SAX2 push parser. Namespaces are always processed.
+ *
+ * Element and attribute names are interned into CMISXMLName and CMISXMLNamespace tokens, using libxml2's own string
+ * dictionary so each distinct name is resolved once per document. Character data is collected in a buffer that is
+ * reused for every element and only turned into a string when the delegate asks for it.
+ *
+ * Delegates that only implement NSXMLParserDelegate receive the usual string based callbacks, so child parsers of
+ * either kind can take turns as the delegate.
+ */
+@interface CMISXMLParser : NSXMLParser
+
+/// The text found since the current element started or the last element ended
+@property (nonatomic, strong, readonly) NSString *text;
+
+/// The local name of the current element
+@property (nonatomic, strong, readonly) NSString *elementName;
+
+/// The namespace URI of the current element
+@property (nonatomic, strong, readonly) NSString *namespaceURI;
+
+/// The attributes of the element that has just started, keyed by qualified name. nil outside of a start element callback
+@property (nonatomic, strong, readonly) NSDictionary *attributes;
+
+/// Initialises a parser the document is handed to in chunks with appendData:
+- (id)init;
+
+/// returns the value of an unprefixed attribute of the element that has just started, or nil
+- (NSString *)valueForAttribute:(CMISXMLName)name;
+
+/// parses the next chunk of the document, returns NO once parsing has failed or was aborted
+- (BOOL)appendData:(NSData *)data;
+
+/// parses the end of the document, returns NO if unsuccessful
+- (BOOL)finishParsing;
+
+/// returns the token for a local name
++ (CMISXMLName)nameForString:(NSString *)string;
+
+/// returns the token for a namespace URI
++ (CMISXMLNamespace)namespaceForURI:(NSString *)namespaceURI;
+
+/// returns the local name of a token
++ (NSString *)stringForName:(CMISXMLName)name;
+
+@end
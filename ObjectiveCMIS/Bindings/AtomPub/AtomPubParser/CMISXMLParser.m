@@ -0,0 +1,564 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import "CMISXMLParser.h"
+#import "CMISAtomPubConstants.h"
+#import <libxml/parser.h>
+#import <libxml/SAX2.h>
+
+// Number of slots of a cache mapping the names interned by libxml2 to tokens, a power of two
+#define TOKEN_CACHE_SIZE 128
+
+// Maximum number of bytes handed to libxml2 at once when parsing a complete document
+#define PARSE_CHUNK_SIZE (256 * 1024)
+
+// Initial capacity in bytes of the character data buffer
+#define TEXT_BUFFER_CAPACITY 1024
+
+typedef struct {
+    const xmlChar *keys[TOKEN_CACHE_SIZE];
+    NSInteger tokens[TOKEN_CACHE_SIZE];
+    NSUInteger count;
+} CMISXMLTokenCache;
+
+static NSDictionary *CMISXMLNameTokens;
+static NSDictionary *CMISXMLNameStrings;
+static NSDictionary *CMISXMLNamespaceTokens;
+
+@interface CMISXMLParser ()
+
+@property (nonatomic, strong) NSData *data;
+@property (nonatomic, weak) id<NSXMLParserDelegate> parserDelegate;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, assign) BOOL aborted;
+@property (nonatomic, assign) BOOL finished;
+
+- (void)startDocument;
+- (void)endDocument;
+- (void)startElement:(const xmlChar *)localName prefix:(const xmlChar *)prefix namespaceURI:(const xmlChar *)namespaceURI
+      attributeCount:(int)attributeCount attributes:(const xmlChar **)attributes;
+- (void)endElement:(const xmlChar *)localName prefix:(const xmlChar *)prefix namespaceURI:(const xmlChar *)namespaceURI;
+- (void)foundCharacters:(const xmlChar *)characters length:(int)length;
+
+@end
+
+#pragma mark -
+#pragma mark libxml2 SAX2 callbacks
+
+static void CMISXMLStartDocument(void *context)
+{
+    [(__bridge CMISXMLParser *)context startDocument];
+}
+
+static void CMISXMLEndDocument(void *context)
+{
+    [(__bridge CMISXMLParser *)context endDocument];
+}
+
+static void CMISXMLStartElement(void *context, const xmlChar *localName, const xmlChar *prefix, const xmlChar *namespaceURI,
+                                int namespaceCount, const xmlChar **namespaces, int attributeCount, int defaultedCount,
+                                const xmlChar **attributes)
+{
+    [(__bridge CMISXMLParser *)context startElement:localName prefix:prefix namespaceURI:namespaceURI
+                                     attributeCount:attributeCount attributes:attributes];
+}
+
+static void CMISXMLEndElement(void *context, const xmlChar *localName, const xmlChar *prefix, const xmlChar *namespaceURI)
+{
+    [(__bridge CMISXMLParser *)context endElement:localName prefix:prefix namespaceURI:namespaceURI];
+}
+
+static void CMISXMLCharacters(void *context, const xmlChar *characters, int length)
+{
+    [(__bridge CMISXMLParser *)context foundCharacters:characters length:length];
+}
+
+static xmlEntityPtr CMISXMLGetEntity(void *context, const xmlChar *name)
+{
+    // only the predefined entities are resolved, declared and external entities are never loaded
+    return xmlGetPredefinedEntity(name);
+}
+
+static void CMISXMLIgnoreMessage(void *context, const char *message, ...)
+{
+    // errors are reported through parserError, libxml2 would print them otherwise
+}
+
+static NSInteger CMISXMLTokenForString(CMISXMLTokenCache *cache, const xmlChar *string, xmlDictPtr dict, NSDictionary *tokens)
+{
+    if (string == NULL) {
+        return 0;
+    }
+    
+    NSUInteger slot = ((uintptr_t)string >> 3) & (TOKEN_CACHE_SIZE - 1);
+    while (cache->keys[slot] != NULL) {
+        if (cache->keys[slot] == string) {
+            return cache->tokens[slot];
+        }
+        slot = (slot + 1) & (TOKEN_CACHE_SIZE - 1);
+    }
+    
+    NSString *key = [[NSString alloc] initWithUTF8String:(const char *)string];
+    NSInteger token = [[tokens objectForKey:key] integerValue];
+    
+    // only strings owned by the dictionary keep their address for the whole document, and a half empty cache keeps the probing short
+    if (cache->count < TOKEN_CACHE_SIZE / 2 && xmlDictOwns(dict, string) == 1) {
+        cache->keys[slot] = string;
+        cache->tokens[slot] = token;
+        cache->count++;
+    }
+    
+    return token;
+}
+
+@implementation CMISXMLParser
+{
+    xmlParserCtxtPtr _context;
+    CMISXMLTokenCache _nameCache;
+    CMISXMLTokenCache _namespaceCache;
+    char *_textBuffer;
+    NSUInteger _textLength;
+    NSUInteger _textCapacity;
+    NSString *_text;
+    const xmlChar *_localName;
+    const xmlChar *_prefix;
+    const xmlChar *_namespaceURI;
+    const xmlChar **_attributeValues;
+    int _attributeCount;
+    BOOL _startingElement;
+    BOOL _tokenDelegate;
+    BOOL _delegateStartsElements;
+    BOOL _delegateEndsElements;
+    BOOL _delegateFindsCharacters;
+}
+
++ (void)initialize
+{
+    if (self == [CMISXMLParser class]) {
+        xmlInitParser();
+        
+        CMISXMLNameTokens = @{kCMISAtomEntry: @(CMISXMLNameEntry),
+                              kCMISAtomEntryLink: @(CMISXMLNameLink),
+                              kCMISAtomEntryContent: @(CMISXMLNameContent),
+                              kCMISAtomEntryRel: @(CMISXMLNameRel),
+                              kCMISAtomEntryType: @(CMISXMLNameType),
+                              kCMISAtomEntryHref: @(CMISXMLNameHref),
+                              kCMISAtomEntrySrc: @(CMISXMLNameSrc),
+                              kCMISAtomFeedNumItems: @(CMISXMLNameNumItems),
+                              kCMISAtomEntryObject: @(CMISXMLNameObject),
+                              kCMISCoreProperties: @(CMISXMLNameProperties),
+                              kCMISAtomEntryPropertyId: @(CMISXMLNamePropertyId),
+                              kCMISAtomEntryPropertyString: @(CMISXMLNamePropertyString),
+                              kCMISAtomEntryPropertyInteger: @(CMISXMLNamePropertyInteger),
+                              kCMISAtomEntryPropertyDecimal: @(CMISXMLNamePropertyDecimal),
+                              kCMISAtomEntryPropertyDateTime: @(CMISXMLNamePropertyDateTime),
+                              kCMISAtomEntryPropertyBoolean: @(CMISXMLNamePropertyBoolean),
+                              kCMISAtomEntryPropertyUri: @(CMISXMLNamePropertyUri),
+                              kCMISAtomEntryPropertyHtml: @(CMISXMLNamePropertyHtml),
+                              kCMISAtomEntryPropertyDefId: @(CMISXMLNamePropertyDefinitionId),
+                              kCMISAtomEntryQueryName: @(CMISXMLNameQueryName),
+                              kCMISAtomEntryDisplayName: @(CMISXMLNameDisplayName),
+                              kCMISAtomEntryValue: @(CMISXMLNameValue),
+                              kCMISAtomEntryAllowableActions: @(CMISXMLNameAllowableActions),
+                              kCMISAtomEntryAcl: @(CMISXMLNameAcl),
+                              kCMISAtomEntryExactACL: @(CMISXMLNameExactACL),
+                              kCMISCoreRelationship: @(CMISXMLNameRelationship),
+                              kCMISCoreRendition: @(CMISXMLNameRendition),
+                              kCMISCoreStreamId: @(CMISXMLNameStreamId),
+                              kCMISCoreMimetype: @(CMISXMLNameMimetype),
+                              kCMISCoreLength: @(CMISXMLNameLength),
+                              kCMISCoreTitle: @(CMISXMLNameTitle),
+                              kCMISCoreKind: @(CMISXMLNameKind),
+                              kCMISCoreHeight: @(CMISXMLNameHeight),
+                              kCMISCoreWidth: @(CMISXMLNameWidth),
+                              kCMISCoreRenditionDocumentId: @(CMISXMLNameRenditionDocumentId)};
+        
+        NSMutableDictionary *nameStrings = [NSMutableDictionary dictionaryWithCapacity:CMISXMLNameTokens.count];
+        [CMISXMLNameTokens enumerateKeysAndObjectsUsingBlock:^(NSString *string, NSNumber *token, BOOL *stop) {
+            [nameStrings setObject:string forKey:token];
+        }];
+        CMISXMLNameStrings = [nameStrings copy];
+        
+        CMISXMLNamespaceTokens = @{kCMISNamespaceAtom: @(CMISXMLNamespaceAtom),
+                                   kCMISNamespaceApp: @(CMISXMLNamespaceApp),
+                                   kCMISNamespaceCmis: @(CMISXMLNamespaceCmis),
+                                   kCMISNamespaceCmisRestAtom: @(CMISXMLNamespaceCmisRestAtom)};
+    }
+}
+
+- (id)init
+{
+    return [super initWithData:[NSData data]];
+}
+
+- (id)initWithData:(NSData *)data
+{
+    self = [super initWithData:data];
+    if (self) {
+        self.data = data;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self freeContext];
+    free(_textBuffer);
+}
+
++ (CMISXMLName)nameForString:(NSString *)string
+{
+    return [[CMISXMLNameTokens objectForKey:string] integerValue];
+}
+
++ (CMISXMLNamespace)namespaceForURI:(NSString *)namespaceURI
+{
+    return [[CMISXMLNamespaceTokens objectForKey:namespaceURI] integerValue];
+}
+
++ (NSString *)stringForName:(CMISXMLName)name
+{
+    return [CMISXMLNameStrings objectForKey:@(name)];
+}
+
+#pragma mark NSXMLParser methods
+
+- (id<NSXMLParserDelegate>)delegate
+{
+    return self.parserDelegate;
+}
+
+- (void)setDelegate:(id<NSXMLParserDelegate>)delegate
+{
+    self.parserDelegate = delegate;
+    _tokenDelegate = [delegate respondsToSelector:@selector(parser:didStartElement:inNamespace:)];
+    _delegateStartsElements = [delegate respondsToSelector:@selector(parser:didStartElement:namespaceURI:qualifiedName:attributes:)];
+    _delegateEndsElements = [delegate respondsToSelector:@selector(parser:didEndElement:namespaceURI:qualifiedName:)];
+    _delegateFindsCharacters = [delegate respondsToSelector:@selector(parser:foundCharacters:)];
+}
+
+- (BOOL)shouldProcessNamespaces
+{
+    return YES;
+}
+
+- (void)setShouldProcessNamespaces:(BOOL)shouldProcessNamespaces
+{
+    // namespaces are always processed
+}
+
+- (BOOL)parse
+{
+    __block BOOL parsing = YES;
+    [self.data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        for (NSUInteger offset = 0; parsing && offset < byteRange.length; offset += PARSE_CHUNK_SIZE) {
+            parsing = [self parseBytes:(const char *)bytes + offset length:MIN(PARSE_CHUNK_SIZE, byteRange.length - offset) terminate:NO];
+        }
+        *stop = !parsing;
+    }];
+    
+    return parsing && [self finishParsing];
+}
+
+- (void)abortParsing
+{
+    self.aborted = YES;
+    if (_context != NULL) {
+        xmlStopParser(_context);
+    }
+}
+
+- (NSError *)parserError
+{
+    return self.error;
+}
+
+- (NSInteger)lineNumber
+{
+    return (_context != NULL ? xmlSAX2GetLineNumber(_context) : 0);
+}
+
+- (NSInteger)columnNumber
+{
+    return (_context != NULL ? xmlSAX2GetColumnNumber(_context) : 0);
+}
+
+#pragma mark Incremental parsing
+
+- (BOOL)appendData:(NSData *)data
+{
+    __block BOOL parsing = YES;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        parsing = [self parseBytes:bytes length:byteRange.length terminate:NO];
+        *stop = !parsing;
+    }];
+    
+    return parsing;
+}
+
+- (BOOL)finishParsing
+{
+    return [self parseBytes:NULL length:0 terminate:YES];
+}
+
+#pragma mark Current element
+
+- (NSString *)text
+{
+    if (_text == nil) {
+        _text = (_textLength > 0 ? [[NSString alloc] initWithBytes:_textBuffer length:_textLength encoding:NSUTF8StringEncoding] : @"");
+    }
+    return _text;
+}
+
+- (NSString *)elementName
+{
+    return (_localName != NULL ? [NSString stringWithUTF8String:(const char *)_localName] : nil);
+}
+
+- (NSString *)namespaceURI
+{
+    return (_namespaceURI != NULL ? [NSString stringWithUTF8String:(const char *)_namespaceURI] : nil);
+}
+
+- (NSDictionary *)attributes
+{
+    if (!_startingElement) {
+        return nil;
+    }
+    
+    NSMutableDictionary *attributes = [NSMutableDictionary dictionaryWithCapacity:_attributeCount];
+    for (int i = 0; i < _attributeCount; i++) {
+        // libxml2 hands over localname, prefix, URI, value and end of value for each attribute
+        const xmlChar **attribute = _attributeValues + i * 5;
+        NSString *value = [[NSString alloc] initWithBytes:attribute[3] length:attribute[4] - attribute[3] encoding:NSUTF8StringEncoding];
+        [attributes setObject:value forKey:[self qualifiedNameForLocalName:attribute[0] prefix:attribute[1]]];
+    }
+    return attributes;
+}
+
+- (NSString *)valueForAttribute:(CMISXMLName)name
+{
+    for (int i = 0; i < _attributeCount; i++) {
+        const xmlChar **attribute = _attributeValues + i * 5;
+        if (attribute[1] == NULL && [self tokenForName:attribute[0]] == name) {
+            return [[NSString alloc] initWithBytes:attribute[3] length:attribute[4] - attribute[3] encoding:NSUTF8StringEncoding];
+        }
+    }
+    return nil;
+}
+
+#pragma mark SAX2 events
+
+- (void)startDocument
+{
+    id<NSXMLParserDelegate> delegate = self.parserDelegate;
+    if ([delegate respondsToSelector:@selector(parserDidStartDocument:)]) {
+        [delegate parserDidStartDocument:self];
+    }
+}
+
+- (void)endDocument
+{
+    id<NSXMLParserDelegate> delegate = self.parserDelegate;
+    if ([delegate respondsToSelector:@selector(parserDidEndDocument:)]) {
+        [delegate parserDidEndDocument:self];
+    }
+}
+
+- (void)startElement:(const xmlChar *)localName prefix:(const xmlChar *)prefix namespaceURI:(const xmlChar *)namespaceURI
+      attributeCount:(int)attributeCount attributes:(const xmlChar **)attributes
+{
+    [self clearText];
+    _localName = localName;
+    _prefix = prefix;
+    _namespaceURI = namespaceURI;
+    _attributeValues = attributes;
+    _attributeCount = attributeCount;
+    _startingElement = YES;
+    
+    id<NSXMLParserDelegate> delegate = self.parserDelegate;
+    if (_tokenDelegate) {
+        [(id<CMISXMLParserDelegate>)delegate parser:self didStartElement:[self tokenForName:localName] inNamespace:[self tokenForNamespace:namespaceURI]];
+    } else if (_delegateStartsElements) {
+        [delegate parser:self didStartElement:self.elementName namespaceURI:self.namespaceURI
+           qualifiedName:[self qualifiedNameForLocalName:localName prefix:prefix] attributes:self.attributes];
+    }
+    
+    // the attributes are only valid while the element starts
+    _startingElement = NO;
+    _attributeValues = NULL;
+    _attributeCount = 0;
+}
+
+- (void)endElement:(const xmlChar *)localName prefix:(const xmlChar *)prefix namespaceURI:(const xmlChar *)namespaceURI
+{
+    _localName = localName;
+    _prefix = prefix;
+    _namespaceURI = namespaceURI;
+    
+    id<NSXMLParserDelegate> delegate = self.parserDelegate;
+    if (_tokenDelegate) {
+        [(id<CMISXMLParserDelegate>)delegate parser:self didEndElement:[self tokenForName:localName] inNamespace:[self tokenForNamespace:namespaceURI]];
+    } else if (_delegateEndsElements) {
+        [delegate parser:self didEndElement:self.elementName namespaceURI:self.namespaceURI
+           qualifiedName:[self qualifiedNameForLocalName:localName prefix:prefix]];
+    }
+    
+    [self clearText];
+}
+
+- (void)foundCharacters:(const xmlChar *)characters length:(int)length
+{
+    if (_textLength + length > _textCapacity) {
+        NSUInteger capacity = MAX(MAX(_textCapacity * 2, _textLength + length), TEXT_BUFFER_CAPACITY);
+        char *textBuffer = realloc(_textBuffer, capacity);
+        if (textBuffer == NULL) {
+            [self abortParsing];
+            return;
+        }
+        _textBuffer = textBuffer;
+        _textCapacity = capacity;
+    }
+    memcpy(_textBuffer + _textLength, characters, length);
+    _textLength += length;
+    _text = nil;
+    
+    if (!_tokenDelegate && _delegateFindsCharacters) {
+        NSString *string = [[NSString alloc] initWithBytes:characters length:length encoding:NSUTF8StringEncoding];
+        [self.parserDelegate parser:self foundCharacters:string];
+    }
+}
+
+#pragma mark -
+#pragma mark Private helper methods
+
+- (BOOL)createContext
+{
+    xmlSAXHandler handler;
+    memset(&handler, 0, sizeof(handler));
+    handler.initialized = XML_SAX2_MAGIC;
+    handler.startDocument = CMISXMLStartDocument;
+    handler.endDocument = CMISXMLEndDocument;
+    handler.startElementNs = CMISXMLStartElement;
+    handler.endElementNs = CMISXMLEndElement;
+    handler.characters = CMISXMLCharacters;
+    handler.ignorableWhitespace = CMISXMLCharacters;
+    handler.cdataBlock = CMISXMLCharacters;
+    handler.getEntity = CMISXMLGetEntity;
+    handler.warning = CMISXMLIgnoreMessage;
+    handler.error = CMISXMLIgnoreMessage;
+    handler.fatalError = CMISXMLIgnoreMessage;
+    
+    _context = xmlCreatePushParserCtxt(&handler, (__bridge void *)self, NULL, 0, NULL);
+    if (_context == NULL) {
+        return NO;
+    }
+    xmlCtxtUseOptions(_context, XML_PARSE_NOENT | XML_PARSE_NONET);
+    
+    // the caches refer to the string dictionary of the context
+    memset(&_nameCache, 0, sizeof(_nameCache));
+    memset(&_namespaceCache, 0, sizeof(_namespaceCache));
+    return YES;
+}
+
+- (void)freeContext
+{
+    if (_context != NULL) {
+        xmlFreeParserCtxt(_context);
+        _context = NULL;
+    }
+}
+
+- (BOOL)parseBytes:(const char *)bytes length:(NSUInteger)length terminate:(BOOL)terminate
+{
+    if (self.error != nil || self.finished) {
+        return NO;
+    }
+    
+    if (_context == NULL && ![self createContext]) {
+        self.error = [NSError errorWithDomain:NSXMLParserErrorDomain code:NSXMLParserInternalError userInfo:nil];
+        return NO;
+    }
+    
+    if (!self.aborted) {
+        xmlParseChunk(_context, bytes, (int)length, terminate ? 1 : 0);
+    }
+    
+    if (self.aborted || !_context->wellFormed) {
+        [self failParsing];
+        return NO;
+    }
+    
+    if (terminate) {
+        self.finished = YES;
+        [self freeContext];
+    }
+    return YES;
+}
+
+- (void)failParsing
+{
+    if (self.aborted) {
+        self.error = [NSError errorWithDomain:NSXMLParserErrorDomain code:NSXMLParserDelegateAbortedParseError userInfo:nil];
+    } else {
+        // the libxml2 error codes are the NSXMLParserError codes
+        const xmlError *lastError = xmlCtxtGetLastError(_context);
+        NSInteger code = (lastError != NULL ? lastError->code : NSXMLParserInternalError);
+        NSDictionary *userInfo = nil;
+        if (lastError != NULL && lastError->message != NULL) {
+            NSString *message = [[NSString stringWithUTF8String:lastError->message] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+            userInfo = @{NSLocalizedDescriptionKey: message};
+        }
+        self.error = [NSError errorWithDomain:NSXMLParserErrorDomain code:code userInfo:userInfo];
+    }
+    [self freeContext];
+    
+    id<NSXMLParserDelegate> delegate = self.parserDelegate;
+    if ([delegate respondsToSelector:@selector(parser:parseErrorOccurred:)]) {
+        [delegate parser:self parseErrorOccurred:self.error];
+    }
+}
+
+- (void)clearText
+{
+    _textLength = 0;
+    _text = nil;
+}
+
+- (CMISXMLName)tokenForName:(const xmlChar *)name
+{
+    return CMISXMLTokenForString(&_nameCache, name, _context->dict, CMISXMLNameTokens);
+}
+
+- (CMISXMLNamespace)tokenForNamespace:(const xmlChar *)namespaceURI
+{
+    return CMISXMLTokenForString(&_namespaceCache, namespaceURI, _context->dict, CMISXMLNamespaceTokens);
+}
+
+- (NSString *)qualifiedNameForLocalName:(const xmlChar *)localName prefix:(const xmlChar *)prefix
+{
+    NSString *name = [NSString stringWithUTF8String:(const char *)localName];
+    if (prefix != NULL) {
+        return [NSString stringWithFormat:@"%@:%@", [NSString stringWithUTF8String:(const char *)prefix], name];
+    }
+    return name;
+}
+
+@end
@@ -138,11 +138,17 @@
                                                //        CMISLogDebug(@"Service document: %@", dataString);
                                                
                                                // Parse the cmis service document
-                                               if (data) {
+                                               id parsedResult = httpResponse.parsedResult;
+                                               if ([parsedResult isKindOfClass:[NSArray class]]) {
+                                                   // service document not modified since it was parsed
+                                                   [self.bindingSession setObject:parsedResult forKey:kCMISSessionKeyWorkspaces];
+                                                   completionBlock(parsedResult, nil);
+                                               } else if (data) {
                                                    CMISAtomPubServiceDocumentParser *parser = [[CMISAtomPubServiceDocumentParser alloc] initWithData:data];
                                                    NSError *error = nil;
                                                    if ([parser parseAndReturnError:&error]) {
                                                        [self.bindingSession setObject:parser.workspaces forKey:kCMISSessionKeyWorkspaces];
+                                                       httpResponse.parsedResult = parser.workspaces;
                                                    } else {
                                                        CMISLogError(@"Error while parsing service document: %@", error.description);
                                                    }
@@ -152,6 +158,11 @@
                                                completionBlock(nil, error);
                                            }
                                        }];
+        
+        // open the other connections to the service while the service document is retrieved
+        if ([self.bindingSession.networkProvider respondsToSelector:@selector(warmUpConnectionsForSession:)]) {
+            [self.bindingSession.networkProvider warmUpConnectionsForSession:self.bindingSession];
+        }
     }
 }
 
@@ -206,10 +217,18 @@
                     if (httpResponse.statusCode == 200 && httpResponse.data) {
                         CMISObjectData *objectData = nil;
                         NSError *error = nil;
-                        CMISAtomEntryParser *parser = [[CMISAtomEntryParser alloc] initWithData:httpResponse.data];
-                        if ([parser parseAndReturnError:&error]) {
-                            objectData = parser.objectData;
-                            
+                        id parsedResult = httpResponse.parsedResult;
+                        if ([parsedResult isKindOfClass:[CMISObjectData class]]) {
+                            objectData = parsedResult; // not modified since it was parsed
+                        } else {
+                            CMISAtomEntryParser *parser = [[CMISAtomEntryParser alloc] initWithData:httpResponse.data];
+                            if ([parser parseAndReturnError:&error]) {
+                                objectData = parser.objectData;
+                                httpResponse.parsedResult = objectData;
+                            }
+                        }
+                        
+                        if (objectData) {
                             // Add links to link cache
                             CMISLinkCache *linkCache = [self linkCache];
                             [linkCache addLinks:objectData.linkRelations objectId:objectData.identifier];
@@ -254,10 +273,18 @@
                     if (httpResponse.statusCode == 200 && httpResponse.data != nil) {
                         CMISObjectData *objectData = nil;
                         NSError *error = nil;
-                        CMISAtomEntryParser *parser = [[CMISAtomEntryParser alloc] initWithData:httpResponse.data];
-                        if ([parser parseAndReturnError:&error]) {
-                            objectData = parser.objectData;
-                            
+                        id parsedResult = httpResponse.parsedResult;
+                        if ([parsedResult isKindOfClass:[CMISObjectData class]]) {
+                            objectData = parsedResult; // not modified since it was parsed
+                        } else {
+                            CMISAtomEntryParser *parser = [[CMISAtomEntryParser alloc] initWithData:httpResponse.data];
+                            if ([parser parseAndReturnError:&error]) {
+                                objectData = parser.objectData;
+                                httpResponse.parsedResult = objectData;
+                            }
+                        }
+                        
+                        if (objectData) {
                             // Add links to link cache
                             CMISLinkCache *linkCache = [self linkCache];
                             [linkCache addLinks:objectData.linkRelations objectId:objectData.identifier];
@@ -413,18 +440,11 @@
     writer.cmisProperties = properties;
     writer.mimeType = contentMimeType;
     
-    NSString *xmlStart = [writer xmlStartElement];
-    NSString *xmlContentStart = [writer xmlContentStartElement];
-    NSString *start = [NSString stringWithFormat:@"%@%@", xmlStart, xmlContentStart];
-    NSData *startData = [NSMutableData dataWithData:[start dataUsingEncoding:NSUTF8StringEncoding]];
-    
-    NSString *xmlContentEnd = [writer xmlContentEndElement];
-    NSString *xmlProperties = [writer xmlPropertiesElements];
-    NSString *end = [NSString stringWithFormat:@"%@%@", xmlContentEnd, xmlProperties];
-    NSData *endData = [end dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *startData = [writer entryStartData];
+    NSData *endData = [writer entryEndData];
     
     // The underlying CMISHttpUploadRequest object generates the atom entry. The base64 encoded content is generated on
-    // the fly to support very large files.
+    // the fly to support very large files, no temporary file is written and the entry length is known up front.
     [self.bindingSession.networkProvider invoke:[NSURL URLWithString:link]
                                      httpMethod:httpRequestMethod
                                         session:self.bindingSession
@@ -25,6 +25,7 @@
 #import "CMISAtomPubVersioningService.h"
 #import "CMISAtomPubDiscoveryService.h"
 #import "CMISAtomPubAclService.h"
+#import "CMISURLSessionPool.h"
 
 @interface CMISAtomPubBinding ()
 
@@ -76,6 +77,7 @@
 - (void)close
 {
     [self clearAllCaches];
+    [[CMISURLSessionPool sharedPool] releaseSessionsForBindingSession:self.session];
 }
 
 @end
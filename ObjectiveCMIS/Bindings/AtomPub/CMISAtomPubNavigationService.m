@@ -40,29 +40,23 @@
                 maxItems:(NSNumber *)maxItems
          completionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock
 {
-    // Get Down link
     CMISRequest *request = [[CMISRequest alloc] init];
-    [self loadLinkForObjectId:objectId
-                     relation:kCMISLinkRelationDown
-                         type:kCMISMediaTypeChildren
-                  cmisRequest:request
-              completionBlock:^(NSString *downLink, NSError *error) {
+    [self loadChildrenLinkForObjectId:objectId
+                              orderBy:orderBy
+                               filter:filter
+                        relationships:relationships
+                      renditionFilter:renditionFilter
+              includeAllowableActions:includeAllowableActions
+                   includePathSegment:includePathSegment
+                            skipCount:skipCount
+                             maxItems:maxItems
+                          cmisRequest:request
+                      completionBlock:^(NSString *downLink, NSError *error) {
                           if (error) {
-                              CMISLogError(@"Could not retrieve down link: %@", error.description);
                               completionBlock(nil, error);
                               return;
                           }
                           
-                          // Add optional params (CMISUrlUtil will not append if the param name or value is nil)
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterFilter value:filter urlString:downLink];
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterOrderBy value:orderBy urlString:downLink];
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeAllowableActions value:(includeAllowableActions ? @"true" : @"false") urlString:downLink];
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeRelationships value:[CMISEnums stringForIncludeRelationShip:relationships] urlString:downLink];
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterRenditionFilter value:renditionFilter urlString:downLink];
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludePathSegment value:(includePathSegment ? @"true" : @"false") urlString:downLink];
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterMaxItems value:[maxItems stringValue] urlString:downLink];
-                          downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterSkipCount value:[skipCount stringValue] urlString:downLink];
-                          
                           // execute the request
                           [self.bindingSession.networkProvider invokeGET:[NSURL URLWithString:downLink]
                                                                  session:self.bindingSession
@@ -80,13 +74,7 @@
                                       CMISAtomFeedParser *parser = [[CMISAtomFeedParser alloc] initWithData:httpResponse.data];
                                       NSError *internalError = nil;
                                       if ([parser parseAndReturnError:&internalError]) {
-                                          NSString *nextLink = [parser.linkRelations linkHrefForRel:kCMISLinkRelationNext];
-                                          
-                                          CMISObjectList *objectList = [[CMISObjectList alloc] init];
-                                          objectList.hasMoreItems = (nextLink != nil);
-                                          objectList.numItems = parser.numItems;
-                                          objectList.objects = parser.entries;
-                                          completionBlock(objectList, nil);
+                                          completionBlock([self objectListFromFeedParser:parser], nil);
                                       } else {
                                           NSError *error = [CMISErrors cmisError:internalError cmisErrorCode:kCMISErrorCodeRuntime];
                                           completionBlock(nil, error);
@@ -99,6 +87,82 @@
     return request;
 }
 
+- (CMISRequest*)retrieveChildren:(NSString *)objectId
+                 orderBy:(NSString *)orderBy
+                  filter:(NSString *)filter
+           relationships:(CMISIncludeRelationship)relationships
+         renditionFilter:(NSString *)renditionFilter
+ includeAllowableActions:(BOOL)includeAllowableActions
+      includePathSegment:(BOOL)includePathSegment
+               skipCount:(NSNumber *)skipCount
+                maxItems:(NSNumber *)maxItems
+              entryBlock:(void (^)(CMISObjectData *objectData))entryBlock
+         completionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock
+{
+    // without a network provider that can stream the response, the children are handed over once the whole feed is parsed
+    if (![self.bindingSession.networkProvider respondsToSelector:@selector(invokeGET:session:cmisRequest:dataBlock:completionBlock:)]) {
+        return [self retrieveChildren:objectId
+                              orderBy:orderBy
+                               filter:filter
+                        relationships:relationships
+                      renditionFilter:renditionFilter
+              includeAllowableActions:includeAllowableActions
+                   includePathSegment:includePathSegment
+                            skipCount:skipCount
+                             maxItems:maxItems
+                      completionBlock:^(CMISObjectList *objectList, NSError *error) {
+                          for (CMISObjectData *objectData in objectList.objects) {
+                              entryBlock(objectData);
+                          }
+                          objectList.objects = @[];
+                          completionBlock(objectList, error);
+                      }];
+    }
+    
+    CMISRequest *request = [[CMISRequest alloc] init];
+    [self loadChildrenLinkForObjectId:objectId
+                              orderBy:orderBy
+                               filter:filter
+                        relationships:relationships
+                      renditionFilter:renditionFilter
+              includeAllowableActions:includeAllowableActions
+                   includePathSegment:includePathSegment
+                            skipCount:skipCount
+                             maxItems:maxItems
+                          cmisRequest:request
+                      completionBlock:^(NSString *downLink, NSError *error) {
+                          if (error) {
+                              completionBlock(nil, error);
+                              return;
+                          }
+                          
+                          // the feed is parsed while it is received, the entries are handed over as soon as they are complete
+                          CMISAtomFeedParser *parser = [[CMISAtomFeedParser alloc] initWithEntryBlock:entryBlock];
+                          [self.bindingSession.networkProvider invokeGET:[NSURL URLWithString:downLink]
+                                                                 session:self.bindingSession
+                                                             cmisRequest:request
+                                                               dataBlock:^(NSData *data) {
+                                                                   [parser appendData:data];
+                                                               }
+                                                         completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                                  if (httpResponse == nil) {
+                                      [parser cancel];
+                                      completionBlock(nil, error);
+                                      return;
+                                  }
+                                  
+                                  [parser finishWithCompletionBlock:^(NSError *parseError) {
+                                      if (parseError) {
+                                          completionBlock(nil, [CMISErrors cmisError:parseError cmisErrorCode:kCMISErrorCodeRuntime]);
+                                      } else {
+                                          completionBlock([self objectListFromFeedParser:parser], nil);
+                                      }
+                                  }];
+                              }];
+                      }];
+    return request;
+}
+
 - (CMISRequest*)retrieveParentsForObject:(NSString *)objectId
                           filter:(NSString *)filter
                    relationships:(CMISIncludeRelationship)relationships
@@ -219,4 +283,56 @@
     return request;
 }
 
+#pragma mark -
+#pragma mark Private helper methods
+
+/// loads the down link of the object and adds the parameters of the children request to it
+- (void)loadChildrenLinkForObjectId:(NSString *)objectId
+                            orderBy:(NSString *)orderBy
+                             filter:(NSString *)filter
+                      relationships:(CMISIncludeRelationship)relationships
+                    renditionFilter:(NSString *)renditionFilter
+            includeAllowableActions:(BOOL)includeAllowableActions
+                 includePathSegment:(BOOL)includePathSegment
+                          skipCount:(NSNumber *)skipCount
+                           maxItems:(NSNumber *)maxItems
+                        cmisRequest:(CMISRequest *)request
+                    completionBlock:(void (^)(NSString *downLink, NSError *error))completionBlock
+{
+    // Get Down link
+    [self loadLinkForObjectId:objectId
+                     relation:kCMISLinkRelationDown
+                         type:kCMISMediaTypeChildren
+                  cmisRequest:request
+              completionBlock:^(NSString *downLink, NSError *error) {
+                  if (error) {
+                      CMISLogError(@"Could not retrieve down link: %@", error.description);
+                      completionBlock(nil, error);
+                      return;
+                  }
+                  
+                  // Add optional params (CMISUrlUtil will not append if the param name or value is nil)
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterFilter value:filter urlString:downLink];
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterOrderBy value:orderBy urlString:downLink];
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeAllowableActions value:(includeAllowableActions ? @"true" : @"false") urlString:downLink];
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeRelationships value:[CMISEnums stringForIncludeRelationShip:relationships] urlString:downLink];
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterRenditionFilter value:renditionFilter urlString:downLink];
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludePathSegment value:(includePathSegment ? @"true" : @"false") urlString:downLink];
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterMaxItems value:[maxItems stringValue] urlString:downLink];
+                  downLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterSkipCount value:[skipCount stringValue] urlString:downLink];
+                  completionBlock(downLink, nil);
+              }];
+}
+
+- (CMISObjectList *)objectListFromFeedParser:(CMISAtomFeedParser *)parser
+{
+    NSString *nextLink = [parser.linkRelations linkHrefForRel:kCMISLinkRelationNext];
+    
+    CMISObjectList *objectList = [[CMISObjectList alloc] init];
+    objectList.hasMoreItems = (nextLink != nil);
+    objectList.numItems = parser.numItems;
+    objectList.objects = (parser.entries ? parser.entries : @[]);
+    return objectList;
+}
+
 @end
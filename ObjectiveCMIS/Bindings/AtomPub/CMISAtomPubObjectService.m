@@ -309,90 +309,38 @@
                       completionBlock:(void (^)(NSError *error))completionBlock
                         progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock
 {
-    CMISRequest *request = [[CMISRequest alloc] init];
-    // Validate object id param
-    if (objectIdParam == nil || objectIdParam.inParameter == nil) {
-        CMISLogError(@"Object id is nil or inParameter of objectId is nil");
-        if (completionBlock) {
-            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument detailedDescription:@"Must provide object id"]);
-        }
-        return nil;
-    }
-    
-    if (inputStream == nil) {
-        CMISLogError(@"Invalid input stream");
-        if (completionBlock) {
-            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument detailedDescription:@"Invalid input stream"]);
-        }
-        return nil;
-    }
-    
-    if (nil == mimeType)
-    {
-        mimeType = kCMISMediaTypeOctetStream;
-    }
-    
-    // Atompub DOES NOT SUPPORT returning the new object id and change token
-    // See http://docs.oasis-open.org/cmis/CMIS/v1.0/cs01/cmis-spec-v1.0.html#_Toc243905498
-    objectIdParam.outParameter = nil;
-    changeTokenParam.outParameter = nil;
-    
-    // Get edit media link
-    [self loadLinkForObjectId:objectIdParam.inParameter
-                     relation:kCMISLinkEditMedia
-                  cmisRequest:request
-              completionBlock:^(NSString *editMediaLink, NSError *error) {
-        if (editMediaLink == nil){
-            CMISLogError(@"Could not retrieve %@ link for object '%@'", kCMISLinkEditMedia, objectIdParam.inParameter);
-            if (completionBlock) {
-                completionBlock([CMISErrors cmisError:error cmisErrorCode:kCMISErrorCodeObjectNotFound]);
-            }
-            return;
-        }
-        
-        // Append optional change token parameters
-        if (changeTokenParam != nil && changeTokenParam.inParameter != nil) {
-            editMediaLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterChangeToken
-                                                             value:changeTokenParam.inParameter urlString:editMediaLink];
-        }
-        
-        // Append overwrite flag
-        editMediaLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterOverwriteFlag
-                                                         value:(overwrite ? @"true" : @"false") urlString:editMediaLink];
-        
-        
-        // Execute HTTP call on edit media link, passing the a stream to the file
-        NSArray *values =  @[[NSString stringWithFormat:kCMISHTTPHeaderContentDispositionAttachment, filename], mimeType];
-        NSArray *keys = @[kCMISHTTPHeaderContentDisposition, kCMISHTTPHeaderContentType];
-        
-        NSDictionary *headers = [NSDictionary dictionaryWithObjects:values forKeys:keys];
-                  
-        [self.bindingSession.networkProvider invoke:[NSURL URLWithString:editMediaLink]
-                                         httpMethod:HTTP_PUT
-                                            session:self.bindingSession
-                                        inputStream:inputStream
-                                            headers:headers
-                                      bytesExpected:bytesExpected
-                                        cmisRequest:request
-                                    completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
-             // Check response status
-             if (httpResponse) {
-                 if (httpResponse.statusCode == 200 || httpResponse.statusCode == 201 || httpResponse.statusCode == 204) {
-                     error = nil;
-                 } else {
-                     CMISLogError(@"Invalid http response status code when updating content: %d", (int)httpResponse.statusCode);
-                     error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeRuntime
-                                             detailedDescription:[NSString stringWithFormat:@"Could not update content: http status code %li", (long)httpResponse.statusCode]];
-                 }
-             }
-             if (completionBlock) {
-                 completionBlock(error);
-             }
-         }
-           progressBlock:progressBlock];
-    }];
-    
-    return request;
+    return [self putContentOfObject:objectIdParam
+                    fromInputStream:inputStream
+                      bytesExpected:bytesExpected
+                           filename:filename
+                           mimeType:mimeType
+                         parameters:@{kCMISParameterOverwriteFlag : (overwrite ? kCMISParameterValueTrue : kCMISParameterValueFalse)}
+                        changeToken:changeTokenParam
+                    completionBlock:completionBlock
+                      progressBlock:progressBlock];
+}
+
+- (CMISRequest*)appendContentOfObject:(CMISStringInOutParameter *)objectIdParam
+                      fromInputStream:(NSInputStream *)inputStream
+                        bytesExpected:(unsigned long long)bytesExpected
+                             filename:(NSString *)filename
+                             mimeType:(NSString *)mimeType
+                          isLastChunk:(BOOL)isLastChunk
+                          changeToken:(CMISStringInOutParameter *)changeTokenParam
+                      completionBlock:(void (^)(NSError *error))completionBlock
+                        progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock
+{
+    // CMIS 1.1: the content is appended by a PUT on the edit media link with the append flag set
+    return [self putContentOfObject:objectIdParam
+                    fromInputStream:inputStream
+                      bytesExpected:bytesExpected
+                           filename:filename
+                           mimeType:mimeType
+                         parameters:@{kCMISParameterAppend : kCMISParameterValueTrue,
+                                      kCMISParameterIsLastChunk : (isLastChunk ? kCMISParameterValueTrue : kCMISParameterValueFalse)}
+                        changeToken:changeTokenParam
+                    completionBlock:completionBlock
+                      progressBlock:progressBlock];
 }
 
 
@@ -789,4 +737,107 @@
     return cmisRequest;
 }
 
+#pragma mark -
+#pragma mark Private helper methods
+
+/// sends the content with a PUT on the edit media link of the object, adding the given parameters to the link
+- (CMISRequest*)putContentOfObject:(CMISStringInOutParameter *)objectIdParam
+                   fromInputStream:(NSInputStream *)inputStream
+                     bytesExpected:(unsigned long long)bytesExpected
+                          filename:(NSString*)filename
+                          mimeType:(NSString *)mimeType
+                        parameters:(NSDictionary *)parameters
+                       changeToken:(CMISStringInOutParameter *)changeTokenParam
+                   completionBlock:(void (^)(NSError *error))completionBlock
+                     progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock
+{
+    CMISRequest *request = [[CMISRequest alloc] init];
+    // Validate object id param
+    if (objectIdParam == nil || objectIdParam.inParameter == nil) {
+        CMISLogError(@"Object id is nil or inParameter of objectId is nil");
+        if (completionBlock) {
+            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument detailedDescription:@"Must provide object id"]);
+        }
+        return nil;
+    }
+    
+    if (inputStream == nil) {
+        CMISLogError(@"Invalid input stream");
+        if (completionBlock) {
+            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument detailedDescription:@"Invalid input stream"]);
+        }
+        return nil;
+    }
+    
+    if (nil == mimeType)
+    {
+        mimeType = kCMISMediaTypeOctetStream;
+    }
+    
+    // Atompub DOES NOT SUPPORT returning the new object id and change token
+    // See http://docs.oasis-open.org/cmis/CMIS/v1.0/cs01/cmis-spec-v1.0.html#_Toc243905498
+    objectIdParam.outParameter = nil;
+    changeTokenParam.outParameter = nil;
+    
+    // Get edit media link
+    [self loadLinkForObjectId:objectIdParam.inParameter
+                     relation:kCMISLinkEditMedia
+                  cmisRequest:request
+              completionBlock:^(NSString *editMediaLink, NSError *error) {
+        if (editMediaLink == nil){
+            CMISLogError(@"Could not retrieve %@ link for object '%@'", kCMISLinkEditMedia, objectIdParam.inParameter);
+            if (completionBlock) {
+                completionBlock([CMISErrors cmisError:error cmisErrorCode:kCMISErrorCodeObjectNotFound]);
+            }
+            return;
+        }
+        
+        // Append optional change token parameters
+        if (changeTokenParam != nil && changeTokenParam.inParameter != nil) {
+            editMediaLink = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterChangeToken
+                                                             value:changeTokenParam.inParameter urlString:editMediaLink];
+        }
+        
+        // Append overwrite or append flags
+        for (NSString *parameter in parameters) {
+            editMediaLink = [CMISURLUtil urlStringByAppendingParameter:parameter
+                                                             value:parameters[parameter] urlString:editMediaLink];
+        }
+        
+        
+        // Execute HTTP call on edit media link, passing the a stream to the file
+        NSArray *values =  @[[NSString stringWithFormat:kCMISHTTPHeaderContentDispositionAttachment, filename], mimeType];
+        NSArray *keys = @[kCMISHTTPHeaderContentDisposition, kCMISHTTPHeaderContentType];
+        
+        NSDictionary *headers = [NSDictionary dictionaryWithObjects:values forKeys:keys];
+                  
+        [self.bindingSession.networkProvider invoke:[NSURL URLWithString:editMediaLink]
+                                         httpMethod:HTTP_PUT
+                                            session:self.bindingSession
+                                        inputStream:inputStream
+                                            headers:headers
+                                      bytesExpected:bytesExpected
+                                        cmisRequest:request
+                                    completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+             // Check response status
+             if (httpResponse) {
+                 if (httpResponse.statusCode == 200 || httpResponse.statusCode == 201 || httpResponse.statusCode == 204) {
+                     error = nil;
+                 } else {
+                     CMISLogError(@"Invalid http response status code when updating content: %d", (int)httpResponse.statusCode);
+                     error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeRuntime
+                                             detailedDescription:[NSString stringWithFormat:@"Could not update content: http status code %li", (long)httpResponse.statusCode]];
+                 }
+             }
+             if (completionBlock) {
+                 completionBlock(error);
+             }
+         }
+           progressBlock:progressBlock];
+    }];
+    
+    return request;
+}
+
+
 @end
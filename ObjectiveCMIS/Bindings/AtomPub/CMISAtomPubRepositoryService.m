@@ -25,6 +25,7 @@
 #import "CMISAtomPubTypeByIdUriBuilder.h"
 #import "CMISHttpResponse.h"
 #import "CMISTypeDefinitionAtomEntryParser.h"
+#import "CMISTypeDefinition.h"
 #import "CMISLog.h"
 
 @interface CMISAtomPubRepositoryService ()
@@ -97,10 +98,14 @@
                                            cmisRequest:request
                                        completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
             if (httpResponse) {
-                if (httpResponse.data != nil) {
+                id parsedResult = httpResponse.parsedResult;
+                if ([parsedResult isKindOfClass:[CMISTypeDefinition class]]) {
+                    completionBlock(parsedResult, nil); // not modified since it was parsed
+                } else if (httpResponse.data != nil) {
                     CMISTypeDefinitionAtomEntryParser *parser = [[CMISTypeDefinitionAtomEntryParser alloc] initWithData:httpResponse.data];
                     NSError *error;
                     if ([parser parseAndReturnError:&error]) {
+                        httpResponse.parsedResult = parser.typeDefinition;
                         completionBlock(parser.typeDefinition, nil);
                     } else {
                         completionBlock(nil, error);
@@ -20,7 +20,7 @@
 #import <Foundation/Foundation.h>
 
 
-@interface CMISAtomCollection : NSObject
+@interface CMISAtomCollection : NSObject <NSCopying>
 
 @property (nonatomic, strong) NSString *href;
 @property (nonatomic, strong) NSString *title;
@@ -22,5 +22,14 @@
 
 @implementation CMISAtomCollection
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISAtomCollection *collection = [[[self class] allocWithZone:zone] init];
+    collection.href = self.href;
+    collection.title = self.title;
+    collection.accept = self.accept;
+    collection.type = self.type;
+    return collection;
+}
 
 @end
\ No newline at end of file
@@ -23,7 +23,7 @@
 @class CMISSessionParameters;
 @class CMISLinkRelations;
 
-@interface CMISAtomWorkspace : NSObject
+@interface CMISAtomWorkspace : NSObject <NSCopying>
 
 @property (nonatomic, strong) CMISSessionParameters *sessionParameters;
 @property (nonatomic, strong) CMISRepositoryInfo *repositoryInfo;
@@ -19,9 +19,31 @@
 
 #import "CMISAtomWorkspace.h"
 #import "CMISAtomCollection.h"
+#import "CMISRepositoryInfo.h"
 
 @implementation CMISAtomWorkspace
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISAtomWorkspace *workspace = [[[self class] allocWithZone:zone] init];
+    workspace.sessionParameters = self.sessionParameters;
+    workspace.repositoryInfo = [self.repositoryInfo copy];
+    workspace.linkRelations = self.linkRelations;
+    workspace.objectByIdUriTemplate = self.objectByIdUriTemplate;
+    workspace.objectByPathUriTemplate = self.objectByPathUriTemplate;
+    workspace.typeByIdUriTemplate = self.typeByIdUriTemplate;
+    workspace.queryUriTemplate = self.queryUriTemplate;
+    
+    if (self.collections) {
+        NSMutableArray *collections = [NSMutableArray arrayWithCapacity:self.collections.count];
+        for (CMISAtomCollection *collection in self.collections) {
+            [collections addObject:[collection copy]];
+        }
+        workspace.collections = collections;
+    }
+    
+    return workspace;
+}
 
 - (NSString *)collectionHrefForCollectionType:(NSString *)collectionType
 {
@@ -21,6 +21,7 @@
 
 @class CMISProperties;
 @class CMISAcl;
+@class CMISMultipartFormDataStream;
 
 @interface CMISBroswerFormDataWriter : NSObject
 
@@ -55,4 +56,10 @@
 /// call this method to get the end of the http request body form data if a content stream is set
 - (NSData *)endData;
 
+/**
+ * call this method to get the complete http request body form data as a stream if a content stream is set.
+ * The parts are generated while the body is read, contentLength is the length of the content stream or -1 if it is not known.
+ */
+- (CMISMultipartFormDataStream *)bodyStreamWithContentLength:(long long)contentLength;
+
 @end
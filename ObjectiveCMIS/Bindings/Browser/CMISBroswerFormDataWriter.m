@@ -27,6 +27,7 @@
 #import "CMISAcl.h"
 #import "CMISAce.h"
 #import "CMISProperties.h"
+#import "CMISMultipartFormDataStream.h"
 
 NSString * const kCMISFormDataContentTypeUrlEncoded = @"application/x-www-form-urlencoded;charset=utf-8";
 NSString * const kCMISFormDataContentTypeFormData = @"multipart/form-data; boundary=";
@@ -185,22 +186,19 @@ NSString * const kCMISFormDataContentTypeFormData = @"multipart/form-data; bound
 - (NSData *)body
 {
     if (self.contentStream == nil) {
-        BOOL first = YES;
-        NSData *amp = [@"&" dataUsingEncoding:NSUTF8StringEncoding];
-        NSMutableData *data = [[NSMutableData alloc] init];
+        // keys and url encoded values are ASCII, so the body is built as a single string
+        NSMutableString *body = [[NSMutableString alloc] init];
         
         for (NSString *parameterKey in self.parameters) {
-            if (first) {
-                first = NO;
-            } else {
-                [data appendData:amp];
+            if (body.length > 0) {
+                [body appendString:@"&"];
             }
-            NSString *encodedParameterValue = [CMISURLUtil encodeUrlParameterValue:self.parameters[parameterKey]];
-            NSString *parameter = [NSString stringWithFormat:@"%@=%@", parameterKey, encodedParameterValue];
-            [data appendData:[parameter dataUsingEncoding:NSUTF8StringEncoding]];
+            [body appendString:parameterKey];
+            [body appendString:@"="];
+            [body appendString:[CMISURLUtil encodeUrlParameterValue:self.parameters[parameterKey]]];
         }
 
-        return data;
+        return [body dataUsingEncoding:NSUTF8StringEncoding];
     } else {
         CMISLogError(@"this method should not be called when content stream is set. Use startData and endData method to retrieve the data.");
         return nil;
@@ -224,16 +222,7 @@ NSString * const kCMISFormDataContentTypeFormData = @"multipart/form-data; bound
         }
         
         // content
-        if (self.fileName == nil || self.fileName.length == 0) {
-            self.fileName = @"content";
-        }
-        
-        if (self.mediaType == nil ||
-            [self.mediaType rangeOfString:@"/"].location < 1 ||
-            [self.mediaType rangeOfString:@"\n"].location > -1 ||
-            [self.mediaType rangeOfString:@"\r"].location > -1) {
-            self.mediaType = kCMISMediaTypeOctetStream;
-        }
+        [self validateContentFileNameAndMediaType];
 
         [self appendLine:data string:[NSString stringWithFormat:@"--%@", self.boundary]];
         [self appendLine:data string:[NSString stringWithFormat:@"Content-Disposition: %@",
@@ -264,6 +253,43 @@ NSString * const kCMISFormDataContentTypeFormData = @"multipart/form-data; bound
     }
 }
 
+- (CMISMultipartFormDataStream *)bodyStreamWithContentLength:(long long)contentLength
+{
+    if (self.contentStream) {
+        CMISMultipartFormDataStream *bodyStream = [[CMISMultipartFormDataStream alloc] initWithBoundary:self.boundary];
+        
+        // parameters
+        for (NSString *paramKey in self.parameters) {
+            [bodyStream addFieldWithName:paramKey value:self.parameters[paramKey]];
+        }
+        
+        // content
+        [self validateContentFileNameAndMediaType];
+        [bodyStream addPartWithContentDisposition:[CMISMimeHelper encodeContentDisposition:kCMISMimeHelperDispositionFormDataContent fileName:self.fileName]
+                                        mediaType:self.mediaType
+                                      inputStream:self.contentStream
+                                           length:contentLength];
+        return bodyStream;
+    } else {
+        CMISLogError(@"this method should not be called when content stream is nil. Use body method to retrieve the data.");
+        return nil;
+    }
+}
+
+- (void)validateContentFileNameAndMediaType
+{
+    if (self.fileName == nil || self.fileName.length == 0) {
+        self.fileName = @"content";
+    }
+    
+    if (self.mediaType == nil ||
+        [self.mediaType rangeOfString:@"/"].location < 1 ||
+        [self.mediaType rangeOfString:@"\n"].location > -1 ||
+        [self.mediaType rangeOfString:@"\r"].location > -1) {
+        self.mediaType = kCMISMediaTypeOctetStream;
+    }
+}
+
 - (void)appendLine:(NSMutableData *)data
 {
     [self appendLine:data string:nil];
@@ -23,6 +23,7 @@
 #import "CMISURLUtil.h"
 #import "CMISHttpResponse.h"
 #import "CMISBrowserUtil.h"
+#import "CMISTypeDefinition.h"
 
 @interface CMISBrowserBaseService ()
 @property (nonatomic, strong, readwrite) CMISBindingSession *bindingSession;
@@ -92,13 +93,17 @@
                                    completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
                                        if (httpResponse) {
                                            NSData *data = httpResponse.data;
-                                           if (data) {
+                                           id parsedResult = httpResponse.parsedResult;
+                                           if ([parsedResult isKindOfClass:[CMISTypeDefinition class]]) {
+                                               completionBlock(parsedResult, nil); // not modified since it was parsed
+                                           } else if (data) {
                                                NSError *parsingError = nil;
                                                CMISTypeDefinition *typeDef = [CMISBrowserUtil typeDefinitionFromJSONData:data error:&parsingError];
                                                if (parsingError) {
                                                    completionBlock(nil, parsingError);
                                                }
                                                else {
+                                                   httpResponse.parsedResult = typeDef;
                                                    completionBlock(typeDef, nil);
                                                }
                                            }
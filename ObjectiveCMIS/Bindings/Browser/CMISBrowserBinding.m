@@ -25,6 +25,7 @@
 #import "CMISBrowserVersioningService.h"
 #import "CMISBrowserDiscoveryService.h"
 #import "CMISBrowserAclService.h"
+#import "CMISURLSessionPool.h"
 
 @interface CMISBrowserBinding ()
 
@@ -71,7 +72,7 @@
 
 - (void)close
 {
-    // do nothing for now
+    [[CMISURLSessionPool sharedPool] releaseSessionsForBindingSession:self.session];
 }
 
 @end
@@ -25,6 +25,7 @@
 #import "CMISBrowserConstants.h"
 #import "CMISURLUtil.h"
 #import "CMISBrowserTypeCache.h"
+#import "CMISBrowserObjectReader.h"
 
 @implementation CMISBrowserNavigationService
 
@@ -39,16 +40,15 @@
                         maxItems:(NSNumber *)maxItems
                  completionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock
 {
-    NSString *objectUrl = [self retrieveObjectUrlForObjectWithId:objectId selector:kCMISBrowserJSONSelectorChildren];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterFilter value:filter urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterOrderBy value:orderBy urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeAllowableActions boolValue:includeAllowableActions urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeRelationships value:[CMISEnums stringForIncludeRelationShip:relationships] urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterRenditionFilter value:renditionFilter urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludePathSegment boolValue:includePathSegment urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterMaxItems numberValue:maxItems urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterSkipCount numberValue:skipCount urlString:objectUrl];
-    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISBrowserJSONParameterSuccinct value:kCMISParameterValueTrue urlString:objectUrl];
+    NSString *objectUrl = [self childrenUrlForObjectId:objectId
+                                               orderBy:orderBy
+                                                filter:filter
+                                         relationships:relationships
+                                       renditionFilter:renditionFilter
+                               includeAllowableActions:includeAllowableActions
+                                    includePathSegment:includePathSegment
+                                             skipCount:skipCount
+                                              maxItems:maxItems];
     
     CMISRequest *cmisRequest = [[CMISRequest alloc] init];
     
@@ -74,6 +74,78 @@
 }
 
 
+- (CMISRequest*)retrieveChildren:(NSString *)objectId
+                         orderBy:(NSString *)orderBy
+                          filter:(NSString *)filter
+                   relationships:(CMISIncludeRelationship)relationships
+                 renditionFilter:(NSString *)renditionFilter
+         includeAllowableActions:(BOOL)includeAllowableActions
+              includePathSegment:(BOOL)includePathSegment
+                       skipCount:(NSNumber *)skipCount
+                        maxItems:(NSNumber *)maxItems
+                      entryBlock:(void (^)(CMISObjectData *objectData))entryBlock
+                 completionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock
+{
+    // without a network provider that can stream the response, the children are handed over once the whole response is read
+    if (![self.bindingSession.networkProvider respondsToSelector:@selector(invokeGET:session:cmisRequest:dataBlock:completionBlock:)]) {
+        return [self retrieveChildren:objectId
+                              orderBy:orderBy
+                               filter:filter
+                        relationships:relationships
+                      renditionFilter:renditionFilter
+              includeAllowableActions:includeAllowableActions
+                   includePathSegment:includePathSegment
+                            skipCount:skipCount
+                             maxItems:maxItems
+                      completionBlock:^(CMISObjectList *objectList, NSError *error) {
+                          for (CMISObjectData *objectData in objectList.objects) {
+                              entryBlock(objectData);
+                          }
+                          objectList.objects = @[];
+                          completionBlock(objectList, error);
+                      }];
+    }
+    
+    NSString *objectUrl = [self childrenUrlForObjectId:objectId
+                                               orderBy:orderBy
+                                                filter:filter
+                                         relationships:relationships
+                                       renditionFilter:renditionFilter
+                               includeAllowableActions:includeAllowableActions
+                                    includePathSegment:includePathSegment
+                                             skipCount:skipCount
+                                              maxItems:maxItems];
+    
+    CMISRequest *cmisRequest = [[CMISRequest alloc] init];
+    
+    // the response is read while it is received, the children are handed over as soon as they are complete
+    CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:self.bindingSession.repositoryId bindingService:self];
+    CMISBrowserObjectReader *reader = [[CMISBrowserObjectReader alloc] initWithResponse:CMISBrowserObjectReaderResponseObjectList typeCache:typeCache objectBlock:entryBlock];
+    [self.bindingSession.networkProvider invokeGET:[NSURL URLWithString:objectUrl]
+                                           session:self.bindingSession
+                                       cmisRequest:cmisRequest
+                                         dataBlock:^(NSData *data) {
+                                             [reader appendData:data];
+                                         }
+                                   completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                                       if (httpResponse == nil) {
+                                           [reader cancel];
+                                           completionBlock(nil, error);
+                                           return;
+                                       }
+                                       
+                                       [reader finishWithCompletionBlock:^(CMISObjectList *objectList, NSError *error) {
+                                           if (error) {
+                                               completionBlock(nil, error);
+                                           } else {
+                                               completionBlock(objectList, nil);
+                                           }
+                                       }];
+                                   }];
+    
+    return cmisRequest;
+}
+
 - (CMISRequest*)retrieveParentsForObject:(NSString *)objectId
                                   filter:(NSString *)filter
                            relationships:(CMISIncludeRelationship)relationships
@@ -161,4 +233,30 @@
     return cmisRequest;
 }
 
+#pragma mark -
+#pragma mark Private helper methods
+
+- (NSString *)childrenUrlForObjectId:(NSString *)objectId
+                             orderBy:(NSString *)orderBy
+                              filter:(NSString *)filter
+                       relationships:(CMISIncludeRelationship)relationships
+                     renditionFilter:(NSString *)renditionFilter
+             includeAllowableActions:(BOOL)includeAllowableActions
+                  includePathSegment:(BOOL)includePathSegment
+                           skipCount:(NSNumber *)skipCount
+                            maxItems:(NSNumber *)maxItems
+{
+    NSString *objectUrl = [self retrieveObjectUrlForObjectWithId:objectId selector:kCMISBrowserJSONSelectorChildren];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterFilter value:filter urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterOrderBy value:orderBy urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeAllowableActions boolValue:includeAllowableActions urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludeRelationships value:[CMISEnums stringForIncludeRelationShip:relationships] urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterRenditionFilter value:renditionFilter urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterIncludePathSegment boolValue:includePathSegment urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterMaxItems numberValue:maxItems urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISParameterSkipCount numberValue:skipCount urlString:objectUrl];
+    objectUrl = [CMISURLUtil urlStringByAppendingParameter:kCMISBrowserJSONParameterSuccinct value:kCMISParameterValueTrue urlString:objectUrl];
+    return objectUrl;
+}
+
 @end
@@ -0,0 +1,69 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import "CMISJSONReader.h"
+
+@class CMISObjectData;
+@class CMISObjectList;
+@class CMISBrowserTypeCache;
+
+/// The kinds of Browser binding responses a CMISBrowserObjectReader reads
+typedef NS_ENUM(NSInteger, CMISBrowserObjectReaderResponse)
+{
+    CMISBrowserObjectReaderResponseObject,      // a single object
+    CMISBrowserObjectReaderResponseObjectList,  // an object list, or an array of objects, children or parents
+    CMISBrowserObjectReaderResponseQueryResult  // a query result list
+};
+
+/**
+ * Reads the objects of a Browser binding JSON response while it is received. CMISObjectData and CMISProperties are
+ * built from the events of a CMISJSONReader instead of from a Foundation object tree of the whole response.
+ *
+ * Properties in the full shape are converted as soon as each of them has been read. Succinct properties are collected
+ * as plain values and typed with the type definitions of the object once it is complete. The remaining members of an
+ * object, such as its ACL or renditions, are small and are converted from their values.
+ *
+ * Objects are converted in order on the calling thread of the initialiser, which must run a run loop while type
+ * definitions are retrieved. All methods must be called on that thread.
+ */
+@interface CMISBrowserObjectReader : NSObject <CMISJSONReaderDelegate>
+
+/// Initialises a reader that collects the objects into the object list
+- (id)initWithResponse:(CMISBrowserObjectReaderResponse)response typeCache:(CMISBrowserTypeCache *)typeCache;
+
+/**
+ * Initialises a reader that hands each object to the object block as soon as it has been converted, so only the
+ * objects still being read or converted are kept. The object list returned on completion has no objects.
+ */
+- (id)initWithResponse:(CMISBrowserObjectReaderResponse)response typeCache:(CMISBrowserTypeCache *)typeCache objectBlock:(void (^)(CMISObjectData *objectData))objectBlock;
+
+/// reads the next chunk of the response, returns NO once reading has failed or was cancelled
+- (BOOL)appendData:(NSData *)data;
+
+/**
+ * Signals the end of the response. The completion block is called once all objects have been converted. A single
+ * object is returned as the only object of the list.
+ */
+- (void)finishWithCompletionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock;
+
+/// stops reading and converting, no more objects are handed over
+- (void)cancel;
+
+@end
@@ -0,0 +1,431 @@
+/*
+ Licensed to the Apache Software Foundation (ASF) under one
+ or more contributor license agreements.  See the NOTICE file
+ distributed with this work for additional information
+ regarding copyright ownership.  The ASF licenses this file
+ to you under the Apache License, Version 2.0 (the
+ "License"); you may not use this file except in compliance
+ with the License.  You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing,
+ software distributed under the License is distributed on an
+ "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ KIND, either express or implied.  See the License for the
+ specific language governing permissions and limitations
+ under the License.
+ */
+
+#import "CMISBrowserObjectReader.h"
+#import "CMISBrowserUtil.h"
+#import "CMISBrowserConstants.h"
+#import "CMISObjectConverter.h"
+#import "CMISObjectData.h"
+#import "CMISObjectList.h"
+#import "CMISProperties.h"
+#import "CMISDictionaryUtil.h"
+#import "CMISErrors.h"
+
+typedef NS_ENUM(NSInteger, CMISBrowserObjectReaderFrameKind)
+{
+    CMISBrowserObjectReaderFrameObjectList,         // the members of an object list
+    CMISBrowserObjectReaderFrameObjects,            // an array of objects
+    CMISBrowserObjectReaderFrameObject,             // an object, or a list item wrapping an object
+    CMISBrowserObjectReaderFrameProperties,         // the properties of an object in the full shape
+    CMISBrowserObjectReaderFrameProperty,           // a property in the full shape
+    CMISBrowserObjectReaderFrameSuccinctProperties, // the properties of an object in the succinct shape
+    CMISBrowserObjectReaderFrameValue               // any other array or object, read into a Foundation collection
+};
+
+/// an array or object of the response that has started but not ended yet
+@interface CMISBrowserObjectReaderFrame : NSObject
+
+@property (nonatomic, assign) CMISBrowserObjectReaderFrameKind kind;
+/// the key of the member being read
+@property (nonatomic, strong) NSString *key;
+/// the plain members or items read so far
+@property (nonatomic, strong) id container;
+/// the properties of an object or properties frame in the full shape
+@property (nonatomic, strong) CMISProperties *properties;
+/// the properties of an object in the succinct shape
+@property (nonatomic, strong) NSDictionary *succinctProperties;
+/// the object wrapped by a list item
+@property (nonatomic, strong) CMISBrowserObjectReaderFrame *object;
+/// the id of the property of a property frame
+@property (nonatomic, strong) NSString *propertyId;
+/// YES for the items of an array of objects, which may wrap the object
+@property (nonatomic, assign) BOOL listItem;
+
+@end
+
+@implementation CMISBrowserObjectReaderFrame
+@end
+
+@interface CMISBrowserObjectReader ()
+
+@property (nonatomic, assign) CMISBrowserObjectReaderResponse response;
+@property (nonatomic, strong) CMISBrowserTypeCache *typeCache;
+@property (nonatomic, copy) void (^objectBlock)(CMISObjectData *objectData);
+@property (nonatomic, copy) void (^completionBlock)(CMISObjectList *objectList, NSError *error);
+@property (nonatomic, strong) CMISJSONReader *jsonReader;
+
+// state of reading
+@property (nonatomic, strong) NSMutableArray *frames;
+@property (nonatomic, strong) NSDictionary *listMembers;
+@property (nonatomic, assign) NSUInteger objectCount;
+
+// state of converting
+@property (nonatomic, strong) NSMutableArray *pendingObjects;
+@property (nonatomic, strong) NSMutableOrderedSet *pendingTypeIds;
+@property (nonatomic, strong) NSMutableSet *retrievedTypeIds;
+@property (nonatomic, strong) NSMutableArray *objects;
+@property (nonatomic, assign) BOOL converting;
+@property (nonatomic, assign) BOOL finished;
+
+@property (strong) NSError *error;
+@property (assign) BOOL cancelled;
+
+@end
+
+@implementation CMISBrowserObjectReader
+
+- (id)initWithResponse:(CMISBrowserObjectReaderResponse)response typeCache:(CMISBrowserTypeCache *)typeCache
+{
+    return [self initWithResponse:response typeCache:typeCache objectBlock:nil];
+}
+
+- (id)initWithResponse:(CMISBrowserObjectReaderResponse)response typeCache:(CMISBrowserTypeCache *)typeCache objectBlock:(void (^)(CMISObjectData *objectData))objectBlock
+{
+    self = [super init];
+    if (self) {
+        self.response = response;
+        self.typeCache = typeCache;
+        self.objectBlock = objectBlock;
+        self.jsonReader = [[CMISJSONReader alloc] initWithDelegate:self];
+        self.frames = [NSMutableArray array];
+        self.pendingObjects = [NSMutableArray array];
+        self.pendingTypeIds = [NSMutableOrderedSet orderedSet];
+        self.retrievedTypeIds = [NSMutableSet set];
+        if (!objectBlock) {
+            self.objects = [NSMutableArray array];
+        }
+    }
+    return self;
+}
+
+- (BOOL)appendData:(NSData *)data
+{
+    if (self.error || self.cancelled) {
+        return NO;
+    }
+    
+    if (![self.jsonReader appendData:data]) {
+        [self failWithReaderError];
+        return NO;
+    }
+    return YES;
+}
+
+- (void)finishWithCompletionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock
+{
+    if (!self.error && !self.cancelled && ![self.jsonReader finishReading]) {
+        [self failWithReaderError];
+    }
+    
+    self.completionBlock = completionBlock;
+    [self finishConverting];
+}
+
+- (void)cancel
+{
+    self.cancelled = YES;
+}
+
+#pragma mark -
+#pragma mark CMISJSONReaderDelegate
+
+- (void)readerDidStartObject:(CMISJSONReader *)reader
+{
+    CMISBrowserObjectReaderFrame *parent = self.frames.lastObject;
+    CMISBrowserObjectReaderFrameKind kind = CMISBrowserObjectReaderFrameValue;
+    if (!parent) {
+        kind = (self.response == CMISBrowserObjectReaderResponseObject) ? CMISBrowserObjectReaderFrameObject : CMISBrowserObjectReaderFrameObjectList;
+    } else if (parent.kind == CMISBrowserObjectReaderFrameObjects) {
+        kind = CMISBrowserObjectReaderFrameObject;
+    } else if (parent.kind == CMISBrowserObjectReaderFrameObject) {
+        if ([parent.key isEqualToString:kCMISBrowserJSONSuccinctProperties]) {
+            kind = CMISBrowserObjectReaderFrameSuccinctProperties;
+        } else if ([parent.key isEqualToString:kCMISBrowserJSONProperties]) {
+            kind = CMISBrowserObjectReaderFrameProperties;
+        } else if (parent.listItem && [parent.key isEqualToString:kCMISBrowserJSONObject]) {
+            kind = CMISBrowserObjectReaderFrameObject;
+        }
+    } else if (parent.kind == CMISBrowserObjectReaderFrameProperties) {
+        kind = CMISBrowserObjectReaderFrameProperty;
+    }
+    
+    CMISBrowserObjectReaderFrame *frame = [[CMISBrowserObjectReaderFrame alloc] init];
+    frame.kind = kind;
+    if (kind == CMISBrowserObjectReaderFrameProperties) {
+        frame.properties = [[CMISProperties alloc] init];
+    } else {
+        frame.container = [[NSMutableDictionary alloc] init];
+        if (kind == CMISBrowserObjectReaderFrameProperty) {
+            frame.propertyId = parent.key;
+        } else if (kind == CMISBrowserObjectReaderFrameObject) {
+            frame.listItem = (parent.kind == CMISBrowserObjectReaderFrameObjects);
+        }
+    }
+    [self.frames addObject:frame];
+}
+
+- (void)readerDidEndObject:(CMISJSONReader *)reader
+{
+    [self endFrame];
+}
+
+- (void)readerDidStartArray:(CMISJSONReader *)reader
+{
+    CMISBrowserObjectReaderFrame *parent = self.frames.lastObject;
+    CMISBrowserObjectReaderFrame *frame = [[CMISBrowserObjectReaderFrame alloc] init];
+    if ((!parent && self.response != CMISBrowserObjectReaderResponseObject) ||
+        (parent.kind == CMISBrowserObjectReaderFrameObjectList && [parent.key isEqualToString:[self objectsKey]])) {
+        frame.kind = CMISBrowserObjectReaderFrameObjects;
+    } else {
+        frame.kind = CMISBrowserObjectReaderFrameValue;
+        frame.container = [[NSMutableArray alloc] init];
+    }
+    [self.frames addObject:frame];
+}
+
+- (void)readerDidEndArray:(CMISJSONReader *)reader
+{
+    [self endFrame];
+}
+
+- (void)reader:(CMISJSONReader *)reader didReadKey:(NSString *)key
+{
+    CMISBrowserObjectReaderFrame *frame = self.frames.lastObject;
+    frame.key = key;
+}
+
+- (void)reader:(CMISJSONReader *)reader didReadValue:(id)value
+{
+    [self addValue:value];
+}
+
+#pragma mark -
+#pragma mark Private helper methods
+
+- (NSString *)objectsKey
+{
+    return (self.response == CMISBrowserObjectReaderResponseQueryResult) ? kCMISBrowserJSONResults : kCMISBrowserJSONObjects;
+}
+
+/// adds a plain value, or the collection of a value frame that has ended, to the current frame
+- (void)addValue:(id)value
+{
+    CMISBrowserObjectReaderFrame *frame = self.frames.lastObject;
+    if (!frame) {
+        return;
+    }
+    
+    switch (frame.kind) {
+        case CMISBrowserObjectReaderFrameObjects:
+            [self failWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
+                                                detailedDescription:[NSString stringWithFormat:@"expected a dictionary but was %@", [value class]]]];
+            break;
+        case CMISBrowserObjectReaderFrameProperties:
+            break; // a property without type and value, e.g. null
+        default:
+            if ([frame.container isKindOfClass:NSMutableArray.class]) {
+                [frame.container addObject:value];
+            } else if (frame.key) {
+                [frame.container setObject:value forKey:frame.key];
+            }
+            break;
+    }
+}
+
+- (void)endFrame
+{
+    CMISBrowserObjectReaderFrame *frame = self.frames.lastObject;
+    [self.frames removeLastObject];
+    CMISBrowserObjectReaderFrame *parent = self.frames.lastObject;
+    
+    switch (frame.kind) {
+        case CMISBrowserObjectReaderFrameValue:
+            [self addValue:frame.container];
+            break;
+        case CMISBrowserObjectReaderFrameProperty: {
+            NSError *error = nil;
+            CMISPropertyData *propertyData = [CMISBrowserUtil convertProperty:frame.propertyId propertyDictionary:frame.container error:&error];
+            if (propertyData) {
+                [parent.properties addProperty:propertyData];
+            } else {
+                [self failWithError:error];
+            }
+            break;
+        }
+        case CMISBrowserObjectReaderFrameProperties:
+            parent.properties = frame.properties;
+            break;
+        case CMISBrowserObjectReaderFrameSuccinctProperties:
+            parent.succinctProperties = frame.container;
+            break;
+        case CMISBrowserObjectReaderFrameObject:
+            if (parent.kind == CMISBrowserObjectReaderFrameObject && parent.listItem) {
+                parent.object = frame; // the object wrapped by a list item
+            } else {
+                [self readObject:(frame.object ? frame.object : frame)];
+            }
+            break;
+        case CMISBrowserObjectReaderFrameObjectList:
+            self.listMembers = frame.container;
+            break;
+        case CMISBrowserObjectReaderFrameObjects:
+            break;
+    }
+}
+
+- (void)readObject:(CMISBrowserObjectReaderFrame *)frame
+{
+    self.objectCount++;
+    
+    if (!self.cancelled) {
+        [self enqueueObject:frame];
+    }
+}
+
+- (void)failWithError:(NSError *)error
+{
+    if (!self.error) {
+        self.error = error;
+    }
+    [self.jsonReader abortReading];
+}
+
+- (void)failWithReaderError
+{
+    if (!self.error && self.jsonReader.error) {
+        self.error = [CMISErrors cmisError:self.jsonReader.error cmisErrorCode:kCMISErrorCodeRuntime];
+    }
+}
+
+#pragma mark -
+#pragma mark Converting
+
+- (void)enqueueObject:(CMISBrowserObjectReaderFrame *)frame
+{
+    [self.pendingObjects addObject:frame];
+    if (self.typeCache) {
+        [CMISBrowserUtil addTypeIdsOfObject:frame.container succinctProperties:frame.succinctProperties toTypeIds:self.pendingTypeIds];
+        [self.pendingTypeIds minusSet:self.retrievedTypeIds];
+    }
+    [self convertPendingObjects];
+}
+
+- (void)finishConverting
+{
+    self.finished = YES;
+    [self convertPendingObjects];
+}
+
+/// converts the pending objects in order, the conversion of an object may wait for type definitions to be retrieved
+- (void)convertPendingObjects
+{
+    while (!self.converting && self.pendingObjects.count > 0 && !self.error && !self.cancelled) {
+        if (self.pendingTypeIds.count > 0) {
+            // retrieve the type definitions of all objects read so far at once, instead of one at a time while converting them
+            NSArray *typeIds = self.pendingTypeIds.array;
+            [self.pendingTypeIds removeAllObjects];
+            
+            self.converting = YES;
+            __block BOOL returned = NO;
+            [self.typeCache retrieveTypeDefinitions:typeIds completionBlock:^(NSError *error) {
+                self.converting = NO;
+                if (error) {
+                    if (!self.error) {
+                        self.error = error;
+                    }
+                } else {
+                    [self.retrievedTypeIds addObjectsFromArray:typeIds];
+                }
+                
+                if (returned) { // the retrieval has waited, continue with the conversion
+                    [self convertPendingObjects];
+                }
+            }];
+            returned = YES;
+            continue;
+        }
+        
+        CMISBrowserObjectReaderFrame *frame = self.pendingObjects.firstObject;
+        [self.pendingObjects removeObjectAtIndex:0];
+        
+        CMISObjectData *objectData = [[CMISObjectData alloc] init];
+        objectData.properties = frame.properties;
+        
+        self.converting = YES;
+        __block BOOL returned = NO;
+        [CMISBrowserUtil convertObjectData:objectData members:frame.container succinctProperties:frame.succinctProperties typeCache:self.typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
+            self.converting = NO;
+            if (error) {
+                if (!self.error) {
+                    self.error = error;
+                }
+            } else if (self.objectBlock) {
+                if (!self.cancelled) {
+                    self.objectBlock(objectData);
+                }
+            } else {
+                [self.objects addObject:objectData];
+            }
+            
+            if (returned) { // the conversion has waited, continue with the next object
+                [self convertPendingObjects];
+            }
+        }];
+        returned = YES;
+    }
+    
+    if (self.finished && !self.converting && (self.pendingObjects.count == 0 || self.error || self.cancelled)) {
+        [self executeCompletionBlock];
+    }
+}
+
+- (void)executeCompletionBlock
+{
+    void (^completionBlock)(CMISObjectList *objectList, NSError *error) = self.completionBlock;
+    self.completionBlock = nil;
+    if (!completionBlock) {
+        return;
+    }
+    
+    if (self.cancelled) {
+        completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled detailedDescription:@"Reading was cancelled"]);
+    } else if (self.error) {
+        completionBlock(nil, self.error);
+    } else {
+        CMISObjectList *objectList = [[CMISObjectList alloc] init];
+        objectList.objects = (self.objects ? [self.objects copy] : @[]);
+        
+        NSDictionary *listMembers = self.listMembers;
+        if (listMembers) {
+            // retrieve the paging data
+            objectList.hasMoreItems = [listMembers cmis_boolForKey:kCMISBrowserJSONHasMoreItems];
+            objectList.numItems = [listMembers cmis_intForKey:kCMISBrowserJSONNumberItems];
+            
+            // handle extension data
+            NSSet *cmisKeys = (self.response == CMISBrowserObjectReaderResponseQueryResult) ? [CMISBrowserConstants queryResultListKeys] : [CMISBrowserConstants objectListKeys];
+            objectList.extensions = [CMISObjectConverter convertExtensions:listMembers cmisKeys:cmisKeys];
+        } else {
+            objectList.hasMoreItems = NO;
+            objectList.numItems = (int)self.objectCount;
+        }
+        completionBlock(objectList, nil);
+    }
+}
+
+@end
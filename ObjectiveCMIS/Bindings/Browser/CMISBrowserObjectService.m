@@ -28,8 +28,10 @@
 #import "CMISErrors.h"
 #import "CMISLog.h"
 #import "CMISBroswerFormDataWriter.h"
+#import "CMISMultipartFormDataStream.h"
 #import "CMISStringInOutParameter.h"
 #import "CMISBrowserTypeCache.h"
+#import "CMISObjectData.h"
 
 @implementation CMISBrowserObjectService
 
@@ -57,12 +59,16 @@
                                            session:self.bindingSession
                                        cmisRequest:cmisRequest
                                    completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
-                                       if (httpResponse.statusCode == 200 && httpResponse.data) {
+                                       id parsedResult = httpResponse.statusCode == 200 ? httpResponse.parsedResult : nil;
+                                       if ([parsedResult isKindOfClass:[CMISObjectData class]]) {
+                                           completionBlock(parsedResult, nil); // not modified since it was parsed
+                                       } else if (httpResponse.statusCode == 200 && httpResponse.data) {
                                            CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:self.bindingSession.repositoryId bindingService:self];
                                            [CMISBrowserUtil objectDataFromJSONData:httpResponse.data typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
                                                if (error) {
                                                    completionBlock(nil, error);
                                                } else {
+                                                   httpResponse.parsedResult = objectData;
                                                    completionBlock(objectData, nil);
                                                }
                                            }];
@@ -99,12 +105,16 @@
                                            session:self.bindingSession
                                        cmisRequest:cmisRequest
                                    completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
-                                       if (httpResponse.statusCode == 200 && httpResponse.data) {
+                                       id parsedResult = httpResponse.statusCode == 200 ? httpResponse.parsedResult : nil;
+                                       if ([parsedResult isKindOfClass:[CMISObjectData class]]) {
+                                           completionBlock(parsedResult, nil); // not modified since it was parsed
+                                       } else if (httpResponse.statusCode == 200 && httpResponse.data) {
                                            CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:self.bindingSession.repositoryId bindingService:self];
                                            [CMISBrowserUtil objectDataFromJSONData:httpResponse.data typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
                                                if (error) {
                                                    completionBlock(nil, error);
                                                } else {
+                                                   httpResponse.parsedResult = objectData;
                                                    completionBlock(objectData, nil);
                                                }
                                            }];
@@ -324,9 +334,6 @@
         return nil;
     }
     
-    // build URL
-    NSString *objectUrl = [self retrieveObjectUrlForObjectWithId:objectId.inParameter];
-    
     // prepare form data
     CMISBroswerFormDataWriter *formData = [[CMISBroswerFormDataWriter alloc] initWithAction:kCMISBrowserJSONActionSetContent contentStream:inputStream mediaType:mimeType];
     [formData setFileName:filename];
@@ -334,51 +341,60 @@
     [formData addParameter:kCMISParameterChangeToken value:changeToken.inParameter];
     [formData addSuccinctFlag:true];
     
+    return [self sendContentForm:formData
+                        toObject:objectId
+                     inputStream:inputStream
+                   bytesExpected:bytesExpected
+                     changeToken:changeToken
+                 completionBlock:completionBlock
+                   progressBlock:progressBlock];
+}
+
+- (CMISRequest*)appendContentOfObject:(CMISStringInOutParameter *)objectId
+                      fromInputStream:(NSInputStream *)inputStream
+                        bytesExpected:(unsigned long long)bytesExpected
+                             filename:(NSString *)filename
+                             mimeType:(NSString *)mimeType
+                          isLastChunk:(BOOL)isLastChunk
+                          changeToken:(CMISStringInOutParameter *)changeToken
+                      completionBlock:(void (^)(NSError *error))completionBlock
+                        progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock
+{
+    // we need an object id
+    if ((objectId.inParameter == nil) || (objectId.inParameter.length == 0)) {
+        if (completionBlock) {
+            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
+                                            detailedDescription:@"Object id must be set!"]);
+        }
+        return nil;
+    }
     
-    CMISRequest *cmisRequest = [[CMISRequest alloc] init];
-    
-    void (^responseHandlingBlock) (CMISHttpResponse*, NSError*) = ^(CMISHttpResponse *httpResponse, NSError *error) {
-        if ((httpResponse.statusCode == 200 || httpResponse.statusCode == 201) && httpResponse.data) {
-            CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:self.bindingSession.repositoryId bindingService:self];
-            [CMISBrowserUtil objectDataFromJSONData:httpResponse.data typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
-                if (error) {
-                    completionBlock(error);
-                } else {
-                    objectId.outParameter = objectData.identifier;
-                    changeToken.outParameter = objectData.properties.propertiesDictionary[kCMISPropertyChangeToken];
-                    
-                    completionBlock(nil);
-                }
-            }];
-        } else {
-            completionBlock(error);
+    if (inputStream == nil) {
+        CMISLogError(@"Invalid input stream");
+        if (completionBlock) {
+            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument detailedDescription:@"Invalid input stream"]);
         }
-    };
+        return nil;
+    }
     
-    // send
-    if (inputStream) {
-        [self.bindingSession.networkProvider invoke:[NSURL URLWithString:objectUrl]
-                                         httpMethod:HTTP_POST
-                                            session:self.bindingSession
-                                        inputStream:inputStream
-                                            headers:formData.headers
-                                      bytesExpected:bytesExpected
-                                        cmisRequest:cmisRequest
-                                          startData:formData.startData
-                                            endData:formData.endData
-                                  useBase64Encoding:NO
-                                    completionBlock:responseHandlingBlock
-                                      progressBlock:progressBlock];
-    } else {
-        [self.bindingSession.networkProvider invokePOST:[NSURL URLWithString:objectUrl]
-                                                session:self.bindingSession
-                                                   body:formData.body
-                                                headers:formData.headers
-                                            cmisRequest:cmisRequest
-                                        completionBlock:responseHandlingBlock];
+    if (nil == mimeType) {
+        mimeType = kCMISMediaTypeOctetStream;
     }
     
-    return cmisRequest;
+    // prepare form data
+    CMISBroswerFormDataWriter *formData = [[CMISBroswerFormDataWriter alloc] initWithAction:kCMISBrowserJSONActionAppendContent contentStream:inputStream mediaType:mimeType];
+    [formData setFileName:filename];
+    [formData addParameter:kCMISParameterIsLastChunk boolValue:isLastChunk];
+    [formData addParameter:kCMISParameterChangeToken value:changeToken.inParameter];
+    [formData addSuccinctFlag:true];
+    
+    return [self sendContentForm:formData
+                        toObject:objectId
+                     inputStream:inputStream
+                   bytesExpected:bytesExpected
+                     changeToken:changeToken
+                 completionBlock:completionBlock
+                   progressBlock:progressBlock];
 }
 
 - (CMISRequest*)createDocumentFromFilePath:(NSString *)filePath
@@ -471,15 +487,17 @@
     
     // send
     if (inputStream) {
+        // the multipart body is generated while it is sent, its length is known if the content length is
+        CMISMultipartFormDataStream *bodyStream = [formData bodyStreamWithContentLength:(bytesExpected > 0 ? (long long)bytesExpected : -1)];
         [self.bindingSession.networkProvider invoke:[NSURL URLWithString:folderObjectUrl]
                                          httpMethod:HTTP_POST
                                             session:self.bindingSession
-                                        inputStream:inputStream
+                                        inputStream:bodyStream
                                             headers:formData.headers
-                                      bytesExpected:bytesExpected
+                                      bytesExpected:MAX(bodyStream.length, 0)
                                         cmisRequest:cmisRequest
-                                          startData:formData.startData
-                                            endData:formData.endData
+                                          startData:nil
+                                            endData:nil
                                   useBase64Encoding:NO
                                     completionBlock:responseHandlingBlock
                                       progressBlock:progressBlock];
@@ -736,4 +754,68 @@
     return cmisRequest;
 }
 
+#pragma mark -
+#pragma mark Private helper methods
+
+/// posts a setContent or appendContent form and updates the object id and change token from the returned object
+- (CMISRequest*)sendContentForm:(CMISBroswerFormDataWriter *)formData
+                       toObject:(CMISStringInOutParameter *)objectId
+                    inputStream:(NSInputStream *)inputStream
+                  bytesExpected:(unsigned long long)bytesExpected
+                    changeToken:(CMISStringInOutParameter *)changeToken
+                completionBlock:(void (^)(NSError *error))completionBlock
+                  progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock
+{
+    // build URL
+    NSString *objectUrl = [self retrieveObjectUrlForObjectWithId:objectId.inParameter];
+    
+    CMISRequest *cmisRequest = [[CMISRequest alloc] init];
+    
+    void (^responseHandlingBlock) (CMISHttpResponse*, NSError*) = ^(CMISHttpResponse *httpResponse, NSError *error) {
+        if ((httpResponse.statusCode == 200 || httpResponse.statusCode == 201) && httpResponse.data) {
+            CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:self.bindingSession.repositoryId bindingService:self];
+            [CMISBrowserUtil objectDataFromJSONData:httpResponse.data typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
+                if (error) {
+                    completionBlock(error);
+                } else {
+                    objectId.outParameter = objectData.identifier;
+                    changeToken.outParameter = objectData.properties.propertiesDictionary[kCMISPropertyChangeToken];
+                    
+                    completionBlock(nil);
+                }
+            }];
+        } else {
+            completionBlock(error);
+        }
+    };
+    
+    // send
+    if (inputStream) {
+        // the multipart body is generated while it is sent, its length is known if the content length is
+        CMISMultipartFormDataStream *bodyStream = [formData bodyStreamWithContentLength:(bytesExpected > 0 ? (long long)bytesExpected : -1)];
+        [self.bindingSession.networkProvider invoke:[NSURL URLWithString:objectUrl]
+                                         httpMethod:HTTP_POST
+                                            session:self.bindingSession
+                                        inputStream:bodyStream
+                                            headers:formData.headers
+                                      bytesExpected:MAX(bodyStream.length, 0)
+                                        cmisRequest:cmisRequest
+                                          startData:nil
+                                            endData:nil
+                                  useBase64Encoding:NO
+                                    completionBlock:responseHandlingBlock
+                                      progressBlock:progressBlock];
+    } else {
+        [self.bindingSession.networkProvider invokePOST:[NSURL URLWithString:objectUrl]
+                                                session:self.bindingSession
+                                                   body:formData.body
+                                                headers:formData.headers
+                                            cmisRequest:cmisRequest
+                                        completionBlock:responseHandlingBlock];
+    }
+    
+    return cmisRequest;
+}
+
+
 @end
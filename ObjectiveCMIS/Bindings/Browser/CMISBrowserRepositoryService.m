@@ -84,6 +84,11 @@
                                        }
                                    }];
     
+    // open the other connections to the service while the repository info is retrieved
+    if ([self.bindingSession.networkProvider respondsToSelector:@selector(warmUpConnectionsForSession:)]) {
+        [self.bindingSession.networkProvider warmUpConnectionsForSession:self.bindingSession];
+    }
+    
     return cmisRequest;
 }
 
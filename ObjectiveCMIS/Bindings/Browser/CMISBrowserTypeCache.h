@@ -28,4 +28,19 @@
 - (CMISRequest *)typeDefinition:(NSString *)typeId
                        completionBlock:(void (^)(CMISTypeDefinition *typeDefinition, NSError *error))completionBlock;
 
+/**
+ * Retrieves the type definitions that are not cached yet, all at the same time.
+ * The completion block is called before this method returns if all type definitions are cached.
+ */
+- (void)retrieveTypeDefinitions:(NSArray *)typeIds
+                completionBlock:(void (^)(NSError *error))completionBlock;
+
+/**
+ * Looks up a type definition without contacting the repository.
+ *
+ * @return YES if the type definition is cached or has been retrieved through this type cache before,
+ *         typeDefinition is set to the definition, which is nil if the repository did not return one
+ */
+- (BOOL)cachedTypeDefinition:(NSString *)typeId typeDefinition:(CMISTypeDefinition **)typeDefinition;
+
 @end
@@ -28,6 +28,8 @@
 
 @property (nonatomic, weak) NSString * repositoryId;
 @property (nonatomic, weak) CMISBrowserBaseService * service;
+// type definitions retrieved through this instance, so they survive evictions from the session cache
+@property (nonatomic, strong) NSMutableDictionary *retrievedTypeDefinitions;
 
 @end
 
@@ -40,6 +42,7 @@
     if (self) {
         _repositoryId = repositoryId;
         _service = service;
+        _retrievedTypeDefinitions = [[NSMutableDictionary alloc] init];
     }
     return self;
 }
@@ -59,6 +62,7 @@
                 if (typeDefinition) { // Store type definition in cache
                     [cache addTypeDefinition:typeDefinition repositoryId:self.repositoryId];
                 }
+                self.retrievedTypeDefinitions[typeId] = typeDefinition ? typeDefinition : [NSNull null];
                 
                 completionBlock(typeDefinition, nil);
             }
@@ -70,4 +74,49 @@
     return request;
 }
 
+- (void)retrieveTypeDefinitions:(NSArray *)typeIds
+                completionBlock:(void (^)(NSError *error))completionBlock
+{
+    NSMutableOrderedSet *missingTypeIds = [NSMutableOrderedSet orderedSet];
+    for (NSString *typeId in typeIds) {
+        if (![self cachedTypeDefinition:typeId typeDefinition:NULL]) {
+            [missingTypeIds addObject:typeId];
+        }
+    }
+    
+    if (missingTypeIds.count == 0) {
+        completionBlock(nil);
+        return;
+    }
+    
+    __block NSUInteger pendingCount = missingTypeIds.count;
+    __block NSError *firstError = nil;
+    for (NSString *typeId in missingTypeIds) {
+        [self typeDefinition:typeId completionBlock:^(CMISTypeDefinition *typeDefinition, NSError *error) {
+            if (error && !firstError) {
+                firstError = error;
+            }
+            if (--pendingCount == 0) {
+                completionBlock(firstError);
+            }
+        }];
+    }
+}
+
+- (BOOL)cachedTypeDefinition:(NSString *)typeId typeDefinition:(CMISTypeDefinition **)typeDefinition
+{
+    id retrievedTypeDefinition = self.retrievedTypeDefinitions[typeId];
+    if (!retrievedTypeDefinition) {
+        retrievedTypeDefinition = [_service.bindingSession.typeDefinitionCache typeDefinitionForTypeId:typeId repositoryId:self.repositoryId];
+    }
+    if (!retrievedTypeDefinition) {
+        return NO;
+    }
+    
+    if (typeDefinition != NULL) {
+        *typeDefinition = (retrievedTypeDefinition == [NSNull null]) ? nil : retrievedTypeDefinition;
+    }
+    return YES;
+}
+
 @end
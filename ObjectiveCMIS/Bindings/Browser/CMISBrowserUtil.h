@@ -25,6 +25,7 @@
 @class CMISObjectList;
 @class CMISBrowserTypeCache;
 @class CMISTypeDefinition;
+@class CMISPropertyData;
 
 @interface CMISBrowserUtil : NSObject
 
@@ -70,4 +71,21 @@
 
 + (NSString *)objectListChangeLogTokenFromJSONData:(NSData *)jsonData error:(NSError **)outError;
 
+/**
+ Completes a CMISObjectData object from the members of its JSON object, other than the properties.
+ The properties are either already set on the object data, or are given in the succinct shape and typed with the type definitions of the object.
+ The completion block is called before this method returns, unless a type definition has to be retrieved from the repository first.
+ */
++ (void)convertObjectData:(CMISObjectData *)objectData members:(NSDictionary *)dictionary succinctProperties:(NSDictionary *)succinctPropertiesJson typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(CMISObjectData *objectData, NSError *error))completionBlock;
+
+/**
+ Adds the ids of the object type and the secondary types that the succinct properties of an object and of its relationships refer to.
+ */
++ (void)addTypeIdsOfObject:(NSDictionary *)dictionary succinctProperties:(NSDictionary *)succinctPropertiesJson toTypeIds:(NSMutableOrderedSet *)typeIds;
+
+/**
+ Returns a CMISPropertyData object for a property given in the full shape, i.e. with its type and value.
+ */
++ (CMISPropertyData *)convertProperty:(NSString *)propName propertyDictionary:(NSDictionary *)propertyDictionary error:(NSError **)outError;
+
 @end
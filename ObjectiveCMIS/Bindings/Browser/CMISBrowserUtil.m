@@ -40,6 +40,7 @@
 #import "CMISObjectList.h"
 #import "CMISPolicyIdList.h"
 #import "CMISChangeEventInfo.h"
+#import "CMISBrowserObjectReader.h"
 
 NSString * const kCMISBrowserMinValueAlfrescoJSONProperty = @"\"minValue\":0.0000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000049,";
 NSString * const kCMISBrowserMinValueECMJSONProperty = @"\"minValue\":-179769313486231570000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000,";
@@ -47,25 +48,6 @@ NSString * const kCMISBrowserMinValueECMJSONProperty = @"\"minValue\":-179769313
 NSString * const kCMISBrowserMaxValueAlfrescoJSONProperty = @"\"maxValue\":179769313486231570000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000,";
 NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":179769313486231570000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000,";
 
-@interface NSObject (CMISUtil)
-
-+ (void)performBlock:(void (^)(void))block;
-
-@end
-
-@implementation NSObject (CMISUtil)
-
-+ (void)performBlock:(void (^)(void))block
-{
-    [NSObject performSelector:@selector(executeBlock:) onThread:[NSThread currentThread] withObject:block waitUntilDone:NO];
-}
-
-+ (void)executeBlock:(void (^)(void))block {
-    block();
-}
-
-@end
-
 @implementation CMISBrowserUtil
 
 + (NSDictionary *)repositoryInfoDictionaryFromJSONData:(NSData *)jsonData bindingSession:(CMISBindingSession *)bindingSession error:(NSError **)outError
@@ -241,74 +223,21 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
 
 + (void)objectDataFromJSONData:(NSData *)jsonData typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(CMISObjectData *objectData, NSError *error))completionBlock
 {
-    // TODO: error handling i.e. if jsonData is nil, also handle outError being nil
-
-    // parse the JSON response
-    NSError *serialisationError = nil;
-    id jsonDictionary = [NSJSONSerialization JSONObjectWithData:jsonData options:0 error:&serialisationError];
-    
-    if (!serialisationError) {
-        // parse the json into a CMISObjectData object
-        [CMISBrowserUtil convertObject:jsonDictionary typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
-            completionBlock(objectData, error);
-        }];
-    } else {
-        completionBlock(nil, [CMISErrors cmisError:serialisationError cmisErrorCode:kCMISErrorCodeRuntime]);
-    }
+    // read the JSON response into a CMISObjectData object
+    CMISBrowserObjectReader *reader = [[CMISBrowserObjectReader alloc] initWithResponse:CMISBrowserObjectReaderResponseObject typeCache:typeCache];
+    [reader appendData:jsonData];
+    [reader finishWithCompletionBlock:^(CMISObjectList *objectList, NSError *error) {
+        completionBlock(objectList.objects.firstObject, error);
+    }];
 }
 
 + (void)objectListFromJSONData:(NSData *)jsonData typeCache:(CMISBrowserTypeCache *)typeCache isQueryResult:(BOOL)isQueryResult completionBlock:(void(^)(CMISObjectList *objectList, NSError *error))completionBlock
 {
-    // TODO: error handling i.e. if jsonData is nil, also handle outError being nil
-    
-    // parse the JSON response
-    NSError *serialisationError = nil;
-    id jsonDictionary = [NSJSONSerialization JSONObjectWithData:jsonData options:0 error:&serialisationError];
-    
-    CMISObjectList *objectList = nil;
-    if (!serialisationError) {
-        // parse the json into a CMISObjectList object
-        objectList = [CMISObjectList new];
-        
-        // parse the objects
-        NSArray *objectsArray;
-        if ([jsonDictionary isKindOfClass:NSArray.class]){
-            objectsArray = jsonDictionary;
-            
-            objectList.hasMoreItems = NO;
-            objectList.numItems = (int)objectsArray.count;
-        } else { // is NSDictionary
-            if (isQueryResult) {
-                objectsArray = [jsonDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONResults];
-            } else {
-                objectsArray = [jsonDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONObjects];
-            }
-            // retrieve the paging data
-            objectList.hasMoreItems = [jsonDictionary cmis_boolForKey:kCMISBrowserJSONHasMoreItems];
-            objectList.numItems = [jsonDictionary cmis_intForKey:kCMISBrowserJSONNumberItems];
-        }
-        
-        [CMISBrowserUtil convertObjects:objectsArray typeCache:typeCache completionBlock:^(NSArray *objects, NSError *error) {
-            if (error){
-                completionBlock(nil, error);
-            } else {
-                // pass objects to list
-                objectList.objects = objects;
-                
-                // handle extension data
-                if([jsonDictionary isKindOfClass:NSDictionary.class]) {
-                    if (isQueryResult) {
-                        objectList.extensions = [CMISObjectConverter convertExtensions:jsonDictionary cmisKeys:[CMISBrowserConstants queryResultListKeys]];
-                    } else {
-                        objectList.extensions = [CMISObjectConverter convertExtensions:jsonDictionary cmisKeys:[CMISBrowserConstants objectListKeys]];
-                    }
-                }
-                completionBlock(objectList, nil);
-            }
-        }];
-    } else {
-        completionBlock(nil, [CMISErrors cmisError:serialisationError cmisErrorCode:kCMISErrorCodeRuntime]);
-    }
+    // read the JSON response into a CMISObjectList object
+    CMISBrowserObjectReaderResponse response = isQueryResult ? CMISBrowserObjectReaderResponseQueryResult : CMISBrowserObjectReaderResponseObjectList;
+    CMISBrowserObjectReader *reader = [[CMISBrowserObjectReader alloc] initWithResponse:response typeCache:typeCache];
+    [reader appendData:jsonData];
+    [reader finishWithCompletionBlock:completionBlock];
 }
 
 + (NSArray *)renditionsFromJSONData:(NSData *)jsonData error:(NSError **)outError
@@ -358,18 +287,12 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
 
 + (void)objectParents:(NSData *)jsonData typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(NSArray *objectParents, NSError *error))completionBlock
 {
-    // TODO: error handling i.e. if jsonData is nil, also handle outError being nil
-    
-    // parse the JSON response
-    NSError *serialisationError = nil;
-    id jsonDictionary = [NSJSONSerialization JSONObjectWithData:jsonData options:0 error:&serialisationError];
-    
-    if (!serialisationError) {
-        [self convertObjects:jsonDictionary typeCache:typeCache completionBlock:completionBlock];
-    } else {
-        completionBlock(nil, [CMISErrors cmisError:serialisationError cmisErrorCode:kCMISErrorCodeRuntime]);
-        return;
-    }
+    // the parents are read like a list of children
+    CMISBrowserObjectReader *reader = [[CMISBrowserObjectReader alloc] initWithResponse:CMISBrowserObjectReaderResponseObjectList typeCache:typeCache];
+    [reader appendData:jsonData];
+    [reader finishWithCompletionBlock:^(CMISObjectList *objectList, NSError *error) {
+        completionBlock(objectList.objects, error);
+    }];
 }
 
 +(void)aclFromJSONData:(NSData *)jsonData completionBlock:(void (^)(CMISAcl *, NSError *))completionBlock
@@ -410,44 +333,146 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
     return token;
 }
 
-#pragma mark -
-#pragma mark Private helper methods
++ (void)convertObjectData:(CMISObjectData *)objectData members:(NSDictionary *)dictionary succinctProperties:(NSDictionary *)succinctPropertiesJson typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(CMISObjectData *objectData, NSError *error))completionBlock
+{
+    NSString *missingTypeId = nil;
+    NSError *error = nil;
+    if ([CMISBrowserUtil convertObjectData:objectData members:dictionary succinctProperties:succinctPropertiesJson typeCache:typeCache missingTypeId:&missingTypeId error:&error]) {
+        completionBlock(objectData, nil);
+    } else if (missingTypeId) {
+        // retrieve the type definition the conversion stopped at, together with the others the object refers to, and start over
+        NSMutableOrderedSet *typeIds = [NSMutableOrderedSet orderedSetWithObject:missingTypeId];
+        [CMISBrowserUtil addTypeIdsOfObject:dictionary succinctProperties:succinctPropertiesJson toTypeIds:typeIds];
+        [typeCache retrieveTypeDefinitions:typeIds.array completionBlock:^(NSError *error) {
+            if (error) {
+                completionBlock(nil, error);
+            } else {
+                [CMISBrowserUtil convertObjectData:objectData members:dictionary succinctProperties:succinctPropertiesJson typeCache:typeCache completionBlock:completionBlock];
+            }
+        }];
+    } else {
+        completionBlock(nil, error);
+    }
+}
 
-+ (void)convertObject:(NSDictionary *)dictionary typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(CMISObjectData *objectData, NSError *error))completionBlock
++ (void)addTypeIdsOfObject:(NSDictionary *)dictionary succinctProperties:(NSDictionary *)succinctPropertiesJson toTypeIds:(NSMutableOrderedSet *)typeIds
 {
-    if (!dictionary) {
-        completionBlock(nil, nil);
+    if (succinctPropertiesJson) {
+        id objectTypeId = [succinctPropertiesJson cmis_objectForKeyNotNull:kCMISPropertyObjectTypeId];
+        if ([objectTypeId isKindOfClass:NSString.class]) {
+            [typeIds addObject:objectTypeId];
+        }
+        
+        NSArray *secTypeIds = [succinctPropertiesJson cmis_objectForKeyNotNull:kCMISPropertySecondaryObjectTypeIds];
+        if ([secTypeIds isKindOfClass:NSArray.class]) {
+            for (id secTypeId in secTypeIds) {
+                if ([secTypeId isKindOfClass:NSString.class]) {
+                    [typeIds addObject:secTypeId];
+                }
+            }
+        }
     }
     
-    CMISObjectData *objectData = [CMISObjectData new];
+    NSArray *relationshipsJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONRelationships];
+    for (NSDictionary *relationshipJson in relationshipsJson) {
+        if ([relationshipJson isKindOfClass:NSDictionary.class]) {
+            [CMISBrowserUtil addTypeIdsOfObject:relationshipJson succinctProperties:[relationshipJson cmis_objectForKeyNotNull:kCMISBrowserJSONSuccinctProperties] toTypeIds:typeIds];
+        }
+    }
+}
+
++ (CMISPropertyData *)convertProperty:(NSString *)propName propertyDictionary:(NSDictionary *)propertyDictionary error:(NSError **)outError
+{
+    CMISPropertyType propertyType = [CMISEnums enumForPropertyType:[propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONDatatype]];
+    
+    id propValue = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONValue];
+    NSArray *values = nil;
+    if ([propValue isKindOfClass:NSArray.class]) {
+        values = propValue;
+    } else if (propValue) {
+        values = [NSArray arrayWithObject:propValue];
+    }
+    
+    CMISPropertyData *propertyData;
+    switch (propertyType) {
+        case CMISPropertyTypeString:
+        case CMISPropertyTypeId:
+        case CMISPropertyTypeBoolean:
+        case CMISPropertyTypeInteger:
+        case CMISPropertyTypeDecimal:
+        case CMISPropertyTypeHtml:
+        case CMISPropertyTypeUri:
+            propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:propertyType];
+            break;
+        case CMISPropertyTypeDateTime: {
+            NSArray *dateValues = [CMISBrowserUtil convertNumbersToDates:values];
+            propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:dateValues type:propertyType];
+            break;
+        }
+        default: {
+            if (outError != NULL) *outError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
+                                             detailedDescription:@"Unknown property type!"];
+            return nil;
+        }
+    }
+    propertyData.identifier = propName;
+    propertyData.displayName = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONDisplayName];
+    propertyData.queryName = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONQueryName];
+    propertyData.localName = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONLocalName];
+    
+    propertyData.extensions = [CMISObjectConverter convertExtensions:propertyDictionary cmisKeys:[CMISBrowserConstants propertyKeys]];
     
-    BOOL hasSuccinctProperties = YES;
-    NSDictionary *propertiesJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONSuccinctProperties];
-    if(!propertiesJson){
-        hasSuccinctProperties = NO;
-        propertiesJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONProperties];
+    return propertyData;
+}
+
+#pragma mark -
+#pragma mark Private helper methods
+
+/**
+ * Completes the object data from the members of its JSON object without waiting for the repository.
+ * Returns NO and sets missingTypeId if a type definition that is needed is not in the type cache yet.
+ */
++ (BOOL)convertObjectData:(CMISObjectData *)objectData members:(NSDictionary *)dictionary succinctProperties:(NSDictionary *)succinctPropertiesJson typeCache:(CMISBrowserTypeCache *)typeCache missingTypeId:(NSString **)missingTypeId error:(NSError **)outError
+{
+    NSDictionary *propertiesExtension = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONPropertiesExtension];
+    
+    // convert the members that need type definitions first, so that little is repeated when one has to be retrieved
+    if (succinctPropertiesJson) {
+        CMISProperties *properties = [CMISBrowserUtil convertSuccinctProperties:succinctPropertiesJson propertiesExtension:propertiesExtension typeCache:typeCache missingTypeId:missingTypeId error:outError];
+        if (!properties) {
+            return NO;
+        }
+        objectData.properties = properties;
+    } else if (propertiesExtension) {
+        objectData.properties.extensions = [CMISObjectConverter convertExtensions:propertiesExtension cmisKeys:[NSSet set]];
     }
     
+    // relationships
+    NSArray *relationshipsJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONRelationships];
+    NSArray *relationships = [CMISBrowserUtil convertObjects:relationshipsJson typeCache:typeCache missingTypeId:missingTypeId error:outError];
+    if (!relationships) {
+        return NO;
+    }
+    objectData.relationships = relationships;
     
-    id identifier = [propertiesJson cmis_objectForKeyNotNull:kCMISPropertyObjectId];
-    if ([identifier isKindOfClass:NSDictionary.class]){
-        objectData.identifier = [identifier cmis_objectForKeyNotNull:kCMISBrowserJSONValue];
+    id identifier = nil;
+    id baseType = nil;
+    if (succinctPropertiesJson) {
+        identifier = [succinctPropertiesJson cmis_objectForKeyNotNull:kCMISPropertyObjectId];
+        baseType = [succinctPropertiesJson cmis_objectForKeyNotNull:kCMISPropertyBaseTypeId];
     } else {
-        objectData.identifier = identifier;
+        identifier = [objectData.properties propertyValueForId:kCMISPropertyObjectId];
+        baseType = [objectData.properties propertyValueForId:kCMISPropertyBaseTypeId];
     }
+    objectData.identifier = identifier;
     
     // determine the object type
-    id baseType = [propertiesJson cmis_objectForKeyNotNull:kCMISPropertyBaseTypeId];
-    if([baseType isKindOfClass:NSDictionary.class]) {
-        baseType = [baseType cmis_objectForKeyNotNull:kCMISBrowserJSONValue];
-    }
-    
     // TODO other base types
-    if ([baseType isEqualToString:kCMISPropertyObjectTypeIdValueDocument]) {
+    if ([baseType isEqual:kCMISPropertyObjectTypeIdValueDocument]) {
         objectData.baseType = CMISBaseTypeDocument;
-    } else if ([baseType isEqualToString:kCMISPropertyObjectTypeIdValueFolder]) {
+    } else if ([baseType isEqual:kCMISPropertyObjectTypeIdValueFolder]) {
         objectData.baseType = CMISBaseTypeFolder;
-    } else if ([baseType isEqualToString:kCMISPropertyObjectTypeIdValueItem]) {
+    } else if ([baseType isEqual:kCMISPropertyObjectTypeIdValueItem]) {
         objectData.baseType = CMISBaseTypeItem;
     }
     
@@ -471,102 +496,57 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
     objectData.isExactAcl = isExactAcl;
     objectData.policyIds = [CMISBrowserUtil convertPolicyIds:[dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONPolicyIds]];
     
-    NSDictionary *propertiesExtension = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONPropertiesExtension];
+    //renditions
+    NSArray *renditionsJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONRenditions];
+    objectData.renditions = [self renditionsFromArray:renditionsJson];
     
-    void (^continueWithObjectConversion)(CMISProperties*, NSError*) = ^(CMISProperties *properties, NSError *error) {
-        if (error){
-            completionBlock(nil, error);
-        } else {
-            objectData.properties = properties;
-            
-            // relationships
-            NSArray *relationshipsJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONRelationships];
-            [CMISBrowserUtil convertObjects:relationshipsJson typeCache:typeCache completionBlock:^(NSArray *objects, NSError *error) {
-                if (error){
-                    completionBlock(nil, error);
-                } else {
-                    objectData.relationships = objects;
-                    
-                    //renditions
-                    NSArray *renditionsJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONRenditions];
-                    objectData.renditions = [self renditionsFromArray:renditionsJson];
-                    
-                    // handle extensions
-                    objectData.extensions = [CMISObjectConverter convertExtensions:dictionary cmisKeys:[CMISBrowserConstants objectKeys]];
-                    
-                    completionBlock(objectData, nil);
-                }
-            }];
-        }
-    };
+    // handle extensions
+    objectData.extensions = [CMISObjectConverter convertExtensions:dictionary cmisKeys:[CMISBrowserConstants objectKeys]];
     
-    if(hasSuccinctProperties) {
-        [CMISBrowserUtil convertSuccinctProperties:propertiesJson propertiesExtension:propertiesExtension typeCache:typeCache completionBlock:^(CMISProperties *properties, NSError *error) {
-            continueWithObjectConversion(properties, error);
-        }];
-    } else {
-        NSError *error = nil;
-        CMISProperties *properties = [CMISBrowserUtil convertProperties:propertiesJson propertiesExtension:propertiesExtension error:&error];
-        continueWithObjectConversion(properties, error);
-    }
-
+    return YES;
 }
 
-+ (void)convertObjects:(NSArray *)objectsArray position:(NSInteger)position convertedObjects:(NSMutableArray *)convertedObjects typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(NSArray* objects, NSError *error))completionBlock
++ (CMISObjectData *)convertObject:(NSDictionary *)dictionary typeCache:(CMISBrowserTypeCache *)typeCache missingTypeId:(NSString **)missingTypeId error:(NSError **)outError
 {
-    NSDictionary *dictionary = [objectsArray objectAtIndex:position];
-    NSDictionary *objectDictionary = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONObject];
-    if (!objectDictionary) {
-        objectDictionary = dictionary;
+    CMISObjectData *objectData = [CMISObjectData new];
+    
+    NSDictionary *succinctPropertiesJson = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONSuccinctProperties];
+    if (!succinctPropertiesJson) {
+        NSError *error = nil;
+        objectData.properties = [CMISBrowserUtil convertProperties:[dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONProperties] propertiesExtension:nil error:&error];
+        if (error) {
+            if (outError != NULL) *outError = error;
+            return nil;
+        }
     }
-
-    if(![objectDictionary isKindOfClass:NSDictionary.class]){
-        completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument detailedDescription:[NSString stringWithFormat:@"expected a dictionary but was %@", objectDictionary.class]]);
+    
+    if (![CMISBrowserUtil convertObjectData:objectData members:dictionary succinctProperties:succinctPropertiesJson typeCache:typeCache missingTypeId:missingTypeId error:outError]) {
+        return nil;
     }
-    [CMISBrowserUtil convertObject:objectDictionary typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
-        if (error){
-            completionBlock(nil, error);
-        } else {
-            if (position == 0) {
-                [convertedObjects addObject:objectData];
-                completionBlock(convertedObjects, nil);
-            } else {
-                // TODO check if there is a better way on how to avoid a large call stack
-                // We need to do this workaround or else we would end up with a very large call stack
-                [CMISBrowserUtil performBlock:^{
-                    [self convertObjects:objectsArray
-                                position:(position -1)
-                        convertedObjects:convertedObjects
-                               typeCache:typeCache
-                         completionBlock:^(NSArray *objects, NSError *error) {
-                             if (error){
-                                 completionBlock(nil, error);
-                             } else {
-                                 [convertedObjects addObject:objectData];
-                                 completionBlock(objects, nil);
-                             }
-                         }];
-                }];
-            }
-        }
-    }];
-
+    return objectData;
 }
 
-+ (void)convertObjects:(NSArray *)objectsArray typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(NSArray* objects, NSError *error))completionBlock
++ (NSArray *)convertObjects:(NSArray *)objectsArray typeCache:(CMISBrowserTypeCache *)typeCache missingTypeId:(NSString **)missingTypeId error:(NSError **)outError
 {
     NSMutableArray *objects = [NSMutableArray arrayWithCapacity:objectsArray.count];
-    if (objectsArray.count > 0) {
-        [CMISBrowserUtil convertObjects:objectsArray
-                               position:(objectsArray.count - 1) // start recursion with last item
-                       convertedObjects:objects
-                                 typeCache:typeCache
-                           completionBlock:^(NSArray *objects, NSError *error) {
-                               completionBlock(objects, error);
-                           }];
-    } else {
-        completionBlock([NSArray array], nil);
+    for (NSDictionary *dictionary in objectsArray) {
+        NSDictionary *objectDictionary = [dictionary cmis_objectForKeyNotNull:kCMISBrowserJSONObject];
+        if (!objectDictionary) {
+            objectDictionary = dictionary;
+        }
+        
+        if (![objectDictionary isKindOfClass:NSDictionary.class]) {
+            if (outError != NULL) *outError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument detailedDescription:[NSString stringWithFormat:@"expected a dictionary but was %@", objectDictionary.class]];
+            return nil;
+        }
+        
+        CMISObjectData *objectData = [CMISBrowserUtil convertObject:objectDictionary typeCache:typeCache missingTypeId:missingTypeId error:outError];
+        if (!objectData) {
+            return nil;
+        }
+        [objects addObject:objectData];
     }
+    return objects;
 }
 
 + (CMISProperties *)convertProperties:(NSDictionary *)propertiesJson propertiesExtension:(NSDictionary *)extJson error:(NSError **)outError
@@ -583,45 +563,10 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
             continue;
         }
         
-        CMISPropertyType propertyType = [CMISEnums enumForPropertyType:[propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONDatatype]];
-        
-        id propValue = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONValue];
-        NSArray *values = nil;
-        if ([propValue isKindOfClass:NSArray.class]) {
-            values = propValue;
-        } else if (propValue) {
-            values = [NSArray arrayWithObject:propValue];
-        }
-        
-        CMISPropertyData *propertyData;
-        switch (propertyType) {
-            case CMISPropertyTypeString:
-            case CMISPropertyTypeId:
-            case CMISPropertyTypeBoolean:
-            case CMISPropertyTypeInteger:
-            case CMISPropertyTypeDecimal:
-            case CMISPropertyTypeHtml:
-            case CMISPropertyTypeUri:
-                propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:propertyType];
-                break;
-            case CMISPropertyTypeDateTime: {
-                NSArray *dateValues = [CMISBrowserUtil convertNumbersToDates:values];
-                propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:dateValues type:propertyType];
-                break;
-            }
-            default: {
-                if (outError != NULL) *outError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
-                                                 detailedDescription:@"Unknown property type!"];
-                return nil;
-            }
+        CMISPropertyData *propertyData = [CMISBrowserUtil convertProperty:propName propertyDictionary:propertyDictionary error:outError];
+        if (!propertyData) {
+            return nil;
         }
-        propertyData.identifier = propName;
-        propertyData.displayName = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONDisplayName];
-        propertyData.queryName = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONQueryName];
-        propertyData.localName = [propertyDictionary cmis_objectForKeyNotNull:kCMISBrowserJSONLocalName];
-        
-        propertyData.extensions = [CMISObjectConverter convertExtensions:propertyDictionary cmisKeys:[CMISBrowserConstants propertyKeys]];
-        
         [properties addProperty:propertyData];
     }
     
@@ -632,64 +577,68 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
     return properties;
 }
 
-+ (void)convertSuccinctProperties:(NSDictionary *)propertiesJson propertiesExtension:(NSDictionary *)extJson typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void(^)(CMISProperties *properties, NSError *error))completionBlock
+/**
+ * Looks up a type definition in the type cache. Returns NO and sets missingTypeId if it has to be retrieved from the repository first.
+ */
++ (BOOL)cachedTypeDefinition:(NSString *)typeId typeCache:(CMISBrowserTypeCache *)typeCache typeDefinition:(CMISTypeDefinition **)typeDefinition missingTypeId:(NSString **)missingTypeId
 {
-    if (!propertiesJson) {
-        completionBlock(nil, nil);
+    if (!typeCache) { // without a type cache the properties are typed from their values
+        *typeDefinition = nil;
+        return YES;
     }
-    
-    void (^continueConvertSuccinctPropertiesAndGetSecondaryObjectTypeDefinitions)(CMISTypeDefinition*) = ^(CMISTypeDefinition *typeDef) {
-        
-        void (^continueConvertSuccinctPropertiesSecondaryObjectTypeDefinitions)(NSArray*) = ^(NSArray *secTypeDefs) {
-            
-            [self convertProperties:propertiesJson typeCache:typeCache typeDefinition:typeDef secondaryTypeDefinitions:secTypeDefs completionBlock:^(CMISProperties *properties, NSError *error){
-                if(error){
-                    completionBlock(nil, error);
-                } else {
-                    if (extJson){
-                        properties.extensions = [CMISObjectConverter convertExtensions:extJson cmisKeys:[NSSet set]];
-                    }
-                    
-                    completionBlock(properties, nil);
-                }
-            }];
-        };
-        
-        // Get secondary object type definitions
-        NSArray *secTypeIds = [propertiesJson cmis_objectForKeyNotNull:kCMISPropertySecondaryObjectTypeIds];
-        if (secTypeIds != nil && secTypeIds.count > 0) {
-            [CMISBrowserUtil retrieveTypeDefinitions:secTypeIds typeCache:typeCache completionBlock:^(NSArray *typeDefinitions, NSError *error) {
-                if(error){
-                    completionBlock(nil, error);
-                } else {
-                    continueConvertSuccinctPropertiesSecondaryObjectTypeDefinitions(typeDefinitions);
-                }
-            }];
-        } else {
-            continueConvertSuccinctPropertiesSecondaryObjectTypeDefinitions(nil);
-        }
-    };
-    
+    if ([typeCache cachedTypeDefinition:typeId typeDefinition:typeDefinition]) {
+        return YES;
+    }
+    if (missingTypeId != NULL) *missingTypeId = typeId;
+    return NO;
+}
+
++ (CMISProperties *)convertSuccinctProperties:(NSDictionary *)propertiesJson propertiesExtension:(NSDictionary *)extJson typeCache:(CMISBrowserTypeCache *)typeCache missingTypeId:(NSString **)missingTypeId error:(NSError **)outError
+{
     // Get type definition for given object type id
     CMISTypeDefinition *typeDef = nil;
-    if ([[propertiesJson cmis_objectForKeyNotNull:kCMISPropertyObjectTypeId] isKindOfClass:NSString.class]){
-        [typeCache typeDefinition:[propertiesJson cmis_objectForKeyNotNull:kCMISPropertyObjectTypeId] completionBlock:^(CMISTypeDefinition *typeDef, NSError *error){
-            if(error){
-                completionBlock(nil, error);
-            } else {
-                continueConvertSuccinctPropertiesAndGetSecondaryObjectTypeDefinitions(typeDef);
+    id objectTypeId = [propertiesJson cmis_objectForKeyNotNull:kCMISPropertyObjectTypeId];
+    if ([objectTypeId isKindOfClass:NSString.class] &&
+        ![CMISBrowserUtil cachedTypeDefinition:objectTypeId typeCache:typeCache typeDefinition:&typeDef missingTypeId:missingTypeId]) {
+        return nil;
+    }
+    
+    // Get secondary object type definitions
+    NSMutableArray *secTypeDefs = nil;
+    NSArray *secTypeIds = [propertiesJson cmis_objectForKeyNotNull:kCMISPropertySecondaryObjectTypeIds];
+    if ([secTypeIds isKindOfClass:NSArray.class] && secTypeIds.count > 0) {
+        secTypeDefs = [NSMutableArray arrayWithCapacity:secTypeIds.count];
+        for (NSString *secTypeId in secTypeIds) {
+            CMISTypeDefinition *secTypeDef = nil;
+            if (![CMISBrowserUtil cachedTypeDefinition:secTypeId typeCache:typeCache typeDefinition:&secTypeDef missingTypeId:missingTypeId]) {
+                return nil;
             }
-        }];
-    } else {
-        continueConvertSuccinctPropertiesAndGetSecondaryObjectTypeDefinitions(typeDef);
+            if (secTypeDef) {
+                [secTypeDefs addObject:secTypeDef];
+            }
+        }
+    }
+    
+    // create properties
+    CMISProperties *properties = [CMISProperties new];
+    for (NSString *propName in propertiesJson) {
+        CMISPropertyData *propertyData = [CMISBrowserUtil convertProperty:propName propertiesJson:propertiesJson typeCache:typeCache typeDefinition:typeDef secondaryTypeDefinitions:secTypeDefs missingTypeId:missingTypeId error:outError];
+        if (!propertyData) {
+            return nil;
+        }
+        [properties addProperty:propertyData];
+    }
+    
+    if (extJson){
+        properties.extensions = [CMISObjectConverter convertExtensions:extJson cmisKeys:[NSSet set]];
     }
+    
+    return properties;
 }
 
-+(void)convertProperty:(NSString *)propName propertiesJson:(NSDictionary *)propertiesJson typeCache:(CMISBrowserTypeCache *)typeCache typeDefinition:(CMISTypeDefinition *)typeDef secondaryTypeDefinitions:(NSArray *)secTypeDefs completionBlock:(void(^)(CMISPropertyData *propertyData, NSError *error))completionBlock {
-    CMISPropertyDefinition *propDef = nil;
-    if (typeDef){
-        propDef = typeDef.propertyDefinitions[propName];
-    }
++ (CMISPropertyData *)convertProperty:(NSString *)propName propertiesJson:(NSDictionary *)propertiesJson typeCache:(CMISBrowserTypeCache *)typeCache typeDefinition:(CMISTypeDefinition *)typeDef secondaryTypeDefinitions:(NSArray *)secTypeDefs missingTypeId:(NSString **)missingTypeId error:(NSError **)outError
+{
+    CMISPropertyDefinition *propDef = typeDef.propertyDefinitions[propName];
     
     if (propDef == nil && secTypeDefs != nil) {
         for (CMISTypeDefinition *secTypeDef in secTypeDefs) {
@@ -700,108 +649,89 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
         }
     }
     
-    void (^continueConvertSuccinctPropertiesTypeDefinitionDocument)(CMISPropertyDefinition*) = ^(CMISPropertyDefinition *propDef) {
-        
-        void (^continueConvertSuccinctPropertiesTypeDefinitionFolder)(CMISPropertyDefinition*) = ^(CMISPropertyDefinition *propDef) {
-            
-            id propValue = [propertiesJson cmis_objectForKeyNotNull:propName];
-            NSArray *values = nil;
-            if ([propValue isKindOfClass:NSArray.class]) {
-                // validate array, it must not contain null elements
-                for (id value in propValue) {
-                    if (value == [NSNull null]) {
-                        NSError *error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
-                                                         detailedDescription:[NSString stringWithFormat:@"Array of property %@ contains null elements!", propName]];
-                        completionBlock(nil, error);
-                        return;
-                    }
-                }
-                
-                values = propValue;
-            } else if (propValue) {
-                values = [NSArray arrayWithObject:propValue];
-            }
-            
-            CMISPropertyData *propertyData;
-            
-            if (propDef){
-                
-                switch (propDef.propertyType) {
-                    case CMISPropertyTypeString:
-                    case CMISPropertyTypeId:
-                    case CMISPropertyTypeBoolean:
-                    case CMISPropertyTypeInteger:
-                    case CMISPropertyTypeDecimal:
-                    case CMISPropertyTypeHtml:
-                    case CMISPropertyTypeUri:
-                        propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:propDef.propertyType];
-                        break;
-                    case CMISPropertyTypeDateTime: {
-                        NSArray *dateValues = [CMISBrowserUtil convertNumbersToDates:values];
-                        propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:dateValues type:propDef.propertyType];
-                        break;
-                    }
-                    default: {
-                        NSError *error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
-                                                         detailedDescription:[NSString stringWithFormat:@"Unknown property type of property %@!", propName]];
-                        completionBlock(nil, error);
-                        return;
-                    }
-                }
-                propertyData.identifier = propName;
-                propertyData.displayName = propDef.displayName;
-                propertyData.queryName = propDef.queryName;
-                propertyData.localName = propDef.localName;
-            } else {
-                // this else block should only be reached in rare circumstances
-                // it may return incorrect types
-                if (values == nil) {
-                    propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:nil type:CMISPropertyTypeString];
-                } else {
-                    id firstValue = values[0];
-                    if ([firstValue isKindOfClass:NSNumber.class]) {
-                        propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:CMISPropertyTypeInteger];
-                    } else {
-                        propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:CMISPropertyTypeString];
-                    }
-                }
-                
-                propertyData.identifier = propName;
-                propertyData.displayName = propName;
-                propertyData.queryName = nil;
-                propertyData.localName = nil;
+    if (!propDef) { //try to find property definition on document
+        CMISTypeDefinition *typeDefinition = nil;
+        if (![CMISBrowserUtil cachedTypeDefinition:kCMISPropertyObjectTypeIdValueDocument typeCache:typeCache typeDefinition:&typeDefinition missingTypeId:missingTypeId]) {
+            return nil;
+        }
+        propDef = typeDefinition.propertyDefinitions[propName];
+    }
+    
+    if (!propDef) { //try to find property definition on folder
+        CMISTypeDefinition *typeDefinition = nil;
+        if (![CMISBrowserUtil cachedTypeDefinition:kCMISPropertyObjectTypeIdValueFolder typeCache:typeCache typeDefinition:&typeDefinition missingTypeId:missingTypeId]) {
+            return nil;
+        }
+        propDef = typeDefinition.propertyDefinitions[propName];
+    }
+    
+    id propValue = [propertiesJson cmis_objectForKeyNotNull:propName];
+    NSArray *values = nil;
+    if ([propValue isKindOfClass:NSArray.class]) {
+        // validate array, it must not contain null elements
+        for (id value in propValue) {
+            if (value == [NSNull null]) {
+                if (outError != NULL) *outError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
+                                                                  detailedDescription:[NSString stringWithFormat:@"Array of property %@ contains null elements!", propName]];
+                return nil;
             }
-            
-            completionBlock(propertyData, nil);
-        };
-        
-        if (!propDef) { //try to find property definition on folder
-            [typeCache typeDefinition:kCMISPropertyObjectTypeIdValueFolder completionBlock:^(CMISTypeDefinition *typeDefinition, NSError *error) {
-                if (error){
-                    completionBlock(nil, error);
-                } else {
-                    CMISPropertyDefinition *propertyDefinition = typeDefinition.propertyDefinitions[propName];
-                    continueConvertSuccinctPropertiesTypeDefinitionFolder(propertyDefinition);
-                }
-            }];
-        } else {
-            continueConvertSuccinctPropertiesTypeDefinitionFolder(propDef);
         }
         
-    };
+        values = propValue;
+    } else if (propValue) {
+        values = [NSArray arrayWithObject:propValue];
+    }
     
-    if (!propDef) { //try to find property definition on document
-        [typeCache typeDefinition:kCMISPropertyObjectTypeIdValueDocument completionBlock:^(CMISTypeDefinition *typeDefinition, NSError *error) {
-            if (error){
-                completionBlock(nil, error);
-            } else {
-                CMISPropertyDefinition *propertyDefinition = typeDefinition.propertyDefinitions[propName];
-                continueConvertSuccinctPropertiesTypeDefinitionDocument(propertyDefinition);
+    CMISPropertyData *propertyData;
+    
+    if (propDef){
+        
+        switch (propDef.propertyType) {
+            case CMISPropertyTypeString:
+            case CMISPropertyTypeId:
+            case CMISPropertyTypeBoolean:
+            case CMISPropertyTypeInteger:
+            case CMISPropertyTypeDecimal:
+            case CMISPropertyTypeHtml:
+            case CMISPropertyTypeUri:
+                propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:propDef.propertyType];
+                break;
+            case CMISPropertyTypeDateTime: {
+                NSArray *dateValues = [CMISBrowserUtil convertNumbersToDates:values];
+                propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:dateValues type:propDef.propertyType];
+                break;
             }
-        }];
+            default: {
+                if (outError != NULL) *outError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
+                                                                  detailedDescription:[NSString stringWithFormat:@"Unknown property type of property %@!", propName]];
+                return nil;
+            }
+        }
+        propertyData.identifier = propName;
+        propertyData.displayName = propDef.displayName;
+        propertyData.queryName = propDef.queryName;
+        propertyData.localName = propDef.localName;
     } else {
-        continueConvertSuccinctPropertiesTypeDefinitionDocument(propDef);
+        // this else block should only be reached in rare circumstances
+        // it may return incorrect types
+        if (values == nil) {
+            propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:nil type:CMISPropertyTypeString];
+        } else {
+            id firstValue = values[0];
+            if ([firstValue isKindOfClass:NSNumber.class]) {
+                propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:CMISPropertyTypeInteger];
+            } else {
+                propertyData = [CMISPropertyData createPropertyForId:propName arrayValue:values type:CMISPropertyTypeString];
+            }
+        }
+        
+        propertyData.identifier = propName;
+        propertyData.displayName = propName;
+        propertyData.queryName = nil;
+        propertyData.localName = nil;
     }
+    
+    return propertyData;
 }
 
 + (NSArray *)convertNumbersToDates:(NSArray *)numbers
@@ -826,69 +756,6 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
     return [NSDate dateWithTimeIntervalSince1970:[miliseconds unsignedLongLongValue] / 1000.0]; // miliseconds to seconds
 }
 
-+ (void)convertProperties:(NSArray*)propNames position:(NSInteger)position properties:(CMISProperties *)properties propertiesJson:(NSDictionary *)propertiesJson typeCache:(CMISBrowserTypeCache *)typeCache typeDefinition:(CMISTypeDefinition *)typeDef secondaryTypeDefinitions:(NSArray *)secTypeDefs completionBlock:(void (^)(CMISProperties *properties, NSError *error))completionBlock
-{
-    NSString *propName = [propNames objectAtIndex:position];
-    
-    [self convertProperty:propName
-           propertiesJson:propertiesJson
-                typeCache:typeCache
-           typeDefinition:typeDef
- secondaryTypeDefinitions:secTypeDefs
-          completionBlock:^(CMISPropertyData *propertyData, NSError *error) {
-              if (error){
-                  completionBlock(nil, error);
-              } else {
-                  if (position == 0) {
-                      [properties addProperty:propertyData];
-                      completionBlock(properties, nil);
-                  } else {
-                      // TODO check if there is a better way on how to avoid a large call stack
-                      // We need to do this workaround or else we would end up with a very large call stack
-                      [CMISBrowserUtil performBlock:^{
-                          [self convertProperties:propNames
-                                         position:(position -1)
-                                       properties:properties
-                                   propertiesJson:propertiesJson
-                                        typeCache:typeCache
-                                   typeDefinition:typeDef
-                         secondaryTypeDefinitions:secTypeDefs
-                                  completionBlock:^(CMISProperties *properties, NSError *error) {
-                                      if (error){
-                                          completionBlock(nil, error);
-                                      } else {
-                                          [properties addProperty:propertyData];
-                                          completionBlock(properties, nil);
-                                      }
-                                  }];
-                      }];
-                  }
-              }
-          }];
-}
-
-+ (void)convertProperties:(NSDictionary *)propertiesJson typeCache:(CMISBrowserTypeCache *)typeCache typeDefinition:(CMISTypeDefinition *)typeDef secondaryTypeDefinitions:(NSArray *)secTypeDefs completionBlock:(void(^)(CMISProperties *properties, NSError *error))completionBlock
-{
-    // create properties
-    CMISProperties *properties = [CMISProperties new];
-    
-    NSArray *propNames = [propertiesJson allKeys];
-    if (propNames.count > 0) {
-        [CMISBrowserUtil convertProperties:propNames
-                                        position:(propNames.count - 1) // start recursion with last item
-                                properties:properties
-                            propertiesJson:propertiesJson
-                                 typeCache:typeCache
-                            typeDefinition:typeDef
-                  secondaryTypeDefinitions:secTypeDefs
-                           completionBlock:^(CMISProperties *properties, NSError *error) {
-                                     completionBlock(properties, error);
-                                 }];
-    } else {
-        completionBlock(properties, nil);
-    }
-}
-
 + (CMISRepositoryCapabilities *)convertRepositoryCapabilities:(NSDictionary *)jsonDictionary
 {
     if (!jsonDictionary){
@@ -1000,45 +867,6 @@ NSString * const kCMISBrowserMaxValueECMJSONProperty = @"\"maxValue\":1797693134
     return result;
 }
 
-+ (void)retrieveTypeDefinitions:(NSArray *)objectTypeIds position:(NSInteger)position typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void (^)(NSMutableArray *typeDefinitions, NSError *error))completionBlock
-{
-    [typeCache typeDefinition:[objectTypeIds objectAtIndex:position]
-              completionBlock:^(CMISTypeDefinition *typeDefinition, NSError *error) {
-                             if (error){
-                                 completionBlock(nil, error);
-                             } else {
-                                 if (position == 0) {
-                                     NSMutableArray *typeDefinitions = [[NSMutableArray alloc] initWithCapacity:objectTypeIds.count];
-                                     [typeDefinitions addObject:typeDefinition];
-                                     completionBlock(typeDefinitions, error);
-                                 } else {
-                                     [self retrieveTypeDefinitions:objectTypeIds position:(position - 1) typeCache:typeCache completionBlock:^(NSMutableArray *typeDefinitions, NSError *error) {
-                                         if(error) {
-                                             completionBlock(nil, error);
-                                         } else {
-                                             [typeDefinitions addObject:typeDefinition];
-                                             completionBlock(typeDefinitions, nil);
-                                         }
-                                     }];
-                                 }
-                             }
-                         }];
-}
-
-+ (void)retrieveTypeDefinitions:(NSArray *)objectTypeIds typeCache:(CMISBrowserTypeCache *)typeCache completionBlock:(void (^)(NSArray *typeDefinitions, NSError *error))completionBlock
-{
-    if (objectTypeIds.count > 0) {
-        [CMISBrowserUtil retrieveTypeDefinitions:objectTypeIds
-                                        position:(objectTypeIds.count - 1) // start recursion with last item
-                                       typeCache:typeCache
-                                 completionBlock:^(NSMutableArray *typeDefinitions, NSError *error) {
-                                     completionBlock(typeDefinitions, error);
-                                 }];
-    } else {
-        completionBlock([[NSArray alloc] init], nil);
-    }
-}
-
 + (NSArray *)renditionsFromArray:(NSArray *)array
 {
     if (!array) {
@@ -26,6 +26,7 @@
 #import "CMISConstants.h"
 #import "CMISErrors.h"
 #import "CMISBroswerFormDataWriter.h"
+#import "CMISMultipartFormDataStream.h"
 #import "CMISFileUtil.h"
 #import "CMISLog.h"
 #import "CMISBrowserTypeCache.h"
@@ -302,15 +303,17 @@
     CMISRequest *cmisRequest = [[CMISRequest alloc] init];
     
     // send
+    // the multipart body is generated while it is sent, its length is known if the content length is
+    CMISMultipartFormDataStream *bodyStream = [formData bodyStreamWithContentLength:(bytesExpected > 0 ? (long long)bytesExpected : -1)];
     [self.bindingSession.networkProvider invoke:[NSURL URLWithString:objectUrl]
                                      httpMethod:HTTP_POST
                                         session:self.bindingSession
-                                    inputStream:inputStream
+                                    inputStream:bodyStream
                                         headers:formData.headers
-                                  bytesExpected:bytesExpected
+                                  bytesExpected:MAX(bodyStream.length, 0)
                                     cmisRequest:cmisRequest
-                                      startData:formData.startData
-                                        endData:formData.endData
+                                      startData:nil
+                                        endData:nil
                               useBase64Encoding:NO
                                 completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
                                     if ((httpResponse.statusCode == 200 || httpResponse.statusCode == 201) && httpResponse.data) {
@@ -23,6 +23,10 @@
 #import "CMISNetworkProvider.h"
 #import "CMISTypeDefinitionCache.h"
 
+@class CMISHttpValidationCache;
+@class CMISRetryPolicy;
+@class CMISCircuitBreaker;
+
 // session key constants
 extern NSString * const kCMISBindingSessionKeyUrl;
 
@@ -33,6 +37,9 @@ extern NSString * const kCMISBindingSessionKeyUrl;
 @property (nonatomic, strong, readonly) id<CMISAuthenticationProvider> authenticationProvider;
 @property (nonatomic, strong, readonly) id<CMISNetworkProvider> networkProvider;
 @property (nonatomic, strong, readonly) CMISTypeDefinitionCache *typeDefinitionCache;
+@property (nonatomic, strong, readonly) CMISHttpValidationCache *validationCache;
+@property (nonatomic, strong, readonly) CMISRetryPolicy *retryPolicy;
+@property (nonatomic, strong, readonly) CMISCircuitBreaker *circuitBreaker;
 
 - (id)initWithSessionParameters:(CMISSessionParameters *)sessionParameters;
 
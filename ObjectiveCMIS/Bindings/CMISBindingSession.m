@@ -18,6 +18,10 @@
  */
 
 #import "CMISBindingSession.h"
+#import "CMISURLSessionPool.h"
+#import "CMISHttpValidationCache.h"
+#import "CMISRetryPolicy.h"
+#import "CMISCircuitBreaker.h"
 
 NSString * const kCMISBindingSessionKeyUrl = @"cmis_session_key_url";
 
@@ -27,6 +31,9 @@ NSString * const kCMISBindingSessionKeyUrl = @"cmis_session_key_url";
 @property (nonatomic, strong, readwrite) id<CMISAuthenticationProvider> authenticationProvider;
 @property (nonatomic, strong, readwrite) id<CMISNetworkProvider> networkProvider;
 @property (nonatomic, strong, readwrite) CMISTypeDefinitionCache *typeDefinitionCache;
+@property (nonatomic, strong, readwrite) CMISHttpValidationCache *validationCache;
+@property (nonatomic, strong, readwrite) CMISRetryPolicy *retryPolicy;
+@property (nonatomic, strong, readwrite) CMISCircuitBreaker *circuitBreaker;
 @property (nonatomic, strong, readwrite) NSMutableDictionary *sessionData;
 @end
 
@@ -68,11 +75,25 @@ NSString * const kCMISBindingSessionKeyUrl = @"cmis_session_key_url";
         } else {
             self.typeDefinitionCache = sessionParameters.typeDefinitionCache;
         }
+        
+        self.validationCache = [[CMISHttpValidationCache alloc] initWithBindingSession:self];
+        self.retryPolicy = [[CMISRetryPolicy alloc] initWithBindingSession:self];
+        
+        id circuitBreakerEnabled = [self objectForKey:kCMISSessionParameterCircuitBreakerEnabled];
+        if (!circuitBreakerEnabled || [circuitBreakerEnabled boolValue]) {
+            self.circuitBreaker = [[CMISCircuitBreaker alloc] initWithBindingSession:self];
+        }
     }
     
     return self;
 }
 
+- (void)dealloc
+{
+    // give the pooled network sessions back, they are invalidated once no other binding session uses them
+    [[CMISURLSessionPool sharedPool] releaseSessionsForBindingSession:self];
+}
+
 - (NSArray *)allKeys
 {
     return [self.sessionData allKeys];
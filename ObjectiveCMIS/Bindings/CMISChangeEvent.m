@@ -18,7 +18,18 @@
  */
 
 #import "CMISChangeEvent.h"
+#import "CMISAcl.h"
 
 @implementation CMISChangeEvent
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISChangeEvent *changeEvent = [super copyWithZone:zone];
+    changeEvent.objectId = self.objectId;
+    changeEvent.properties = self.properties;
+    changeEvent.policyIds = self.policyIds;
+    changeEvent.acl = [self.acl copy];
+    return changeEvent;
+}
+
 @end
@@ -23,7 +23,7 @@
 /**
  * Class to hold the basic change event.
  */
-@interface CMISChangeEventInfo : CMISExtensionData
+@interface CMISChangeEventInfo : CMISExtensionData <NSCopying>
 
 /**
  * Change event type, not nil
@@ -21,4 +21,13 @@
 
 @implementation CMISChangeEventInfo
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISChangeEventInfo *changeEventInfo = [[[self class] allocWithZone:zone] init];
+    changeEventInfo.extensions = self.extensions;
+    changeEventInfo.changeType = self.changeType;
+    changeEventInfo.changeTime = self.changeTime;
+    return changeEventInfo;
+}
+
 @end
@@ -21,4 +21,12 @@
 
 @implementation CMISDocumentTypeDefinition
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISDocumentTypeDefinition *typeDefinition = [super copyWithZone:zone];
+    typeDefinition.versionable = self.versionable;
+    typeDefinition.contentStreamAllowed = self.contentStreamAllowed;
+    return typeDefinition;
+}
+
 @end
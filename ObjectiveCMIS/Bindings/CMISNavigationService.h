@@ -22,6 +22,7 @@
 
 @class CMISFolder;
 @class CMISObjectList;
+@class CMISObjectData;
 @class CMISRequest;
 
 @protocol CMISNavigationService <NSObject>
@@ -69,4 +70,24 @@
                                            maxItems:(NSNumber *)maxItems
                                     completionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock;
 
+@optional
+
+/**
+ * Retrieves the children for the given object identifier, handing over each child while the response is received.
+ * entryBlock is called on the calling thread for each child as soon as it has been parsed; the children are not
+ * collected, so the object list returned by the completionBlock has no objects.
+ * completionBlock returns object list or nil if unsuccessful
+ */
+- (CMISRequest*)retrieveChildren:(NSString *)objectId
+                         orderBy:(NSString *)orderBy
+                          filter:(NSString *)filter
+                   relationships:(CMISIncludeRelationship)relationships
+                 renditionFilter:(NSString *)renditionFilter
+         includeAllowableActions:(BOOL)includeAllowableActions
+              includePathSegment:(BOOL)includePathSegment
+                       skipCount:(NSNumber *)skipCount
+                        maxItems:(NSNumber *)maxItems
+                      entryBlock:(void (^)(CMISObjectData *objectData))entryBlock
+                 completionBlock:(void (^)(CMISObjectList *objectList, NSError *error))completionBlock;
+
 @end
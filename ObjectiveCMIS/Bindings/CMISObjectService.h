@@ -159,6 +159,26 @@
                       completionBlock:(void (^)(NSError *error))completionBlock
                         progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock;
 
+/**
+ * Appends the content from the given input stream to the content stream of the given document (CMIS 1.1).
+ *
+ * It is recommended that a mime type is provided. In case no value is given - the mime type defaults to application/octet-stream.
+ * isLastChunk: If TRUE, the repository is told that this is the last part of the content stream.
+ *
+ * NOTE for atom pub binding: This does not return the new object id and change token as specified by the domain model.
+ * (This is not possible without introducing a new HTTP header).
+ * completionBlock - returns NSError nil if successful
+ */
+- (CMISRequest*)appendContentOfObject:(CMISStringInOutParameter *)objectIdParam
+                      fromInputStream:(NSInputStream *)inputStream
+                        bytesExpected:(unsigned long long)bytesExpected
+                             filename:(NSString *)filename
+                             mimeType:(NSString *)mimeType
+                          isLastChunk:(BOOL)isLastChunk
+                          changeToken:(CMISStringInOutParameter *)changeTokenParam
+                      completionBlock:(void (^)(NSError *error))completionBlock
+                        progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock;
+
 /**
  * uploads the file from the given path to the given folder.
  *
@@ -28,7 +28,7 @@
 
 
 // TODO: type specific properties, see cmis spec line 527
-@interface CMISPropertyDefinition : CMISExtensionData
+@interface CMISPropertyDefinition : CMISExtensionData <NSCopying>
 
 
 @property (nonatomic, strong) NSString *identifier;
@@ -26,4 +26,27 @@
 
 @implementation CMISPropertyDefinition
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISPropertyDefinition *propertyDefinition = [[[self class] allocWithZone:zone] init];
+    propertyDefinition.extensions = self.extensions;
+    propertyDefinition.identifier = self.identifier;
+    propertyDefinition.localName = self.localName;
+    propertyDefinition.localNamespace = self.localNamespace;
+    propertyDefinition.displayName = self.displayName;
+    propertyDefinition.queryName = self.queryName;
+    propertyDefinition.summary = self.summary;
+    propertyDefinition.propertyType = self.propertyType;
+    propertyDefinition.cardinality = self.cardinality;
+    propertyDefinition.updatability = self.updatability;
+    propertyDefinition.inherited = self.inherited;
+    propertyDefinition.required = self.required;
+    propertyDefinition.queryable = self.queryable;
+    propertyDefinition.orderable = self.orderable;
+    propertyDefinition.openChoice = self.openChoice;
+    propertyDefinition.defaultValues = self.defaultValues;
+    propertyDefinition.choices = self.choices;
+    return propertyDefinition;
+}
+
 @end
\ No newline at end of file
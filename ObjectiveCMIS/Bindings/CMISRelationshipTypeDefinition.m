@@ -21,4 +21,12 @@
 
 @implementation CMISRelationshipTypeDefinition
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISRelationshipTypeDefinition *typeDefinition = [super copyWithZone:zone];
+    typeDefinition.allowedSourceTypes = self.allowedSourceTypes;
+    typeDefinition.allowedTargetTypes = self.allowedTargetTypes;
+    return typeDefinition;
+}
+
 @end
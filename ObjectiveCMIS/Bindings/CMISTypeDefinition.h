@@ -23,8 +23,8 @@
 
 @class CMISPropertyDefinition;
 
-
-@interface CMISTypeDefinition : CMISExtensionData
+/// A type definition, a copy contains copies of the property definitions.
+@interface CMISTypeDefinition : CMISExtensionData <NSCopying>
 
 @property (nonatomic, strong) NSString *identifier;
 @property (nonatomic, strong) NSString *localName;
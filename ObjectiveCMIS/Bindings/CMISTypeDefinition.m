@@ -29,6 +29,31 @@
 
 @implementation CMISTypeDefinition
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISTypeDefinition *typeDefinition = [[[self class] allocWithZone:zone] init];
+    typeDefinition.extensions = self.extensions;
+    typeDefinition.identifier = self.identifier;
+    typeDefinition.localName = self.localName;
+    typeDefinition.localNamespace = self.localNamespace;
+    typeDefinition.displayName = self.displayName;
+    typeDefinition.queryName = self.queryName;
+    typeDefinition.summary = self.summary;
+    typeDefinition.baseTypeId = self.baseTypeId;
+    typeDefinition.parentTypeId = self.parentTypeId;
+    typeDefinition.creatable = self.creatable;
+    typeDefinition.fileable = self.fileable;
+    typeDefinition.queryable = self.queryable;
+    typeDefinition.fullTextIndexed = self.fullTextIndexed;
+    typeDefinition.includedInSupertypeQuery = self.includedInSupertypeQuery;
+    typeDefinition.controllablePolicy = self.controllablePolicy;
+    typeDefinition.controllableAcl = self.controllableAcl;
+    for (CMISPropertyDefinition *propertyDefinition in self.internalPropertyDefinitions.allValues) {
+        [typeDefinition addPropertyDefinition:[propertyDefinition copy]];
+    }
+    return typeDefinition;
+}
+
 - (NSDictionary *)propertyDefinitions
 {
     return self.internalPropertyDefinitions;
@@ -131,6 +131,22 @@
                                     completionBlock:(void (^)(NSError *error))completionBlock
                                       progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock;
 
+/**
+ * Changes the content of this document to the content of the given file, uploading it in parts (CMIS 1.1).
+ *
+ * Each part is sent with its own request, the part size is set with kCMISSessionParameterUploadPartSize.
+ * If a checkpoint file path is given, an upload that failed or was cancelled can be resumed by calling this method again
+ * with the same file and checkpoint file: only the parts the repository has not stored yet are sent.
+ * partCompletionBlock is called for each part acknowledged by the repository with the rate (in bytes per second) it was sent at.
+ * completionBlock will return NSError nil if successful
+ */
+- (CMISRequest*)changeContentToContentOfFile:(NSString *)filePath
+                                    mimeType:(NSString *)mimeType
+                          checkpointFilePath:(NSString *)checkpointFilePath
+                             completionBlock:(void (^)(NSError *error))completionBlock
+                         partCompletionBlock:(void (^)(NSUInteger partIndex, unsigned long long partLength, double bytesPerSecond))partCompletionBlock
+                               progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock;
+
 /**
  * Deletes the content of this document.
  * completionBlock will return NSError nil if successful
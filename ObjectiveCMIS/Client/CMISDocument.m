@@ -26,6 +26,18 @@
 #import "CMISRequest.h"
 #import "CMISSession.h"
 #import "CMISLog.h"
+#import "CMISParallelDownload.h"
+#import "CMISChunkedUpload.h"
+#import "CMISContentHasher.h"
+
+// Default number of concurrent range requests used to download content to a file
+#define DEFAULT_PARALLEL_DOWNLOAD_RANGES 1
+
+// Default minimum content length for downloads with concurrent range requests
+#define DEFAULT_PARALLEL_DOWNLOAD_MINIMUM_LENGTH (16 * 1024 * 1024)
+
+// Default size of the parts of a chunked upload
+#define DEFAULT_UPLOAD_PART_SIZE (8 * 1024 * 1024)
 
 @interface CMISDocument()
 
@@ -117,6 +129,31 @@
                                                progressBlock:progressBlock];
 }
 
+- (CMISRequest*)changeContentToContentOfFile:(NSString *)filePath
+                                    mimeType:(NSString *)mimeType
+                          checkpointFilePath:(NSString *)checkpointFilePath
+                             completionBlock:(void (^)(NSError *error))completionBlock
+                         partCompletionBlock:(void (^)(NSUInteger partIndex, unsigned long long partLength, double bytesPerSecond))partCompletionBlock
+                               progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock
+{
+    unsigned long long partSize = [[self.session.sessionParameters objectForKey:kCMISSessionParameterUploadPartSize
+                                                                   defaultValue:@(DEFAULT_UPLOAD_PART_SIZE)] unsignedLongLongValue];
+    
+    CMISRequest *request = [[CMISRequest alloc] init];
+    CMISChunkedUpload *upload = [[CMISChunkedUpload alloc] initWithObjectService:self.binding.objectService
+                                                                        objectId:self.identifier
+                                                                     changeToken:self.changeToken
+                                                                        partSize:partSize];
+    [upload uploadContentOfFile:filePath
+                       mimeType:mimeType
+             checkpointFilePath:checkpointFilePath
+                    cmisRequest:request
+                completionBlock:completionBlock
+            partCompletionBlock:partCompletionBlock
+                  progressBlock:progressBlock];
+    return request;
+}
+
 - (CMISRequest*)deleteContentWithCompletionBlock:(void (^)(NSError *error))completionBlock
 {
     return [self.binding.objectService deleteContentOfObject:[CMISStringInOutParameter inOutParameterUsingInParameter:self.identifier]
@@ -156,11 +193,49 @@
                       completionBlock:(void (^)(NSError *error))completionBlock
                         progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
 {
-    return [self.binding.objectService downloadContentOfObject:self.identifier
-                                                      streamId:nil
-                                                        toFile:filePath
-                                               completionBlock:completionBlock
-                                                 progressBlock:progressBlock];
+    // large content is split into ranges that are downloaded at the same time
+    NSUInteger rangeCount = [[self.session.sessionParameters objectForKey:kCMISSessionParameterParallelDownloadRanges
+                                                             defaultValue:@(DEFAULT_PARALLEL_DOWNLOAD_RANGES)] unsignedIntegerValue];
+    unsigned long long minimumLength = [[self.session.sessionParameters objectForKey:kCMISSessionParameterParallelDownloadMinimumLength
+                                                                        defaultValue:@(DEFAULT_PARALLEL_DOWNLOAD_MINIMUM_LENGTH)] unsignedLongLongValue];
+    if (rangeCount > 1 && self.contentStreamLength > 0 && self.contentStreamLength >= minimumLength) {
+        CMISRequest *request = [[CMISRequest alloc] init];
+        CMISParallelDownload *download = [[CMISParallelDownload alloc] initWithObjectService:self.binding.objectService
+                                                                                    objectId:self.identifier
+                                                                                    streamId:nil
+                                                                               contentLength:self.contentStreamLength
+                                                                                  rangeCount:rangeCount];
+        CMISContentHashAlgorithm algorithm = [[self.session.sessionParameters objectForKey:kCMISSessionParameterContentHashAlgorithm
+                                                                              defaultValue:@(CMISContentHashAlgorithmNone)] integerValue];
+        if ([CMISContentHasher nameForAlgorithm:algorithm]) {
+            download.contentHasher = [[CMISContentHasher alloc] initWithAlgorithm:algorithm];
+        }
+        [download downloadToFile:filePath cmisRequest:request completionBlock:^(NSError *error) {
+            if (!error) {
+                error = [self verifyContentHashOfRequest:request];
+            }
+            if (completionBlock) {
+                completionBlock(error);
+            }
+        } progressBlock:progressBlock];
+        return request;
+    }
+    
+    __block CMISRequest *request = nil;
+    request = [self.binding.objectService downloadContentOfObject:self.identifier
+                                                         streamId:nil
+                                                           toFile:filePath
+                                                  completionBlock:^(NSError *error) {
+                                                      if (!error) {
+                                                          error = [self verifyContentHashOfRequest:request];
+                                                      }
+                                                      request = nil;
+                                                      if (completionBlock) {
+                                                          completionBlock(error);
+                                                      }
+                                                  }
+                                                    progressBlock:progressBlock];
+    return request;
 }
 
 
@@ -168,11 +243,23 @@
                               completionBlock:(void (^)(NSError *error))completionBlock
                                 progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
 {
-    return [self downloadContentToOutputStream:outputStream
-                                        offset:nil
-                                        length:nil
-                               completionBlock:completionBlock
-                                 progressBlock:progressBlock];
+    __block CMISRequest *request = nil;
+    request = [self.binding.objectService downloadContentOfObject:self.identifier
+                                                         streamId:nil
+                                                   toOutputStream:outputStream
+                                                           offset:nil
+                                                           length:nil
+                                                  completionBlock:^(NSError *error) {
+                                                      if (!error) {
+                                                          error = [self verifyContentHashOfRequest:request];
+                                                      }
+                                                      request = nil;
+                                                      if (completionBlock) {
+                                                          completionBlock(error);
+                                                      }
+                                                  }
+                                                    progressBlock:progressBlock];
+    return request;
 }
 
 - (CMISRequest*)downloadContentToFile:(NSString *)filePath
@@ -303,4 +390,26 @@
     } progressBlock:progressBlock];
 }
 
+#pragma mark -
+#pragma mark Private helper methods
+
+/// compares the hash computed while downloading the content with the cmis:contentStreamHash values of the document
+- (NSError *)verifyContentHashOfRequest:(CMISRequest *)request
+{
+    NSString *contentHash = request.contentHash;
+    if (contentHash == nil) {
+        return nil; // content hashing is not enabled or the content was not hashed
+    }
+    
+    NSArray *contentStreamHashes = [self.properties propertyMultiValueById:kCMISPropertyContentStreamHash];
+    if ([CMISContentHasher hash:contentHash matchesContentStreamHashes:contentStreamHashes]) {
+        return nil;
+    }
+    
+    CMISLogError(@"Content of document %@ has hash %@, the repository reported %@", self.identifier, contentHash, contentStreamHashes);
+    return [CMISErrors createCMISErrorWithCode:kCMISErrorCodeContentHashMismatch
+                           detailedDescription:[NSString stringWithFormat:@"Downloaded content has hash %@, expected one of %@",
+                                                contentHash, [contentStreamHashes componentsJoinedByString:@", "]]];
+}
+
 @end
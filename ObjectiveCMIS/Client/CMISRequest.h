@@ -18,12 +18,17 @@
  */
 
 #import <Foundation/Foundation.h>
+#import "CMISEnums.h"
 
 @class CMISHttpRequest;
 @protocol CMISCancellableRequest <NSObject>
 
 - (void)cancel;
 
+@optional
+/// called when the priority of the CMISRequest changes, so a request that has not been started yet can be re-queued
+- (void)updatePriority:(CMISRequestPriority)priority;
+
 @end
 
 @interface CMISRequest : NSObject
@@ -31,6 +36,14 @@
 @property (nonatomic, strong) id httpRequest;
 @property (nonatomic, readonly, getter = isCancelled) BOOL cancelled;
 
+/// the priority used to schedule the network request, by default the priority configured for the session is used.
+/// Changing it while the request is waiting for a slot moves the request to the queue of the new priority.
+@property (nonatomic, assign) CMISRequestPriority priority;
+
+/// the hash of the content uploaded or downloaded by the request, available once the request has completed
+/// if kCMISSessionParameterContentHashAlgorithm is set, in the format of cmis:contentStreamHash (e.g. "{sha-256}...")
+@property (strong) NSString *contentHash;
+
 /**
  cancel a network request
  */
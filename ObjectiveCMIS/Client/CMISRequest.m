@@ -45,6 +45,13 @@
     }
 }
 
+- (void)setPriority:(CMISRequestPriority)priority
+{
+    _priority = priority;
+    if ([self.httpRequest respondsToSelector:@selector(updatePriority:)]) {
+        [self.httpRequest updatePriority:priority];
+    }
+}
 
 - (void)setHttpRequest:(id)httpRequest
 {
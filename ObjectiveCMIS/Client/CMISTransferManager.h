@@ -0,0 +1,147 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CMISEnums.h"
+#import "CMISRequest.h"
+
+@class CMISSession;
+@class CMISFolder;
+@class CMISDocument;
+
+/**
+ * A single upload of a file to a folder or download of a document to a file, run by a CMISTransferManager.
+ */
+@interface CMISTransferJob : NSObject <CMISCancellableRequest>
+
+@property (nonatomic, assign, readonly) CMISTransferType type;
+
+/// the file uploaded or downloaded to
+@property (nonatomic, strong, readonly) NSString *filePath;
+
+/// the folder the document is created in (uploads only)
+@property (nonatomic, strong, readonly) CMISFolder *folder;
+
+/// the properties of the created document (uploads only)
+@property (nonatomic, strong, readonly) NSDictionary *properties;
+
+/// the mime type of the created document (uploads only)
+@property (nonatomic, strong, readonly) NSString *mimeType;
+
+/// the document whose content is downloaded (downloads only)
+@property (nonatomic, strong, readonly) CMISDocument *document;
+
+/// the number of bytes to transfer, used to order the jobs
+@property (nonatomic, assign, readonly) unsigned long long size;
+
+@property (nonatomic, assign, readonly) CMISTransferState state;
+
+/// the number of bytes transferred by the current attempt
+@property (nonatomic, assign, readonly) unsigned long long bytesTransferred;
+
+/// the number of times the transfer has been started
+@property (nonatomic, assign, readonly) NSUInteger attemptCount;
+
+/// the id of the created document once an upload has succeeded
+@property (nonatomic, strong, readonly) NSString *objectId;
+
+/// the error of the last attempt if the job failed or was cancelled
+@property (nonatomic, strong, readonly) NSError *error;
+
+/// called when the job has succeeded, failed after all retries or was cancelled
+@property (nonatomic, copy) void (^completionBlock)(CMISTransferJob *job);
+
+/// creates a job uploading the file to a new document in the given folder
++ (CMISTransferJob *)uploadJobWithFilePath:(NSString *)filePath
+                                  mimeType:(NSString *)mimeType
+                                properties:(NSDictionary *)properties
+                                  toFolder:(CMISFolder *)folder;
+
+/// creates a job downloading the content of the given document to a file
++ (CMISTransferJob *)downloadJobWithDocument:(CMISDocument *)document toFilePath:(NSString *)filePath;
+
+/// cancels the job, whether it is queued, waiting for a retry or running
+- (void)cancel;
+
+@end
+
+
+/**
+ * Runs many uploads and downloads with a limited number of concurrent transfers.
+ *
+ * Queued jobs are started largest first: the big transfers run alongside many small ones instead of being left on
+ * their own at the end of a batch, which keeps all transfer slots busy until the batch is done. Failed downloads are
+ * started again after a growing delay as long as the error is transient (connection problems), up to the maximum
+ * number of retries. Downloads rejected by an open circuit breaker fail right away, the breaker stays open longer than
+ * the retries would wait. Failed uploads are not retried automatically: the document may have been created even though
+ * the response was lost, so an upload is only started again with retryJob:. With a bandwidth limit, all transfers
+ * together are held to the given rate.
+ *
+ * The manager and its jobs must be used on one thread with a run loop, all blocks are called on that thread.
+ */
+@interface CMISTransferManager : NSObject
+
+@property (nonatomic, strong, readonly) CMISSession *session;
+
+/// the maximum number of jobs running at the same time, default is 4
+@property (nonatomic, assign) NSUInteger maxConcurrentTransfers;
+
+/// the maximum rate in bytes per second of all transfers together, 0 (the default) means unlimited
+@property (nonatomic, assign) unsigned long long bandwidthLimit;
+
+/// the number of times a download failing with a transient error is started again, default is 2
+@property (nonatomic, assign) NSUInteger maxRetries;
+
+/// the delay before the first retry of a job in seconds, doubled with every further retry, default is 1
+@property (nonatomic, assign) NSTimeInterval retryDelay;
+
+/// the jobs of the current batch, finished jobs are dropped once all jobs of the batch have finished
+@property (nonatomic, strong, readonly) NSArray *jobs;
+
+/// the number of bytes of all jobs that have not been cancelled
+@property (nonatomic, assign, readonly) unsigned long long bytesTotal;
+
+/// the number of bytes of the succeeded jobs and transferred so far by the running jobs
+@property (nonatomic, assign, readonly) unsigned long long bytesTransferred;
+
+/// the rate of all transfers together over the last few seconds
+@property (nonatomic, assign, readonly) double bytesPerSecond;
+
+@property (nonatomic, assign, readonly) NSUInteger queuedJobCount;
+@property (nonatomic, assign, readonly) NSUInteger runningJobCount;
+
+/// called whenever a transfer made progress
+@property (nonatomic, copy) void (^progressBlock)(unsigned long long bytesTransferred, unsigned long long bytesTotal, double bytesPerSecond);
+
+/// called when no job is queued, waiting for a retry or running anymore, with the jobs that failed
+@property (nonatomic, copy) void (^completionBlock)(NSArray *failedJobs);
+
+- (id)initWithSession:(CMISSession *)session;
+
+/// queues the given CMISTransferJob instances and starts as many as allowed
+- (void)addJobs:(NSArray *)jobs;
+
+/// queues a failed or cancelled job again with a new set of retries, a failed upload should only be retried once it is known that its document was not created
+- (void)retryJob:(CMISTransferJob *)job;
+
+/// cancels all jobs that have not finished yet
+- (void)cancelAllJobs;
+
+@end
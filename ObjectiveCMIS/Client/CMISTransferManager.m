@@ -0,0 +1,456 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISTransferManager.h"
+#import "CMISSession.h"
+#import "CMISFolder.h"
+#import "CMISDocument.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+#import "CMISFileUtil.h"
+#import "CMISBandwidthLimiter.h"
+#import "CMISThrottledInputStream.h"
+#import "CMISThrottledOutputStream.h"
+
+// Default number of jobs running at the same time
+#define DEFAULT_MAX_CONCURRENT_TRANSFERS 4
+
+// Default number of retries of a job failing with a transient error
+#define DEFAULT_MAX_RETRIES 2
+
+// Default delay before the first retry of a job in seconds
+#define DEFAULT_RETRY_DELAY 1.0
+
+// Time span the transfer rate is measured over in seconds
+#define RATE_WINDOW 5.0
+
+@class CMISTransferManager;
+
+@interface CMISTransferJob ()
+
+@property (nonatomic, assign, readwrite) CMISTransferType type;
+@property (nonatomic, strong, readwrite) NSString *filePath;
+@property (nonatomic, strong, readwrite) CMISFolder *folder;
+@property (nonatomic, strong, readwrite) NSDictionary *properties;
+@property (nonatomic, strong, readwrite) NSString *mimeType;
+@property (nonatomic, strong, readwrite) CMISDocument *document;
+@property (nonatomic, assign, readwrite) unsigned long long size;
+@property (nonatomic, assign, readwrite) CMISTransferState state;
+@property (nonatomic, assign, readwrite) unsigned long long bytesTransferred;
+@property (nonatomic, assign, readwrite) NSUInteger attemptCount;
+@property (nonatomic, strong, readwrite) NSString *objectId;
+@property (nonatomic, strong, readwrite) NSError *error;
+@property (nonatomic, weak) CMISTransferManager *manager;
+@property (nonatomic, strong) CMISRequest *request;
+@property (nonatomic, assign) BOOL cancelRequested;
+
+@end
+
+@interface CMISTransferManager ()
+
+@property (nonatomic, strong, readwrite) CMISSession *session;
+@property (nonatomic, strong) NSMutableArray *allJobs;
+@property (nonatomic, strong) NSMutableArray *queuedJobs; // ordered largest first
+@property (nonatomic, strong) NSMutableArray *runningJobs;
+@property (nonatomic, assign) NSUInteger retryingJobCount; // failed jobs waiting for their retry
+@property (nonatomic, strong) CMISBandwidthLimiter *bandwidthLimiter;
+@property (nonatomic, assign, readwrite) unsigned long long bytesTotal;
+@property (nonatomic, assign) unsigned long long completedBytes;
+@property (nonatomic, assign) long long runningBytes;
+@property (nonatomic, assign) unsigned long long bytesMoved; // only grows, used for the rate
+@property (nonatomic, strong) NSMutableArray *rateSamples; // pairs of time and bytes moved
+@property (nonatomic, assign) BOOL active;
+
+- (void)cancelJob:(CMISTransferJob *)job;
+
+@end
+
+
+@implementation CMISTransferJob
+
++ (CMISTransferJob *)uploadJobWithFilePath:(NSString *)filePath
+                                  mimeType:(NSString *)mimeType
+                                properties:(NSDictionary *)properties
+                                  toFolder:(CMISFolder *)folder
+{
+    CMISTransferJob *job = [[CMISTransferJob alloc] init];
+    job.type = CMISTransferTypeUpload;
+    job.filePath = filePath;
+    job.mimeType = mimeType;
+    job.properties = properties;
+    job.folder = folder;
+    
+    NSError *fileError = nil;
+    job.size = [CMISFileUtil fileSizeForFileAtPath:filePath error:&fileError];
+    if (fileError) {
+        CMISLogError(@"Could not determine size of file %@: %@", filePath, [fileError description]);
+    }
+    return job;
+}
+
++ (CMISTransferJob *)downloadJobWithDocument:(CMISDocument *)document toFilePath:(NSString *)filePath
+{
+    CMISTransferJob *job = [[CMISTransferJob alloc] init];
+    job.type = CMISTransferTypeDownload;
+    job.document = document;
+    job.filePath = filePath;
+    job.size = document.contentStreamLength;
+    return job;
+}
+
+- (void)cancel
+{
+    [self.manager cancelJob:self];
+}
+
+@end
+
+
+@implementation CMISTransferManager
+
+- (id)initWithSession:(CMISSession *)session
+{
+    self = [super init];
+    if (self) {
+        _session = session;
+        _maxConcurrentTransfers = DEFAULT_MAX_CONCURRENT_TRANSFERS;
+        _maxRetries = DEFAULT_MAX_RETRIES;
+        _retryDelay = DEFAULT_RETRY_DELAY;
+        _allJobs = [NSMutableArray array];
+        _queuedJobs = [NSMutableArray array];
+        _runningJobs = [NSMutableArray array];
+        _rateSamples = [NSMutableArray array];
+        _bandwidthLimiter = [[CMISBandwidthLimiter alloc] initWithBytesPerSecond:0];
+    }
+    return self;
+}
+
+- (void)setBandwidthLimit:(unsigned long long)bandwidthLimit
+{
+    _bandwidthLimit = bandwidthLimit;
+    self.bandwidthLimiter.bytesPerSecond = bandwidthLimit;
+}
+
+- (void)setMaxConcurrentTransfers:(NSUInteger)maxConcurrentTransfers
+{
+    _maxConcurrentTransfers = MAX(maxConcurrentTransfers, 1);
+    [self startQueuedJobs];
+}
+
+- (NSArray *)jobs
+{
+    return [self.allJobs copy];
+}
+
+- (unsigned long long)bytesTransferred
+{
+    return self.completedBytes + (unsigned long long)MAX(self.runningBytes, 0);
+}
+
+- (double)bytesPerSecond
+{
+    [self pruneRateSamplesAt:[NSDate timeIntervalSinceReferenceDate]];
+    if (self.rateSamples.count < 2) {
+        return 0;
+    }
+    NSArray *first = [self.rateSamples firstObject];
+    NSArray *last = [self.rateSamples lastObject];
+    NSTimeInterval duration = [[last objectAtIndex:0] doubleValue] - [[first objectAtIndex:0] doubleValue];
+    unsigned long long bytes = [[last objectAtIndex:1] unsignedLongLongValue] - [[first objectAtIndex:1] unsignedLongLongValue];
+    return (duration > 0 ? bytes / duration : 0);
+}
+
+- (NSUInteger)queuedJobCount
+{
+    return self.queuedJobs.count;
+}
+
+- (NSUInteger)runningJobCount
+{
+    return self.runningJobs.count;
+}
+
+- (void)addJobs:(NSArray *)jobs
+{
+    for (CMISTransferJob *job in jobs) {
+        job.manager = self;
+        job.state = CMISTransferStateQueued;
+        [self.allJobs addObject:job];
+        [self.queuedJobs addObject:job];
+        self.bytesTotal += job.size;
+    }
+    [self sortQueuedJobs];
+    self.active = YES;
+    [self startQueuedJobs];
+}
+
+- (void)retryJob:(CMISTransferJob *)job
+{
+    if (job.manager != self || (job.state != CMISTransferStateFailed && job.state != CMISTransferStateCancelled)) {
+        return;
+    }
+    
+    if (job.state == CMISTransferStateCancelled) {
+        self.bytesTotal += job.size;
+    }
+    if (![self.allJobs containsObject:job]) { // the job is from a batch that has completed already
+        [self.allJobs addObject:job];
+    }
+    job.attemptCount = 0;
+    job.error = nil;
+    job.cancelRequested = NO;
+    job.state = CMISTransferStateQueued;
+    [self.queuedJobs addObject:job];
+    [self sortQueuedJobs];
+    self.active = YES;
+    [self startQueuedJobs];
+}
+
+- (void)cancelAllJobs
+{
+    NSArray *jobs = [self.allJobs copy];
+    for (CMISTransferJob *job in jobs) {
+        [self cancelJob:job];
+    }
+}
+
+#pragma mark Private methods
+
+- (void)sortQueuedJobs
+{
+    [self.queuedJobs sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(CMISTransferJob *job1, CMISTransferJob *job2) {
+        if (job1.size == job2.size) {
+            return NSOrderedSame;
+        }
+        return (job1.size > job2.size ? NSOrderedAscending : NSOrderedDescending);
+    }];
+}
+
+- (void)startQueuedJobs
+{
+    while (self.runningJobs.count < self.maxConcurrentTransfers && self.queuedJobs.count > 0) {
+        CMISTransferJob *job = [self.queuedJobs objectAtIndex:0];
+        [self.queuedJobs removeObjectAtIndex:0];
+        [self startJob:job];
+    }
+}
+
+- (void)startJob:(CMISTransferJob *)job
+{
+    job.state = CMISTransferStateRunning;
+    job.attemptCount++;
+    job.bytesTransferred = 0;
+    [self.runningJobs addObject:job];
+    
+    void (^progressBlock)(unsigned long long, unsigned long long) = ^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+        [self job:job didTransferBytes:bytesTransferred];
+    };
+    
+    // without a limit the file based methods are used, so downloads can be resumed and split into ranges
+    BOOL limited = (self.bandwidthLimit > 0);
+    CMISRequest *request = nil;
+    if (job.type == CMISTransferTypeUpload) {
+        void (^completionBlock)(NSString *, NSError *) = ^(NSString *objectId, NSError *error) {
+            [self job:job didCompleteWithObjectId:objectId error:error];
+        };
+        if (limited) {
+            NSInputStream *fileStream = [NSInputStream inputStreamWithFileAtPath:job.filePath];
+            request = [job.folder createDocumentFromInputStream:[[CMISThrottledInputStream alloc] initWithInputStream:fileStream bandwidthLimiter:self.bandwidthLimiter]
+                                                       mimeType:job.mimeType
+                                                     properties:job.properties
+                                                  bytesExpected:job.size
+                                                completionBlock:completionBlock
+                                                  progressBlock:progressBlock];
+        } else {
+            request = [job.folder createDocumentFromFilePath:job.filePath
+                                                    mimeType:job.mimeType
+                                                  properties:job.properties
+                                             completionBlock:completionBlock
+                                               progressBlock:progressBlock];
+        }
+    } else {
+        void (^completionBlock)(NSError *) = ^(NSError *error) {
+            [self job:job didCompleteWithObjectId:nil error:error];
+        };
+        if (limited) {
+            NSOutputStream *fileStream = [NSOutputStream outputStreamToFileAtPath:job.filePath append:NO];
+            request = [job.document downloadContentToOutputStream:[[CMISThrottledOutputStream alloc] initWithOutputStream:fileStream bandwidthLimiter:self.bandwidthLimiter]
+                                                  completionBlock:completionBlock
+                                                    progressBlock:progressBlock];
+        } else {
+            request = [job.document downloadContentToFile:job.filePath
+                                          completionBlock:completionBlock
+                                            progressBlock:progressBlock];
+        }
+    }
+    
+    // the request may have failed before it was sent
+    if (job.state == CMISTransferStateRunning) {
+        job.request = request;
+    }
+}
+
+- (void)job:(CMISTransferJob *)job didTransferBytes:(unsigned long long)bytesTransferred
+{
+    if (job.state != CMISTransferStateRunning) {
+        return;
+    }
+    
+    if (bytesTransferred > job.bytesTransferred) {
+        unsigned long long delta = bytesTransferred - job.bytesTransferred;
+        self.bytesMoved += delta;
+        self.runningBytes += (long long)delta;
+        job.bytesTransferred = bytesTransferred;
+        
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        [self.rateSamples addObject:@[@(now), @(self.bytesMoved)]];
+        [self pruneRateSamplesAt:now];
+    }
+    
+    [self reportProgress];
+}
+
+- (void)job:(CMISTransferJob *)job didCompleteWithObjectId:(NSString *)objectId error:(NSError *)error
+{
+    if (job.state != CMISTransferStateRunning) {
+        return;
+    }
+    
+    [self.runningJobs removeObject:job];
+    job.request = nil;
+    self.runningBytes -= (long long)job.bytesTransferred;
+    
+    if (error == nil) {
+        job.objectId = objectId;
+        job.bytesTransferred = job.size;
+        job.state = CMISTransferStateSucceeded;
+        self.completedBytes += job.size;
+    } else if (job.cancelRequested || error.code == kCMISErrorCodeCancelled) {
+        job.error = error;
+        job.state = CMISTransferStateCancelled;
+        self.bytesTotal -= job.size;
+    } else if (job.type == CMISTransferTypeDownload && job.attemptCount <= self.maxRetries && [CMISTransferManager isTransientError:error]) {
+        // only downloads are retried, a failed upload may have created the document already
+        NSTimeInterval delay = self.retryDelay * pow(2, job.attemptCount - 1);
+        CMISLogDebug(@"Transfer of %@ failed with %@, retrying in %.1f seconds", job.filePath, error, delay);
+        job.error = error;
+        job.bytesTransferred = 0;
+        job.state = CMISTransferStateQueued;
+        self.retryingJobCount++;
+        [self performSelector:@selector(queueRetriedJob:) withObject:job afterDelay:delay];
+    } else {
+        CMISLogError(@"Transfer of %@ failed: %@", job.filePath, error);
+        job.error = error;
+        job.state = CMISTransferStateFailed;
+    }
+    
+    [self finishJobIfDone:job];
+}
+
+- (void)queueRetriedJob:(CMISTransferJob *)job
+{
+    self.retryingJobCount--;
+    // the job may have been cancelled while waiting
+    if (job.state == CMISTransferStateQueued && ![self.queuedJobs containsObject:job]) {
+        [self.queuedJobs addObject:job];
+        [self sortQueuedJobs];
+    }
+    [self startQueuedJobs];
+    [self finishBatchIfDone];
+}
+
+- (void)cancelJob:(CMISTransferJob *)job
+{
+    if (job.state == CMISTransferStateQueued) {
+        [self.queuedJobs removeObject:job];
+        job.error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled detailedDescription:@"Transfer was cancelled"];
+        job.state = CMISTransferStateCancelled;
+        self.bytesTotal -= job.size;
+        [self finishJobIfDone:job];
+    } else if (job.state == CMISTransferStateRunning) {
+        // the job finishes once the request reports the cancellation
+        job.cancelRequested = YES;
+        [job.request cancel];
+    }
+}
+
+- (void)finishJobIfDone:(CMISTransferJob *)job
+{
+    if (job.state != CMISTransferStateQueued && job.state != CMISTransferStateRunning) {
+        if (job.completionBlock) {
+            job.completionBlock(job);
+        }
+    }
+    
+    [self startQueuedJobs];
+    [self reportProgress];
+    [self finishBatchIfDone];
+}
+
+- (void)finishBatchIfDone
+{
+    if (!self.active || self.queuedJobs.count > 0 || self.runningJobs.count > 0 || self.retryingJobCount > 0) {
+        return;
+    }
+    
+    self.active = NO;
+    
+    // every job of the batch has finished, they are dropped so the next batch does not carry them along
+    NSMutableArray *failedJobs = [NSMutableArray array];
+    for (CMISTransferJob *job in self.allJobs) {
+        if (job.state == CMISTransferStateFailed) {
+            [failedJobs addObject:job];
+        }
+    }
+    [self.allJobs removeAllObjects];
+    
+    if (self.completionBlock) {
+        self.completionBlock(failedJobs);
+    }
+}
+
+- (void)reportProgress
+{
+    if (self.progressBlock) {
+        self.progressBlock(self.bytesTransferred, self.bytesTotal, self.bytesPerSecond);
+    }
+}
+
+- (void)pruneRateSamplesAt:(NSTimeInterval)now
+{
+    // keep one sample older than the window, so the rate covers the whole window
+    while (self.rateSamples.count > 2 && now - [[[self.rateSamples objectAtIndex:1] objectAtIndex:0] doubleValue] > RATE_WINDOW) {
+        [self.rateSamples removeObjectAtIndex:0];
+    }
+}
+
+/// an open circuit breaker is not transient: it stays open far longer than the retry delays, the job fails right away instead
++ (BOOL)isTransientError:(NSError *)error
+{
+    switch (error.code) {
+        case kCMISErrorCodeConnection:
+        case kCMISErrorCodeNoNetworkConnection:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
+@end
@@ -21,7 +21,7 @@
 #import "CMISExtensionData.h"
 #import "CMISPrincipal.h"
 
-@interface CMISAce : CMISExtensionData
+@interface CMISAce : CMISExtensionData <NSCopying>
 
 
 ///ACE principal
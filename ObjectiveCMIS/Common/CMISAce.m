@@ -21,6 +21,16 @@
 
 @implementation CMISAce
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISAce *ace = [[[self class] allocWithZone:zone] init];
+    ace.extensions = self.extensions;
+    ace.principal = [self.principal copy];
+    ace.permissions = self.permissions;
+    ace.isDirect = self.isDirect;
+    return ace;
+}
+
 -(NSString *)principalId{
     return self.principal.principalId;
 }
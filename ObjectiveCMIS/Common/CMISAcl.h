@@ -21,7 +21,8 @@
 #import <Foundation/Foundation.h>
 #import "CMISExtensionData.h"
 
-@interface CMISAcl : CMISExtensionData
+/// An access control list, a copy contains copies of the access control entries.
+@interface CMISAcl : CMISExtensionData <NSCopying>
 
 @property (nonatomic, strong) NSSet *aces;
 @property (nonatomic, assign) BOOL isExact;
@@ -19,9 +19,25 @@
 
 
 #import "CMISAcl.h"
+#import "CMISAce.h"
 
 @implementation CMISAcl
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISAcl *acl = [[[self class] allocWithZone:zone] init];
+    acl.extensions = self.extensions;
+    acl.isExact = self.isExact;
+    if (self.aces) {
+        NSMutableSet *aces = [NSMutableSet setWithCapacity:self.aces.count];
+        for (CMISAce *ace in self.aces) {
+            [aces addObject:[ace copy]];
+        }
+        acl.aces = aces;
+    }
+    return acl;
+}
+
 - (NSString *)description
 {
     return [NSString stringWithFormat:@"CMIS Access Control List - aces: %@, isExact: %@", self.aces, self.isExact ? @"true" : @"false"];
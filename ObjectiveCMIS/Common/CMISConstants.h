@@ -103,6 +103,8 @@ extern NSString * const kCMISRepositoryCapabilityCreateablePropertyTypesCanCreat
 extern NSString * const kCMISParameterChangeToken;
 extern NSString * const kCMISParameterChangeLogToken;
 extern NSString * const kCMISParameterOverwriteFlag;
+extern NSString * const kCMISParameterAppend;
+extern NSString * const kCMISParameterIsLastChunk;
 extern NSString * const kCMISParameterIncludeAllowableActions;
 extern NSString * const kCMISParameterFilter;
 extern NSString * const kCMISParameterMaxItems;
@@ -114,6 +114,8 @@ NSString * const kCMISRepositoryCapabilityCreateablePropertyTypesCanCreate = @"c
 NSString * const kCMISParameterChangeToken = @"changeToken";
 NSString * const kCMISParameterChangeLogToken = @"changeLogToken";
 NSString * const kCMISParameterOverwriteFlag = @"overwriteFlag";
+NSString * const kCMISParameterAppend = @"append";
+NSString * const kCMISParameterIsLastChunk = @"isLastChunk";
 NSString * const kCMISParameterIncludeAllowableActions = @"includeAllowableActions";
 NSString * const kCMISParameterFilter = @"filter";
 NSString * const kCMISParameterMaxItems = @"maxItems";
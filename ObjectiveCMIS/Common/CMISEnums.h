@@ -233,6 +233,41 @@ typedef NS_ENUM(NSInteger, CMISChangeType)
     CMISChangeTypeSecurity
 };
 
+// Request priority, used by the network provider to order queued requests
+typedef NS_ENUM(NSInteger, CMISRequestPriority)
+{
+    CMISRequestPriorityDefault, // the priority configured for the session is used
+    CMISRequestPriorityInteractive,
+    CMISRequestPriorityBackground,
+    CMISRequestPriorityBulk
+};
+
+// Direction of a transfer run by CMISTransferManager
+typedef NS_ENUM(NSInteger, CMISTransferType)
+{
+    CMISTransferTypeUpload,
+    CMISTransferTypeDownload
+};
+
+// State of a transfer run by CMISTransferManager
+typedef NS_ENUM(NSInteger, CMISTransferState)
+{
+    CMISTransferStateQueued,
+    CMISTransferStateRunning,
+    CMISTransferStateSucceeded,
+    CMISTransferStateFailed,
+    CMISTransferStateCancelled
+};
+
+// Algorithm used to hash content while it is uploaded or downloaded
+typedef NS_ENUM(NSInteger, CMISContentHashAlgorithm)
+{
+    CMISContentHashAlgorithmNone,
+    CMISContentHashAlgorithmMD5,
+    CMISContentHashAlgorithmSHA1,
+    CMISContentHashAlgorithmSHA256
+};
+
 @interface CMISEnums : NSObject 
 
 + (NSString *)stringForIncludeRelationShip:(CMISIncludeRelationship)includeRelationship;
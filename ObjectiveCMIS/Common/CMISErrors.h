@@ -42,6 +42,8 @@ typedef NS_ENUM(NSInteger, CMISErrorCodes)
     kCMISErrorCodeCancelled = 6,
     kCMISErrorCodeParsingFailed = 7,
     kCMISErrorCodeNoNetworkConnection = 8,
+    kCMISErrorCodeCircuitOpen = 9,
+    kCMISErrorCodeContentHashMismatch = 10,
     
     //error ranges for General errors
     kCMISErrorCodeGeneralMinimum = 256,
@@ -84,6 +86,8 @@ extern NSString * const kCMISErrorDescriptionRepositoryNotFound;
 extern NSString * const kCMISErrorDescriptionCancelled;
 extern NSString * const kCMISErrorDescriptionParsingFailed;
 extern NSString * const kCMISErrorDescriptionNoNetworkConnection;
+extern NSString * const kCMISErrorDescriptionCircuitOpen;
+extern NSString * const kCMISErrorDescriptionContentHashMismatch;
 //General errors as defined in 2.2.1.4.1 of spec
 extern NSString * const kCMISErrorDescriptionInvalidArgument;
 extern NSString * const kCMISErrorDescriptionObjectNotFound;
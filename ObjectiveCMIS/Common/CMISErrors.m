@@ -40,6 +40,8 @@ NSString * const kCMISErrorDescriptionRepositoryNotFound =  @"Repository Not Fou
 NSString * const kCMISErrorDescriptionCancelled = @"Operation Cancelled";
 NSString * const kCMISErrorDescriptionParsingFailed = @"Parsing Failed";
 NSString * const kCMISErrorDescriptionNoNetworkConnection = @"No Network Connection";
+NSString * const kCMISErrorDescriptionCircuitOpen = @"Server Temporarily Unavailable";
+NSString * const kCMISErrorDescriptionContentHashMismatch = @"Content Hash Mismatch";
 
 //General errors as defined in 2.2.1.4.1 of spec
 NSString * const kCMISErrorDescriptionInvalidArgument = @"Invalid Argument Error";
@@ -140,6 +142,10 @@ NSString * const kCMISErrorBearerOAuthCodeInsufficientScope = @"insufficient_sco
             return kCMISErrorDescriptionParsingFailed;
         case kCMISErrorCodeNoNetworkConnection:
             return kCMISErrorDescriptionNoNetworkConnection;
+        case kCMISErrorCodeCircuitOpen:
+            return kCMISErrorDescriptionCircuitOpen;
+        case kCMISErrorCodeContentHashMismatch:
+            return kCMISErrorDescriptionContentHashMismatch;
         case kCMISErrorCodeInvalidArgument:
             return kCMISErrorDescriptionInvalidArgument;
         case kCMISErrorCodeObjectNotFound:
@@ -19,7 +19,8 @@ typedef NS_ENUM(NSInteger, CMISHttpRequestMethod)
     HTTP_GET,
     HTTP_POST,
     HTTP_PUT,
-    HTTP_DELETE
+    HTTP_DELETE,
+    HTTP_HEAD
 };
 
 @class CMISBindingSession, CMISRequest, CMISHttpResponse;
@@ -250,7 +251,30 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
          cmisRequest:(CMISRequest *)cmisRequest
      completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock;
 
+@optional
 
+/**
+ * Opens connections to the service of the session, if configured with kCMISSessionParameterWarmUpConnections.
+ * Called by the bindings right before the repository info is requested, so the other connections are opened while
+ * that request is running. The requests must be sent with the authentication of the session, only the first call for
+ * a session has an effect and the method must not block.
+ * @param session the binding session the repository info is requested for
+ */
+- (void)warmUpConnectionsForSession:(CMISBindingSession *)session;
 
+/**
+ * GET invoke method handing over the body of a successful response while it is received, so it can be parsed incrementally.
+ * The body is not collected, the HTTPResponse passed to the completion block only contains the body of an error response.
+ * @param url the RESTful API URL to be used
+ * @param session
+ * @param dataBlock called with each chunk of the body, in order, on the thread the completion block is called on
+ * @param completionBlock returns an instance of the HTTPResponse if successful or nil otherwise
+ * @param requestObject a handle to the CMISRequest allowing this HTTP request to be cancelled
+ */
+- (void)invokeGET:(NSURL *)url
+          session:(CMISBindingSession *)session
+      cmisRequest:(CMISRequest *)cmisRequest
+        dataBlock:(void (^)(NSData *data))dataBlock
+  completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock;
 
 @end
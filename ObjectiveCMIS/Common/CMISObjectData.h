@@ -29,7 +29,11 @@
 @class CMISChangeEventInfo;
 @class CMISPolicyIdList;
 
-@interface CMISObjectData : CMISExtensionData
+/**
+ * Object data as returned by the bindings. A copy has its own properties, ACL, renditions, relationships, change event
+ * and policy ids; the link relations and allowable actions cannot be modified and are shared.
+ */
+@interface CMISObjectData : CMISExtensionData <NSCopying>
 
 @property (nonatomic, strong) NSString *identifier; 
 @property (nonatomic, assign) CMISBaseType baseType;
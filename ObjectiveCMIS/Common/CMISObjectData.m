@@ -18,8 +18,51 @@
  */
 
 #import "CMISObjectData.h"
+#import "CMISRenditionData.h"
+#import "CMISChangeEventInfo.h"
+#import "CMISPolicyIdList.h"
 
 @implementation CMISObjectData
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISObjectData *objectData = [[[self class] allocWithZone:zone] init];
+    objectData.extensions = self.extensions;
+    objectData.identifier = self.identifier;
+    objectData.baseType = self.baseType;
+    objectData.properties = [self.properties copy];
+    objectData.linkRelations = self.linkRelations;
+    objectData.contentUrl = self.contentUrl;
+    objectData.allowableActions = self.allowableActions;
+    objectData.acl = [self.acl copy];
+    objectData.isExactAcl = self.isExactAcl;
+    objectData.changeEventInfo = [self.changeEventInfo copy];
+    
+    if (self.renditions) {
+        NSMutableArray *renditions = [NSMutableArray arrayWithCapacity:self.renditions.count];
+        for (CMISRenditionData *renditionData in self.renditions) {
+            CMISRenditionData *rendition = [[CMISRenditionData alloc] initWithRenditionData:renditionData];
+            rendition.extensions = renditionData.extensions;
+            [renditions addObject:rendition];
+        }
+        objectData.renditions = renditions;
+    }
+    
+    if (self.relationships) {
+        NSMutableArray *relationships = [NSMutableArray arrayWithCapacity:self.relationships.count];
+        for (CMISObjectData *relationship in self.relationships) {
+            [relationships addObject:[relationship copy]];
+        }
+        objectData.relationships = relationships;
+    }
+    
+    if (self.policyIds) {
+        objectData.policyIds = [[CMISPolicyIdList alloc] init];
+        objectData.policyIds.policyIds = self.policyIds.policyIds;
+        objectData.policyIds.extensions = self.policyIds.extensions;
+    }
+    return objectData;
+}
+
 
 @end
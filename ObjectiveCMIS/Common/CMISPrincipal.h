@@ -19,7 +19,7 @@
 
 #import "CMISExtensionData.h"
 
-@interface CMISPrincipal : CMISExtensionData
+@interface CMISPrincipal : CMISExtensionData <NSCopying>
 
 @property NSString *principalId;
 
@@ -21,6 +21,14 @@
 
 @implementation CMISPrincipal
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISPrincipal *principal = [[[self class] allocWithZone:zone] init];
+    principal.extensions = self.extensions;
+    principal.principalId = self.principalId;
+    return principal;
+}
+
 - (NSString *)description
 {
     return [NSString stringWithFormat:@"CMIS Principal principalId: %@", self.principalId];
@@ -21,7 +21,8 @@
 #import "CMISPropertyData.h"
 #import "CMISExtensionData.h"
 
-@interface CMISProperties : CMISExtensionData
+/// Properties of an object, a copy contains copies of the properties.
+@interface CMISProperties : CMISExtensionData <NSCopying>
 
 // Dictionary of property id -> CMISPropertyData
 @property (nonatomic, strong, readonly) NSDictionary *propertiesDictionary;
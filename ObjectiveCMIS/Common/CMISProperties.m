@@ -26,6 +26,16 @@
 
 @implementation CMISProperties
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISProperties *properties = [[[self class] allocWithZone:zone] init];
+    properties.extensions = self.extensions;
+    for (CMISPropertyData *propertyData in self.internalPropertiesByIdDict.allValues) {
+        [properties addProperty:[propertyData copy]];
+    }
+    return properties;
+}
+
 
 
 - (void)addProperty:(CMISPropertyData *)propertyData
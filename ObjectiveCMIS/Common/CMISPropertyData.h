@@ -21,7 +21,7 @@
 #import "CMISEnums.h"
 #import "CMISExtensionData.h"
 
-@interface CMISPropertyData : CMISExtensionData
+@interface CMISPropertyData : CMISExtensionData <NSCopying>
 
 @property (nonatomic, strong) NSString *identifier;
 @property (nonatomic, strong) NSString *localName;
@@ -27,6 +27,19 @@
 
 @implementation CMISPropertyData
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISPropertyData *propertyData = [[[self class] allocWithZone:zone] init];
+    propertyData.extensions = self.extensions;
+    propertyData.identifier = self.identifier;
+    propertyData.localName = self.localName;
+    propertyData.displayName = self.displayName;
+    propertyData.queryName = self.queryName;
+    propertyData.type = self.type;
+    propertyData.values = self.values;
+    return propertyData;
+}
+
 
 - (id)firstValue
 {
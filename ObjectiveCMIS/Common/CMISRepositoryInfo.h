@@ -21,7 +21,7 @@
 #import "CMISExtensionData.h"
 #import "CMISRepositoryCapabilities.h"
 
-@interface CMISRepositoryInfo : CMISExtensionData
+@interface CMISRepositoryInfo : CMISExtensionData <NSCopying>
 
 @property (nonatomic, strong) NSString *identifier;
 @property (nonatomic, strong) NSString *name;
@@ -21,6 +21,25 @@
 
 @implementation CMISRepositoryInfo
 
+- (id)copyWithZone:(NSZone *)zone
+{
+    CMISRepositoryInfo *repositoryInfo = [[[self class] allocWithZone:zone] init];
+    repositoryInfo.extensions = self.extensions;
+    repositoryInfo.identifier = self.identifier;
+    repositoryInfo.name = self.name;
+    repositoryInfo.summary = self.summary;
+    repositoryInfo.rootFolderId = self.rootFolderId;
+    repositoryInfo.cmisVersionSupported = self.cmisVersionSupported;
+    repositoryInfo.productName = self.productName;
+    repositoryInfo.productVersion = self.productVersion;
+    repositoryInfo.vendorName = self.vendorName;
+    repositoryInfo.thinClientUri = self.thinClientUri;
+    repositoryInfo.latestChangeLogToken = self.latestChangeLogToken;
+    repositoryInfo.principalIdAnonymous = self.principalIdAnonymous;
+    repositoryInfo.principalIdAnyone = self.principalIdAnyone;
+    repositoryInfo.repositoryCapabilities = self.repositoryCapabilities;
+    return repositoryInfo;
+}
 
 - (NSString *)description
 {
@@ -46,6 +46,13 @@ extern NSString * const kCMISSessionParameterLinkCacheSize;
  */
 extern NSString * const kCMISSessionParameterTypeDefinitionCacheSize;
 
+/**
+ * Key for setting the memory budget of the HTTP validation cache, which keeps ETag/Last-Modified validated responses
+ * together with their parsed result. Value should be an NSNumber, indicating the budget in bytes, default is 4 MB.
+ * A value of 0 disables the cache.
+ */
+extern NSString * const kCMISSessionParameterValidationCacheSize;
+
 /**
  * Key for setting whether cookies should be added to requests. 
  * Value should be a boolean flag, default is YES.
@@ -83,6 +90,164 @@ extern NSString * const kCMISSessionParameterBackgroundNetworkSessionId;
  */
 extern NSString * const kCMISSessionParameterBackgroundNetworkSessionSharedContainerId;
 
+/**
+ * Key for setting the maximum number of requests the default network provider runs concurrently per host.
+ * Further requests are queued until a running request finishes. Value should be an NSNumber, default is 6.
+ */
+extern NSString * const kCMISSessionParameterMaxConcurrentRequestsPerHost;
+
+/**
+ * Key for setting the priority used for requests that do not specify a priority on their CMISRequest object.
+ * Value should be an NSNumber holding a CMISRequestPriority value, default is CMISRequestPriorityInteractive.
+ */
+extern NSString * const kCMISSessionParameterDefaultRequestPriority;
+
+/**
+ * Key for setting whether identical GET requests running at the same time share a single network request.
+ * Value should be an NSNumber holding a BOOL, default is YES.
+ */
+extern NSString * const kCMISSessionParameterCoalesceRequests;
+
+/**
+ * Key for setting whether gzip and deflate compressed responses are accepted.
+ * Value should be an NSNumber holding a BOOL, default is YES.
+ */
+extern NSString * const kCMISSessionParameterAcceptCompressedResponses;
+
+/**
+ * Key for setting the size from which on url encoded form bodies are sent gzip compressed.
+ * Only set this parameter if the server accepts gzip encoded request bodies.
+ * Value should be an NSNumber, indicating the size in bytes, default is not to compress request bodies.
+ */
+extern NSString * const kCMISSessionParameterCompressRequestBodyThreshold;
+
+/**
+ * Key for setting how often a failed idempotent request (GET, PUT with a data body, DELETE) is retried.
+ * Requests are retried if the connection failed or the server responded with 429, 502, 503 or 504.
+ * Value should be an NSNumber, default is 2. A value of 0 disables retries.
+ */
+extern NSString * const kCMISSessionParameterMaxRetries;
+
+/**
+ * Key for setting the delay (in seconds) before the first retry, the delay doubles with every further retry.
+ * Value should be an NSNumber, default is 0.5.
+ */
+extern NSString * const kCMISSessionParameterRetryBaseDelay;
+
+/**
+ * Key for setting the maximum delay (in seconds) before a retry. Requests are not retried if the server asks
+ * for a longer delay with a Retry-After header. Value should be an NSNumber, default is 10.
+ */
+extern NSString * const kCMISSessionParameterRetryMaxDelay;
+
+/**
+ * Key for setting the retry budget of a session as ratio of retries to requests, so retries cannot multiply the load
+ * on an overloaded server. Value should be an NSNumber, default is 0.2 (one retry for every five requests).
+ */
+extern NSString * const kCMISSessionParameterRetryBudgetRatio;
+
+/**
+ * Key for enabling hedged GET requests. A GET request that has not received a response after the hedge delay is
+ * sent a second time, the first response is used and the other request is cancelled.
+ * Both requests count against kCMISSessionParameterMaxConcurrentRequestsPerHost.
+ * Value should be an NSNumber object created from a BOOL, default is NO.
+ */
+extern NSString * const kCMISSessionParameterHedgeRequests;
+
+/**
+ * Key for setting the hedge delay as percentile of the recent times to first byte of the host.
+ * Value should be an NSNumber between 0 and 100, default is 95.
+ */
+extern NSString * const kCMISSessionParameterHedgeDelayPercentile;
+
+/**
+ * Key for setting the minimum hedge delay in seconds. Value should be an NSNumber, default is 0.05.
+ */
+extern NSString * const kCMISSessionParameterHedgeMinimumDelay;
+
+/**
+ * Key for enabling the circuit breaker. While the breaker of a host is open, requests to the host fail immediately
+ * with kCMISErrorCodeCircuitOpen. State changes are posted as kCMISCircuitBreakerStateDidChangeNotification.
+ * Value should be an NSNumber object created from a BOOL, default is YES.
+ */
+extern NSString * const kCMISSessionParameterCircuitBreakerEnabled;
+
+/**
+ * Key for setting the ratio of failed recent requests that opens the circuit breaker of a host.
+ * Value should be an NSNumber between 0 and 1, default is 0.5.
+ */
+extern NSString * const kCMISSessionParameterCircuitBreakerFailureRatio;
+
+/**
+ * Key for setting the time (in seconds) to receive the response headers after which a request counts as failed for the
+ * circuit breaker. The time taken to transfer the body is not included, so long uploads and downloads are not slow calls.
+ * Value should be an NSNumber, default is 10. A value of 0 disables the latency check.
+ */
+extern NSString * const kCMISSessionParameterCircuitBreakerSlowCallThreshold;
+
+/**
+ * Key for setting how long (in seconds) the circuit breaker stays open before a probe request is sent.
+ * Value should be an NSNumber, default is 30.
+ */
+extern NSString * const kCMISSessionParameterCircuitBreakerOpenInterval;
+
+/**
+ * Key for setting the number of connections opened to the service together with the first repository info request,
+ * so the following requests do not have to wait for DNS lookup, TCP and TLS handshakes. The additional connections are
+ * opened with authenticated HEAD requests to the service URL.
+ * Value should be an NSNumber, default is 0 (no warm up).
+ */
+extern NSString * const kCMISSessionParameterWarmUpConnections;
+
+/**
+ * Key for setting the interval (in seconds) in which idle warmed up connections are used to keep them open.
+ * Should be shorter than the keep alive timeout of the server. Only used together with
+ * kCMISSessionParameterWarmUpConnections. Value should be an NSNumber, default is 0 (connections are not kept alive).
+ */
+extern NSString * const kCMISSessionParameterConnectionKeepAliveInterval;
+
+/**
+ * Key for setting whether downloads to a file keep the partially downloaded content when the transfer fails,
+ * so the next download of the same content to the same file continues where the previous one stopped.
+ * Value should be an NSNumber (BOOL), default is YES. Ignored for background network sessions.
+ */
+extern NSString * const kCMISSessionParameterResumableDownloads;
+
+/**
+ * Key for setting the number of concurrent range requests used by CMISDocument to download content to a file.
+ * Value should be an NSNumber, default is 1 (content is downloaded with a single request).
+ */
+extern NSString * const kCMISSessionParameterParallelDownloadRanges;
+
+/**
+ * Key for setting the minimum content length (in bytes) for which content is downloaded with concurrent range requests.
+ * Value should be an NSNumber, default is 16MB.
+ */
+extern NSString * const kCMISSessionParameterParallelDownloadMinimumLength;
+
+/**
+ * Key for setting the size (in bytes) of the chunks the content of an upload is read and encoded in.
+ * Two chunks are buffered per upload, so one can be encoded while the other is sent.
+ * Value should be an NSNumber, default is 256KB.
+ */
+extern NSString * const kCMISSessionParameterUploadChunkSize;
+
+/**
+ * Key for setting the size (in bytes) of the parts CMISDocument splits content into for a chunked upload.
+ * Each part is sent with its own appendContentStream request, so a failed upload only repeats the part that failed.
+ * Value should be an NSNumber, default is 8MB.
+ */
+extern NSString * const kCMISSessionParameterUploadPartSize;
+
+/**
+ * Key for setting the algorithm used to hash content while it is uploaded or downloaded.
+ * The hash is computed from the raw content as it passes through the network layer and is available from
+ * CMISRequest's contentHash once the request has completed. Downloads of a whole document are verified against
+ * the cmis:contentStreamHash property if the repository provides a value for the same algorithm.
+ * Value should be an NSNumber holding a CMISContentHashAlgorithm, default is CMISContentHashAlgorithmNone.
+ */
+extern NSString * const kCMISSessionParameterContentHashAlgorithm;
+
 // --- OAuth ---
 
 extern NSString * const kCMISSessionParameterOAuthClientId;
@@ -23,6 +23,7 @@
 NSString * const kCMISSessionParameterObjectConverterClassName = @"session_param_object_converter_class";
 NSString * const kCMISSessionParameterLinkCacheSize = @"session_param_cache_size_links";
 NSString * const kCMISSessionParameterTypeDefinitionCacheSize = @"session_param_cache_size_type_definition";
+NSString * const kCMISSessionParameterValidationCacheSize = @"session_param_cache_size_validation";
 NSString * const kCMISSessionParameterSendCookies = @"session_param_send_cookies";
 
 NSString * const kCMISSessionParameterCheckNetworkReachability = @"session_param_check_network_reachability";
@@ -30,6 +31,30 @@ NSString * const kCMISSessionParameterRequestTimeout = @"session_param_request_t
 NSString * const kCMISSessionParameterUseBackgroundNetworkSession = @"session_param_use_background_session";
 NSString * const kCMISSessionParameterBackgroundNetworkSessionId = @"session_param_background_session_id";
 NSString * const kCMISSessionParameterBackgroundNetworkSessionSharedContainerId = @"session_param_background_session_shared_container_id";
+NSString * const kCMISSessionParameterMaxConcurrentRequestsPerHost = @"session_param_max_concurrent_requests_per_host";
+NSString * const kCMISSessionParameterDefaultRequestPriority = @"session_param_default_request_priority";
+NSString * const kCMISSessionParameterCoalesceRequests = @"session_param_coalesce_requests";
+NSString * const kCMISSessionParameterAcceptCompressedResponses = @"session_param_accept_compressed_responses";
+NSString * const kCMISSessionParameterCompressRequestBodyThreshold = @"session_param_compress_request_body_threshold";
+NSString * const kCMISSessionParameterMaxRetries = @"session_param_max_retries";
+NSString * const kCMISSessionParameterRetryBaseDelay = @"session_param_retry_base_delay";
+NSString * const kCMISSessionParameterRetryMaxDelay = @"session_param_retry_max_delay";
+NSString * const kCMISSessionParameterRetryBudgetRatio = @"session_param_retry_budget_ratio";
+NSString * const kCMISSessionParameterHedgeRequests = @"session_param_hedge_requests";
+NSString * const kCMISSessionParameterHedgeDelayPercentile = @"session_param_hedge_delay_percentile";
+NSString * const kCMISSessionParameterHedgeMinimumDelay = @"session_param_hedge_minimum_delay";
+NSString * const kCMISSessionParameterCircuitBreakerEnabled = @"session_param_circuit_breaker_enabled";
+NSString * const kCMISSessionParameterCircuitBreakerFailureRatio = @"session_param_circuit_breaker_failure_ratio";
+NSString * const kCMISSessionParameterCircuitBreakerSlowCallThreshold = @"session_param_circuit_breaker_slow_call_threshold";
+NSString * const kCMISSessionParameterCircuitBreakerOpenInterval = @"session_param_circuit_breaker_open_interval";
+NSString * const kCMISSessionParameterWarmUpConnections = @"session_param_warm_up_connections";
+NSString * const kCMISSessionParameterConnectionKeepAliveInterval = @"session_param_connection_keep_alive_interval";
+NSString * const kCMISSessionParameterResumableDownloads = @"session_param_resumable_downloads";
+NSString * const kCMISSessionParameterParallelDownloadRanges = @"session_param_parallel_download_ranges";
+NSString * const kCMISSessionParameterParallelDownloadMinimumLength = @"session_param_parallel_download_minimum_length";
+NSString * const kCMISSessionParameterUploadChunkSize = @"session_param_upload_chunk_size";
+NSString * const kCMISSessionParameterUploadPartSize = @"session_param_upload_part_size";
+NSString * const kCMISSessionParameterContentHashAlgorithm = @"session_param_content_hash_algorithm";
 
 // --- OAuth ---
 
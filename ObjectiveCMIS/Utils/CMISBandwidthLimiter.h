@@ -0,0 +1,51 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Limits the rate of data transferred by several transfers together (token bucket).
+ *
+ * The bucket fills at the configured rate up to one second worth of data. A transfer takes the bytes it has moved out
+ * of the bucket; if the bucket runs empty, the transfer is held back until the bucket has filled up again. The bucket
+ * may go into debt, so transfers taking bytes at the same time are held back in the order they took them.
+ * All methods are thread safe.
+ */
+@interface CMISBandwidthLimiter : NSObject
+
+/// the maximum rate in bytes per second, 0 means unlimited
+@property (assign) unsigned long long bytesPerSecond;
+
+/// the largest number of bytes a transfer should move before taking them from the bucket
+@property (readonly) NSUInteger maximumChunkLength;
+
+- (id)initWithBytesPerSecond:(unsigned long long)bytesPerSecond;
+
+/**
+ * Takes the given number of bytes from the bucket.
+ * @return the time the caller has to wait before transferring more data, 0 if it can continue right away
+ */
+- (NSTimeInterval)reserveBytes:(NSUInteger)length;
+
+/// takes the given number of bytes from the bucket and blocks the calling thread as long as necessary
+- (void)waitForBytes:(NSUInteger)length;
+
+@end
@@ -0,0 +1,103 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+
+#import "CMISBandwidthLimiter.h"
+
+// Fraction of a second of data moved between two checks of the bucket
+#define CHUNKS_PER_SECOND 20
+
+// Smallest chunk, so very low rates do not lead to tiny reads and writes
+#define MINIMUM_CHUNK_LENGTH 1024
+
+@interface CMISBandwidthLimiter ()
+
+@property (nonatomic, assign) double availableBytes;
+@property (nonatomic, assign) NSTimeInterval lastRefillTime;
+
+@end
+
+
+@implementation CMISBandwidthLimiter
+
+@synthesize bytesPerSecond = _bytesPerSecond;
+
+- (id)initWithBytesPerSecond:(unsigned long long)bytesPerSecond
+{
+    self = [super init];
+    if (self) {
+        _bytesPerSecond = bytesPerSecond;
+        _availableBytes = (double)bytesPerSecond;
+        _lastRefillTime = [NSDate timeIntervalSinceReferenceDate];
+    }
+    return self;
+}
+
+- (unsigned long long)bytesPerSecond
+{
+    @synchronized(self) {
+        return _bytesPerSecond;
+    }
+}
+
+- (void)setBytesPerSecond:(unsigned long long)bytesPerSecond
+{
+    @synchronized(self) {
+        _bytesPerSecond = bytesPerSecond;
+        self.availableBytes = MIN(self.availableBytes, (double)bytesPerSecond);
+        self.lastRefillTime = [NSDate timeIntervalSinceReferenceDate];
+    }
+}
+
+- (NSUInteger)maximumChunkLength
+{
+    unsigned long long bytesPerSecond = self.bytesPerSecond;
+    if (bytesPerSecond == 0) {
+        return NSUIntegerMax;
+    }
+    return (NSUInteger)MAX(bytesPerSecond / CHUNKS_PER_SECOND, MINIMUM_CHUNK_LENGTH);
+}
+
+- (NSTimeInterval)reserveBytes:(NSUInteger)length
+{
+    @synchronized(self) {
+        if (_bytesPerSecond == 0) {
+            return 0;
+        }
+        
+        NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+        double rate = (double)_bytesPerSecond;
+        self.availableBytes = MIN(self.availableBytes + (now - self.lastRefillTime) * rate, rate);
+        self.lastRefillTime = now;
+        
+        self.availableBytes -= length;
+        return (self.availableBytes < 0 ? -self.availableBytes / rate : 0);
+    }
+}
+
+- (void)waitForBytes:(NSUInteger)length
+{
+    NSTimeInterval delay = [self reserveBytes:length];
+    if (delay > 0) {
+        [NSThread sleepForTimeInterval:delay];
+    }
+}
+
+@end
@@ -0,0 +1,45 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+@interface CMISBase64Decoder : NSObject
+
+/// the error describing the invalid input, once decoding failed
+@property (nonatomic, strong, readonly) NSError *error;
+
+/// returns the decoded data for given base64 encoded data, whitespace is ignored; returns nil if the data is not valid base64
++ (NSData *)dataByDecodingText:(NSData *)encodedText;
+
+/// returns the maximum number of bytes decoding a chunk of the given number of characters writes
++ (NSUInteger)maximumDecodedLengthForLength:(NSUInteger)length;
+
+/**
+ * Streaming decoding: a decoder instance decodes base64 data that arrives in chunks of any size.
+ * Characters that do not complete a group of 4 are kept until the next chunk.
+ * @param buffer must hold at least maximumDecodedLengthForLength:length bytes
+ * @return the number of decoded bytes written to buffer, or NSNotFound if the data is not valid base64
+ */
+- (NSUInteger)decodeBytes:(const char *)bytes length:(NSUInteger)length toBuffer:(uint8_t *)buffer;
+
+/// checks that the data ended with a complete group; returns NO and sets the error otherwise
+- (BOOL)finish;
+
+@end
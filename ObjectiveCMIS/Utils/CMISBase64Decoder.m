@@ -0,0 +1,270 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISBase64Decoder.h"
+#import "CMISErrors.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define CMIS_BASE64_NEON 1
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define CMIS_BASE64_SSSE3 1
+#endif
+
+// decode table values that are not 6 bit values
+#define PADDING 0x40
+#define WHITESPACE 0x41
+#define INVALID 0xFF
+
+static uint8_t decodeTable[256];
+
+static void CMISBase64InitDecodeTable(void)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    
+    memset(decodeTable, INVALID, sizeof(decodeTable));
+    for (uint8_t i = 0; i < 64; i++) {
+        decodeTable[(uint8_t)alphabet[i]] = i;
+    }
+    decodeTable['='] = PADDING;
+    decodeTable[' '] = decodeTable['\t'] = decodeTable['\r'] = decodeTable['\n'] = WHITESPACE;
+}
+
+/**
+ Decodes complete groups of 4 characters up to the first padding, whitespace or invalid character, which is
+ left to the caller. Returns the number of characters consumed, a multiple of 4.
+ The vector paths work on 64 (NEON) or 16 (SSSE3) characters at a time, the rest is decoded one group at a time.
+ */
+static NSUInteger CMISBase64DecodeGroups(const uint8_t *input, NSUInteger length, uint8_t *output)
+{
+    NSUInteger i = 0;
+    
+#if CMIS_BASE64_NEON
+    const uint8x16x4_t lowTable = { { vld1q_u8(decodeTable), vld1q_u8(decodeTable + 16),
+                                      vld1q_u8(decodeTable + 32), vld1q_u8(decodeTable + 48) } };
+    const uint8x16x4_t highTable = { { vld1q_u8(decodeTable + 64), vld1q_u8(decodeTable + 80),
+                                       vld1q_u8(decodeTable + 96), vld1q_u8(decodeTable + 112) } };
+    const uint8x16_t highOffset = vdupq_n_u8(64);
+    const uint8x16_t highBit = vdupq_n_u8(0x80);
+    for (; length - i >= 64; i += 64) {
+        // deinterleave into the first, second, third and fourth characters of 16 groups
+        uint8x16x4_t characters = vld4q_u8(input + i);
+        
+        // characters below 64 are looked up in the low table, those from 64 to 127 in the high table
+        uint8x16x4_t values;
+        values.val[0] = vqtbx4q_u8(vqtbl4q_u8(lowTable, characters.val[0]), highTable, vsubq_u8(characters.val[0], highOffset));
+        values.val[1] = vqtbx4q_u8(vqtbl4q_u8(lowTable, characters.val[1]), highTable, vsubq_u8(characters.val[1], highOffset));
+        values.val[2] = vqtbx4q_u8(vqtbl4q_u8(lowTable, characters.val[2]), highTable, vsubq_u8(characters.val[2], highOffset));
+        values.val[3] = vqtbx4q_u8(vqtbl4q_u8(lowTable, characters.val[3]), highTable, vsubq_u8(characters.val[3], highOffset));
+        
+        // anything but a 6 bit value, and any character from 128 up, is handled by the caller
+        uint8x16_t check = vorrq_u8(vorrq_u8(values.val[0], values.val[1]), vorrq_u8(values.val[2], values.val[3]));
+        check = vorrq_u8(check, vandq_u8(vorrq_u8(vorrq_u8(characters.val[0], characters.val[1]),
+                                                  vorrq_u8(characters.val[2], characters.val[3])), highBit));
+        if (vmaxvq_u8(check) >= 64) {
+            break;
+        }
+        
+        uint8x16x3_t bytes;
+        bytes.val[0] = vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+        bytes.val[1] = vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+        bytes.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+        vst3q_u8(output + i / 4 * 3, bytes);
+    }
+#elif CMIS_BASE64_SSSE3
+    // 16 bytes are stored for every 12 decoded, so the loop stops while the output still has room for that
+    const __m128i lowNibbleFlags = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i highNibbleFlags = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                                  0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i offsets = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    for (; length - i >= 24; i += 16) {
+        __m128i characters = _mm_loadu_si128((const __m128i *)(input + i));
+        __m128i highNibbles = _mm_and_si128(_mm_srli_epi32(characters, 4), nibbleMask);
+        __m128i lowNibbles = _mm_and_si128(characters, nibbleMask);
+        
+        // a character is valid if the flags for its low and its high nibble have no bit in common
+        __m128i flags = _mm_and_si128(_mm_shuffle_epi8(lowNibbleFlags, lowNibbles), _mm_shuffle_epi8(highNibbleFlags, highNibbles));
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(flags, _mm_setzero_si128())) != 0) {
+            break;
+        }
+        
+        // the high nibble selects the offset for A-Z, a-z and 0-9 and +, / needs its own
+        __m128i slashes = _mm_cmpeq_epi8(characters, _mm_set1_epi8('/'));
+        __m128i values = _mm_add_epi8(characters, _mm_shuffle_epi8(offsets, _mm_add_epi8(slashes, highNibbles)));
+        
+        // merge the four 6 bit values of each 32 bit lane into 3 bytes and pack those together
+        __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        merged = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i *)(output + i / 4 * 3), _mm_shuffle_epi8(merged, shuffle));
+    }
+#endif
+    
+    for (; length - i >= 4; i += 4) {
+        uint32_t a = decodeTable[input[i]];
+        uint32_t b = decodeTable[input[i + 1]];
+        uint32_t c = decodeTable[input[i + 2]];
+        uint32_t d = decodeTable[input[i + 3]];
+        if ((a | b | c | d) >= 64) {
+            break;
+        }
+        
+        uint8_t *out = output + i / 4 * 3;
+        uint32_t group = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0] = (uint8_t)(group >> 16);
+        out[1] = (uint8_t)(group >> 8);
+        out[2] = (uint8_t)group;
+    }
+    return i;
+}
+
+/**
+ Decodes a group of 2, 3 or 4 values and returns the number of bytes written.
+ */
+static NSUInteger CMISBase64DecodeGroup(const uint8_t *values, NSUInteger count, uint8_t *output)
+{
+    uint32_t group = ((uint32_t)values[0] << 18) | ((uint32_t)values[1] << 12);
+    if (count > 2) {
+        group |= (uint32_t)values[2] << 6;
+    }
+    if (count > 3) {
+        group |= values[3];
+    }
+    
+    output[0] = (uint8_t)(group >> 16);
+    if (count > 2) {
+        output[1] = (uint8_t)(group >> 8);
+    }
+    if (count > 3) {
+        output[2] = (uint8_t)group;
+    }
+    return count - 1;
+}
+
+
+@interface CMISBase64Decoder ()
+{
+    uint8_t _groupValues[4];
+    NSUInteger _groupLength;
+    NSUInteger _paddingLength;
+    BOOL _ended;
+}
+
+@property (nonatomic, strong, readwrite) NSError *error;
+
+@end
+
+@implementation CMISBase64Decoder
+
++ (void)initialize
+{
+    if (self == [CMISBase64Decoder class]) {
+        CMISBase64InitDecodeTable();
+    }
+}
+
++ (NSData *)dataByDecodingText:(NSData *)encodedText
+{
+    CMISBase64Decoder *decoder = [[self alloc] init];
+    NSMutableData *decodedData = [[NSMutableData alloc] initWithLength:[self maximumDecodedLengthForLength:encodedText.length]];
+    NSUInteger decodedLength = [decoder decodeBytes:encodedText.bytes length:encodedText.length toBuffer:decodedData.mutableBytes];
+    if (decodedLength == NSNotFound || ![decoder finish]) {
+        return nil;
+    }
+    
+    decodedData.length = decodedLength;
+    return decodedData;
+}
+
++ (NSUInteger)maximumDecodedLengthForLength:(NSUInteger)length
+{
+    // up to 3 characters of an incomplete group may be left from the previous chunk
+    return (length + 3) / 4 * 3;
+}
+
+- (NSUInteger)decodeBytes:(const char *)bytes length:(NSUInteger)length toBuffer:(uint8_t *)buffer
+{
+    if (self.error) {
+        return NSNotFound;
+    }
+    
+    const uint8_t *input = (const uint8_t *)bytes;
+    NSUInteger written = 0;
+    NSUInteger i = 0;
+    while (i < length) {
+        // between groups, decode as many complete groups as possible at once
+        if (_groupLength == 0 && _paddingLength == 0 && !_ended) {
+            NSUInteger consumed = CMISBase64DecodeGroups(input + i, length - i, buffer + written);
+            i += consumed;
+            written += consumed / 4 * 3;
+            if (i == length) {
+                break;
+            }
+        }
+        
+        uint8_t value = decodeTable[input[i++]];
+        if (value == WHITESPACE) {
+            continue;
+        } else if (value == PADDING) {
+            // padding completes a final group of 2 or 3 characters
+            if (_groupLength < 2 || _groupLength + _paddingLength >= 4) {
+                return [self failWithDescription:@"Unexpected padding in base64 data"];
+            }
+            _paddingLength++;
+            if (_groupLength + _paddingLength == 4) {
+                written += CMISBase64DecodeGroup(_groupValues, _groupLength, buffer + written);
+                _groupLength = 0;
+                _ended = YES;
+            }
+        } else if (value == INVALID || _paddingLength > 0 || _ended) {
+            return [self failWithDescription:@"Invalid character in base64 data"];
+        } else {
+            _groupValues[_groupLength++] = value;
+            if (_groupLength == 4) {
+                written += CMISBase64DecodeGroup(_groupValues, 4, buffer + written);
+                _groupLength = 0;
+            }
+        }
+    }
+    return written;
+}
+
+- (BOOL)finish
+{
+    if (self.error) {
+        return NO;
+    }
+    if (_groupLength > 0 || (_paddingLength > 0 && !_ended)) {
+        [self failWithDescription:@"Incomplete base64 data"];
+        return NO;
+    }
+    return YES;
+}
+
+- (NSUInteger)failWithDescription:(NSString *)description
+{
+    self.error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeParsingFailed detailedDescription:description];
+    return NSNotFound;
+}
+
+@end
@@ -27,6 +27,12 @@
 /// returns base64 encoded data for given input data
 + (NSData *)dataByEncodingText:(NSData *)plainText;
 
+/// returns the length of the base64 encoding, including padding, of the given number of bytes
++ (NSUInteger)encodedLengthForLength:(NSUInteger)length;
+
+/// base64 encodes length bytes into the given buffer, which must hold at least encodedLengthForLength:length bytes; returns the number of encoded bytes
++ (NSUInteger)encodeBytes:(const uint8_t *)bytes length:(NSUInteger)length toBuffer:(char *)buffer;
+
 /// base64 encodes the content of a file
 + (NSString *)encodeContentOfFile:(NSString *)sourceFilePath;
 
@@ -39,4 +45,15 @@
 /// base64 encodes data from an input stream and appends the encoded data to a given destination file
 + (void)encodeContentFromInputStream:(NSInputStream*)inputStream appendToFile:(NSString *)destinationFilePath;
 
+/**
+ * Streaming encoding: an encoder instance encodes data that arrives in chunks of any size.
+ * Bytes that do not complete a group of 3 are kept until the next chunk, so the result is the same as encoding all data at once.
+ * @param buffer must hold at least encodedLengthForLength:(length + 2) bytes
+ * @return the number of encoded bytes written to buffer
+ */
+- (NSUInteger)appendBytes:(const uint8_t *)bytes length:(NSUInteger)length toBuffer:(char *)buffer;
+
+/// encodes the remaining bytes including padding into the buffer, which must hold at least 4 bytes; returns the number of encoded bytes
+- (NSUInteger)finishToBuffer:(char *)buffer;
+
 @end
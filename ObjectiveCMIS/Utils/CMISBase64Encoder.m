@@ -21,7 +21,105 @@
 #import "CMISFileUtil.h"
 #import "CMISLog.h"
 
-static char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define CMIS_BASE64_NEON 1
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define CMIS_BASE64_SSSE3 1
+#endif
+
+// size of the chunks read when encoding files and streams, a multiple of 3
+#define ENCODE_CHUNK_SIZE 524286
+
+static const char alphabet[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/**
+ Encodes all complete groups of 3 bytes and returns the number of input bytes consumed, a multiple of 3.
+ The vector paths work on 48 (NEON) or 12 (SSSE3) bytes at a time, the rest is encoded one group at a time.
+ */
+static NSUInteger CMISBase64EncodeGroups(const uint8_t *input, NSUInteger length, char *output)
+{
+    NSUInteger i = 0;
+    
+#if CMIS_BASE64_NEON
+    const uint8x16x4_t table = { { vld1q_u8((const uint8_t *)alphabet), vld1q_u8((const uint8_t *)alphabet + 16),
+                                   vld1q_u8((const uint8_t *)alphabet + 32), vld1q_u8((const uint8_t *)alphabet + 48) } };
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+    for (; length - i >= 48; i += 48) {
+        // deinterleave into the first, second and third bytes of 16 groups
+        uint8x16x3_t bytes = vld3q_u8(input + i);
+        uint8x16x4_t indices;
+        indices.val[0] = vshrq_n_u8(bytes.val[0], 2);
+        indices.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[1], 4), vshlq_n_u8(bytes.val[0], 4)), mask);
+        indices.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(bytes.val[2], 6), vshlq_n_u8(bytes.val[1], 2)), mask);
+        indices.val[3] = vandq_u8(bytes.val[2], mask);
+        
+        uint8x16x4_t characters;
+        characters.val[0] = vqtbl4q_u8(table, indices.val[0]);
+        characters.val[1] = vqtbl4q_u8(table, indices.val[1]);
+        characters.val[2] = vqtbl4q_u8(table, indices.val[2]);
+        characters.val[3] = vqtbl4q_u8(table, indices.val[3]);
+        vst4q_u8((uint8_t *)output + i / 3 * 4, characters);
+    }
+#elif CMIS_BASE64_SSSE3
+    // 16 bytes are loaded for every 12 encoded, so the loop stops while at least 4 more bytes are left
+    const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    for (; length - i >= 16; i += 12) {
+        // spread each group of 3 bytes over a 32 bit lane and move the four 6 bit indices into separate bytes
+        __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(input + i)), shuffle);
+        __m128i indices = _mm_or_si128(_mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040)),
+                                       _mm_mullo_epi16(_mm_and_si128(bytes, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010)));
+        
+        // map the index ranges A-Z, a-z, 0-9, + and / to the offset that turns an index into its character
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        __m128i characters = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+        _mm_storeu_si128((__m128i *)(output + i / 3 * 4), characters);
+    }
+#endif
+    
+    for (; length - i >= 3; i += 3) {
+        char *out = output + i / 3 * 4;
+        uint32_t group = ((uint32_t)input[i] << 16) | ((uint32_t)input[i + 1] << 8) | input[i + 2];
+        out[0] = alphabet[group >> 18];
+        out[1] = alphabet[(group >> 12) & 0x3F];
+        out[2] = alphabet[(group >> 6) & 0x3F];
+        out[3] = alphabet[group & 0x3F];
+    }
+    return i;
+}
+
+/**
+ Encodes the last 1 or 2 bytes of the data including padding and returns the number of characters written.
+ */
+static NSUInteger CMISBase64EncodeFinalGroup(const uint8_t *input, NSUInteger length, char *output)
+{
+    if (length == 0) {
+        return 0;
+    }
+    
+    output[0] = alphabet[(input[0] & 0xFC) >> 2];
+    if (length == 1) {
+        output[1] = alphabet[(input[0] & 0x03) << 4];
+        output[2] = '=';
+    } else {
+        output[1] = alphabet[((input[0] & 0x03) << 4) | ((input[1] & 0xF0) >> 4)];
+        output[2] = alphabet[(input[1] & 0x0F) << 2];
+    }
+    output[3] = '=';
+    return 4;
+}
+
+
+@interface CMISBase64Encoder ()
+{
+    uint8_t _pendingBytes[3];
+    NSUInteger _pendingLength;
+}
+@end
 
 @implementation CMISBase64Encoder
 
@@ -33,35 +131,55 @@ static char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz012
 
 + (NSData *)dataByEncodingText:(NSData *)plainText
 {
-    NSUInteger encodedLength = (4 * (([plainText length] / 3) + (1 - (3 - ([plainText length] % 3)) / 3)));
-    NSMutableData *encodedData = [[NSMutableData alloc] initWithLength:encodedLength];
-    char *outputBuffer = encodedData.mutableBytes;
-    unsigned char *inputBuffer = (unsigned char *) [plainText bytes];
-
-    NSInteger i;
-    NSInteger j = 0;
-    NSUInteger remain;
-
-    for (i = 0; i < [plainText length]; i += 3) {
-        remain = [plainText length] - i;
-
-        outputBuffer[j++] = alphabet[(inputBuffer[i] & 0xFC) >> 2];
-        outputBuffer[j++] = alphabet[((inputBuffer[i] & 0x03) << 4) |
-                ((remain > 1) ? ((inputBuffer[i + 1] & 0xF0) >> 4) : 0)];
-
-        if (remain > 1)
-            outputBuffer[j++] = alphabet[((inputBuffer[i + 1] & 0x0F) << 2)
-                    | ((remain > 2) ? ((inputBuffer[i + 2] & 0xC0) >> 6) : 0)];
-        else
-            outputBuffer[j++] = '=';
-
-        if (remain > 2)
-            outputBuffer[j++] = alphabet[inputBuffer[i + 2] & 0x3F];
-        else
-            outputBuffer[j++] = '=';
+    NSMutableData *encodedData = [[NSMutableData alloc] initWithLength:[self encodedLengthForLength:plainText.length]];
+    [self encodeBytes:plainText.bytes length:plainText.length toBuffer:encodedData.mutableBytes];
+    return encodedData;
+}
+
++ (NSUInteger)encodedLengthForLength:(NSUInteger)length
+{
+    return (length + 2) / 3 * 4;
+}
+
++ (NSUInteger)encodeBytes:(const uint8_t *)bytes length:(NSUInteger)length toBuffer:(char *)buffer
+{
+    NSUInteger consumed = CMISBase64EncodeGroups(bytes, length, buffer);
+    NSUInteger written = consumed / 3 * 4;
+    return written + CMISBase64EncodeFinalGroup(bytes + consumed, length - consumed, buffer + written);
+}
+
+#pragma mark Streaming encoding
+
+- (NSUInteger)appendBytes:(const uint8_t *)bytes length:(NSUInteger)length toBuffer:(char *)buffer
+{
+    NSUInteger written = 0;
+    
+    // complete the group left over from the previous chunk
+    if (_pendingLength > 0) {
+        while (_pendingLength < 3 && length > 0) {
+            _pendingBytes[_pendingLength++] = *bytes++;
+            length--;
+        }
+        if (_pendingLength < 3) {
+            return 0;
+        }
+        written = CMISBase64EncodeGroups(_pendingBytes, 3, buffer) / 3 * 4;
+        _pendingLength = 0;
     }
+    
+    NSUInteger consumed = CMISBase64EncodeGroups(bytes, length, buffer + written);
+    written += consumed / 3 * 4;
+    
+    _pendingLength = length - consumed;
+    memcpy(_pendingBytes, bytes + consumed, _pendingLength);
+    return written;
+}
 
-    return encodedData;
+- (NSUInteger)finishToBuffer:(char *)buffer
+{
+    NSUInteger written = CMISBase64EncodeFinalGroup(_pendingBytes, _pendingLength, buffer);
+    _pendingLength = 0;
+    return written;
 }
 
 + (NSString *)encodeContentOfFile:(NSString *)sourceFilePath
@@ -70,20 +188,11 @@ static char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz012
 
     NSFileHandle *fileHandle = [NSFileHandle fileHandleForReadingAtPath:sourceFilePath];
     if (fileHandle) {
-        // Get the total file length
-        [fileHandle seekToEndOfFile];
-        unsigned long long fileLength = [fileHandle offsetInFile];
-
-        // Set file offset to start of file
-        unsigned long long currentOffset = 0ULL;
-
-        // Read the data and append it to the file
-        while (currentOffset < fileLength) {
+        // Read the data in chunks that are a multiple of 3, so padding is only added at the end
+        NSData *chunkOfData;
+        while ((chunkOfData = [fileHandle readDataOfLength:ENCODE_CHUNK_SIZE]).length > 0) {
             @autoreleasepool {
-                [fileHandle seekToFileOffset:currentOffset];
-                NSData *chunkOfData = [fileHandle readDataOfLength:32768];
                 [result appendString:[self stringByEncodingText:chunkOfData]];
-                currentOffset += chunkOfData.length;
             }
         }
 
@@ -98,21 +207,11 @@ static char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz012
 
 + (NSString *)encodeContentFromInputStream:(NSInputStream*)inputStream
 {
-    NSMutableString *result = [[NSMutableString alloc] init];
-
-    while ([inputStream hasBytesAvailable]) {
-        @autoreleasepool {
-            NSMutableData *chunkOfData = [[NSMutableData alloc] initWithLength:524288]; // 512 kb
-            NSInteger length = [inputStream read:chunkOfData.mutableBytes maxLength:chunkOfData.length];
-            if (length > 0) {
-                [chunkOfData setLength:length];
-                [result appendString:[self stringByEncodingText:chunkOfData]];
-            } else {
-                break;
-            }
-        }
-    }
-    return result;
+    NSMutableData *result = [[NSMutableData alloc] init];
+    [self encodeContentFromInputStream:inputStream usingBlock:^(NSData *encodedData) {
+        [result appendData:encodedData];
+    }];
+    return [[NSString alloc] initWithData:result encoding:NSUTF8StringEncoding];
 }
 
 
@@ -120,20 +219,11 @@ static char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz012
 {
     NSFileHandle *fileHandle = [NSFileHandle fileHandleForReadingAtPath:sourceFilePath];
     if (fileHandle) {
-        // Get the total file length
-        [fileHandle seekToEndOfFile];
-        unsigned long long fileLength = [fileHandle offsetInFile];
-
-        // Set file offset to start of file
-        unsigned long long currentOffset = 0ULL;
-
-        // Read the data and append it to the file
-        while (currentOffset < fileLength) {
+        // Read the data in chunks that are a multiple of 3 and append it to the file
+        NSData *chunkOfData;
+        while ((chunkOfData = [fileHandle readDataOfLength:ENCODE_CHUNK_SIZE]).length > 0) {
             @autoreleasepool {
-                [fileHandle seekToFileOffset:currentOffset];
-                NSData *chunkOfData = [fileHandle readDataOfLength:524288]; // 512 kb
                 [CMISFileUtil appendToFileAtPath:destinationFilePath data:[self dataByEncodingText:chunkOfData]];
-                currentOffset += chunkOfData.length;
             }
         }
 
@@ -148,22 +238,39 @@ static char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz012
 {
     [inputStream open];
     
+    [self encodeContentFromInputStream:inputStream usingBlock:^(NSData *encodedData) {
+        [CMISFileUtil appendToFileAtPath:destinationFilePath data:encodedData];
+    }];
+    
+    [inputStream close];
+}
+
+/**
+ Streams may return fewer bytes than requested, so the chunks are encoded with a streaming encoder
+ that carries incomplete groups over to the next chunk.
+ */
++ (void)encodeContentFromInputStream:(NSInputStream *)inputStream usingBlock:(void (^)(NSData *encodedData))block
+{
+    CMISBase64Encoder *encoder = [[CMISBase64Encoder alloc] init];
+    NSMutableData *chunkOfData = [[NSMutableData alloc] initWithLength:ENCODE_CHUNK_SIZE];
+    NSMutableData *encodedChunkOfData = [[NSMutableData alloc] initWithLength:[self encodedLengthForLength:ENCODE_CHUNK_SIZE + 2]];
+    
     while ([inputStream hasBytesAvailable]) {
         @autoreleasepool {
-            NSMutableData *chunkOfData = [[NSMutableData alloc] initWithLength:524288]; // 512 kb
             NSInteger length = [inputStream read:chunkOfData.mutableBytes maxLength:chunkOfData.length];
             if (length > 0) {
-                [chunkOfData setLength:length];
-                NSData *encodedChunkOfData = [self dataByEncodingText:chunkOfData];
-                [CMISFileUtil appendToFileAtPath:destinationFilePath data:encodedChunkOfData];
+                NSUInteger encodedLength = [encoder appendBytes:chunkOfData.bytes length:length toBuffer:encodedChunkOfData.mutableBytes];
+                block([NSData dataWithBytesNoCopy:encodedChunkOfData.mutableBytes length:encodedLength freeWhenDone:NO]);
             } else {
                 break;
             }
         }
     }
     
-    [inputStream close];
+    NSUInteger encodedLength = [encoder finishToBuffer:encodedChunkOfData.mutableBytes];
+    if (encodedLength > 0) {
+        block([NSData dataWithBytesNoCopy:encodedChunkOfData.mutableBytes length:encodedLength freeWhenDone:NO]);
+    }
 }
 
-
 @end
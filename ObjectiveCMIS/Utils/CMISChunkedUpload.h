@@ -0,0 +1,94 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+
+#import <Foundation/Foundation.h>
+#import "CMISRequest.h"
+#import "CMISObjectService.h"
+
+/**
+ * Uploads the content of a file to a document in parts (CMIS 1.1).
+ *
+ * The first part replaces the content of the document, the following parts are added with appendContentStream and
+ * the last part is flagged as the last chunk. The next part is read from the file while the current one is sent.
+ * If a checkpoint file is given, the number of bytes acknowledged by the repository is recorded in it after each part.
+ * A later upload of the same file to the same document with the same checkpoint file checks the content length stored
+ * by the repository and continues with the first part that has not been stored, instead of starting over.
+ */
+@interface CMISChunkedUpload : NSObject <CMISCancellableRequest>
+
+/// the length of the file
+@property (nonatomic, assign, readonly) unsigned long long contentLength;
+
+/// the number of bytes the repository has acknowledged, including the bytes stored by an earlier upload that is resumed
+@property (nonatomic, assign, readonly) unsigned long long bytesAcknowledged;
+
+/// the id of the document, updated if the repository returns a new id for a part
+@property (nonatomic, strong, readonly) NSString *objectId;
+
+/**
+ * Splits content of the given length into parts of the given size, the last part may be shorter.
+ * Returns an array of parts, each part being an array of two NSNumbers: the offset and the length of the part.
+ * Empty content is a single part of length 0.
+ */
++ (NSArray *)partsForContentLength:(unsigned long long)contentLength partSize:(unsigned long long)partSize;
+
+/**
+ * Returns the index of the part an interrupted upload continues with, or NSNotFound if it has to start over.
+ * @param parts the parts of the content as returned by partsForContentLength:partSize:
+ * @param bytesAcknowledged the number of bytes recorded in the checkpoint
+ * @param storedLength the content length the repository currently stores for the document
+ */
++ (NSUInteger)resumePartIndexForParts:(NSArray *)parts
+                    bytesAcknowledged:(unsigned long long)bytesAcknowledged
+                         storedLength:(unsigned long long)storedLength;
+
+/**
+ * Initialises the upload.
+ * @param objectService the object service used to send the parts
+ * @param objectId the id of the document to upload the content to
+ * @param changeToken the change token of the document or nil
+ * @param partSize the maximum number of bytes sent with one request
+ */
+- (id)initWithObjectService:(id<CMISObjectService>)objectService
+                   objectId:(NSString *)objectId
+                changeToken:(NSString *)changeToken
+                   partSize:(unsigned long long)partSize;
+
+/**
+ * Uploads the content of the given file.
+ * Must be called on a thread with a run loop, all blocks are called on that thread.
+ * @param filePath the path of the file to upload
+ * @param mimeType the mime type of the content, defaults to application/octet-stream if nil
+ * @param checkpointFilePath the file progress is recorded in so the upload can be resumed, or nil
+ * @param cmisRequest the request handle of the caller, cancelling it cancels the upload of the current part
+ * @param completionBlock called with nil if all parts have been acknowledged, the checkpoint file is then removed
+ * @param partCompletionBlock called for each acknowledged part with its index, its length and the rate it was sent at
+ * @param progressBlock called with the number of bytes uploaded for all parts
+ */
+- (void)uploadContentOfFile:(NSString *)filePath
+                   mimeType:(NSString *)mimeType
+         checkpointFilePath:(NSString *)checkpointFilePath
+                cmisRequest:(CMISRequest *)cmisRequest
+            completionBlock:(void (^)(NSError *error))completionBlock
+        partCompletionBlock:(void (^)(NSUInteger partIndex, unsigned long long partLength, double bytesPerSecond))partCompletionBlock
+              progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock;
+
+@end
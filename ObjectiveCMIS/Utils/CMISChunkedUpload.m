@@ -0,0 +1,473 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+
+#import "CMISChunkedUpload.h"
+#import "CMISStringInOutParameter.h"
+#import "CMISObjectData.h"
+#import "CMISConstants.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// keys of the checkpoint file
+#define CHECKPOINT_KEY_OBJECT_ID @"objectId"
+#define CHECKPOINT_KEY_CURRENT_OBJECT_ID @"currentObjectId"
+#define CHECKPOINT_KEY_CHANGE_TOKEN @"changeToken"
+#define CHECKPOINT_KEY_FILE_SIZE @"fileSize"
+#define CHECKPOINT_KEY_FILE_MODIFICATION_DATE @"fileModificationDate"
+#define CHECKPOINT_KEY_PART_SIZE @"partSize"
+#define CHECKPOINT_KEY_BYTES_ACKNOWLEDGED @"bytesAcknowledged"
+
+@interface CMISChunkedUpload ()
+
+@property (nonatomic, strong) id<CMISObjectService> objectService;
+@property (nonatomic, strong, readwrite) NSString *objectId;
+@property (nonatomic, strong) NSString *originalObjectId;
+@property (nonatomic, strong) NSString *changeToken;
+@property (nonatomic, assign) unsigned long long partSize;
+@property (nonatomic, assign, readwrite) unsigned long long contentLength;
+@property (nonatomic, assign, readwrite) unsigned long long bytesAcknowledged;
+@property (nonatomic, strong) NSArray *parts;
+@property (nonatomic, strong) NSString *fileName;
+@property (nonatomic, strong) NSString *mimeType;
+@property (nonatomic, strong) NSDate *fileModificationDate;
+@property (nonatomic, strong) NSString *checkpointFilePath;
+@property (nonatomic, assign) int fileDescriptor;
+@property (nonatomic, strong) dispatch_queue_t readQueue;
+@property (nonatomic, strong) NSThread *originalThread;
+@property (nonatomic, strong) NSData *preparedPart; // the content of the next part once it has been read
+@property (nonatomic, assign) NSUInteger preparedPartIndex;
+@property (nonatomic, assign) BOOL sendingPart;
+@property (nonatomic, strong) CMISRequest *partRequest; // request of the part being sent, or of the resume check
+@property (nonatomic, strong) NSDate *partStartDate;
+@property (nonatomic, assign) BOOL finished;
+@property (nonatomic, copy) void (^completionBlock)(NSError *error);
+@property (nonatomic, copy) void (^partCompletionBlock)(NSUInteger partIndex, unsigned long long partLength, double bytesPerSecond);
+@property (nonatomic, copy) void (^progressBlock)(unsigned long long bytesUploaded, unsigned long long bytesTotal);
+
+@end
+
+
+@implementation CMISChunkedUpload
+
++ (NSArray *)partsForContentLength:(unsigned long long)contentLength partSize:(unsigned long long)partSize
+{
+    partSize = MAX(partSize, 1);
+    
+    NSMutableArray *parts = [NSMutableArray arrayWithCapacity:(NSUInteger)(contentLength / partSize + 1)];
+    unsigned long long offset = 0;
+    do {
+        unsigned long long length = MIN(partSize, contentLength - offset);
+        [parts addObject:@[@(offset), @(length)]];
+        offset += length;
+    } while (offset < contentLength);
+    return parts;
+}
+
++ (NSUInteger)resumePartIndexForParts:(NSArray *)parts
+                    bytesAcknowledged:(unsigned long long)bytesAcknowledged
+                         storedLength:(unsigned long long)storedLength
+{
+    NSArray *lastPart = [parts lastObject];
+    unsigned long long contentLength = [[lastPart objectAtIndex:0] unsignedLongLongValue] + [[lastPart objectAtIndex:1] unsignedLongLongValue];
+    if (bytesAcknowledged == 0 || bytesAcknowledged > contentLength) {
+        return NSNotFound;
+    }
+    if (bytesAcknowledged == contentLength && storedLength == contentLength) {
+        return parts.count;
+    }
+    
+    for (NSUInteger i = 0; i < parts.count; i++) {
+        NSArray *part = [parts objectAtIndex:i];
+        unsigned long long offset = [[part objectAtIndex:0] unsignedLongLongValue];
+        if (offset == bytesAcknowledged) {
+            if (storedLength == offset) {
+                return i;
+            } else if (storedLength == offset + [[part objectAtIndex:1] unsignedLongLongValue]) {
+                // the part was stored but the response did not arrive
+                return i + 1;
+            }
+            break;
+        }
+    }
+    return NSNotFound;
+}
+
+- (id)initWithObjectService:(id<CMISObjectService>)objectService
+                   objectId:(NSString *)objectId
+                changeToken:(NSString *)changeToken
+                   partSize:(unsigned long long)partSize
+{
+    self = [super init];
+    if (self) {
+        _objectService = objectService;
+        _objectId = objectId;
+        _originalObjectId = objectId;
+        _changeToken = changeToken;
+        _partSize = MAX(partSize, 1);
+        _fileDescriptor = -1;
+        _readQueue = dispatch_queue_create("org.apache.chemistry.objectivecmis.chunkedupload", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)uploadContentOfFile:(NSString *)filePath
+                   mimeType:(NSString *)mimeType
+         checkpointFilePath:(NSString *)checkpointFilePath
+                cmisRequest:(CMISRequest *)cmisRequest
+            completionBlock:(void (^)(NSError *error))completionBlock
+        partCompletionBlock:(void (^)(NSUInteger partIndex, unsigned long long partLength, double bytesPerSecond))partCompletionBlock
+              progressBlock:(void (^)(unsigned long long bytesUploaded, unsigned long long bytesTotal))progressBlock
+{
+    if (cmisRequest.isCancelled) {
+        if (completionBlock) {
+            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                            detailedDescription:@"Request was cancelled"]);
+        }
+        return;
+    }
+    
+    self.fileName = [filePath lastPathComponent];
+    self.mimeType = (mimeType ? mimeType : kCMISMediaTypeOctetStream);
+    self.checkpointFilePath = checkpointFilePath;
+    self.originalThread = [NSThread currentThread];
+    self.completionBlock = completionBlock;
+    self.partCompletionBlock = partCompletionBlock;
+    self.progressBlock = progressBlock;
+    
+    NSDictionary *attributes = [[NSFileManager defaultManager] attributesOfItemAtPath:filePath error:nil];
+    self.fileDescriptor = open(filePath.fileSystemRepresentation, O_RDONLY);
+    if (attributes == nil || self.fileDescriptor < 0) {
+        CMISLogError(@"Could not open file %@", filePath);
+        [self finishWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeInvalidArgument
+                                              detailedDescription:[NSString stringWithFormat:@"Could not open file %@", filePath]]];
+        return;
+    }
+    self.contentLength = [attributes fileSize];
+    self.fileModificationDate = [attributes fileModificationDate];
+    self.parts = [CMISChunkedUpload partsForContentLength:self.contentLength partSize:self.partSize];
+    
+    cmisRequest.httpRequest = self;
+    
+    NSDictionary *checkpoint = (checkpointFilePath ? [NSDictionary dictionaryWithContentsOfFile:checkpointFilePath] : nil);
+    if ([self isMatchingCheckpoint:checkpoint]) {
+        [self resumeFromCheckpoint:checkpoint];
+    } else {
+        [self startAtPartIndex:0];
+    }
+}
+
+#pragma mark CMISCancellableRequest method
+
+- (void)cancel
+{
+    [self finishWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                          detailedDescription:@"Request was cancelled"]];
+}
+
+#pragma mark Private methods
+
+- (BOOL)isMatchingCheckpoint:(NSDictionary *)checkpoint
+{
+    return (checkpoint != nil &&
+            [[checkpoint objectForKey:CHECKPOINT_KEY_OBJECT_ID] isEqual:self.originalObjectId] &&
+            [[checkpoint objectForKey:CHECKPOINT_KEY_FILE_SIZE] unsignedLongLongValue] == self.contentLength &&
+            [[checkpoint objectForKey:CHECKPOINT_KEY_FILE_MODIFICATION_DATE] isEqual:self.fileModificationDate] &&
+            [[checkpoint objectForKey:CHECKPOINT_KEY_PART_SIZE] unsignedLongLongValue] == self.partSize &&
+            [checkpoint objectForKey:CHECKPOINT_KEY_CURRENT_OBJECT_ID] != nil);
+}
+
+/// asks the repository how much of the content it has stored and continues with the first part it does not have
+- (void)resumeFromCheckpoint:(NSDictionary *)checkpoint
+{
+    NSString *currentObjectId = [checkpoint objectForKey:CHECKPOINT_KEY_CURRENT_OBJECT_ID];
+    unsigned long long bytesAcknowledged = [[checkpoint objectForKey:CHECKPOINT_KEY_BYTES_ACKNOWLEDGED] unsignedLongLongValue];
+    NSString *filter = [@[kCMISPropertyObjectId, kCMISPropertyContentStreamLength, kCMISPropertyChangeToken] componentsJoinedByString:@","];
+    
+    self.sendingPart = YES;
+    CMISRequest *request = [self.objectService retrieveObject:currentObjectId
+                                                       filter:filter
+                                                relationships:CMISIncludeRelationshipNone
+                                             includePolicyIds:NO
+                                              renditionFilter:nil
+                                                   includeACL:NO
+                                      includeAllowableActions:NO
+                                              completionBlock:^(CMISObjectData *objectData, NSError *error) {
+        self.sendingPart = NO;
+        @synchronized(self) {
+            self.partRequest = nil;
+        }
+        if (self.finished) {
+            return;
+        }
+        
+        NSUInteger partIndex = NSNotFound;
+        if (objectData) {
+            unsigned long long storedLength = [[[objectData.properties.propertiesDictionary objectForKey:kCMISPropertyContentStreamLength] firstValue] unsignedLongLongValue];
+            partIndex = [CMISChunkedUpload resumePartIndexForParts:self.parts bytesAcknowledged:bytesAcknowledged storedLength:storedLength];
+        } else {
+            CMISLogDebug(@"Could not retrieve object %@ to resume upload: %@", currentObjectId, error);
+        }
+        
+        if (partIndex == NSNotFound) {
+            CMISLogDebug(@"Content stored for object %@ does not match checkpoint, upload starts over", currentObjectId);
+            [self startAtPartIndex:0];
+        } else {
+            CMISLogDebug(@"Resuming upload to object %@ with part %lu", currentObjectId, (unsigned long)partIndex);
+            self.objectId = currentObjectId;
+            self.changeToken = [[objectData.properties.propertiesDictionary objectForKey:kCMISPropertyChangeToken] firstValue];
+            self.bytesAcknowledged = (partIndex < self.parts.count ? [[[self.parts objectAtIndex:partIndex] objectAtIndex:0] unsignedLongLongValue] : self.contentLength);
+            [self startAtPartIndex:partIndex];
+        }
+    }];
+    [self trackPartRequest:request];
+}
+
+- (void)startAtPartIndex:(NSUInteger)index
+{
+    if (index >= self.parts.count) {
+        [self finishWithError:nil];
+    } else {
+        [self preparePartAtIndex:index];
+    }
+}
+
+/// reads the content of the part on the read queue, the part is handed back on the original thread
+- (void)preparePartAtIndex:(NSUInteger)index
+{
+    NSArray *part = [self.parts objectAtIndex:index];
+    off_t offset = (off_t)[[part objectAtIndex:0] unsignedLongLongValue];
+    size_t length = (size_t)[[part objectAtIndex:1] unsignedLongLongValue];
+    int fileDescriptor = self.fileDescriptor;
+    
+    dispatch_async(self.readQueue, ^{
+        NSMutableData *data = [NSMutableData dataWithLength:length];
+        size_t bytesRead = 0;
+        while (data && bytesRead < length) {
+            ssize_t result = pread(fileDescriptor, (uint8_t *)data.mutableBytes + bytesRead, length - bytesRead, offset + (off_t)bytesRead);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            } else if (result <= 0) {
+                break;
+            }
+            bytesRead += (size_t)result;
+        }
+        
+        id partResult = data;
+        if (data == nil || bytesRead != length) {
+            partResult = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                         detailedDescription:[NSString stringWithFormat:@"Could not read part %lu of file %@", (unsigned long)index, self.fileName]];
+        }
+        [self performSelector:@selector(partPrepared:) onThread:self.originalThread withObject:@[@(index), partResult] waitUntilDone:NO];
+    });
+}
+
+- (void)partPrepared:(NSArray *)partResult
+{
+    if (self.finished) {
+        return;
+    }
+    
+    id result = [partResult objectAtIndex:1];
+    if ([result isKindOfClass:[NSError class]]) {
+        [self finishWithError:result];
+        return;
+    }
+    
+    self.preparedPart = result;
+    self.preparedPartIndex = [[partResult objectAtIndex:0] unsignedIntegerValue];
+    [self sendPreparedPartIfIdle];
+}
+
+/// sends the prepared part once the previous part has been acknowledged and starts reading the part after it
+- (void)sendPreparedPartIfIdle
+{
+    if (self.finished || self.sendingPart || self.preparedPart == nil) {
+        return;
+    }
+    
+    NSData *partData = self.preparedPart;
+    NSUInteger index = self.preparedPartIndex;
+    self.preparedPart = nil;
+    if (index + 1 < self.parts.count) {
+        [self preparePartAtIndex:index + 1];
+    }
+    
+    CMISStringInOutParameter *objectIdParam = [CMISStringInOutParameter inOutParameterUsingInParameter:self.objectId];
+    CMISStringInOutParameter *changeTokenParam = [CMISStringInOutParameter inOutParameterUsingInParameter:self.changeToken];
+    unsigned long long bytesAcknowledged = self.bytesAcknowledged;
+    
+    void (^partCompletionBlock)(NSError *error) = ^(NSError *error) {
+        [self partAtIndex:index didCompleteWithObjectId:objectIdParam changeToken:changeTokenParam error:error];
+    };
+    void (^partProgressBlock)(unsigned long long, unsigned long long) = ^(unsigned long long bytesUploaded, unsigned long long bytesTotal) {
+        // the total of a part may include the multipart overhead of the browser binding
+        if (self.progressBlock && !self.finished) {
+            self.progressBlock(bytesAcknowledged + MIN(bytesUploaded, partData.length), self.contentLength);
+        }
+    };
+    
+    self.sendingPart = YES;
+    self.partStartDate = [NSDate date];
+    CMISRequest *request = nil;
+    if (index == 0) {
+        // the first part replaces any existing content
+        request = [self.objectService changeContentOfObject:objectIdParam
+                                     toContentOfInputStream:[NSInputStream inputStreamWithData:partData]
+                                              bytesExpected:partData.length
+                                                   filename:self.fileName
+                                                   mimeType:self.mimeType
+                                          overwriteExisting:YES
+                                                changeToken:changeTokenParam
+                                            completionBlock:partCompletionBlock
+                                              progressBlock:partProgressBlock];
+    } else {
+        request = [self.objectService appendContentOfObject:objectIdParam
+                                            fromInputStream:[NSInputStream inputStreamWithData:partData]
+                                              bytesExpected:partData.length
+                                                   filename:self.fileName
+                                                   mimeType:self.mimeType
+                                                isLastChunk:(index + 1 == self.parts.count)
+                                                changeToken:changeTokenParam
+                                            completionBlock:partCompletionBlock
+                                              progressBlock:partProgressBlock];
+    }
+    [self trackPartRequest:request];
+}
+
+/// keeps the request of the part being sent so it can be cancelled, unless it has already completed
+- (void)trackPartRequest:(CMISRequest *)request
+{
+    BOOL finished;
+    @synchronized(self) {
+        finished = self.finished;
+        if (!finished && self.sendingPart) {
+            self.partRequest = request;
+        }
+    }
+    if (finished) {
+        [request cancel];
+    }
+}
+
+- (void)partAtIndex:(NSUInteger)index
+didCompleteWithObjectId:(CMISStringInOutParameter *)objectIdParam
+        changeToken:(CMISStringInOutParameter *)changeTokenParam
+              error:(NSError *)error
+{
+    self.sendingPart = NO;
+    @synchronized(self) {
+        self.partRequest = nil;
+    }
+    if (self.finished) {
+        return;
+    }
+    if (error) {
+        [self finishWithError:error];
+        return;
+    }
+    
+    NSTimeInterval duration = -[self.partStartDate timeIntervalSinceNow];
+    unsigned long long partLength = [[[self.parts objectAtIndex:index] objectAtIndex:1] unsignedLongLongValue];
+    self.bytesAcknowledged += partLength;
+    if (objectIdParam.outParameter) {
+        self.objectId = objectIdParam.outParameter;
+    }
+    // the atom pub binding does not return the new change token, the old one must not be sent again
+    self.changeToken = changeTokenParam.outParameter;
+    
+    if (self.partCompletionBlock) {
+        self.partCompletionBlock(index, partLength, (duration > 0 ? partLength / duration : 0));
+    }
+    
+    if (index + 1 == self.parts.count) {
+        [self finishWithError:nil];
+    } else {
+        [self writeCheckpoint];
+        [self sendPreparedPartIfIdle];
+    }
+}
+
+- (void)writeCheckpoint
+{
+    if (self.checkpointFilePath == nil) {
+        return;
+    }
+    
+    NSMutableDictionary *checkpoint = [NSMutableDictionary dictionary];
+    [checkpoint setObject:self.originalObjectId forKey:CHECKPOINT_KEY_OBJECT_ID];
+    [checkpoint setObject:self.objectId forKey:CHECKPOINT_KEY_CURRENT_OBJECT_ID];
+    if (self.changeToken) {
+        [checkpoint setObject:self.changeToken forKey:CHECKPOINT_KEY_CHANGE_TOKEN];
+    }
+    [checkpoint setObject:@(self.contentLength) forKey:CHECKPOINT_KEY_FILE_SIZE];
+    if (self.fileModificationDate) {
+        [checkpoint setObject:self.fileModificationDate forKey:CHECKPOINT_KEY_FILE_MODIFICATION_DATE];
+    }
+    [checkpoint setObject:@(self.partSize) forKey:CHECKPOINT_KEY_PART_SIZE];
+    [checkpoint setObject:@(self.bytesAcknowledged) forKey:CHECKPOINT_KEY_BYTES_ACKNOWLEDGED];
+    
+    if (![checkpoint writeToFile:self.checkpointFilePath atomically:YES]) {
+        CMISLogWarning(@"Could not write upload checkpoint to %@", self.checkpointFilePath);
+    }
+}
+
+- (void)finishWithError:(NSError *)error
+{
+    CMISRequest *partRequest = nil;
+    @synchronized(self) {
+        if (self.finished) {
+            return;
+        }
+        self.finished = YES;
+        partRequest = self.partRequest;
+        self.partRequest = nil;
+    }
+    
+    [partRequest cancel];
+    
+    // parts may still be read, the file is closed once the read queue is done with them
+    int fileDescriptor = self.fileDescriptor;
+    self.fileDescriptor = -1;
+    if (fileDescriptor >= 0) {
+        dispatch_async(self.readQueue, ^{
+            close(fileDescriptor);
+        });
+    }
+    self.preparedPart = nil;
+    
+    // a failed upload keeps its checkpoint so it can be resumed
+    if (!error && self.checkpointFilePath) {
+        [[NSFileManager defaultManager] removeItemAtPath:self.checkpointFilePath error:nil];
+    }
+    
+    void (^completionBlock)(NSError *error) = self.completionBlock;
+    self.completionBlock = nil;
+    self.partCompletionBlock = nil;
+    self.progressBlock = nil;
+    if (completionBlock) {
+        completionBlock(error);
+    }
+}
+
+@end
@@ -0,0 +1,83 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+@class CMISBindingSession;
+
+typedef NS_ENUM(NSInteger, CMISCircuitBreakerState)
+{
+    CMISCircuitBreakerStateClosed,   // requests are sent
+    CMISCircuitBreakerStateOpen,     // requests fail immediately
+    CMISCircuitBreakerStateHalfOpen  // a single probe request is sent to find out whether the host has recovered
+};
+
+/// posted when the state of a host changes, the object is the circuit breaker
+extern NSString * const kCMISCircuitBreakerStateDidChangeNotification;
+
+/// user info key of the notification holding the host as NSString
+extern NSString * const kCMISCircuitBreakerHostKey;
+
+/// user info key of the notification holding the new state as NSNumber
+extern NSString * const kCMISCircuitBreakerStateKey;
+
+/// user info key of the notification holding the previous state as NSNumber
+extern NSString * const kCMISCircuitBreakerPreviousStateKey;
+
+/**
+ * Stops sending requests to a host that keeps failing, so callers fail immediately instead of waiting for timeouts.
+ *
+ * The outcome of the recent requests to each host is recorded. Connection errors, server errors (5xx), 429 responses
+ * and requests waiting longer than the slow call threshold for the response headers count as failures. Once the failure ratio exceeds the
+ * configured threshold the breaker opens and requests to the host are rejected. After the open interval a single
+ * probe request is let through (half-open): if it succeeds the breaker closes, otherwise it opens again.
+ */
+@interface CMISCircuitBreaker : NSObject
+
+/// the ratio of failed requests (0 - 1) that opens the breaker
+@property (nonatomic, assign) double failureRatioThreshold;
+
+/// requests waiting longer than this number of seconds for the response headers count as failures, 0 disables the latency check
+@property (nonatomic, assign) NSTimeInterval slowCallThreshold;
+
+/// the number of seconds the breaker stays open before a probe request is let through
+@property (nonatomic, assign) NSTimeInterval openInterval;
+
+- (id)initWithBindingSession:(CMISBindingSession *)bindingSession;
+
+/**
+ * Returns YES if a request may be sent to the given host. If YES is returned, the outcome of the request must be
+ * reported with recordOutcomeForHost:success:duration: or releaseRequestForHost:.
+ */
+- (BOOL)allowRequestToHost:(NSString *)host;
+
+/// Records the outcome of a request allowed by allowRequestToHost:, the duration is the time until the response headers were received.
+- (void)recordOutcomeForHost:(NSString *)host success:(BOOL)success duration:(NSTimeInterval)duration;
+
+/// Releases a request allowed by allowRequestToHost: without recording an outcome, e.g. because it was cancelled.
+- (void)releaseRequestForHost:(NSString *)host;
+
+/// returns the current state of the given host
+- (CMISCircuitBreakerState)stateForHost:(NSString *)host;
+
+/// the number of requests rejected because the breaker was open
+- (NSUInteger)rejectedRequestCount;
+
+@end
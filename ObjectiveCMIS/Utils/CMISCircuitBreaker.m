@@ -0,0 +1,241 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISCircuitBreaker.h"
+#import "CMISBindingSession.h"
+#import "CMISLog.h"
+
+NSString * const kCMISCircuitBreakerStateDidChangeNotification = @"CMISCircuitBreakerStateDidChangeNotification";
+NSString * const kCMISCircuitBreakerHostKey = @"host";
+NSString * const kCMISCircuitBreakerStateKey = @"state";
+NSString * const kCMISCircuitBreakerPreviousStateKey = @"previousState";
+
+// Default failure ratio opening the breaker
+#define DEFAULT_CIRCUIT_BREAKER_FAILURE_RATIO 0.5
+
+// Default time in seconds to receive the response headers after which a request counts as failed
+#define DEFAULT_CIRCUIT_BREAKER_SLOW_CALL_THRESHOLD 10.0
+
+// Default duration in seconds the breaker stays open
+#define DEFAULT_CIRCUIT_BREAKER_OPEN_INTERVAL 30.0
+
+// the number of recent outcomes kept per host
+#define OUTCOME_WINDOW_SIZE 20
+
+// the number of outcomes needed before the breaker can open
+#define MIN_OUTCOMES 10
+
+/**
+ State and recent outcomes of a single host.
+ */
+@interface CMISCircuitBreakerHost : NSObject
+{
+    @public
+    BOOL _outcomes[OUTCOME_WINDOW_SIZE]; // ring buffer, YES for a failure
+    NSUInteger _outcomeCount;
+    NSUInteger _nextOutcomeIndex;
+    NSUInteger _failureCount;
+}
+
+@property (nonatomic, assign) CMISCircuitBreakerState state;
+@property (nonatomic, strong) NSDate *openDate;
+@property (nonatomic, assign) BOOL probeInFlight;
+
+- (void)addOutcome:(BOOL)failed;
+- (void)resetOutcomes;
+
+@end
+
+
+@interface CMISCircuitBreaker ()
+{
+    NSUInteger _rejectedRequestCount;
+}
+
+@property (nonatomic, strong) NSMutableDictionary *hosts;
+
+@end
+
+
+@implementation CMISCircuitBreaker
+
+- (id)initWithBindingSession:(CMISBindingSession *)bindingSession
+{
+    self = [super init];
+    if (self) {
+        _hosts = [[NSMutableDictionary alloc] init];
+        _failureRatioThreshold = [[bindingSession objectForKey:kCMISSessionParameterCircuitBreakerFailureRatio
+                                                  defaultValue:@(DEFAULT_CIRCUIT_BREAKER_FAILURE_RATIO)] doubleValue];
+        _slowCallThreshold = [[bindingSession objectForKey:kCMISSessionParameterCircuitBreakerSlowCallThreshold
+                                              defaultValue:@(DEFAULT_CIRCUIT_BREAKER_SLOW_CALL_THRESHOLD)] doubleValue];
+        _openInterval = [[bindingSession objectForKey:kCMISSessionParameterCircuitBreakerOpenInterval
+                                         defaultValue:@(DEFAULT_CIRCUIT_BREAKER_OPEN_INTERVAL)] doubleValue];
+    }
+    return self;
+}
+
+- (BOOL)allowRequestToHost:(NSString *)host
+{
+    CMISCircuitBreakerState previousState, state;
+    BOOL allowed = YES;
+    @synchronized(self) {
+        CMISCircuitBreakerHost *breakerHost = [self breakerHostForHost:host];
+        previousState = breakerHost.state;
+        
+        if (breakerHost.state == CMISCircuitBreakerStateOpen && -[breakerHost.openDate timeIntervalSinceNow] >= self.openInterval) {
+            breakerHost.state = CMISCircuitBreakerStateHalfOpen;
+            breakerHost.probeInFlight = NO;
+        }
+        
+        if (breakerHost.state == CMISCircuitBreakerStateOpen) {
+            allowed = NO;
+        } else if (breakerHost.state == CMISCircuitBreakerStateHalfOpen) {
+            allowed = !breakerHost.probeInFlight;
+            breakerHost.probeInFlight = YES;
+        }
+        
+        if (!allowed) {
+            _rejectedRequestCount++;
+        }
+        state = breakerHost.state;
+    }
+    
+    [self notifyStateChangeForHost:host fromState:previousState toState:state];
+    return allowed;
+}
+
+- (void)recordOutcomeForHost:(NSString *)host success:(BOOL)success duration:(NSTimeInterval)duration
+{
+    BOOL failed = !success || (self.slowCallThreshold > 0 && duration > self.slowCallThreshold);
+    
+    CMISCircuitBreakerState previousState, state;
+    @synchronized(self) {
+        CMISCircuitBreakerHost *breakerHost = [self breakerHostForHost:host];
+        previousState = breakerHost.state;
+        
+        if (breakerHost.state == CMISCircuitBreakerStateHalfOpen) {
+            // the probe decides whether the host has recovered
+            breakerHost.probeInFlight = NO;
+            if (failed) {
+                breakerHost.state = CMISCircuitBreakerStateOpen;
+                breakerHost.openDate = [NSDate date];
+            } else {
+                breakerHost.state = CMISCircuitBreakerStateClosed;
+                [breakerHost resetOutcomes];
+            }
+        } else if (breakerHost.state == CMISCircuitBreakerStateClosed) {
+            [breakerHost addOutcome:failed];
+            if (breakerHost->_outcomeCount >= MIN_OUTCOMES &&
+                (double)breakerHost->_failureCount / breakerHost->_outcomeCount >= self.failureRatioThreshold) {
+                breakerHost.state = CMISCircuitBreakerStateOpen;
+                breakerHost.openDate = [NSDate date];
+            }
+        }
+        state = breakerHost.state;
+    }
+    
+    [self notifyStateChangeForHost:host fromState:previousState toState:state];
+}
+
+- (void)releaseRequestForHost:(NSString *)host
+{
+    @synchronized(self) {
+        CMISCircuitBreakerHost *breakerHost = [self breakerHostForHost:host];
+        if (breakerHost.state == CMISCircuitBreakerStateHalfOpen) {
+            breakerHost.probeInFlight = NO; // let the next request probe the host
+        }
+    }
+}
+
+- (CMISCircuitBreakerState)stateForHost:(NSString *)host
+{
+    @synchronized(self) {
+        return [self breakerHostForHost:host].state;
+    }
+}
+
+- (NSUInteger)rejectedRequestCount
+{
+    @synchronized(self) {
+        return _rejectedRequestCount;
+    }
+}
+
+#pragma mark Private methods
+
+/// must be called while holding the lock
+- (CMISCircuitBreakerHost *)breakerHostForHost:(NSString *)host
+{
+    NSString *hostKey = host ? host.lowercaseString : @"";
+    CMISCircuitBreakerHost *breakerHost = [self.hosts objectForKey:hostKey];
+    if (breakerHost == nil) {
+        breakerHost = [[CMISCircuitBreakerHost alloc] init];
+        [self.hosts setObject:breakerHost forKey:hostKey];
+    }
+    return breakerHost;
+}
+
+- (void)notifyStateChangeForHost:(NSString *)host fromState:(CMISCircuitBreakerState)previousState toState:(CMISCircuitBreakerState)state
+{
+    if (previousState == state) {
+        return;
+    }
+    
+    CMISLogInfo(@"Circuit breaker for host %@ changed from state %d to %d", host, (int)previousState, (int)state);
+    
+    NSDictionary *userInfo = @{kCMISCircuitBreakerHostKey : (host ? host : @""),
+                               kCMISCircuitBreakerStateKey : @(state),
+                               kCMISCircuitBreakerPreviousStateKey : @(previousState)};
+    [[NSNotificationCenter defaultCenter] postNotificationName:kCMISCircuitBreakerStateDidChangeNotification
+                                                        object:self
+                                                      userInfo:userInfo];
+}
+
+@end
+
+
+@implementation CMISCircuitBreakerHost
+
+- (void)addOutcome:(BOOL)failed
+{
+    if (_outcomeCount == OUTCOME_WINDOW_SIZE) {
+        // the oldest outcome drops out of the window
+        if (_outcomes[_nextOutcomeIndex]) {
+            _failureCount--;
+        }
+    } else {
+        _outcomeCount++;
+    }
+    
+    _outcomes[_nextOutcomeIndex] = failed;
+    if (failed) {
+        _failureCount++;
+    }
+    _nextOutcomeIndex = (_nextOutcomeIndex + 1) % OUTCOME_WINDOW_SIZE;
+}
+
+- (void)resetOutcomes
+{
+    _outcomeCount = 0;
+    _nextOutcomeIndex = 0;
+    _failureCount = 0;
+}
+
+@end
@@ -0,0 +1,64 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CMISEnums.h"
+
+@class CMISBindingSession;
+
+/**
+ * Computes a hash of content incrementally while it passes through the network layer, using the digest functions
+ * of CommonCrypto. The hash is formatted the way CMIS repositories report it in cmis:contentStreamHash,
+ * i.e. "{sha-256}" followed by the lowercase hexadecimal digest.
+ * A hasher must only be used from one thread at a time.
+ */
+@interface CMISContentHasher : NSObject
+
+@property (nonatomic, assign, readonly) CMISContentHashAlgorithm algorithm;
+
+/// the number of bytes hashed so far
+@property (nonatomic, assign, readonly) unsigned long long length;
+
+/// returns a hasher for the algorithm configured for the session, or nil if content hashing is not enabled
++ (CMISContentHasher *)hasherForSession:(CMISBindingSession *)session;
+
+- (id)initWithAlgorithm:(CMISContentHashAlgorithm)algorithm;
+
+- (void)updateWithBytes:(const void *)bytes length:(NSUInteger)length;
+
+- (void)updateWithData:(NSData *)data;
+
+/// hashes the first given number of bytes of a file, returns NO if the file could not be read completely
+- (BOOL)updateWithContentsOfFile:(NSString *)filePath length:(unsigned long long)length;
+
+/// finishes the hash and returns it in the format of cmis:contentStreamHash, the hasher cannot be updated afterwards
+- (NSString *)finish;
+
+/// returns the name CMIS uses for the algorithm, e.g. "sha-256", or nil for CMISContentHashAlgorithmNone
++ (NSString *)nameForAlgorithm:(CMISContentHashAlgorithm)algorithm;
+
+/**
+ * Compares a hash returned by finish with the values of a cmis:contentStreamHash property.
+ * Returns NO only if one of the values uses the same algorithm and has a different digest; repositories that do not
+ * provide a value for the algorithm are not treated as a mismatch.
+ */
++ (BOOL)hash:(NSString *)contentHash matchesContentStreamHashes:(NSArray *)contentStreamHashes;
+
+@end
@@ -0,0 +1,206 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISContentHasher.h"
+#import "CMISBindingSession.h"
+#import "CMISSessionParameters.h"
+#import <CommonCrypto/CommonDigest.h>
+
+// Size of the buffer used to read files that are hashed
+#define FILE_READ_BUFFER_SIZE (256 * 1024)
+
+@interface CMISContentHasher ()
+
+@property (nonatomic, assign, readwrite) CMISContentHashAlgorithm algorithm;
+@property (nonatomic, assign, readwrite) unsigned long long length;
+@property (nonatomic, assign) BOOL finished;
+
+@end
+
+
+@implementation CMISContentHasher
+{
+    CC_MD5_CTX _md5Context;
+    CC_SHA1_CTX _sha1Context;
+    CC_SHA256_CTX _sha256Context;
+}
+
++ (CMISContentHasher *)hasherForSession:(CMISBindingSession *)session
+{
+    CMISContentHashAlgorithm algorithm = [[session objectForKey:kCMISSessionParameterContentHashAlgorithm
+                                                   defaultValue:@(CMISContentHashAlgorithmNone)] integerValue];
+    if ([CMISContentHasher nameForAlgorithm:algorithm] == nil) {
+        return nil;
+    }
+    return [[CMISContentHasher alloc] initWithAlgorithm:algorithm];
+}
+
+- (id)initWithAlgorithm:(CMISContentHashAlgorithm)algorithm
+{
+    self = [super init];
+    if (self) {
+        _algorithm = algorithm;
+        switch (algorithm) {
+            case CMISContentHashAlgorithmMD5:
+                CC_MD5_Init(&_md5Context);
+                break;
+            case CMISContentHashAlgorithmSHA1:
+                CC_SHA1_Init(&_sha1Context);
+                break;
+            case CMISContentHashAlgorithmSHA256:
+                CC_SHA256_Init(&_sha256Context);
+                break;
+            default:
+                break;
+        }
+    }
+    return self;
+}
+
+- (void)updateWithBytes:(const void *)bytes length:(NSUInteger)length
+{
+    if (self.finished) {
+        return;
+    }
+    
+    // the CommonCrypto functions take 32 bit lengths
+    while (length > 0) {
+        CC_LONG blockLength = (CC_LONG)MIN(length, (NSUInteger)UINT32_MAX);
+        switch (self.algorithm) {
+            case CMISContentHashAlgorithmMD5:
+                CC_MD5_Update(&_md5Context, bytes, blockLength);
+                break;
+            case CMISContentHashAlgorithmSHA1:
+                CC_SHA1_Update(&_sha1Context, bytes, blockLength);
+                break;
+            case CMISContentHashAlgorithmSHA256:
+                CC_SHA256_Update(&_sha256Context, bytes, blockLength);
+                break;
+            default:
+                break;
+        }
+        bytes = (const uint8_t *)bytes + blockLength;
+        length -= blockLength;
+        self.length += blockLength;
+    }
+}
+
+- (void)updateWithData:(NSData *)data
+{
+    // data received from the network is often not contiguous, hash the ranges without flattening them
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        [self updateWithBytes:bytes length:byteRange.length];
+    }];
+}
+
+- (BOOL)updateWithContentsOfFile:(NSString *)filePath length:(unsigned long long)length
+{
+    NSFileHandle *fileHandle = [NSFileHandle fileHandleForReadingAtPath:filePath];
+    if (fileHandle == nil) {
+        return NO;
+    }
+    
+    unsigned long long remaining = length;
+    while (remaining > 0) {
+        @autoreleasepool {
+            NSData *data = [fileHandle readDataOfLength:(NSUInteger)MIN(remaining, (unsigned long long)FILE_READ_BUFFER_SIZE)];
+            if (data.length == 0) {
+                break;
+            }
+            [self updateWithData:data];
+            remaining -= data.length;
+        }
+    }
+    [fileHandle closeFile];
+    
+    return remaining == 0;
+}
+
+- (NSString *)finish
+{
+    NSString *name = [CMISContentHasher nameForAlgorithm:self.algorithm];
+    if (self.finished || name == nil) {
+        return nil;
+    }
+    self.finished = YES;
+    
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    NSUInteger digestLength = 0;
+    switch (self.algorithm) {
+        case CMISContentHashAlgorithmMD5:
+            CC_MD5_Final(digest, &_md5Context);
+            digestLength = CC_MD5_DIGEST_LENGTH;
+            break;
+        case CMISContentHashAlgorithmSHA1:
+            CC_SHA1_Final(digest, &_sha1Context);
+            digestLength = CC_SHA1_DIGEST_LENGTH;
+            break;
+        case CMISContentHashAlgorithmSHA256:
+            CC_SHA256_Final(digest, &_sha256Context);
+            digestLength = CC_SHA256_DIGEST_LENGTH;
+            break;
+        default:
+            break;
+    }
+    
+    NSMutableString *hash = [NSMutableString stringWithCapacity:name.length + 2 + digestLength * 2];
+    [hash appendFormat:@"{%@}", name];
+    for (NSUInteger i = 0; i < digestLength; i++) {
+        [hash appendFormat:@"%02x", digest[i]];
+    }
+    return hash;
+}
+
++ (NSString *)nameForAlgorithm:(CMISContentHashAlgorithm)algorithm
+{
+    switch (algorithm) {
+        case CMISContentHashAlgorithmMD5:
+            return @"md5";
+        case CMISContentHashAlgorithmSHA1:
+            return @"sha-1";
+        case CMISContentHashAlgorithmSHA256:
+            return @"sha-256";
+        default:
+            return nil;
+    }
+}
+
++ (BOOL)hash:(NSString *)contentHash matchesContentStreamHashes:(NSArray *)contentStreamHashes
+{
+    NSRange prefixEnd = [contentHash rangeOfString:@"}"];
+    if (prefixEnd.location == NSNotFound) {
+        return YES;
+    }
+    NSString *prefix = [contentHash substringToIndex:prefixEnd.location + 1];
+    
+    for (id value in contentStreamHashes) {
+        if (![value isKindOfClass:NSString.class]) {
+            continue;
+        }
+        // repositories are not consistent about case and whitespace in the value
+        NSString *contentStreamHash = [[(NSString *)value stringByReplacingOccurrencesOfString:@" " withString:@""] lowercaseString];
+        if ([contentStreamHash hasPrefix:prefix] && ![contentStreamHash isEqualToString:contentHash]) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
+@end
@@ -0,0 +1,51 @@
+/*
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import "CMISNetworkProvider.h"
+
+/**
+ * Network provider based on the libcurl multi interface, intended for platforms where NSURLSession is slow or lacks
+ * HTTP/2 support. Requires libcurl 7.68 or later: the functions missing from older versions are looked up at runtime,
+ * so the library loads with any system libcurl, and the initialisers return nil if the provider is not available.
+ *
+ * All transfers of a provider run on a single worker thread driven by curl_multi_poll. Connections are reused
+ * across requests and multiplexed with HTTP/2 where the server supports it. DNS results, TLS sessions and cookies
+ * are shared between all transfers of the provider.
+ * Request bodies and downloads are streamed, completion and progress blocks are called on the thread the request
+ * was invoked from, which must run a run loop.
+ *
+ * Use it by setting an instance as networkProvider of the CMISSessionParameters. It is built into the macOS library
+ * only and links libcurl of the SDK, iOS builds do not include it.
+ *
+ * Requests are sent as they are invoked. The following features of CMISDefaultNetworkProvider are not supported:
+ * - scheduling by priority and the per host request statistics of CMISRequestScheduler
+ * - automatic retries of the CMISRetryPolicy and the CMISCircuitBreaker of a host
+ * - revalidating cached responses with the CMISHttpValidationCache
+ * - coalescing identical GET requests and hedging slow ones
+ * - warming up connections and keeping them alive
+ * - NSURLAuthenticationChallenge based authentication, only the headers returned by the authentication provider are sent
+ */
+@interface CMISCurlNetworkProvider : NSObject <CMISNetworkProvider>
+
+/// the number of transfers waiting for or using a connection
+@property (nonatomic, assign, readonly) NSUInteger activeTransferCount;
+
+/**
+ * Initialises the provider.
+ * @param maxConnectionsPerHost the maximum number of connections opened to a host, further transfers are queued
+ */
+- (id)initWithMaxConnectionsPerHost:(NSUInteger)maxConnectionsPerHost;
+
+@end
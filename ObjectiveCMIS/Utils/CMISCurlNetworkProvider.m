@@ -0,0 +1,1144 @@
+/*
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+ 
+ http://www.apache.org/licenses/LICENSE-2.0
+ 
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ */
+
+#import "CMISCurlNetworkProvider.h"
+#import <curl/curl.h>
+#import <dlfcn.h>
+#import "CMISBindingSession.h"
+#import "CMISRequest.h"
+#import "CMISHttpRequest.h"
+#import "CMISHttpResponse.h"
+#import "CMISBase64Encoder.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+
+// Default maximum number of connections per host
+#define DEFAULT_MAX_CONNECTIONS_PER_HOST 6
+
+// Default request timeout in seconds
+#define DEFAULT_REQUEST_TIMEOUT 60
+
+// the number of bytes read from an upload stream at once, a multiple of 3 so base64 encoded chunks can be concatenated
+#define UPLOAD_CHUNK_SIZE (3 * 16 * 1024)
+
+// the maximum time in milliseconds the worker thread waits for network activity before checking for new transfers
+#define POLL_TIMEOUT_MS 1000
+
+// the oldest libcurl providing curl_multi_poll and curl_multi_wakeup, 7.68.0
+#define MIN_CURL_VERSION_NUM 0x074400
+
+// curl_multi_poll and curl_multi_wakeup are looked up at runtime, so the library still loads with an older system libcurl
+typedef CURLMcode (*CMISCurlMultiPollFunction)(CURLM *multiHandle, struct curl_waitfd extraFds[], unsigned int extraNfds, int timeoutMs, int *numFds);
+typedef CURLMcode (*CMISCurlMultiWakeupFunction)(CURLM *multiHandle);
+static CMISCurlMultiPollFunction CMISCurlMultiPoll = NULL;
+static CMISCurlMultiWakeupFunction CMISCurlMultiWakeup = NULL;
+
+typedef NS_ENUM(NSInteger, CMISCurlUploadPhase)
+{
+    CMISCurlUploadPhaseBody,
+    CMISCurlUploadPhaseStartData,
+    CMISCurlUploadPhaseStream,
+    CMISCurlUploadPhaseEndData,
+    CMISCurlUploadPhaseFinished
+};
+
+@class CMISCurlWorker;
+
+/**
+ A single request. It is set as the http request of the CMISRequest, so cancelling the CMISRequest aborts the transfer.
+ The easy handle and all callbacks are only used on the worker thread.
+ */
+@interface CMISCurlTransfer : NSObject <CMISCancellableRequest>
+{
+    @public
+    CURL *_easyHandle;
+    struct curl_slist *_headerList;
+    char _errorBuffer[CURL_ERROR_SIZE];
+}
+
+@property (nonatomic, weak) CMISCurlWorker *worker;
+@property (nonatomic, assign) CMISHttpRequestMethod requestMethod;
+@property (nonatomic, strong) NSURL *url;
+@property (nonatomic, strong) CMISBindingSession *session;
+@property (nonatomic, strong) NSDictionary *additionalHeaders;
+@property (nonatomic, strong) NSMutableArray *requestHeaders; // "Name: value" strings
+@property (nonatomic, assign) BOOL acceptCompressedResponses;
+@property (nonatomic, assign) BOOL sendCookies;
+@property (nonatomic, assign) long timeout;
+
+// request body
+@property (nonatomic, strong) NSData *requestBody;
+@property (nonatomic, strong) NSInputStream *inputStream;
+@property (nonatomic, strong) NSData *startData;
+@property (nonatomic, strong) NSData *endData;
+@property (nonatomic, assign) BOOL base64Encoding;
+@property (nonatomic, assign) unsigned long long bytesExpected;
+@property (nonatomic, assign) CMISCurlUploadPhase uploadPhase;
+@property (nonatomic, strong) NSData *uploadBuffer;
+@property (nonatomic, assign) NSUInteger uploadBufferOffset;
+@property (nonatomic, strong) NSMutableData *base64Remainder;
+@property (nonatomic, strong) NSError *uploadError;
+
+// response
+@property (nonatomic, strong) NSOutputStream *outputStream;
+@property (nonatomic, strong) NSString *outputFilePath;
+@property (nonatomic, strong) NSString *temporaryFilePath;
+@property (nonatomic, assign) BOOL bodyStarted;
+@property (nonatomic, assign) BOOL writingToOutput;
+@property (nonatomic, strong) NSMutableData *responseBody;
+@property (nonatomic, strong) NSMutableDictionary *responseHeaders;
+@property (nonatomic, strong) NSString *statusMessage;
+@property (nonatomic, strong) NSError *storageError;
+@property (nonatomic, assign) unsigned long long reportedBytes;
+
+// delivery
+@property (nonatomic, weak) NSThread *originalThread;
+@property (nonatomic, copy) void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error);
+@property (nonatomic, copy) void (^progressBlock)(unsigned long long bytesTransferred, unsigned long long bytesTotal);
+@property (nonatomic, copy) void (^pendingCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error);
+@property (nonatomic, strong) CMISHttpResponse *httpResponse;
+@property (nonatomic, strong) NSError *error;
+@property (assign) BOOL cancelled;
+
+- (void)addHeaders:(NSDictionary *)headers;
+- (BOOL)prepareWithShareHandle:(CURLSH *)shareHandle;
+- (BOOL)fillUploadBuffer;
+- (void)reportProgressWithDownloadTotal:(curl_off_t)downloadTotal downloaded:(curl_off_t)downloaded uploadTotal:(curl_off_t)uploadTotal uploaded:(curl_off_t)uploaded;
+- (void)finishWithResult:(CURLcode)result;
+- (void)deliverResponse:(CMISHttpResponse *)httpResponse error:(NSError *)error;
+- (void)cleanUp;
+
+@end
+
+
+/**
+ Owns the multi handle and runs all transfers on its thread.
+ */
+@interface CMISCurlWorker : NSObject
+{
+    CURLM *_multiHandle;
+    CURLSH *_shareHandle;
+}
+
+@property (nonatomic, strong) NSMutableArray *addedTransfers;
+@property (nonatomic, strong) NSMutableArray *removedTransfers;
+@property (nonatomic, strong) NSMutableSet *activeTransfers; // only used on the worker thread
+@property (atomic, assign) NSUInteger activeTransferCount;
+@property (atomic, assign) BOOL stopped;
+
+- (id)initWithMaxConnectionsPerHost:(NSUInteger)maxConnectionsPerHost;
+- (void)addTransfer:(CMISCurlTransfer *)transfer;
+- (void)removeTransfer:(CMISCurlTransfer *)transfer;
+- (void)stop;
+
+@end
+
+
+@interface CMISCurlNetworkProvider ()
+
+@property (nonatomic, strong) CMISCurlWorker *worker;
+
+@end
+
+
+#pragma mark - libcurl callbacks
+
+static size_t CMISCurlHeaderCallback(char *buffer, size_t size, size_t count, void *userData)
+{
+    CMISCurlTransfer *transfer = (__bridge CMISCurlTransfer *)userData;
+    size_t length = size * count;
+    
+    NSString *line = [[NSString alloc] initWithBytes:buffer length:length encoding:NSISOLatin1StringEncoding];
+    line = [line stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]];
+    if ([line hasPrefix:@"HTTP/"]) {
+        // a new response starts, e.g. after a redirect or an interim 100 response
+        [transfer.responseHeaders removeAllObjects];
+        NSRange statusRange = [line rangeOfString:@" "];
+        NSRange messageRange = statusRange.location == NSNotFound ? statusRange : [line rangeOfString:@" " options:0 range:NSMakeRange(NSMaxRange(statusRange), line.length - NSMaxRange(statusRange))];
+        transfer.statusMessage = messageRange.location == NSNotFound ? @"" : [line substringFromIndex:NSMaxRange(messageRange)];
+    } else {
+        NSRange colonRange = [line rangeOfString:@":"];
+        if (colonRange.location != NSNotFound) {
+            NSString *name = [line substringToIndex:colonRange.location];
+            NSString *value = [[line substringFromIndex:NSMaxRange(colonRange)] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+            NSString *existingValue = [transfer.responseHeaders objectForKey:name];
+            if (existingValue) {
+                value = [NSString stringWithFormat:@"%@, %@", existingValue, value];
+            }
+            [transfer.responseHeaders setObject:value forKey:name];
+        }
+    }
+    
+    return length;
+}
+
+static size_t CMISCurlWriteCallback(char *buffer, size_t size, size_t count, void *userData)
+{
+    CMISCurlTransfer *transfer = (__bridge CMISCurlTransfer *)userData;
+    size_t length = size * count;
+    
+    if (transfer.cancelled) {
+        return 0; // aborts the transfer
+    }
+    
+    if (!transfer.bodyStarted) {
+        transfer.bodyStarted = YES;
+        
+        // error responses are kept in memory so the error message can be extracted
+        long statusCode = 0;
+        curl_easy_getinfo(transfer->_easyHandle, CURLINFO_RESPONSE_CODE, &statusCode);
+        BOOL errorResponse = [CMISHttpRequest isErrorResponse:statusCode httpRequestMethod:transfer.requestMethod];
+        
+        if (!errorResponse && transfer.outputFilePath) {
+            transfer.temporaryFilePath = [transfer.outputFilePath stringByAppendingPathExtension:@"download"];
+            transfer.outputStream = [NSOutputStream outputStreamToFileAtPath:transfer.temporaryFilePath append:NO];
+        }
+        
+        if (!errorResponse && transfer.outputStream) {
+            if (transfer.outputStream.streamStatus != NSStreamStatusOpen) {
+                [transfer.outputStream open];
+            }
+            if (transfer.outputStream.streamStatus != NSStreamStatusOpen) {
+                transfer.storageError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                                        detailedDescription:@"Could not open output stream"];
+                return 0;
+            }
+            transfer.writingToOutput = YES;
+        }
+    }
+    
+    if (!transfer.writingToOutput) {
+        [transfer.responseBody appendBytes:buffer length:length];
+        return length;
+    }
+    
+    size_t offset = 0;
+    while (offset < length) {
+        NSInteger written = [transfer.outputStream write:(const uint8_t *)&buffer[offset] maxLength:length - offset];
+        if (written <= 0) {
+            CMISLogError(@"Error while writing downloaded data to stream");
+            transfer.storageError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                                    detailedDescription:@"Could not write downloaded data"];
+            return 0;
+        }
+        offset += written;
+    }
+    return length;
+}
+
+static size_t CMISCurlReadCallback(char *buffer, size_t size, size_t count, void *userData)
+{
+    CMISCurlTransfer *transfer = (__bridge CMISCurlTransfer *)userData;
+    size_t maxLength = size * count;
+    
+    if (transfer.cancelled) {
+        return CURL_READFUNC_ABORT;
+    }
+    
+    size_t length = 0;
+    while (length < maxLength) {
+        if (transfer.uploadBufferOffset >= transfer.uploadBuffer.length && ![transfer fillUploadBuffer]) {
+            break;
+        }
+        NSUInteger available = transfer.uploadBuffer.length - transfer.uploadBufferOffset;
+        NSUInteger chunkLength = MIN(available, maxLength - length);
+        [transfer.uploadBuffer getBytes:&buffer[length] range:NSMakeRange(transfer.uploadBufferOffset, chunkLength)];
+        transfer.uploadBufferOffset += chunkLength;
+        length += chunkLength;
+    }
+    
+    if (transfer.uploadError) {
+        return CURL_READFUNC_ABORT;
+    }
+    return length;
+}
+
+static int CMISCurlSeekCallback(void *userData, curl_off_t offset, int origin)
+{
+    CMISCurlTransfer *transfer = (__bridge CMISCurlTransfer *)userData;
+    
+    // only in-memory bodies can be sent again, e.g. after a redirect
+    if (origin != SEEK_SET || transfer.requestBody == nil || offset < 0 || (unsigned long long)offset > transfer.requestBody.length) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    transfer.uploadBuffer = transfer.requestBody;
+    transfer.uploadBufferOffset = (NSUInteger)offset;
+    transfer.uploadPhase = CMISCurlUploadPhaseFinished;
+    return CURL_SEEKFUNC_OK;
+}
+
+static int CMISCurlProgressCallback(void *userData, curl_off_t downloadTotal, curl_off_t downloaded, curl_off_t uploadTotal, curl_off_t uploaded)
+{
+    CMISCurlTransfer *transfer = (__bridge CMISCurlTransfer *)userData;
+    
+    if (transfer.cancelled) {
+        return 1; // aborts the transfer
+    }
+    
+    [transfer reportProgressWithDownloadTotal:downloadTotal downloaded:downloaded uploadTotal:uploadTotal uploaded:uploaded];
+    return 0;
+}
+
+
+#pragma mark - CMISCurlNetworkProvider
+
+@implementation CMISCurlNetworkProvider
+
++ (void)initialize
+{
+    if (self == [CMISCurlNetworkProvider class]) {
+        curl_global_init(CURL_GLOBAL_ALL);
+        
+        curl_version_info_data *versionInfo = curl_version_info(CURLVERSION_NOW);
+        if (versionInfo && versionInfo->version_num >= MIN_CURL_VERSION_NUM) {
+            CMISCurlMultiPoll = (CMISCurlMultiPollFunction)dlsym(RTLD_DEFAULT, "curl_multi_poll");
+            CMISCurlMultiWakeup = (CMISCurlMultiWakeupFunction)dlsym(RTLD_DEFAULT, "curl_multi_wakeup");
+        }
+    }
+}
+
+- (id)init
+{
+    return [self initWithMaxConnectionsPerHost:DEFAULT_MAX_CONNECTIONS_PER_HOST];
+}
+
+- (id)initWithMaxConnectionsPerHost:(NSUInteger)maxConnectionsPerHost
+{
+    self = [super init];
+    if (self) {
+        if (CMISCurlMultiPoll == NULL || CMISCurlMultiWakeup == NULL) {
+            CMISLogError(@"libcurl %s is too old, the curl network provider requires 7.68.0 or later", curl_version_info(CURLVERSION_NOW)->version);
+            return nil;
+        }
+        _worker = [[CMISCurlWorker alloc] initWithMaxConnectionsPerHost:maxConnectionsPerHost];
+        if (_worker == nil) {
+            return nil;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [_worker stop];
+}
+
+- (NSUInteger)activeTransferCount
+{
+    return self.worker.activeTransferCount;
+}
+
+#pragma mark Invoke methods
+
+- (void)invoke:(NSURL *)url
+    httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+       session:(CMISBindingSession *)session
+          body:(NSData *)body
+       headers:(NSDictionary *)additionalHeaders
+   cmisRequest:(CMISRequest *)cmisRequest
+completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    CMISCurlTransfer *transfer = [self transferForUrl:url
+                                           httpMethod:httpRequestMethod
+                                              session:session
+                                              headers:additionalHeaders
+                                      completionBlock:completionBlock
+                                        progressBlock:nil];
+    transfer.requestBody = body;
+    [self startTransfer:transfer cmisRequest:cmisRequest];
+}
+
+- (void)invoke:(NSURL *)url
+    httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+       session:(CMISBindingSession *)session
+   inputStream:(NSInputStream *)inputStream
+       headers:(NSDictionary *)additionalHeaders
+   cmisRequest:(CMISRequest *)cmisRequest
+completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    [self invoke:url
+      httpMethod:httpRequestMethod
+         session:session
+     inputStream:inputStream
+         headers:additionalHeaders
+   bytesExpected:0
+     cmisRequest:cmisRequest
+ completionBlock:completionBlock
+   progressBlock:nil];
+}
+
+- (void)invoke:(NSURL *)url
+    httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+       session:(CMISBindingSession *)session
+   inputStream:(NSInputStream *)inputStream
+       headers:(NSDictionary *)additionalHeaders
+ bytesExpected:(unsigned long long)bytesExpected
+   cmisRequest:(CMISRequest *)cmisRequest
+completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+ progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
+{
+    [self invoke:url
+      httpMethod:httpRequestMethod
+         session:session
+     inputStream:inputStream
+         headers:additionalHeaders
+   bytesExpected:bytesExpected
+     cmisRequest:cmisRequest
+       startData:nil
+         endData:nil
+useBase64Encoding:NO
+ completionBlock:completionBlock
+   progressBlock:progressBlock];
+}
+
+- (void)invoke:(NSURL *)url
+    httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+       session:(CMISBindingSession *)session
+   inputStream:(NSInputStream *)inputStream
+       headers:(NSDictionary *)additionalHeaders
+ bytesExpected:(unsigned long long)bytesExpected
+   cmisRequest:(CMISRequest *)cmisRequest
+     startData:(NSData *)startData
+       endData:(NSData *)endData
+useBase64Encoding:(BOOL)useBase64Encoding
+completionBlock:(void (^)(CMISHttpResponse *, NSError *))completionBlock
+ progressBlock:(void (^)(unsigned long long, unsigned long long))progressBlock
+{
+    CMISCurlTransfer *transfer = [self transferForUrl:url
+                                           httpMethod:httpRequestMethod
+                                              session:session
+                                              headers:additionalHeaders
+                                      completionBlock:completionBlock
+                                        progressBlock:progressBlock];
+    transfer.inputStream = inputStream;
+    transfer.startData = startData;
+    transfer.endData = endData;
+    transfer.base64Encoding = useBase64Encoding;
+    transfer.bytesExpected = bytesExpected;
+    transfer.uploadPhase = CMISCurlUploadPhaseStartData;
+    [self startTransfer:transfer cmisRequest:cmisRequest];
+}
+
+- (void)invoke:(NSURL *)url
+    httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+       session:(CMISBindingSession *)session
+outputFilePath:(NSString *)outputFilePath
+ bytesExpected:(unsigned long long)bytesExpected
+   cmisRequest:(CMISRequest *)cmisRequest
+completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+ progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
+{
+    CMISCurlTransfer *transfer = [self transferForUrl:url
+                                           httpMethod:httpRequestMethod
+                                              session:session
+                                              headers:nil
+                                      completionBlock:completionBlock
+                                        progressBlock:progressBlock];
+    transfer.outputFilePath = outputFilePath;
+    transfer.bytesExpected = bytesExpected;
+    transfer.acceptCompressedResponses = NO;
+    [self startTransfer:transfer cmisRequest:cmisRequest];
+}
+
+- (void)invoke:(NSURL *)url
+    httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+       session:(CMISBindingSession *)session
+  outputStream:(NSOutputStream *)outputStream
+ bytesExpected:(unsigned long long)bytesExpected
+   cmisRequest:(CMISRequest *)cmisRequest
+completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+ progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
+{
+    [self invoke:url
+      httpMethod:httpRequestMethod
+         session:session
+    outputStream:outputStream
+   bytesExpected:bytesExpected
+          offset:nil
+          length:nil
+     cmisRequest:cmisRequest
+ completionBlock:completionBlock
+   progressBlock:progressBlock];
+}
+
+- (void)invoke:(NSURL *)url
+    httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+       session:(CMISBindingSession *)session
+  outputStream:(NSOutputStream *)outputStream
+ bytesExpected:(unsigned long long)bytesExpected
+        offset:(NSDecimalNumber*)offset
+        length:(NSDecimalNumber*)length
+   cmisRequest:(CMISRequest *)cmisRequest
+completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+ progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
+{
+    NSDictionary *headers = nil;
+    if (offset != nil || length != nil) {
+        if (offset == nil) {
+            offset = [NSDecimalNumber zero];
+        }
+        NSMutableString *range = [NSMutableString stringWithFormat:@"bytes=%@-", [offset stringValue]];
+        if (length != nil) {
+            [range appendFormat:@"%llu", [offset unsignedLongLongValue] + [length unsignedLongLongValue] - 1];
+        }
+        headers = @{@"Range" : range};
+    }
+    
+    CMISCurlTransfer *transfer = [self transferForUrl:url
+                                           httpMethod:httpRequestMethod
+                                              session:session
+                                              headers:headers
+                                      completionBlock:completionBlock
+                                        progressBlock:progressBlock];
+    transfer.outputStream = outputStream;
+    transfer.bytesExpected = bytesExpected;
+    transfer.acceptCompressedResponses = NO;
+    [self startTransfer:transfer cmisRequest:cmisRequest];
+}
+
+- (void)invokeGET:(NSURL *)url
+          session:(CMISBindingSession *)session
+      cmisRequest:(CMISRequest *)cmisRequest
+  completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    [self invoke:url httpMethod:HTTP_GET session:session body:nil headers:nil cmisRequest:cmisRequest completionBlock:completionBlock];
+}
+
+- (void)invokePOST:(NSURL *)url
+           session:(CMISBindingSession *)session
+              body:(NSData *)body
+           headers:(NSDictionary *)additionalHeaders
+       cmisRequest:(CMISRequest *)cmisRequest
+   completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    [self invoke:url httpMethod:HTTP_POST session:session body:body headers:additionalHeaders cmisRequest:cmisRequest completionBlock:completionBlock];
+}
+
+- (void)invokePUT:(NSURL *)url
+          session:(CMISBindingSession *)session
+             body:(NSData *)body
+          headers:(NSDictionary *)additionalHeaders
+      cmisRequest:(CMISRequest *)cmisRequest
+  completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    [self invoke:url httpMethod:HTTP_PUT session:session body:body headers:additionalHeaders cmisRequest:cmisRequest completionBlock:completionBlock];
+}
+
+- (void)invokeDELETE:(NSURL *)url
+             session:(CMISBindingSession *)session
+         cmisRequest:(CMISRequest *)cmisRequest
+     completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    [self invoke:url httpMethod:HTTP_DELETE session:session body:nil headers:nil cmisRequest:cmisRequest completionBlock:completionBlock];
+}
+
+#pragma mark Helper methods
+
+- (CMISCurlTransfer *)transferForUrl:(NSURL *)url
+                          httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+                             session:(CMISBindingSession *)session
+                             headers:(NSDictionary *)additionalHeaders
+                     completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+                       progressBlock:(void (^)(unsigned long long bytesTransferred, unsigned long long bytesTotal))progressBlock
+{
+    CMISCurlTransfer *transfer = [[CMISCurlTransfer alloc] init];
+    transfer.worker = self.worker;
+    transfer.url = url;
+    transfer.requestMethod = httpRequestMethod;
+    transfer.session = session;
+    transfer.originalThread = [NSThread currentThread];
+    transfer.completionBlock = completionBlock;
+    transfer.progressBlock = progressBlock;
+    transfer.timeout = [[session objectForKey:kCMISSessionParameterRequestTimeout defaultValue:@(DEFAULT_REQUEST_TIMEOUT)] longValue];
+    
+    id acceptCompressedResponses = [session objectForKey:kCMISSessionParameterAcceptCompressedResponses];
+    transfer.acceptCompressedResponses = !acceptCompressedResponses || [acceptCompressedResponses boolValue];
+    id sendCookies = [session objectForKey:kCMISSessionParameterSendCookies];
+    transfer.sendCookies = !sendCookies || [sendCookies boolValue];
+    
+    CMISLogDebug(@"HTTP %d: %@", (int)httpRequestMethod, [url absoluteString]);
+    
+    // the additional headers are added after the authentication headers, as done by CMISHttpRequest
+    transfer.additionalHeaders = additionalHeaders;
+    return transfer;
+}
+
+- (void)startTransfer:(CMISCurlTransfer *)transfer cmisRequest:(CMISRequest *)cmisRequest
+{
+    if (cmisRequest.isCancelled) {
+        [transfer cancel];
+        return;
+    }
+    cmisRequest.httpRequest = transfer;
+    
+    void (^enqueueTransfer)(NSDictionary *) = ^(NSDictionary *authenticationHeaders) {
+        [transfer addHeaders:authenticationHeaders];
+        [transfer addHeaders:transfer.additionalHeaders];
+        [self.worker addTransfer:transfer];
+    };
+    
+    id<CMISAuthenticationProvider> authenticationProvider = transfer.session.authenticationProvider;
+    if ([authenticationProvider respondsToSelector:@selector(asyncHttpHeadersToApply:)]) {
+        [authenticationProvider asyncHttpHeadersToApply:^(NSDictionary *headers, NSError *cmisError) {
+            if (cmisError) {
+                [transfer deliverResponse:nil error:cmisError];
+            } else {
+                enqueueTransfer(headers);
+            }
+        }];
+    } else {
+        enqueueTransfer(authenticationProvider.httpHeadersToApply);
+    }
+}
+
+@end
+
+
+#pragma mark - CMISCurlWorker
+
+@implementation CMISCurlWorker
+
+- (id)initWithMaxConnectionsPerHost:(NSUInteger)maxConnectionsPerHost
+{
+    self = [super init];
+    if (self) {
+        _multiHandle = curl_multi_init();
+        _shareHandle = curl_share_init();
+        if (_multiHandle == NULL || _shareHandle == NULL) {
+            CMISLogError(@"Could not initialise libcurl");
+            return nil;
+        }
+        
+        // all transfers run on one thread, so the shared data needs no locking
+        curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(_shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+        
+        curl_multi_setopt(_multiHandle, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(_multiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, (long)MAX(maxConnectionsPerHost, 1));
+        
+        _addedTransfers = [[NSMutableArray alloc] init];
+        _removedTransfers = [[NSMutableArray alloc] init];
+        _activeTransfers = [[NSMutableSet alloc] init];
+        
+        NSThread *thread = [[NSThread alloc] initWithTarget:self selector:@selector(run) object:nil];
+        thread.name = @"CMISCurlNetworkProvider";
+        [thread start];
+    }
+    return self;
+}
+
+- (void)addTransfer:(CMISCurlTransfer *)transfer
+{
+    @synchronized(self) {
+        [self.addedTransfers addObject:transfer];
+    }
+    CMISCurlMultiWakeup(_multiHandle);
+}
+
+- (void)removeTransfer:(CMISCurlTransfer *)transfer
+{
+    @synchronized(self) {
+        [self.removedTransfers addObject:transfer];
+    }
+    CMISCurlMultiWakeup(_multiHandle);
+}
+
+- (void)stop
+{
+    self.stopped = YES;
+    CMISCurlMultiWakeup(_multiHandle);
+}
+
+#pragma mark Worker thread
+
+- (void)run
+{
+    while (!self.stopped) {
+        @autoreleasepool {
+            [self processAddedAndRemovedTransfers];
+            
+            int runningHandles = 0;
+            curl_multi_perform(_multiHandle, &runningHandles);
+            [self processCompletedTransfers];
+            
+            CMISCurlMultiPoll(_multiHandle, NULL, 0, POLL_TIMEOUT_MS, NULL);
+        }
+    }
+    
+    // the provider has been released, transfers still running are aborted
+    @autoreleasepool {
+        [self processAddedAndRemovedTransfers];
+        for (CMISCurlTransfer *transfer in self.activeTransfers) {
+            curl_multi_remove_handle(_multiHandle, transfer->_easyHandle);
+            [transfer finishWithResult:CURLE_ABORTED_BY_CALLBACK];
+            [transfer cleanUp];
+        }
+        [self.activeTransfers removeAllObjects];
+        self.activeTransferCount = 0;
+    }
+    
+    curl_multi_cleanup(_multiHandle);
+    curl_share_cleanup(_shareHandle);
+    _multiHandle = NULL;
+    _shareHandle = NULL;
+}
+
+- (void)processAddedAndRemovedTransfers
+{
+    NSArray *addedTransfers = nil;
+    NSArray *removedTransfers = nil;
+    @synchronized(self) {
+        addedTransfers = [self.addedTransfers copy];
+        removedTransfers = [self.removedTransfers copy];
+        [self.addedTransfers removeAllObjects];
+        [self.removedTransfers removeAllObjects];
+    }
+    
+    for (CMISCurlTransfer *transfer in addedTransfers) {
+        if (transfer.cancelled) {
+            continue;
+        }
+        if (![transfer prepareWithShareHandle:_shareHandle] || curl_multi_add_handle(_multiHandle, transfer->_easyHandle) != CURLM_OK) {
+            [transfer finishWithResult:CURLE_FAILED_INIT];
+            [transfer cleanUp];
+            continue;
+        }
+        [self.activeTransfers addObject:transfer];
+    }
+    
+    for (CMISCurlTransfer *transfer in removedTransfers) {
+        if ([self.activeTransfers containsObject:transfer]) {
+            curl_multi_remove_handle(_multiHandle, transfer->_easyHandle);
+            [transfer finishWithResult:CURLE_ABORTED_BY_CALLBACK];
+            [transfer cleanUp];
+            [self.activeTransfers removeObject:transfer];
+        }
+    }
+    
+    self.activeTransferCount = self.activeTransfers.count;
+}
+
+- (void)processCompletedTransfers
+{
+    CURLMsg *message = NULL;
+    int queuedMessages = 0;
+    while ((message = curl_multi_info_read(_multiHandle, &queuedMessages))) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        
+        CURL *easyHandle = message->easy_handle;
+        CURLcode result = message->data.result; // the message is invalid once the handle is removed
+        char *privateData = NULL;
+        curl_easy_getinfo(easyHandle, CURLINFO_PRIVATE, &privateData);
+        CMISCurlTransfer *transfer = (__bridge CMISCurlTransfer *)(void *)privateData;
+        
+        curl_multi_remove_handle(_multiHandle, easyHandle);
+        [transfer finishWithResult:result];
+        [transfer cleanUp];
+        [self.activeTransfers removeObject:transfer];
+    }
+    
+    self.activeTransferCount = self.activeTransfers.count;
+}
+
+@end
+
+
+#pragma mark - CMISCurlTransfer
+
+@implementation CMISCurlTransfer
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _requestHeaders = [[NSMutableArray alloc] init];
+        _responseHeaders = [[NSMutableDictionary alloc] init];
+        _responseBody = [[NSMutableData alloc] init];
+        _uploadPhase = CMISCurlUploadPhaseBody;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self cleanUp];
+}
+
+- (void)addHeaders:(NSDictionary *)headers
+{
+    [headers enumerateKeysAndObjectsUsingBlock:^(NSString *headerName, id header, BOOL *stop) {
+        if ([header isKindOfClass:NSSet.class]) {
+            for (NSString *headerValue in header) {
+                [self.requestHeaders addObject:[NSString stringWithFormat:@"%@: %@", headerName, headerValue]];
+            }
+        } else {
+            [self.requestHeaders addObject:[NSString stringWithFormat:@"%@: %@", headerName, header]];
+        }
+    }];
+}
+
+- (BOOL)hasRequestBody
+{
+    return self.requestMethod == HTTP_POST || self.requestMethod == HTTP_PUT;
+}
+
+/// the length of the request body or -1 if it is not known in advance
+- (curl_off_t)requestBodyLength
+{
+    if (self.inputStream == nil) {
+        return (curl_off_t)self.requestBody.length;
+    }
+    if (self.bytesExpected == 0) {
+        return -1;
+    }
+    
+    unsigned long long contentLength = self.bytesExpected;
+    if (self.base64Encoding) {
+        contentLength = 4 * ((contentLength + 2) / 3);
+    }
+    return (curl_off_t)(self.startData.length + contentLength + self.endData.length);
+}
+
+- (BOOL)prepareWithShareHandle:(CURLSH *)shareHandle
+{
+    _easyHandle = curl_easy_init();
+    if (_easyHandle == NULL) {
+        return NO;
+    }
+    _errorBuffer[0] = '\0';
+    
+    CURL *handle = _easyHandle;
+    curl_easy_setopt(handle, CURLOPT_URL, self.url.absoluteString.UTF8String);
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, (__bridge void *)self);
+    curl_easy_setopt(handle, CURLOPT_SHARE, shareHandle);
+    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, _errorBuffer);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    
+    // use HTTP/2 for https connections and wait for an existing connection to multiplex on instead of opening a new one
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    
+    // like the request timeout of NSURLRequest, the timeout applies to periods without any data being transferred
+    if (self.timeout > 0) {
+        curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, self.timeout);
+        curl_easy_setopt(handle, CURLOPT_LOW_SPEED_LIMIT, 1L);
+        curl_easy_setopt(handle, CURLOPT_LOW_SPEED_TIME, self.timeout);
+    }
+    
+    if (self.acceptCompressedResponses) {
+        curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, ""); // all encodings supported by libcurl, decoded by libcurl
+    }
+    if (self.sendCookies) {
+        curl_easy_setopt(handle, CURLOPT_COOKIEFILE, ""); // enables the shared cookie engine
+    }
+    
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, CMISCurlHeaderCallback);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, (__bridge void *)self);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, CMISCurlWriteCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, (__bridge void *)self);
+    curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, CMISCurlProgressCallback);
+    curl_easy_setopt(handle, CURLOPT_XFERINFODATA, (__bridge void *)self);
+    curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L);
+    
+    curl_off_t bodyLength = [self hasRequestBody] ? [self requestBodyLength] : 0;
+    switch (self.requestMethod) {
+        case HTTP_GET:
+            curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+            break;
+        case HTTP_DELETE:
+            curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, "DELETE");
+            break;
+        case HTTP_HEAD:
+            curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
+            break;
+        case HTTP_POST:
+            curl_easy_setopt(handle, CURLOPT_POST, 1L);
+            curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, bodyLength);
+            break;
+        case HTTP_PUT:
+            curl_easy_setopt(handle, CURLOPT_UPLOAD, 1L);
+            if (bodyLength >= 0) {
+                curl_easy_setopt(handle, CURLOPT_INFILESIZE_LARGE, bodyLength);
+            }
+            break;
+        default:
+            CMISLogError(@"Invalid http request method: %d", (int)self.requestMethod);
+            return NO;
+    }
+    
+    if ([self hasRequestBody]) {
+        if (self.inputStream && self.inputStream.streamStatus != NSStreamStatusOpen) {
+            [self.inputStream open];
+        }
+        curl_easy_setopt(handle, CURLOPT_READFUNCTION, CMISCurlReadCallback);
+        curl_easy_setopt(handle, CURLOPT_READDATA, (__bridge void *)self);
+        curl_easy_setopt(handle, CURLOPT_SEEKFUNCTION, CMISCurlSeekCallback);
+        curl_easy_setopt(handle, CURLOPT_SEEKDATA, (__bridge void *)self);
+        
+        if (bodyLength < 0) {
+            [self.requestHeaders addObject:@"Transfer-Encoding: chunked"];
+        }
+    }
+    
+    // do not wait for a 100 Continue response before sending the body
+    [self.requestHeaders addObject:@"Expect:"];
+    for (NSString *header in self.requestHeaders) {
+        _headerList = curl_slist_append(_headerList, header.UTF8String);
+    }
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, _headerList);
+    
+    return YES;
+}
+
+/// provides the next part of the request body, returns NO once the body is complete or reading failed
+- (BOOL)fillUploadBuffer
+{
+    self.uploadBuffer = nil;
+    self.uploadBufferOffset = 0;
+    
+    while (self.uploadBuffer.length == 0) {
+        switch (self.uploadPhase) {
+            case CMISCurlUploadPhaseBody:
+                self.uploadBuffer = self.requestBody;
+                self.uploadPhase = CMISCurlUploadPhaseFinished;
+                break;
+            case CMISCurlUploadPhaseStartData:
+                self.uploadBuffer = self.startData;
+                self.uploadPhase = CMISCurlUploadPhaseStream;
+                break;
+            case CMISCurlUploadPhaseStream: {
+                NSData *chunk = [self readStreamChunk];
+                if (self.uploadError) {
+                    return NO;
+                }
+                if (chunk == nil) {
+                    self.uploadPhase = CMISCurlUploadPhaseEndData;
+                } else {
+                    self.uploadBuffer = chunk;
+                }
+                break;
+            }
+            case CMISCurlUploadPhaseEndData:
+                self.uploadBuffer = self.endData;
+                self.uploadPhase = CMISCurlUploadPhaseFinished;
+                break;
+            case CMISCurlUploadPhaseFinished:
+                return NO;
+        }
+    }
+    return YES;
+}
+
+/// reads the next chunk from the input stream, encoded if needed, returns nil at the end of the stream
+- (NSData *)readStreamChunk
+{
+    NSMutableData *chunk = [NSMutableData dataWithLength:UPLOAD_CHUNK_SIZE];
+    NSInteger bytesRead = [self.inputStream read:chunk.mutableBytes maxLength:UPLOAD_CHUNK_SIZE];
+    if (bytesRead < 0) {
+        self.uploadError = [CMISErrors cmisError:self.inputStream.streamError cmisErrorCode:kCMISErrorCodeStorage];
+        return nil;
+    }
+    chunk.length = (NSUInteger)bytesRead;
+    
+    if (!self.base64Encoding) {
+        return bytesRead > 0 ? chunk : nil;
+    }
+    
+    // base64 encoded chunks can only be concatenated if all but the last one are a multiple of 3 bytes long
+    if (self.base64Remainder == nil) {
+        self.base64Remainder = [NSMutableData data];
+    }
+    [self.base64Remainder appendData:chunk];
+    NSUInteger encodableLength = (bytesRead == 0) ? self.base64Remainder.length : (self.base64Remainder.length / 3) * 3;
+    if (encodableLength == 0) {
+        return bytesRead == 0 ? nil : [NSData data];
+    }
+    
+    NSData *encodedData = [CMISBase64Encoder dataByEncodingText:[self.base64Remainder subdataWithRange:NSMakeRange(0, encodableLength)]];
+    [self.base64Remainder replaceBytesInRange:NSMakeRange(0, encodableLength) withBytes:NULL length:0];
+    return encodedData;
+}
+
+- (void)reportProgressWithDownloadTotal:(curl_off_t)downloadTotal downloaded:(curl_off_t)downloaded uploadTotal:(curl_off_t)uploadTotal uploaded:(curl_off_t)uploaded
+{
+    if (self.progressBlock == nil) {
+        return;
+    }
+    
+    unsigned long long bytesTransferred, bytesTotal;
+    if ([self hasRequestBody]) {
+        bytesTransferred = (unsigned long long)uploaded;
+        bytesTotal = uploadTotal > 0 ? (unsigned long long)uploadTotal : self.bytesExpected;
+        if (self.base64Encoding) {
+            // report the size of the raw content, not the size of the encoded request
+            unsigned long long encodedBytes = bytesTransferred > self.startData.length ? bytesTransferred - self.startData.length : 0;
+            bytesTransferred = MIN(encodedBytes / 4 * 3, self.bytesExpected);
+            bytesTotal = self.bytesExpected;
+        }
+    } else {
+        bytesTransferred = (unsigned long long)downloaded;
+        bytesTotal = downloadTotal > 0 ? (unsigned long long)downloadTotal : self.bytesExpected;
+    }
+    
+    if (bytesTransferred == self.reportedBytes) {
+        return;
+    }
+    self.reportedBytes = bytesTransferred;
+    
+    NSThread *thread = self.originalThread;
+    if (thread) {
+        [self performSelector:@selector(executeProgressBlock:) onThread:thread withObject:@[@(bytesTransferred), @(bytesTotal)] waitUntilDone:NO];
+    }
+}
+
+- (void)executeProgressBlock:(NSArray *)valueArray
+{
+    if (self.progressBlock) {
+        self.progressBlock([valueArray[0] unsignedLongLongValue], [valueArray[1] unsignedLongLongValue]);
+    }
+}
+
+- (void)finishWithResult:(CURLcode)result
+{
+    if (self.writingToOutput) {
+        [self.outputStream close];
+    }
+    if (self.inputStream) {
+        [self.inputStream close];
+    }
+    
+    NSString *temporaryFilePath = self.temporaryFilePath;
+    if (self.cancelled) {
+        if (temporaryFilePath) {
+            [[NSFileManager defaultManager] removeItemAtPath:temporaryFilePath error:nil];
+        }
+        return; // the completion block has already been called
+    }
+    
+    CMISHttpResponse *httpResponse = nil;
+    NSError *error = nil;
+    if (result == CURLE_OK) {
+        long statusCode = 0;
+        curl_easy_getinfo(_easyHandle, CURLINFO_RESPONSE_CODE, &statusCode);
+        
+        NSHTTPURLResponse *urlResponse = [[NSHTTPURLResponse alloc] initWithURL:self.url
+                                                                     statusCode:statusCode
+                                                                    HTTPVersion:nil
+                                                                   headerFields:self.responseHeaders];
+        [self.session.authenticationProvider updateWithHttpURLResponse:urlResponse];
+        
+        if (temporaryFilePath) {
+            NSFileManager *fileManager = [NSFileManager defaultManager];
+            [fileManager removeItemAtPath:self.outputFilePath error:nil];
+            if ([fileManager moveItemAtPath:temporaryFilePath toPath:self.outputFilePath error:nil]) {
+                temporaryFilePath = nil;
+            } else {
+                error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                        detailedDescription:[NSString stringWithFormat:@"Could not move downloaded file to %@", self.outputFilePath]];
+            }
+        }
+        
+        if (error == nil) {
+            httpResponse = [CMISHttpResponse responseWithStatusCode:(int)statusCode
+                                                      statusMessage:self.statusMessage
+                                                            headers:[self.responseHeaders copy]
+                                                       responseData:self.writingToOutput ? nil : self.responseBody];
+            if (![CMISHttpRequest checkStatusCodeForResponse:httpResponse httpRequestMethod:self.requestMethod error:&error]) {
+                httpResponse = nil;
+            }
+        }
+    } else if (self.storageError) {
+        error = self.storageError;
+    } else if (self.uploadError) {
+        error = self.uploadError;
+    } else {
+        NSString *detailedDescription = _errorBuffer[0] != '\0' ? @(_errorBuffer) : @(curl_easy_strerror(result));
+        error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection detailedDescription:detailedDescription];
+    }
+    
+    if (temporaryFilePath) {
+        [[NSFileManager defaultManager] removeItemAtPath:temporaryFilePath error:nil];
+    }
+    
+    [self deliverResponse:httpResponse error:error];
+}
+
+- (void)deliverResponse:(CMISHttpResponse *)httpResponse error:(NSError *)error
+{
+    @synchronized(self) {
+        if (self.completionBlock == nil) {
+            return;
+        }
+        self.pendingCompletionBlock = self.completionBlock;
+        self.completionBlock = nil;
+        self.httpResponse = httpResponse;
+        self.error = error;
+    }
+    
+    NSThread *thread = self.originalThread;
+    if (thread == nil || thread == [NSThread currentThread] || thread.isFinished) {
+        [self executeCompletionBlock];
+    } else {
+        [self performSelector:@selector(executeCompletionBlock) onThread:thread withObject:nil waitUntilDone:NO];
+    }
+}
+
+- (void)executeCompletionBlock
+{
+    void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error) = self.pendingCompletionBlock;
+    self.pendingCompletionBlock = nil;
+    if (completionBlock) {
+        completionBlock(self.httpResponse, self.error);
+    }
+}
+
+- (void)cleanUp
+{
+    if (_easyHandle) {
+        curl_easy_cleanup(_easyHandle);
+        _easyHandle = NULL;
+    }
+    if (_headerList) {
+        curl_slist_free_all(_headerList);
+        _headerList = NULL;
+    }
+}
+
+#pragma mark CMISCancellableRequest method
+
+- (void)cancel
+{
+    void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error) = nil;
+    @synchronized(self) {
+        if (self.cancelled) {
+            return;
+        }
+        self.cancelled = YES;
+        completionBlock = self.completionBlock;
+        self.completionBlock = nil;
+        self.progressBlock = nil;
+    }
+    
+    [self.worker removeTransfer:self];
+    
+    if (completionBlock) {
+        completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled detailedDescription:@"Request was cancelled"]);
+    }
+}
+
+@end
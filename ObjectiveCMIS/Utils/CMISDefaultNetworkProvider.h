@@ -15,8 +15,24 @@
 #import <Foundation/Foundation.h>
 #import "CMISNetworkProvider.h"
 
+@class CMISRequestScheduler;
+@class CMISRequestCoalescer;
+@class CMISRequestHedger;
+
 @interface CMISDefaultNetworkProvider : NSObject <CMISNetworkProvider>
 
+/// the scheduler limiting the concurrent requests per host, exposes queue depth and wait time statistics
+@property (nonatomic, strong, readonly) CMISRequestScheduler *requestScheduler;
+
+/// shares in-flight GET requests among callers issuing an identical request
+@property (nonatomic, strong, readonly) CMISRequestCoalescer *requestCoalescer;
+
+/// duplicates slow GET requests if enabled with kCMISSessionParameterHedgeRequests, exposes hedging statistics
+@property (nonatomic, strong, readonly) CMISRequestHedger *requestHedger;
+
+/// the number of requests sent to open or keep alive idle connections
+@property (assign, readonly) NSUInteger warmUpRequestCount;
+
 @end
 
 @interface CMISDefaultNetworkProvider (Protected)
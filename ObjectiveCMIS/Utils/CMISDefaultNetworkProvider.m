@@ -18,8 +18,50 @@
 #import "CMISHttpDownloadRequest.h"
 #import "CMISHttpUploadRequest.h"
 #import "CMISLog.h"
+#import "CMISRequestScheduler.h"
+#import "CMISRequestCoalescer.h"
+#import "CMISRequestHedger.h"
+#import "CMISHttpContentCoder.h"
+#import "CMISHttpResponse.h"
+#import "CMISURLSessionPool.h"
+
+// Default maximum number of concurrent requests per host
+#define DEFAULT_MAX_CONCURRENT_REQUESTS_PER_HOST 6
+
+// Default interval in seconds in which idle connections are used to keep them open, 0 disables keep alive
+#define DEFAULT_CONNECTION_KEEP_ALIVE_INTERVAL 0
+
+// binding session key marking that the connections of the session have been warmed up
+static NSString * const kCMISBindingSessionKeyConnectionsWarmedUp = @"cmis_session_key_connections_warmed_up";
+
+// Default percentile of the recorded times to first byte after which a request is duplicated
+#define DEFAULT_HEDGE_DELAY_PERCENTILE 95
+
+// Default minimum delay in seconds before a request is duplicated
+#define DEFAULT_HEDGE_MINIMUM_DELAY 0.05
+
+@interface CMISDefaultNetworkProvider ()
+
+@property (nonatomic, strong, readwrite) CMISRequestScheduler *requestScheduler;
+@property (nonatomic, strong, readwrite) CMISRequestCoalescer *requestCoalescer;
+@property (nonatomic, strong, readwrite) CMISRequestHedger *requestHedger;
+@property (assign, readwrite) NSUInteger warmUpRequestCount;
+
+@end
 
 @implementation CMISDefaultNetworkProvider
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        self.requestScheduler = [[CMISRequestScheduler alloc] init];
+        self.requestCoalescer = [[CMISRequestCoalescer alloc] init];
+        self.requestHedger = [[CMISRequestHedger alloc] init];
+    }
+    return self;
+}
+
 #pragma mark block based methods
 
 
@@ -31,27 +73,90 @@
    cmisRequest:(CMISRequest *)cmisRequest
 completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
 {
-    NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
-                                                                           httpMethod:httpRequestMethod
-                                                                              session:session];
-    if (!cmisRequest.isCancelled)
-    {
-        CMISHttpRequest* request = [CMISHttpRequest startRequest:urlRequest
+    // identical GET requests running at the same time share one network request
+    id coalesceRequests = [session objectForKey:kCMISSessionParameterCoalesceRequests];
+    if (httpRequestMethod == HTTP_GET && body == nil && (!coalesceRequests || [coalesceRequests boolValue])) {
+        [self.requestCoalescer invokeRequestWithKey:[CMISRequestCoalescer keyForUrl:url session:session headers:additionalHeaders]
+                                           priority:[CMISDefaultNetworkProvider priorityForRequest:cmisRequest session:session]
+                                        cmisRequest:cmisRequest
+                                    completionBlock:completionBlock
+                                         startBlock:^(CMISRequest *sharedRequest, void (^sharedCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                                             [self invokeRequest:url
                                                       httpMethod:httpRequestMethod
-                                                     requestBody:body
-                                                         headers:additionalHeaders
                                                          session:session
-                                                 completionBlock:completionBlock];
-        if (request)
-        {
-            cmisRequest.httpRequest = request;
-        }
+                                                            body:body
+                                                         headers:additionalHeaders
+                                                     cmisRequest:sharedRequest
+                                                 completionBlock:sharedCompletionBlock];
+                                         }];
     } else {
-        if (completionBlock) {
-            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
-                                                 detailedDescription:@"Request was cancelled"]);
+        [self invokeRequest:url
+                 httpMethod:httpRequestMethod
+                    session:session
+                       body:body
+                    headers:additionalHeaders
+                cmisRequest:cmisRequest
+            completionBlock:completionBlock];
+    }
+}
+
+- (void)invokeRequest:(NSURL *)url
+           httpMethod:(CMISHttpRequestMethod)httpRequestMethod
+              session:(CMISBindingSession *)session
+                 body:(NSData *)body
+              headers:(NSDictionary *)additionalHeaders
+          cmisRequest:(CMISRequest *)cmisRequest
+      completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    // compress large url encoded form bodies, if configured the server accepts them
+    NSNumber *compressionThreshold = [session objectForKey:kCMISSessionParameterCompressRequestBodyThreshold];
+    NSString *contentType = [CMISHttpResponse valueForHeader:@"Content-Type" headers:additionalHeaders];
+    if (compressionThreshold && body.length >= [compressionThreshold unsignedIntegerValue] &&
+        [contentType hasPrefix:@"application/x-www-form-urlencoded"]) {
+        NSData *compressedBody = [CMISHttpContentCoder gzipEncodedData:body];
+        if (compressedBody && compressedBody.length < body.length) {
+            CMISLogDebug(@"Compressed request body from %lu to %lu bytes", (unsigned long)body.length, (unsigned long)compressedBody.length);
+            body = compressedBody;
+            NSMutableDictionary *headers = [NSMutableDictionary dictionaryWithDictionary:additionalHeaders];
+            [headers setObject:@"gzip" forKey:@"Content-Encoding"];
+            additionalHeaders = headers;
         }
     }
+    
+    void (^startBlock)(CMISRequest *, void (^)(CMISHttpResponse *, NSError *)) = ^(CMISRequest *request, void (^requestCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+        [self scheduleRequestForUrl:url
+                            session:session
+                        cmisRequest:request
+                    completionBlock:requestCompletionBlock
+                         startBlock:^id(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                             NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
+                                                                                                    httpMethod:httpRequestMethod
+                                                                                                       session:session];
+                             return [CMISHttpRequest startRequest:urlRequest
+                                                       httpMethod:httpRequestMethod
+                                                      requestBody:body
+                                                          headers:additionalHeaders
+                                                          session:session
+                                                  completionBlock:scheduledCompletionBlock];
+                         }];
+    };
+    
+    // duplicate slow GET requests if configured, both copies take a slot of the host
+    id hedgeRequests = [session objectForKey:kCMISSessionParameterHedgeRequests];
+    if (httpRequestMethod == HTTP_GET && body == nil && hedgeRequests && [hedgeRequests boolValue]) {
+        NSNumber *percentile = [session objectForKey:kCMISSessionParameterHedgeDelayPercentile
+                                        defaultValue:@(DEFAULT_HEDGE_DELAY_PERCENTILE)];
+        NSNumber *minimumDelay = [session objectForKey:kCMISSessionParameterHedgeMinimumDelay
+                                          defaultValue:@(DEFAULT_HEDGE_MINIMUM_DELAY)];
+        [self.requestHedger invokeRequestForHost:url.host
+                                      percentile:[percentile doubleValue]
+                                    minimumDelay:[minimumDelay doubleValue]
+                                     cmisRequest:cmisRequest
+                                 completionBlock:completionBlock
+                                      startBlock:startBlock];
+    } else {
+        startBlock(cmisRequest, completionBlock);
+    }
 }
 
 - (void)invoke:(NSURL *)url
@@ -62,29 +167,23 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
    cmisRequest:(CMISRequest *)cmisRequest
 completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
 {
-    if (!cmisRequest.isCancelled) {
-        NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
-                                                                               httpMethod:httpRequestMethod
-                                                                                  session:session];
-        
-        CMISHttpUploadRequest* request = [CMISHttpUploadRequest startRequest:urlRequest
-                                                                  httpMethod:httpRequestMethod
-                                                                 inputStream:inputStream
-                                                                     headers:additionalHeaders
-                                                               bytesExpected:0
-                                                                     session:session
-                                                             completionBlock:completionBlock
-                                                               progressBlock:nil];
-        if (request)
-        {
-            cmisRequest.httpRequest = request;
-        }
-    } else {
-        if (completionBlock) {
-            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
-                                                 detailedDescription:@"Request was cancelled"]);
-        }
-    }
+    [self scheduleRequestForUrl:url
+                        session:session
+                    cmisRequest:cmisRequest
+                completionBlock:completionBlock
+                     startBlock:^id(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                         NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
+                                                                                                httpMethod:httpRequestMethod
+                                                                                                   session:session];
+                         return [CMISHttpUploadRequest startRequest:urlRequest
+                                                         httpMethod:httpRequestMethod
+                                                        inputStream:inputStream
+                                                            headers:additionalHeaders
+                                                      bytesExpected:0
+                                                            session:session
+                                                    completionBlock:scheduledCompletionBlock
+                                                      progressBlock:nil];
+                     }];
 }
 
 - (void)invoke:(NSURL *)url
@@ -97,28 +196,23 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
 completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
  progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
 {
-    if (!cmisRequest.isCancelled) {
-        NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
-                                                                               httpMethod:httpRequestMethod
-                                                                                  session:session];
-        
-        CMISHttpUploadRequest* request = [CMISHttpUploadRequest startRequest:urlRequest
-                                                                  httpMethod:httpRequestMethod
-                                                                 inputStream:inputStream
-                                                                     headers:additionalHeaders
-                                                               bytesExpected:bytesExpected
-                                                                     session:session
-                                                             completionBlock:completionBlock
-                                                               progressBlock:progressBlock];
-        if (request){
-            cmisRequest.httpRequest = request;
-        }
-    } else {
-        if (completionBlock) {
-            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
-                                                 detailedDescription:@"Request was cancelled"]);
-        }
-    }
+    [self scheduleRequestForUrl:url
+                        session:session
+                    cmisRequest:cmisRequest
+                completionBlock:completionBlock
+                     startBlock:^id(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                         NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
+                                                                                                httpMethod:httpRequestMethod
+                                                                                                   session:session];
+                         return [CMISHttpUploadRequest startRequest:urlRequest
+                                                         httpMethod:httpRequestMethod
+                                                        inputStream:inputStream
+                                                            headers:additionalHeaders
+                                                      bytesExpected:bytesExpected
+                                                            session:session
+                                                    completionBlock:scheduledCompletionBlock
+                                                      progressBlock:progressBlock];
+                     }];
 }
 
 - (void)invoke:(NSURL *)url
@@ -134,31 +228,26 @@ useBase64Encoding:(BOOL)useBase64Encoding
 completionBlock:(void (^)(CMISHttpResponse *, NSError *))completionBlock
  progressBlock:(void (^)(unsigned long long, unsigned long long))progressBlock
 {
-    if (!cmisRequest.isCancelled) {
-        NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
-                                                                               httpMethod:httpRequestMethod
-                                                                                  session:session];
-        
-        CMISHttpUploadRequest* request = [CMISHttpUploadRequest startRequest:urlRequest
-                                                                  httpMethod:httpRequestMethod
-                                                                 inputStream:inputStream
-                                                                     headers:additionalHeaders
-                                                               bytesExpected:bytesExpected
-                                                                     session:session
-                                                                   startData:startData
-                                                                     endData:endData
-                                                           useBase64Encoding:useBase64Encoding
-                                                             completionBlock:completionBlock
-                                                               progressBlock:progressBlock];
-        if (request){
-            cmisRequest.httpRequest = request;
-        }
-    } else {
-        if (completionBlock) {
-            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
-                                                 detailedDescription:@"Request was cancelled"]);
-        }
-    }
+    [self scheduleRequestForUrl:url
+                        session:session
+                    cmisRequest:cmisRequest
+                completionBlock:completionBlock
+                     startBlock:^id(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                         NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
+                                                                                                httpMethod:httpRequestMethod
+                                                                                                   session:session];
+                         return [CMISHttpUploadRequest startRequest:urlRequest
+                                                         httpMethod:httpRequestMethod
+                                                        inputStream:inputStream
+                                                            headers:additionalHeaders
+                                                      bytesExpected:bytesExpected
+                                                            session:session
+                                                          startData:startData
+                                                            endData:endData
+                                                  useBase64Encoding:useBase64Encoding
+                                                    completionBlock:scheduledCompletionBlock
+                                                      progressBlock:progressBlock];
+                     }];
 }
 
 - (void)invoke:(NSURL *)url
@@ -170,28 +259,24 @@ outputFilePath:(NSString *)outputFilePath
 completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
  progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
 {
-    if (!cmisRequest.isCancelled) {
-        NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
-                                                                               httpMethod:HTTP_GET
-                                                                                  session:session];
-        
-        CMISHttpDownloadRequest* request = [CMISHttpDownloadRequest startRequest:urlRequest
-                                                                      httpMethod:httpRequestMethod
-                                                                  outputFilePath:outputFilePath
-                                                                   bytesExpected:bytesExpected
-                                                                         session:session
-                                                                 completionBlock:completionBlock
-                                                                   progressBlock:progressBlock];
-        if (request) {
-            cmisRequest.httpRequest = request;
-        }
-    } else {
-        if (completionBlock) {
-            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
-                                                 detailedDescription:@"Request was cancelled"]);
-            
-        }
-    }
+    [self scheduleRequestForUrl:url
+                        session:session
+                    cmisRequest:cmisRequest
+                completionBlock:completionBlock
+                     startBlock:^id(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                         NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
+                                                                                                httpMethod:HTTP_GET
+                                                                                                   session:session];
+                         // content streams are often compressed already and byte ranges must refer to the unencoded content
+                         [urlRequest setValue:@"identity" forHTTPHeaderField:@"Accept-Encoding"];
+                         return [CMISHttpDownloadRequest startRequest:urlRequest
+                                                           httpMethod:httpRequestMethod
+                                                       outputFilePath:outputFilePath
+                                                        bytesExpected:bytesExpected
+                                                              session:session
+                                                      completionBlock:scheduledCompletionBlock
+                                                        progressBlock:progressBlock];
+                     }];
 }
 
 - (void)invoke:(NSURL *)url
@@ -226,30 +311,26 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
 completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
  progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
 {
-    if (!cmisRequest.isCancelled) {
-        NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
-                                                                               httpMethod:HTTP_GET
-                                                                                  session:session];
-        
-        CMISHttpDownloadRequest* request = [CMISHttpDownloadRequest startRequest:urlRequest
-                                                                      httpMethod:httpRequestMethod
-                                                                    outputStream:outputStream
-                                                                   bytesExpected:bytesExpected
-                                                                          offset:offset
-                                                                          length:length
-                                                                         session:session
-                                                                 completionBlock:completionBlock
-                                                                   progressBlock:progressBlock];
-        if (request) {
-            cmisRequest.httpRequest = request;
-        }
-    } else {
-        if (completionBlock) {
-            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
-                                                 detailedDescription:@"Request was cancelled"]);
-            
-        }
-    }
+    [self scheduleRequestForUrl:url
+                        session:session
+                    cmisRequest:cmisRequest
+                completionBlock:completionBlock
+                     startBlock:^id(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                         NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
+                                                                                                httpMethod:HTTP_GET
+                                                                                                   session:session];
+                         // content streams are often compressed already and byte ranges must refer to the unencoded content
+                         [urlRequest setValue:@"identity" forHTTPHeaderField:@"Accept-Encoding"];
+                         return [CMISHttpDownloadRequest startRequest:urlRequest
+                                                           httpMethod:httpRequestMethod
+                                                         outputStream:outputStream
+                                                        bytesExpected:bytesExpected
+                                                               offset:offset
+                                                               length:length
+                                                              session:session
+                                                      completionBlock:scheduledCompletionBlock
+                                                        progressBlock:progressBlock];
+                     }];
 }
 
 - (void)invokeGET:(NSURL *)url
@@ -266,6 +347,32 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
         completionBlock:completionBlock];
 }
 
+- (void)invokeGET:(NSURL *)url
+          session:(CMISBindingSession *)session
+      cmisRequest:(CMISRequest *)cmisRequest
+        dataBlock:(void (^)(NSData *data))dataBlock
+  completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+{
+    // a streamed response has a single consumer, so it is neither coalesced nor hedged
+    [self scheduleRequestForUrl:url
+                        session:session
+                    cmisRequest:cmisRequest
+                completionBlock:completionBlock
+                     startBlock:^id(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)) {
+                         NSMutableURLRequest *urlRequest = [CMISDefaultNetworkProvider createRequestForUrl:url
+                                                                                                httpMethod:HTTP_GET
+                                                                                                   session:session];
+                         CMISHttpRequest *httpRequest = [[CMISHttpRequest alloc] initWithHttpMethod:HTTP_GET
+                                                                                    completionBlock:scheduledCompletionBlock];
+                         httpRequest.session = session;
+                         httpRequest.responseDataBlock = dataBlock;
+                         if (![httpRequest startRequest:urlRequest]) {
+                             httpRequest = nil;
+                         }
+                         return httpRequest;
+                     }];
+}
+
 - (void)invokePOST:(NSURL *)url
            session:(CMISBindingSession *)session
               body:(NSData *)body
@@ -312,7 +419,117 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
         completionBlock:completionBlock];
 }
 
+- (void)warmUpConnectionsForSession:(CMISBindingSession *)session
+{
+    NSUInteger connectionCount = [[session objectForKey:kCMISSessionParameterWarmUpConnections defaultValue:@(0)] unsignedIntegerValue];
+    NSURL *url = [session objectForKey:kCMISBindingSessionKeyUrl];
+    if (connectionCount == 0 || url == nil) {
+        return;
+    }
+    
+    @synchronized(session) {
+        if ([session objectForKey:kCMISBindingSessionKeyConnectionsWarmedUp]) {
+            return;
+        }
+        [session setObject:@YES forKey:kCMISBindingSessionKeyConnectionsWarmedUp];
+    }
+    
+    // the repository info request sent along opens one of the connections
+    [self sendWarmUpRequests:connectionCount - 1 url:url session:session];
+    
+    NSNumber *keepAliveInterval = [session objectForKey:kCMISSessionParameterConnectionKeepAliveInterval
+                                           defaultValue:@(DEFAULT_CONNECTION_KEEP_ALIVE_INTERVAL)];
+    __weak CMISDefaultNetworkProvider *weakSelf = self;
+    __weak CMISBindingSession *weakSession = session;
+    [[CMISURLSessionPool sharedPool] keepConnectionsAliveToURL:url
+                                                bindingSession:session
+                                                      interval:[keepAliveInterval doubleValue]
+                                                keepAliveBlock:^{
+                                                    CMISBindingSession *keepAliveSession = weakSession;
+                                                    if (keepAliveSession) {
+                                                        [weakSelf sendWarmUpRequests:connectionCount url:url session:keepAliveSession];
+                                                    }
+                                                }];
+}
+
 #pragma mark Helper methods
+
+/// sends concurrent HEAD requests through the regular request path, so they carry the authentication headers
+- (void)sendWarmUpRequests:(NSUInteger)requestCount url:(NSURL *)url session:(CMISBindingSession *)session
+{
+    for (NSUInteger index = 0; index < requestCount; index++) {
+        [self invokeRequest:url
+                 httpMethod:HTTP_HEAD
+                    session:session
+                       body:nil
+                    headers:nil
+                cmisRequest:[[CMISRequest alloc] init]
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                if (error) {
+                    CMISLogDebug(@"Warm up request to %@ failed: %@", url.host, error);
+                }
+            }];
+    }
+    @synchronized(self) {
+        self.warmUpRequestCount += requestCount;
+    }
+}
+
+- (void)scheduleRequestForUrl:(NSURL *)url
+                      session:(CMISBindingSession *)session
+                  cmisRequest:(CMISRequest *)cmisRequest
+              completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+                   startBlock:(id (^)(void (^scheduledCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)))startBlock
+{
+    if (cmisRequest.isCancelled) {
+        if (completionBlock) {
+            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                                 detailedDescription:@"Request was cancelled"]);
+        }
+        return;
+    }
+    
+    CMISRequestPriority priority = [CMISDefaultNetworkProvider priorityForRequest:cmisRequest session:session];
+    NSNumber *maxConcurrentRequests = [session objectForKey:kCMISSessionParameterMaxConcurrentRequestsPerHost
+                                               defaultValue:@(DEFAULT_MAX_CONCURRENT_REQUESTS_PER_HOST)];
+    
+    [self.requestScheduler scheduleRequestForHost:url.host
+                                         priority:priority
+                            maxConcurrentRequests:[maxConcurrentRequests unsignedIntegerValue]
+                                      cmisRequest:cmisRequest
+                                       startBlock:^(void (^finishedBlock)(void)) {
+                                           id request = startBlock(^(CMISHttpResponse *httpResponse, NSError *error) {
+                                               // give the slot to the next queued request before handing over the result
+                                               finishedBlock();
+                                               if (httpResponse.contentHash) {
+                                                   cmisRequest.contentHash = httpResponse.contentHash;
+                                               }
+                                               if (completionBlock) {
+                                                   completionBlock(httpResponse, error);
+                                               }
+                                           });
+                                           if (request) {
+                                               cmisRequest.httpRequest = request;
+                                           }
+                                       }
+                                      cancelBlock:^{
+                                          if (completionBlock) {
+                                              completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                                                                   detailedDescription:@"Request was cancelled"]);
+                                          }
+                                      }];
+}
+
+/// the priority of the request, or the priority configured for the session if the request has none
++ (CMISRequestPriority)priorityForRequest:(CMISRequest *)cmisRequest session:(CMISBindingSession *)session
+{
+    if (cmisRequest.priority != CMISRequestPriorityDefault) {
+        return cmisRequest.priority;
+    }
+    return [[session objectForKey:kCMISSessionParameterDefaultRequestPriority
+                     defaultValue:@(CMISRequestPriorityInteractive)] integerValue];
+}
+
 + (NSMutableURLRequest *)createRequestForUrl:(NSURL *)url
                                   httpMethod:(CMISHttpRequestMethod)httpRequestMethod
                                      session:(CMISBindingSession *)session
@@ -336,6 +553,9 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
         case HTTP_PUT:
             httpMethod = @"PUT";
             break;
+        case HTTP_HEAD:
+            httpMethod = @"HEAD";
+            break;
         default:
             CMISLogError(@"Invalid http request method: %d", (int)httpRequestMethod);
             return nil;
@@ -344,6 +564,14 @@ completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))comple
     [request setHTTPMethod:httpMethod];
     CMISLogDebug(@"HTTP %@: %@", httpMethod, [url absoluteString]);
     
+    // negotiate compressed responses, they are decoded by the platform or by CMISHttpRequest
+    id acceptCompressedResponses = [session objectForKey:kCMISSessionParameterAcceptCompressedResponses];
+    if (!acceptCompressedResponses || [acceptCompressedResponses boolValue]) {
+        [request setValue:@"gzip, deflate" forHTTPHeaderField:@"Accept-Encoding"];
+    } else {
+        [request setValue:@"identity" forHTTPHeaderField:@"Accept-Encoding"];
+    }
+    
     // turn off cookies if configured to do so
     id sendCookies = [session objectForKey:kCMISSessionParameterSendCookies];
     if (sendCookies && ![sendCookies boolValue])
@@ -0,0 +1,56 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ * The destination of a downloaded response body.
+ *
+ * The data received for a download is handed to the sink as it arrives, without being collected in memory. A sink may
+ * write the data asynchronously, in which case it limits the amount of buffered data by asking the request to pause
+ * receiving data through the backpressure block.
+ */
+@protocol CMISDownloadSink <NSObject>
+
+/// the error of the first write that failed, nil as long as all data could be written
+@property (readonly) NSError *error;
+
+/// the number of bytes written so far
+@property (readonly) unsigned long long bytesWritten;
+
+/**
+ * Prepares the sink for receiving data.
+ * @param expectedLength the number of bytes expected, 0 if not known
+ * @return NO if the data cannot be written, the error describes why
+ */
+- (BOOL)openWithExpectedLength:(unsigned long long)expectedLength error:(NSError **)error;
+
+/// writes the data; the sink may keep a reference to the data until it has been written
+- (void)writeData:(NSData *)data;
+
+/// waits for all data to be written, closes the sink and calls the completion block on an arbitrary thread
+- (void)closeWithCompletionBlock:(void (^)(NSError *error))completionBlock;
+
+@optional
+
+/// called with YES when the sink cannot take more data for the moment and with NO once it can again
+@property (copy) void (^backpressureBlock)(BOOL paused);
+
+@end
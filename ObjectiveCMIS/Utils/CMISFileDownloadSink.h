@@ -0,0 +1,42 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CMISDownloadSink.h"
+
+/**
+ * Writes a download directly to a file descriptor using positional writes.
+ *
+ * When the expected length is known, disk space for it is reserved before the first write, where the platform supports
+ * it. The size of the file always matches the number of bytes written, so an interrupted download can be continued.
+ */
+@interface CMISFileDownloadSink : NSObject <CMISDownloadSink>
+
+/// the path of the file written to
+@property (nonatomic, strong, readonly) NSString *filePath;
+
+/**
+ * Initialises the sink.
+ * @param filePath the file to write to, created if it does not exist
+ * @param append YES to add the data to the end of an existing file, NO to replace the content of the file
+ */
+- (id)initWithFilePath:(NSString *)filePath append:(BOOL)append;
+
+@end
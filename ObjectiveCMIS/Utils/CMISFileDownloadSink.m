@@ -0,0 +1,133 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISFileDownloadSink.h"
+#import "CMISErrors.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+@interface CMISFileDownloadSink ()
+
+@property (nonatomic, strong, readwrite) NSString *filePath;
+@property (nonatomic, assign) BOOL append;
+@property (nonatomic, assign) int fileDescriptor;
+@property (nonatomic, assign) unsigned long long offset;
+@property (strong, readwrite) NSError *error;
+@property (readwrite) unsigned long long bytesWritten;
+
+@end
+
+
+@implementation CMISFileDownloadSink
+
+- (id)initWithFilePath:(NSString *)filePath append:(BOOL)append
+{
+    self = [super init];
+    if (self) {
+        _filePath = filePath;
+        _append = append;
+        _fileDescriptor = -1;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (_fileDescriptor >= 0) {
+        close(_fileDescriptor);
+    }
+}
+
+- (BOOL)openWithExpectedLength:(unsigned long long)expectedLength error:(NSError **)error
+{
+    int flags = O_WRONLY | O_CREAT | (self.append ? 0 : O_TRUNC);
+    self.fileDescriptor = open(self.filePath.fileSystemRepresentation, flags, 0644);
+    off_t offset = self.fileDescriptor >= 0 ? lseek(self.fileDescriptor, 0, SEEK_END) : -1;
+    if (offset < 0) {
+        if (error) {
+            *error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                     detailedDescription:[NSString stringWithFormat:@"Could not open file %@", self.filePath]];
+        }
+        return NO;
+    }
+    self.offset = (unsigned long long)offset;
+    
+    if (expectedLength > 0) {
+        [self reserveSpaceForLength:expectedLength];
+    }
+    return YES;
+}
+
+- (void)writeData:(NSData *)data
+{
+    if (self.error || self.fileDescriptor < 0) {
+        return;
+    }
+    
+    // the data received by NSURLSession may consist of several regions, they are written without being joined first
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        NSUInteger written = 0;
+        while (written < byteRange.length) {
+            ssize_t result = pwrite(self.fileDescriptor, (const uint8_t *)bytes + written, byteRange.length - written, (off_t)self.offset);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                self.error = [CMISErrors cmisError:[NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil]
+                                     cmisErrorCode:kCMISErrorCodeStorage];
+                *stop = YES;
+                return;
+            }
+            written += result;
+            self.offset += result;
+            self.bytesWritten += result;
+        }
+    }];
+}
+
+- (void)closeWithCompletionBlock:(void (^)(NSError *error))completionBlock
+{
+    if (self.fileDescriptor >= 0) {
+        close(self.fileDescriptor);
+        self.fileDescriptor = -1;
+    }
+    
+    if (completionBlock) {
+        completionBlock(self.error);
+    }
+}
+
+#pragma mark Private methods
+
+/// reserves disk space for the remaining data without changing the size of the file, failures are ignored
+- (void)reserveSpaceForLength:(unsigned long long)length
+{
+#ifdef F_PREALLOCATE
+    fstore_t store = {F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t)length, 0};
+    if (fcntl(self.fileDescriptor, F_PREALLOCATE, &store) == -1) {
+        // contiguous space is not available, any space will do
+        store.fst_flags = F_ALLOCATEALL;
+        fcntl(self.fileDescriptor, F_PREALLOCATE, &store);
+    }
+#endif
+}
+
+@end
@@ -0,0 +1,49 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ * An output stream writing to a region of a file that is shared with other streams, so several ranges of a
+ * content stream can be downloaded into the same file at the same time.
+ *
+ * Data is written with positional writes starting at the offset of the stream. The file descriptor is owned by the
+ * caller; opening and closing the stream does not open or close it.
+ */
+@interface CMISFileRangeOutputStream : NSOutputStream
+
+/// the position in the file of the first byte written to the stream
+@property (nonatomic, assign, readonly) unsigned long long offset;
+
+/// the maximum number of bytes that can be written to the stream, 0 if the number is not limited
+@property (nonatomic, assign, readonly) unsigned long long maximumLength;
+
+/// the number of bytes written to the stream
+@property (nonatomic, assign, readonly) unsigned long long bytesWritten;
+
+/**
+ * Initialises the stream.
+ * @param fileDescriptor a file descriptor opened for writing
+ * @param offset the position in the file of the first byte written to the stream
+ * @param maximumLength the maximum number of bytes accepted by the stream, 0 if the number is not limited
+ */
+- (id)initWithFileDescriptor:(int)fileDescriptor offset:(unsigned long long)offset maximumLength:(unsigned long long)maximumLength;
+
+@end
@@ -0,0 +1,146 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISFileRangeOutputStream.h"
+#import "CMISErrors.h"
+#include <errno.h>
+#include <unistd.h>
+
+@interface CMISFileRangeOutputStream ()
+
+@property (nonatomic, assign) int fileDescriptor;
+@property (nonatomic, assign, readwrite) unsigned long long offset;
+@property (nonatomic, assign, readwrite) unsigned long long maximumLength;
+@property (nonatomic, assign, readwrite) unsigned long long bytesWritten;
+@property (nonatomic, assign) NSStreamStatus status;
+@property (nonatomic, strong) NSError *error;
+@property (nonatomic, weak) id<NSStreamDelegate> streamDelegate;
+
+@end
+
+
+@implementation CMISFileRangeOutputStream
+
+- (id)initWithFileDescriptor:(int)fileDescriptor offset:(unsigned long long)offset maximumLength:(unsigned long long)maximumLength
+{
+    self = [super init];
+    if (self) {
+        _fileDescriptor = fileDescriptor;
+        _offset = offset;
+        _maximumLength = maximumLength;
+        _status = NSStreamStatusNotOpen;
+    }
+    return self;
+}
+
+#pragma mark NSStream methods
+
+- (void)open
+{
+    if (self.status == NSStreamStatusNotOpen) {
+        self.status = NSStreamStatusOpen;
+    }
+}
+
+- (void)close
+{
+    if (self.status != NSStreamStatusError) {
+        self.status = NSStreamStatusClosed;
+    }
+}
+
+- (NSStreamStatus)streamStatus
+{
+    return self.status;
+}
+
+- (NSError *)streamError
+{
+    return self.error;
+}
+
+- (id<NSStreamDelegate>)delegate
+{
+    return self.streamDelegate;
+}
+
+- (void)setDelegate:(id<NSStreamDelegate>)delegate
+{
+    self.streamDelegate = delegate;
+}
+
+- (id)propertyForKey:(NSString *)key
+{
+    if ([key isEqualToString:NSStreamFileCurrentOffsetKey]) {
+        return @(self.offset + self.bytesWritten);
+    }
+    return nil;
+}
+
+- (BOOL)setProperty:(id)property forKey:(NSString *)key
+{
+    return NO;
+}
+
+- (void)scheduleInRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+    // writes never block, there are no events to deliver
+}
+
+- (void)removeFromRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+}
+
+#pragma mark NSOutputStream methods
+
+- (BOOL)hasSpaceAvailable
+{
+    return self.status == NSStreamStatusOpen;
+}
+
+- (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)length
+{
+    if (self.status != NSStreamStatusOpen) {
+        return -1;
+    }
+    
+    if (self.maximumLength > 0 && self.bytesWritten + length > self.maximumLength) {
+        self.error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                     detailedDescription:@"More data received than requested for the range"];
+        self.status = NSStreamStatusError;
+        return -1;
+    }
+    
+    ssize_t written;
+    do {
+        written = pwrite(self.fileDescriptor, buffer, length, (off_t)(self.offset + self.bytesWritten));
+    } while (written < 0 && errno == EINTR);
+    
+    if (written < 0) {
+        self.error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        self.status = NSStreamStatusError;
+        return -1;
+    }
+    
+    self.bytesWritten += written;
+    return written;
+}
+
+@end
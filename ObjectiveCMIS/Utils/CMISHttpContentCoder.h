@@ -0,0 +1,47 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+/**
+ * Decodes gzip or deflate encoded HTTP bodies chunk by chunk, and gzip encodes request bodies.
+ *
+ * NSURLSession transparently decodes compressed responses on Apple platforms. A decoder is only created if the
+ * received bytes are still compressed, so responses are never decoded twice.
+ */
+@interface CMISHttpContentCoder : NSObject
+
+/**
+ * Returns a decoder if the given content encoding is gzip or deflate and the first received bytes are still encoded.
+ * @param contentEncoding the value of the Content-Encoding response header
+ * @param data the first chunk of the response body
+ * @return the decoder or nil if the data does not have to be decoded
+ */
++ (CMISHttpContentCoder *)decoderForContentEncoding:(NSString *)contentEncoding data:(NSData *)data;
+
+/// decodes the next chunk of the body, returns nil if the data is corrupt
+- (NSData *)decodeData:(NSData *)data;
+
+/// returns YES if the end of the encoded body has been reached
+@property (nonatomic, assign, readonly, getter = isFinished) BOOL finished;
+
+/// returns the gzip encoded data or nil if the data could not be encoded
++ (NSData *)gzipEncodedData:(NSData *)data;
+
+@end
@@ -0,0 +1,144 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import "CMISHttpContentCoder.h"
+#import "CMISLog.h"
+#import <zlib.h>
+
+// size of the buffer the decoded data is written to
+#define DECODE_BUFFER_SIZE 32768
+
+// zlib window bits: 15 is the maximum window, +16 selects gzip, +32 detects gzip or zlib automatically
+#define WINDOW_BITS_GZIP (15 + 16)
+#define WINDOW_BITS_AUTO (15 + 32)
+
+@interface CMISHttpContentCoder ()
+{
+    z_stream _stream;
+}
+
+@property (nonatomic, assign, readwrite, getter = isFinished) BOOL finished;
+@property (nonatomic, assign) BOOL failed;
+
+@end
+
+@implementation CMISHttpContentCoder
+
++ (CMISHttpContentCoder *)decoderForContentEncoding:(NSString *)contentEncoding data:(NSData *)data
+{
+    if (contentEncoding == nil || data.length < 2) {
+        return nil;
+    }
+    
+    const uint8_t *bytes = data.bytes;
+    NSString *encoding = [contentEncoding.lowercaseString stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    BOOL encoded = NO;
+    if ([encoding isEqualToString:@"gzip"] || [encoding isEqualToString:@"x-gzip"]) {
+        encoded = (bytes[0] == 0x1f && bytes[1] == 0x8b);
+    } else if ([encoding isEqualToString:@"deflate"]) {
+        // zlib header: deflate compression method and a valid header checksum
+        encoded = ((bytes[0] & 0x0f) == Z_DEFLATED && ((bytes[0] << 8) | bytes[1]) % 31 == 0);
+    }
+    
+    return encoded ? [[CMISHttpContentCoder alloc] init] : nil;
+}
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        if (inflateInit2(&_stream, WINDOW_BITS_AUTO) != Z_OK) {
+            CMISLogError(@"Could not initialize decoder: %s", _stream.msg);
+            _failed = YES;
+        }
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    if (!_failed) {
+        inflateEnd(&_stream);
+    }
+}
+
+- (NSData *)decodeData:(NSData *)data
+{
+    if (self.failed) {
+        return nil;
+    }
+    
+    NSMutableData *decodedData = [NSMutableData dataWithCapacity:data.length * 4];
+    uint8_t buffer[DECODE_BUFFER_SIZE];
+    
+    _stream.next_in = (Bytef *)data.bytes;
+    _stream.avail_in = (uInt)data.length;
+    
+    // continue while input is left or the buffer was filled completely, as more output might be pending
+    do {
+        _stream.next_out = buffer;
+        _stream.avail_out = DECODE_BUFFER_SIZE;
+        
+        int status = inflate(&_stream, Z_NO_FLUSH);
+        if (status != Z_OK && status != Z_STREAM_END && status != Z_BUF_ERROR) {
+            CMISLogError(@"Could not decode response body: %s", _stream.msg ? _stream.msg : "unknown error");
+            inflateEnd(&_stream);
+            self.failed = YES;
+            return nil;
+        }
+        
+        [decodedData appendBytes:buffer length:DECODE_BUFFER_SIZE - _stream.avail_out];
+        
+        if (status == Z_STREAM_END) {
+            self.finished = YES;
+        } else if (status == Z_BUF_ERROR) {
+            break; // no progress possible, more input needed
+        }
+    } while (!self.finished && (_stream.avail_in > 0 || _stream.avail_out == 0));
+    
+    return decodedData;
+}
+
++ (NSData *)gzipEncodedData:(NSData *)data
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, WINDOW_BITS_GZIP, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        CMISLogError(@"Could not initialize encoder: %s", stream.msg);
+        return nil;
+    }
+    
+    NSMutableData *encodedData = [NSMutableData dataWithLength:deflateBound(&stream, (uLong)data.length) + 32];
+    stream.next_in = (Bytef *)data.bytes;
+    stream.avail_in = (uInt)data.length;
+    stream.next_out = encodedData.mutableBytes;
+    stream.avail_out = (uInt)encodedData.length;
+    
+    int status = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (status != Z_STREAM_END) {
+        CMISLogError(@"Could not encode data: %d", status);
+        return nil;
+    }
+    
+    encodedData.length = stream.total_out;
+    return encodedData;
+}
+
+@end
@@ -27,6 +27,7 @@
 
 // the outputStream should be unopened but if it is already open it will not be reset but used as is;
 // it is closed on completion; if no outputStream is provided, download goes to httpResponse.data
+// data is written to the stream on a separate queue, receiving is paused while the stream cannot keep up
 @property (nonatomic, strong) NSOutputStream *outputStream;
 
 // optional; if not set, expected content length from HTTP header is used
@@ -34,6 +35,9 @@
 
 @property (nonatomic, readonly) unsigned long long bytesDownloaded;
 
+// the number of bytes of a previous, interrupted download of the content that were kept and not requested again
+@property (nonatomic, readonly) unsigned long long resumeOffset;
+
 /** starts a URL request for download. Data are written to the provided output stream
  * completionBlock returns a CMISHttpResponse object or nil if unsuccessful
  */
@@ -59,6 +63,9 @@
      progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock;
 
 /** starts a URL request for download. Data is written to the provided file path.
+ * Unless disabled with kCMISSessionParameterResumableDownloads, the content is downloaded to a partial file next to the
+ * file path, which is kept if the download fails. A later download of the same URL to the same file path requests only
+ * the missing bytes, provided the server supports range requests and the content has not changed in the meantime.
  * completionBlock returns a CMISHttpResponse object or nil if unsuccessful
  */
 + (id)startRequest:(NSMutableURLRequest *)urlRequest
@@ -69,4 +76,9 @@
    completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
      progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock;
 
+/** parses the value of a Content-Range header, e.g. "bytes 100-199/200"
+ * the total length is 0 if the server does not know it
+ */
++ (BOOL)parseContentRange:(NSString *)contentRange firstBytePosition:(unsigned long long *)firstBytePosition totalLength:(unsigned long long *)totalLength;
+
 @end
@@ -18,15 +18,44 @@
  */
 
 #import "CMISHttpDownloadRequest.h"
+#import "CMISHttpResponse.h"
+#import "CMISBindingSession.h"
+#import "CMISSessionParameters.h"
 #import "CMISErrors.h"
 #import "CMISLog.h"
+#import "CMISFileDownloadSink.h"
+#import "CMISStreamDownloadSink.h"
+#import "CMISContentHasher.h"
+
+// the number of received bytes that may wait to be written to an output stream before receiving is paused
+#define OUTPUT_STREAM_BUFFER_LIMIT (4 * 1024 * 1024)
+
+// extension of the file the content is downloaded to before it is moved to the output file path
+#define PARTIAL_FILE_EXTENSION @"cmispart"
+
+// extension of the file describing which content the partial file belongs to
+#define PARTIAL_FILE_INFO_EXTENSION @"plist"
+
+static NSString * const kCMISPartialFileInfoUrl = @"url";
+static NSString * const kCMISPartialFileInfoETag = @"etag";
+static NSString * const kCMISPartialFileInfoLastModified = @"lastModified";
+static NSString * const kCMISPartialFileInfoLength = @"length";
 
 @interface CMISHttpDownloadRequest ()
 
 @property (nonatomic, copy) void (^progressBlock)(unsigned long long bytesDownloaded, unsigned long long bytesTotal);
 @property (nonatomic, assign) unsigned long long bytesDownloaded;
 @property (nonatomic, assign) BOOL cancelled;
-@property (nonatomic, strong) NSError *fileCopyError;
+@property (nonatomic, strong) NSError *fileError;
+@property (nonatomic, assign, readwrite) unsigned long long resumeOffset;
+@property (nonatomic, strong) NSString *partialFilePath;
+@property (nonatomic, strong) NSString *partialFileUrl;
+@property (nonatomic, strong) id<CMISDownloadSink> sink;
+@property (nonatomic, assign) BOOL progressDeliveryPending;
+@property (nonatomic, strong) CMISContentHasher *contentHasher; // only used on the hash queue once the request has started
+@property (nonatomic, strong) dispatch_queue_t hashQueue; // nil if the content is not hashed
+@property (nonatomic, assign) CMISContentHashAlgorithm contentHashAlgorithm;
+@property (nonatomic, assign) unsigned long long hashedResumeOffset; // the number of kept bytes queued for hashing
 
 - (id)initWithHttpMethod:(CMISHttpRequestMethod)httpRequestMethod
          completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
@@ -86,6 +115,9 @@
         }
         
         httpRequest.additionalHeaders = [NSDictionary dictionaryWithObject:range forKey:@"Range"];
+    } else {
+        // a range is only part of the content, its hash could not be compared with anything
+        [httpRequest setUpContentHasherForSession:session];
     }
 
     if (![httpRequest startRequest:urlRequest]) {
@@ -109,6 +141,14 @@
     httpRequest.outputFilePath = outputFilePath;
     httpRequest.bytesExpected = bytesExpected;
     httpRequest.session = session;
+    [httpRequest setUpContentHasherForSession:session];
+    
+    // background sessions only support download tasks, which cannot write to a file of our choice while downloading
+    id resumableDownloads = [session objectForKey:kCMISSessionParameterResumableDownloads];
+    id useBackgroundSession = [session objectForKey:kCMISSessionParameterUseBackgroundNetworkSession];
+    if ((!resumableDownloads || [resumableDownloads boolValue]) && ![useBackgroundSession boolValue]) {
+        [httpRequest preparePartialFileForUrl:urlRequest.URL];
+    }
     
     if (![httpRequest startRequest:urlRequest]) {
         httpRequest = nil;
@@ -129,23 +169,224 @@
     return self;
 }
 
+/**
+ The content is hashed on a separate serial queue, so reading files and hashing large amounts of data does not hold up
+ the delegate queue shared by all requests of the session. The hash is finished on that queue before the request completes.
+ */
+- (void)setUpContentHasherForSession:(CMISBindingSession *)session
+{
+    self.contentHasher = [CMISContentHasher hasherForSession:session];
+    if (self.contentHasher) {
+        self.contentHashAlgorithm = self.contentHasher.algorithm;
+        self.hashQueue = dispatch_queue_create("org.apache.chemistry.objectivecmis.contenthash", DISPATCH_QUEUE_SERIAL);
+    }
+}
+
+/// runs the block with the hasher on the hash queue, the hash is dropped if the block returns NO
+- (void)updateContentHashUsingBlock:(BOOL (^)(CMISContentHasher *contentHasher))block
+{
+    if (self.hashQueue == nil) {
+        return;
+    }
+    dispatch_async(self.hashQueue, ^{
+        if (self.contentHasher && !block(self.contentHasher)) {
+            self.contentHasher = nil;
+        }
+    });
+}
+
+/// starts the hash over, e.g. because the server sends the whole content instead of the bytes missing from the partial file
+- (void)resetContentHash
+{
+    if (self.hashQueue == nil) {
+        return;
+    }
+    CMISContentHashAlgorithm algorithm = self.contentHashAlgorithm;
+    dispatch_async(self.hashQueue, ^{
+        self.contentHasher = [[CMISContentHasher alloc] initWithAlgorithm:algorithm];
+    });
+}
+
+/// drops the hash, e.g. because an error response is received instead of the content
+- (void)discardContentHash
+{
+    [self updateContentHashUsingBlock:^BOOL(CMISContentHasher *contentHasher) {
+        return NO;
+    }];
+}
+
+/// picks up the partial file of a previous download of the same content and requests only the missing bytes
+- (void)preparePartialFileForUrl:(NSURL *)url
+{
+    self.partialFilePath = [self.outputFilePath stringByAppendingPathExtension:PARTIAL_FILE_EXTENSION];
+    self.partialFileUrl = url.absoluteString;
+    NSString *infoFilePath = [self.partialFilePath stringByAppendingPathExtension:PARTIAL_FILE_INFO_EXTENSION];
+    
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSDictionary *info = [NSDictionary dictionaryWithContentsOfFile:infoFilePath];
+    unsigned long long partialLength = [[fileManager attributesOfItemAtPath:self.partialFilePath error:nil] fileSize];
+    unsigned long long contentLength = [[info objectForKey:kCMISPartialFileInfoLength] unsignedLongLongValue];
+    NSString *validator = [info objectForKey:kCMISPartialFileInfoETag] ?: [info objectForKey:kCMISPartialFileInfoLastModified];
+    
+    if ([[info objectForKey:kCMISPartialFileInfoUrl] isEqualToString:self.partialFileUrl] && validator &&
+        partialLength > 0 && (contentLength == 0 || partialLength < contentLength)) {
+        self.resumeOffset = partialLength;
+        
+        // with If-Range the server sends the whole content instead of the range if the content has changed
+        NSMutableDictionary *headers = [NSMutableDictionary dictionaryWithDictionary:self.additionalHeaders];
+        [headers setObject:[NSString stringWithFormat:@"bytes=%llu-", partialLength] forKey:@"Range"];
+        [headers setObject:validator forKey:@"If-Range"];
+        self.additionalHeaders = headers;
+        
+        // the kept bytes are hashed while the request is sent, the received bytes are hashed after them
+        NSString *partialFilePath = self.partialFilePath;
+        self.hashedResumeOffset = partialLength;
+        [self updateContentHashUsingBlock:^BOOL(CMISContentHasher *contentHasher) {
+            if (![contentHasher updateWithContentsOfFile:partialFilePath length:partialLength]) {
+                CMISLogWarning(@"Could not read partial file %@, the content will not be hashed", partialFilePath);
+                return NO;
+            }
+            return YES;
+        }];
+        
+        CMISLogDebug(@"Resuming download of %@ at offset %llu", url, partialLength);
+    } else {
+        [fileManager removeItemAtPath:self.partialFilePath error:nil];
+        [fileManager removeItemAtPath:infoFilePath error:nil];
+    }
+}
+
+/// sets up the output stream to the partial file for the response, returns NO if the response cannot be used
+- (BOOL)openPartialFileForResponse:(NSHTTPURLResponse *)response
+{
+    NSString *infoFilePath = [self.partialFilePath stringByAppendingPathExtension:PARTIAL_FILE_INFO_EXTENSION];
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    
+    if ([CMISHttpRequest isErrorResponse:response.statusCode httpRequestMethod:self.requestMethod]) {
+        if (response.statusCode == 416) { // the kept bytes do not fit the content anymore
+            [fileManager removeItemAtPath:self.partialFilePath error:nil];
+            [fileManager removeItemAtPath:infoFilePath error:nil];
+        }
+        self.resumeOffset = 0;
+        return YES; // the partial file is left alone, the error response is kept in memory
+    }
+    
+    NSDictionary *headers = response.allHeaderFields;
+    unsigned long long contentLength = response.expectedContentLength > 0 ? (unsigned long long)response.expectedContentLength : 0;
+    BOOL append = NO;
+    if (response.statusCode == 206) {
+        NSString *contentRange = [CMISHttpResponse valueForHeader:@"Content-Range" headers:headers];
+        unsigned long long firstBytePosition = 0;
+        if (![CMISHttpDownloadRequest parseContentRange:contentRange firstBytePosition:&firstBytePosition totalLength:&contentLength] ||
+            firstBytePosition != self.resumeOffset) {
+            [fileManager removeItemAtPath:self.partialFilePath error:nil];
+            [fileManager removeItemAtPath:infoFilePath error:nil];
+            self.fileError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection
+                                             detailedDescription:[NSString stringWithFormat:@"Unexpected content range: %@", contentRange]];
+            return NO;
+        }
+        append = self.resumeOffset > 0;
+    } else {
+        // the server ignored the range or the content has changed, start over
+        self.resumeOffset = 0;
+    }
+    
+    // a partial file can only be resumed if the server provided a strong validator for the content
+    NSString *etag = [CMISHttpResponse valueForHeader:@"ETag" headers:headers];
+    if ([etag hasPrefix:@"W/"]) {
+        etag = nil;
+    }
+    NSString *lastModified = [CMISHttpResponse valueForHeader:@"Last-Modified" headers:headers];
+    if (etag || lastModified) {
+        NSMutableDictionary *info = [NSMutableDictionary dictionary];
+        [info setObject:self.partialFileUrl forKey:kCMISPartialFileInfoUrl];
+        [info setObject:@(contentLength) forKey:kCMISPartialFileInfoLength];
+        if (etag) {
+            [info setObject:etag forKey:kCMISPartialFileInfoETag];
+        }
+        if (lastModified) {
+            [info setObject:lastModified forKey:kCMISPartialFileInfoLastModified];
+        }
+        [info writeToFile:infoFilePath atomically:YES];
+    } else {
+        [fileManager removeItemAtPath:infoFilePath error:nil];
+    }
+    
+    self.sink = [[CMISFileDownloadSink alloc] initWithFilePath:self.partialFilePath append:append];
+    return YES;
+}
+
+/// moves the completely downloaded partial file to the output file path
+- (NSError *)movePartialFileToOutputFilePath
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    [fileManager removeItemAtPath:self.outputFilePath error:nil];
+    if (![fileManager moveItemAtPath:self.partialFilePath toPath:self.outputFilePath error:nil]) {
+        return [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                               detailedDescription:[NSString stringWithFormat:@"Could not move downloaded file to %@", self.outputFilePath]];
+    }
+    [fileManager removeItemAtPath:[self.partialFilePath stringByAppendingPathExtension:PARTIAL_FILE_INFO_EXTENSION] error:nil];
+    return nil;
+}
+
++ (BOOL)parseContentRange:(NSString *)contentRange firstBytePosition:(unsigned long long *)firstBytePosition totalLength:(unsigned long long *)totalLength
+{
+    if (contentRange == nil) {
+        return NO;
+    }
+    
+    NSScanner *scanner = [NSScanner scannerWithString:contentRange];
+    unsigned long long first = 0, last = 0, total = 0;
+    if (![scanner scanString:@"bytes" intoString:NULL] ||
+        ![scanner scanUnsignedLongLong:&first] ||
+        ![scanner scanString:@"-" intoString:NULL] ||
+        ![scanner scanUnsignedLongLong:&last] ||
+        ![scanner scanString:@"/" intoString:NULL] ||
+        last < first) {
+        return NO;
+    }
+    if (![scanner scanString:@"*" intoString:NULL] && (![scanner scanUnsignedLongLong:&total] || total <= last)) {
+        return NO;
+    }
+    
+    if (firstBytePosition) {
+        *firstBytePosition = first;
+    }
+    if (totalLength) {
+        *totalLength = total;
+    }
+    return YES;
+}
+
 - (NSURLSessionTask *)taskForRequest:(NSURLRequest *)request
 {
-    if (self.outputFilePath) {
+    if (self.outputFilePath && !self.partialFilePath) {
         return [self.urlSession downloadTaskWithRequest:request];
     } else {
         return [super taskForRequest:request];
     }
 }
 
+- (BOOL)shouldUseValidationCache
+{
+    return NO; // the response is streamed to the output and not kept
+}
+
+- (BOOL)canRetryRequest
+{
+    return NO; // parts of the response may already have been written to the output, partial files are resumed by the next download
+}
+
 #pragma mark CMISCancellableRequest method
 
 - (void)cancel
 {
     [super cancel];
     
-    // clean up
-    [self.outputStream close];
+    // clean up, a sink is closed once the task has completed
+    if (self.sink == nil) {
+        [self.outputStream close];
+    }
     self.progressBlock = nil;
 }
 
@@ -153,61 +394,88 @@
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
 {
-    // clean up
-    [self.outputStream close];
-    self.progressBlock = nil;
+    id<CMISDownloadSink> sink = self.sink;
+    if (sink == nil) {
+        [self.outputStream close];
+        [self finishWithSession:session task:task error:error];
+        return;
+    }
     
+    // the request completes once the sink has written all received data
+    [sink closeWithCompletionBlock:^(NSError *sinkError) {
+        [self finishWithSession:session task:task error:(sinkError ?: error)];
+    }];
+}
+
+- (void)finishWithSession:(NSURLSession *)session task:(NSURLSessionTask *)task error:(NSError *)error
+{
     if (self.outputFilePath) {
         // download tasks don't return the response via delegate methods so get it from the task
         self.response = (NSHTTPURLResponse *)task.response;
         
-        if (self.fileCopyError) {
-            error = self.fileCopyError;
+        if (self.fileError) {
+            error = self.fileError;
+        } else if (!error && self.partialFilePath && self.sink) {
+            // the partial file is kept if the download failed, so it can be resumed
+            error = [self movePartialFileToOutputFilePath];
         }
     }
     
-    [super URLSession:session task:task didCompleteWithError:error];
+    if (error || self.hashQueue == nil) {
+        [super URLSession:session task:task didCompleteWithError:error];
+        return;
+    }
+    
+    // the request completes once all received data has been hashed
+    dispatch_async(self.hashQueue, ^{
+        self.contentHash = [self.contentHasher finish];
+        [super URLSession:session task:task didCompleteWithError:error];
+    });
 }
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
 {
-    if (self.outputStream == nil) { // if there is no outputStream then store data in memory in self.data
+    [self updateContentHashUsingBlock:^BOOL(CMISContentHasher *contentHasher) {
+        [contentHasher updateWithData:data];
+        return YES;
+    }];
+    
+    if (self.sink == nil) { // if there is no sink then store data in memory in self.data
         [super URLSession:session dataTask:dataTask didReceiveData:data];
     } else {
-        const uint8_t *bytes = data.bytes;
-        NSUInteger length = data.length;
-        NSUInteger offset = 0;
-        do {
-            NSUInteger written = [self.outputStream write:&bytes[offset] maxLength:length - offset];
-            if (written <= 0) {
-                CMISLogError(@"Error while writing downloaded data to stream");
-                [session invalidateAndCancel];
-                return;
-            } else {
-                offset += written;
-            }
-        } while (offset < length);
+        [self.sink writeData:data];
+        if (self.sink.error) {
+            CMISLogError(@"Error while writing downloaded data: %@", self.sink.error);
+            [dataTask cancel];
+            return;
+        }
     }
     
     // update statistics
-    self.bytesDownloaded += data.length;
-    
-    // pass progress to progressBlock, on the original thread
-    if (self.originalThread) {
-        [self performSelector:@selector(executeProgressBlock:) onThread:self.originalThread withObject:@[@(self.bytesDownloaded), @(self.bytesExpected)] waitUntilDone:NO];
+    @synchronized(self) {
+        self.bytesDownloaded += data.length;
     }
+    
+    [self scheduleProgressDelivery];
 }
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
 {
-    // update statistics
+    if (self.partialFilePath && [response isKindOfClass:NSHTTPURLResponse.class] &&
+        ![self openPartialFileForResponse:(NSHTTPURLResponse *)response]) {
+        completionHandler(NSURLSessionResponseCancel);
+        return;
+    }
+    
+    // update statistics, a resumed download continues where the previous one stopped
     if (self.bytesExpected == 0 && self.sessionTask.countOfBytesExpectedToReceive != NSURLSessionTransferSizeUnknown) {
-        self.bytesExpected = self.sessionTask.countOfBytesExpectedToReceive;
+        self.bytesExpected = self.resumeOffset + self.sessionTask.countOfBytesExpectedToReceive;
     }
     
-    self.bytesDownloaded = 0;
+    self.bytesDownloaded = self.resumeOffset;
     if ([response isKindOfClass:NSHTTPURLResponse.class] && [CMISHttpRequest isErrorResponse:((NSHTTPURLResponse *)response).statusCode httpRequestMethod:self.requestMethod]) {
         // we are receiving an error response -> do not write error response body to outputStream. Instead, store data in memory in self.data
+        [self discardContentHash];
         if (self.outputStream) { // clean up
             BOOL isStreamOpen = self.outputStream.streamStatus == NSStreamStatusOpen;
             if (isStreamOpen) {
@@ -217,42 +485,98 @@
         }
         [super URLSession:session dataTask:dataTask didReceiveResponse:response completionHandler:completionHandler];
     } else {
-        // set up output stream if available
-        if (self.outputStream) { // otherwise store data in memory in self.data
-            // create file for downloaded content
-            BOOL isStreamReady = self.outputStream.streamStatus == NSStreamStatusOpen;
-            if (!isStreamReady) {
-                [self.outputStream open];
-                isStreamReady = self.outputStream.streamStatus == NSStreamStatusOpen;
-            }
+        // the kept bytes were hashed for nothing if the server does not continue after them
+        if (self.hashedResumeOffset != self.resumeOffset) {
+            self.hashedResumeOffset = self.resumeOffset;
+            [self resetContentHash];
+        }
+        
+        // set up the sink for the content, the partial file sink is created for the response already
+        if (self.sink == nil && self.outputStream) {
+            self.sink = [self sinkForOutputStream:self.outputStream dataTask:dataTask];
+        }
+        
+        NSError *sinkError = nil;
+        if (self.sink == nil || [self.sink openWithExpectedLength:(response.expectedContentLength > 0 ? response.expectedContentLength : 0) error:&sinkError]) {
+            [super URLSession:session dataTask:dataTask didReceiveResponse:response completionHandler:completionHandler];
+        } else {
+            self.sink = nil;
+            [dataTask cancel];
             
-            if (isStreamReady) {
-                [super URLSession:session dataTask:dataTask didReceiveResponse:response completionHandler:completionHandler];
-            } else {
-                [session invalidateAndCancel];
-                
-                if (self.completionBlock)
-                {
-                    NSError *cmisError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
-                                                         detailedDescription:@"Could not open output stream"];
-                    
-                    // call the completion block on the original thread
-                    if (self.originalThread) {
-                        [self performSelector:@selector(executeCompletionBlockError:) onThread:self.originalThread withObject:cmisError waitUntilDone:NO];
-                    }
+            if (self.completionBlock) {
+                // call the completion block on the original thread
+                if (self.originalThread) {
+                    [self performSelector:@selector(executeCompletionBlockError:) onThread:self.originalThread withObject:sinkError waitUntilDone:NO];
                 }
             }
         }
     }
 }
 
+/// writes to the stream on a separate queue and pauses the task while the stream cannot keep up
+- (id<CMISDownloadSink>)sinkForOutputStream:(NSOutputStream *)outputStream dataTask:(NSURLSessionDataTask *)dataTask
+{
+    CMISStreamDownloadSink *sink = [[CMISStreamDownloadSink alloc] initWithOutputStream:outputStream bufferLimit:OUTPUT_STREAM_BUFFER_LIMIT];
+    __weak NSURLSessionDataTask *weakDataTask = dataTask;
+    sink.backpressureBlock = ^(BOOL paused) {
+        // a suspended task stops reading from the socket, so the server has to wait instead of data piling up in memory
+        if (paused) {
+            [weakDataTask suspend];
+        } else {
+            [weakDataTask resume];
+        }
+    };
+    return sink;
+}
+
+/// delivers the progress on the original thread, with at most one delivery pending at any time
+- (void)scheduleProgressDelivery
+{
+    if (self.progressBlock == nil || self.originalThread == nil) {
+        return;
+    }
+    
+    @synchronized(self) {
+        if (self.progressDeliveryPending) {
+            return;
+        }
+        self.progressDeliveryPending = YES;
+    }
+    [self performSelector:@selector(deliverProgress) onThread:self.originalThread withObject:nil waitUntilDone:NO];
+}
+
+- (void)deliverProgress
+{
+    unsigned long long bytesDownloaded, bytesExpected;
+    @synchronized(self) {
+        self.progressDeliveryPending = NO;
+        bytesDownloaded = self.bytesDownloaded;
+        bytesExpected = self.bytesExpected;
+    }
+    
+    if (self.progressBlock) {
+        self.progressBlock(bytesDownloaded, bytesExpected);
+    }
+}
+
 - (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didResumeAtOffset:(int64_t)fileOffset expectedTotalBytes:(int64_t)expectedTotalBytes
 {
-    // TODO: Add support for resuming download tasks
+    [self didReceiveFirstByte];
+    
+    // download tasks are only used by background sessions, which resume interrupted transfers themselves
+    @synchronized(self) {
+        self.bytesDownloaded = fileOffset;
+        if (expectedTotalBytes > 0) {
+            self.bytesExpected = expectedTotalBytes;
+        }
+    }
+    [self scheduleProgressDelivery];
 }
 
 - (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didFinishDownloadingToURL:(NSURL *)location
 {
+    [self didReceiveFirstByte];
+    
     // create URL representation of destination
     NSURL *destinationURL = [NSURL fileURLWithPath:self.outputFilePath];
 
@@ -263,32 +587,30 @@
     // copy the temporary file to the requested file path
     if ([fileManager copyItemAtURL:location toURL:destinationURL error:nil]) {
         CMISLogDebug(@"Copied downloaded file from %@ to %@", location, self.outputFilePath);
+        
+        // download tasks don't hand over the data while it is received, so the file is hashed once it is complete
+        NSString *outputFilePath = self.outputFilePath;
+        unsigned long long fileSize = [[fileManager attributesOfItemAtPath:outputFilePath error:nil] fileSize];
+        [self updateContentHashUsingBlock:^BOOL(CMISContentHasher *contentHasher) {
+            return [contentHasher updateWithContentsOfFile:outputFilePath length:fileSize];
+        }];
     } else {
-        self.fileCopyError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
-                                             detailedDescription:[NSString stringWithFormat:@"Could not copy temporary file to %@", self.outputFilePath]];
+        self.fileError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                         detailedDescription:[NSString stringWithFormat:@"Could not copy temporary file to %@", self.outputFilePath]];
     }
 }
 
 - (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didWriteData:(int64_t)bytesWritten totalBytesWritten:(int64_t)totalBytesWritten totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite
 {
-    // pass progress to progressBlock, on the main thread
-    if (self.progressBlock) {
-        unsigned long long totalBytesExpected = totalBytesExpectedToWrite;
-        
-        if (totalBytesExpected == NSURLSessionTransferSizeUnknown && self.bytesExpected != 0) {
-            totalBytesExpected = self.bytesExpected;
-        }
-        // pass progress to progressBlock, on the original thread
-        if (self.originalThread) {
-            [self performSelector:@selector(executeProgressBlock:) onThread:self.originalThread withObject:@[@(totalBytesWritten), @(totalBytesExpected)] waitUntilDone:NO];
+    [self didReceiveFirstByte];
+    
+    @synchronized(self) {
+        self.bytesDownloaded = totalBytesWritten;
+        if (totalBytesExpectedToWrite != NSURLSessionTransferSizeUnknown) {
+            self.bytesExpected = totalBytesExpectedToWrite;
         }
     }
-}
-
-- (void)executeProgressBlock:(NSArray*)valueArray {
-    if (self.progressBlock) {
-        self.progressBlock([valueArray[0] unsignedLongLongValue], [valueArray[1] unsignedLongLongValue]);
-    }
+    [self scheduleProgressDelivery];
 }
 
 @end
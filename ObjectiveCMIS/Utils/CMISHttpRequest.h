@@ -35,6 +35,14 @@
 @property (nonatomic, strong) CMISBindingSession *session;
 @property (nonatomic, copy) void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error);
 @property (nonatomic, weak) NSThread *originalThread;
+/// the number of times the request has been sent so far
+@property (nonatomic, assign, readonly) NSUInteger attemptCount;
+/// the time in seconds the current attempt took to receive the response headers, 0 until they are received
+@property (assign, readonly) NSTimeInterval timeToFirstByte;
+/// if set, the body of a successful response is handed to the block chunk by chunk while it is received instead of being collected, on the thread the completion block is called on
+@property (nonatomic, copy) void (^responseDataBlock)(NSData *data);
+/// the hash of the content sent or received, set by subclasses that transfer content once the transfer has finished
+@property (strong) NSString *contentHash;
 
 /**
  * starts a URL request for given HTTP method
@@ -80,5 +88,8 @@
 
 + (BOOL)isErrorResponse:(NSInteger)statusCode httpRequestMethod:(CMISHttpRequestMethod)httpRequestMethod;
 - (BOOL)shouldApplyHttpHeaders;
+- (BOOL)shouldUseValidationCache;
+- (BOOL)canRetryRequest;
+- (void)didReceiveFirstByte;
 
 @end
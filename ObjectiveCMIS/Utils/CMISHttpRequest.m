@@ -23,7 +23,11 @@
 #import "CMISLog.h"
 #import "CMISReachability.h"
 #import "CMISConstants.h"
-#import "CMISURLSessionUtil.h"
+#import "CMISURLSessionPool.h"
+#import "CMISHttpValidationCache.h"
+#import "CMISHttpContentCoder.h"
+#import "CMISRetryPolicy.h"
+#import "CMISCircuitBreaker.h"
 
 //Exception names as returned in the <!--exception> tag
 NSString * const kCMISExceptionInvalidArgument         = @"invalidArgument";
@@ -40,6 +44,25 @@ NSString * const kCMISExceptionStreamNotSupported      = @"streamNotSupported";
 NSString * const kCMISExceptionUpdateConflict          = @"updateConflict";
 NSString * const kCMISExceptionVersioning              = @"versioning";
 
+@interface CMISHttpRequest ()
+
+@property (nonatomic, strong) NSString *validationCacheKey;
+@property (nonatomic, strong) CMISHttpResponse *cachedResponse;
+@property (nonatomic, assign) BOOL contentEncodingChecked;
+@property (nonatomic, strong) CMISHttpContentCoder *contentDecoder;
+@property (nonatomic, assign) BOOL contentDecodingFailed;
+@property (nonatomic, assign) unsigned long long wireByteCount;
+@property (nonatomic, assign) unsigned long long measuredWireByteCount;
+@property (nonatomic, assign, readwrite) NSUInteger attemptCount;
+@property (nonatomic, strong) NSURLRequest *preparedRequest;
+@property (nonatomic, assign) BOOL retryPending;
+@property (nonatomic, strong) NSDate *attemptStartDate;
+@property (assign, readwrite) NSTimeInterval timeToFirstByte;
+@property (nonatomic, strong) NSDate *bodySentDate;
+@property (nonatomic, strong) NSString *circuitBreakerHost;
+
+@end
+
 @implementation CMISHttpRequest
 
 
@@ -78,6 +101,13 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
 
 - (BOOL)startRequest:(NSMutableURLRequest*)urlRequest
 {
+    // fail immediately while the host keeps failing, before any other work is done
+    NSError *circuitOpenError = [self checkCircuitBreakerForURL:urlRequest.URL];
+    if (circuitOpenError) {
+        [self URLSession:self.urlSession task:self.sessionTask didCompleteWithError:circuitOpenError];
+        return NO;
+    }
+    
     // check network reachability (unless it's disabled) and return early if appropriate
     id checkNetworkReachability = [self.session objectForKey:kCMISSessionParameterCheckNetworkReachability];
     if (!checkNetworkReachability || [checkNetworkReachability boolValue]) {
@@ -112,30 +142,31 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
             [urlRequest addValue:header forHTTPHeaderField:headerName];
         }];
         
+        // validate a previously received response instead of downloading it again
+        if ([self shouldUseValidationCache] && self.session.validationCache) {
+            self.validationCacheKey = [CMISHttpValidationCache keyForRequest:urlRequest session:self.session];
+            self.cachedResponse = [self.session.validationCache addValidatorsToRequest:urlRequest forKey:self.validationCacheKey];
+        }
+        
         if ([CMISLog sharedInstance].logLevel == CMISLogLevelTrace) {
             CMISLogTrace(@"Added headers: %@", urlRequest.allHTTPHeaderFields);
         }
             
-        // create session and task
-        self.urlSession = [CMISURLSessionUtil internalUrlSessionWithParameters:self.session delegate:self];
-        self.sessionTask = [self taskForRequest:urlRequest];
-        
-        if (self.sessionTask) {
-            // start the task
-            [self.sessionTask resume];
-        } else {
-            if (self.completionBlock) {
-                NSString *detailedDescription = [NSString stringWithFormat:@"Could not create network session for %@", urlRequest.URL];
-                NSError *cmisError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection detailedDescription:detailedDescription];
-                [self executeCompletionBlockResponse:nil error:cmisError];
-            }
+        // keep the fully prepared request so it can be sent again if the attempt fails
+        if ([self canRetryRequest] && self.session.retryPolicy) {
+            self.preparedRequest = [urlRequest copy];
+            [self.session.retryPolicy requestWillStart];
         }
+        self.attemptCount = 1;
+        
+        [self resumeTaskForRequest:urlRequest];
     };
     
     if ([self shouldApplyHttpHeaders]) {
         if ([self.session.authenticationProvider respondsToSelector:@selector(asyncHttpHeadersToApply:)]) {
             [self.session.authenticationProvider asyncHttpHeadersToApply:^(NSDictionary *headers, NSError *cmisError) {
                 if (cmisError) {;
+                    [self recordCircuitBreakerOutcomeWithError:cmisError];
                     [self executeCompletionBlockResponse:nil error:cmisError];
                 } else {
                     continueWithStartRequest(headers);
@@ -157,23 +188,179 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
     return YES;
 }
 
+// will be overwritten by requests streaming their response
+- (BOOL)shouldUseValidationCache
+{
+    return self.requestMethod == HTTP_GET && self.requestBody == nil && self.responseDataBlock == nil;
+}
+
+// will be overwritten by requests streaming their body or response
+- (BOOL)canRetryRequest
+{
+    return self.responseDataBlock == nil; // a streamed response can not be taken back from its consumer
+}
+
+// called by tasks that do not report the response, e.g. download tasks, once the first data arrives
+- (void)didReceiveFirstByte
+{
+    if (self.timeToFirstByte == 0) {
+        self.timeToFirstByte = MAX(-[self.attemptStartDate timeIntervalSinceNow], DBL_EPSILON);
+    }
+}
+
 - (NSURLSessionTask *)taskForRequest:(NSURLRequest *)request
 {
     return [self.urlSession dataTaskWithRequest:request];
 }
 
+- (void)resumeTaskForRequest:(NSURLRequest *)urlRequest
+{
+    self.attemptStartDate = [NSDate date];
+    self.timeToFirstByte = 0;
+    self.bodySentDate = nil;
+    
+    // create the task on the pooled session, delegate callbacks for the task will be forwarded to this request
+    self.sessionTask = [[CMISURLSessionPool sharedPool] taskForRequest:urlRequest
+                                                        bindingSession:self.session
+                                                               handler:self
+                                                           taskFactory:^NSURLSessionTask *(NSURLSession *urlSession) {
+                                                               self.urlSession = urlSession;
+                                                               return [self taskForRequest:urlRequest];
+                                                           }];
+    
+    if (self.sessionTask) {
+        // start the task
+        [self.sessionTask resume];
+    } else {
+        NSString *detailedDescription = [NSString stringWithFormat:@"Could not create network session for %@", urlRequest.URL];
+        NSError *cmisError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection detailedDescription:detailedDescription];
+        [self recordCircuitBreakerOutcomeWithError:cmisError];
+        if (self.completionBlock) {
+            [self executeCompletionBlockResponse:nil error:cmisError];
+        }
+    }
+}
+
+/// returns an error if the circuit breaker rejects requests to the host, otherwise the outcome of the request will be recorded
+- (NSError *)checkCircuitBreakerForURL:(NSURL *)url
+{
+    CMISCircuitBreaker *circuitBreaker = self.session.circuitBreaker;
+    if (circuitBreaker == nil) {
+        return nil;
+    }
+    
+    NSString *host = url.host ? url.host : @"";
+    if (![circuitBreaker allowRequestToHost:host]) {
+        NSString *detailedDescription = [NSString stringWithFormat:@"Requests to %@ are suspended after repeated failures", host];
+        return [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCircuitOpen detailedDescription:detailedDescription];
+    }
+    self.circuitBreakerHost = host;
+    return nil;
+}
+
+- (void)recordCircuitBreakerOutcomeWithError:(NSError *)error
+{
+    NSString *host = self.circuitBreakerHost;
+    if (host == nil) {
+        return;
+    }
+    self.circuitBreakerHost = nil;
+    
+    CMISCircuitBreaker *circuitBreaker = self.session.circuitBreaker;
+    if (error) {
+        // only transport errors say something about the health of the server
+        if ([error.domain isEqualToString:NSURLErrorDomain] && error.code != NSURLErrorCancelled) {
+            [circuitBreaker recordOutcomeForHost:host success:NO duration:[self responseLatency]];
+        } else {
+            [circuitBreaker releaseRequestForHost:host];
+        }
+    } else {
+        NSInteger statusCode = self.response.statusCode;
+        BOOL success = statusCode < 500 && statusCode != 429;
+        [circuitBreaker recordOutcomeForHost:host success:success duration:[self responseLatency]];
+    }
+}
+
+/// the time the current attempt waited for the response headers, the transfer of the request and response bodies is not included
+- (NSTimeInterval)responseLatency
+{
+    if (self.timeToFirstByte == 0) {
+        return -[self.attemptStartDate timeIntervalSinceNow]; // no response has been received
+    }
+    
+    NSTimeInterval bodyTransferTime = self.bodySentDate ? [self.bodySentDate timeIntervalSinceDate:self.attemptStartDate] : 0;
+    return MAX(self.timeToFirstByte - bodyTransferTime, 0);
+}
+
+/// returns YES if the failed attempt will be repeated after a delay, the completion block must not be called then
+- (BOOL)scheduleRetryAfterError:(NSError *)error
+{
+    CMISRetryPolicy *retryPolicy = self.session.retryPolicy;
+    if (retryPolicy == nil || self.preparedRequest == nil || self.contentDecodingFailed) {
+        return NO;
+    }
+    
+    NSInteger statusCode = error ? 0 : self.response.statusCode;
+    NSString *retryAfter = error ? nil : [CMISHttpResponse valueForHeader:@"Retry-After" headers:self.response.allHeaderFields];
+    NSTimeInterval delay = 0;
+    if (![retryPolicy shouldRetryRequestWithMethod:self.requestMethod
+                                           attempt:self.attemptCount
+                                        statusCode:statusCode
+                                        retryAfter:retryAfter
+                                             error:error
+                                             delay:&delay]) {
+        return NO;
+    }
+    
+    CMISLogDebug(@"Attempt %lu for %@ failed (status %d, error %@), retrying in %.2f seconds",
+                 (unsigned long)self.attemptCount, self.preparedRequest.URL, (int)statusCode, error.localizedDescription, delay);
+    
+    @synchronized(self) {
+        self.retryPending = YES;
+    }
+    self.sessionTask = nil;
+    self.urlSession = nil;
+    self.response = nil;
+    self.responseBody = nil;
+    
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        @synchronized(self) {
+            if (!self.retryPending) {
+                return; // cancelled while waiting
+            }
+            self.retryPending = NO;
+        }
+        NSError *circuitOpenError = [self checkCircuitBreakerForURL:self.preparedRequest.URL];
+        if (circuitOpenError) {
+            [self didCompleteWithError:circuitOpenError];
+            return;
+        }
+        self.attemptCount++;
+        [self resumeTaskForRequest:self.preparedRequest];
+    });
+    return YES;
+}
+
 #pragma mark CMISCancellableRequest method
 
 - (void)cancel
 {
-    if (self.urlSession) {
+    BOOL retryPending = NO;
+    @synchronized(self) {
+        retryPending = self.retryPending;
+        self.retryPending = NO;
+    }
+    
+    if (self.sessionTask || retryPending) {
         void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error);
         completionBlock = self.completionBlock; // remember completion block in order to invoke it after the connection was cancelled
         
         self.completionBlock = nil; // prevent potential NSURLSession delegate callbacks to invoke the completion block redundantly
         
-        [self.urlSession invalidateAndCancel];
+        // only cancel our own task, the session is shared with other requests
+        [self.sessionTask cancel];
         
+        self.sessionTask = nil;
         self.urlSession = nil;
         
         if (completionBlock) {
@@ -192,6 +379,16 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
 }
 
 -(void) didCompleteWithError:(NSError *)error {
+    if (self.contentDecodingFailed) {
+        error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection detailedDescription:@"Could not decode response body"];
+    }
+    
+    [self recordCircuitBreakerOutcomeWithError:error];
+    
+    if (self.completionBlock && [self canRetryRequest] && [self scheduleRetryAfterError:error]) {
+        return;
+    }
+    
     if (self.completionBlock) {
         
         NSError *cmisError = nil;
@@ -209,12 +406,26 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
                 cmisErrorCode = kCMISErrorCodeCancelled;
             } else if (error.code == kCMISErrorCodeNoNetworkConnection) {
                 cmisErrorCode = kCMISErrorCodeNoNetworkConnection;
+            } else if ([error.domain isEqualToString:kCMISErrorDomainName] && error.code == kCMISErrorCodeCircuitOpen) {
+                cmisErrorCode = kCMISErrorCodeCircuitOpen;
             }
             
             cmisError = [CMISErrors cmisError:error cmisErrorCode:cmisErrorCode];
         } else {
             // no error returned but we also need to check response code
             httpResponse = [CMISHttpResponse responseUsingURLHTTPResponse:self.response data:self.responseBody];
+            httpResponse.decodedByteCount = self.responseBody.length;
+            httpResponse.wireByteCount = [self responseWireByteCount];
+            httpResponse.attemptCount = self.attemptCount;
+            httpResponse.timeToFirstByte = self.timeToFirstByte;
+            httpResponse.contentHash = self.contentHash;
+            if (self.validationCacheKey) {
+                // a 304 response is replaced by the cached response it confirmed
+                httpResponse = [self.session.validationCache responseForResponse:httpResponse
+                                                                  cachedResponse:self.cachedResponse
+                                                                          forKey:self.validationCacheKey];
+                self.cachedResponse = nil;
+            }
             if (![CMISHttpRequest checkStatusCodeForResponse:httpResponse httpRequestMethod:self.requestMethod error:&cmisError]) {
                 httpResponse = nil;
             }
@@ -237,12 +448,60 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
 {
+    self.wireByteCount += data.length;
+    
+    // decode the body ourselves if the platform did not do it already
+    if (!self.contentEncodingChecked) {
+        self.contentEncodingChecked = YES;
+        NSString *contentEncoding = [CMISHttpResponse valueForHeader:@"Content-Encoding" headers:self.response.allHeaderFields];
+        self.contentDecoder = [CMISHttpContentCoder decoderForContentEncoding:contentEncoding data:data];
+    }
+    if (self.contentDecoder) {
+        data = [self.contentDecoder decodeData:data];
+        if (data == nil) {
+            self.contentDecodingFailed = YES;
+            [self.sessionTask cancel];
+            return;
+        }
+    }
+    
+    // error responses are still collected, so the error message can be read from them
+    if (self.responseDataBlock && ![CMISHttpRequest isErrorResponse:self.response.statusCode httpRequestMethod:self.requestMethod]) {
+        // the chunks are queued on the original thread ahead of the completion block, the shared delegate queue never waits for the consumer
+        if ([self callCompletionBlockOnOriginalThread] && self.originalThread) {
+            [self performSelector:@selector(executeResponseDataBlock:) onThread:self.originalThread withObject:data waitUntilDone:NO];
+        } else {
+            [self executeResponseDataBlock:data];
+        }
+        return;
+    }
+    
     [self.responseBody appendData:data];
 }
 
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
+{
+    if (@available(iOS 13.0, macOS 10.15, *)) {
+        // the number of bytes before the platform decoded the body
+        self.measuredWireByteCount = metrics.transactionMetrics.lastObject.countOfResponseBodyBytesReceived;
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend
+{
+    // the server only answers once the body has been sent, the time sending it does not count as waiting for the server
+    if (self.timeToFirstByte == 0) {
+        self.bodySentDate = [NSDate date];
+    }
+}
+
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
 {
+    [self didReceiveFirstByte];
     self.responseBody = [[NSMutableData alloc] init];
+    self.wireByteCount = 0;
+    self.contentEncodingChecked = NO;
+    self.contentDecoder = nil;
     if ([response isKindOfClass:NSHTTPURLResponse.class]) {
         self.response = (NSHTTPURLResponse*)response;
     }
@@ -342,7 +601,25 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
     return (httpRequestMethod == HTTP_GET && statusCode != 200 && statusCode != 206)
             || (httpRequestMethod == HTTP_POST && statusCode != 200 && statusCode != 201)
             || (httpRequestMethod == HTTP_DELETE && statusCode != 204)
-            || (httpRequestMethod == HTTP_PUT && ((statusCode < 200 || statusCode > 299)));
+            || (httpRequestMethod == HTTP_PUT && ((statusCode < 200 || statusCode > 299)))
+            || (httpRequestMethod == HTTP_HEAD && ((statusCode < 200 || statusCode > 299)));
+}
+
+- (unsigned long long)responseWireByteCount
+{
+    if (self.contentDecoder == nil) {
+        if (self.measuredWireByteCount > 0) {
+            return self.measuredWireByteCount;
+        }
+        
+        // without metrics the content length of an encoded body is the best estimate
+        NSDictionary *headers = self.response.allHeaderFields;
+        NSString *contentLength = [CMISHttpResponse valueForHeader:@"Content-Length" headers:headers];
+        if (contentLength && [CMISHttpResponse valueForHeader:@"Content-Encoding" headers:headers]) {
+            return (unsigned long long)[contentLength longLongValue];
+        }
+    }
+    return self.wireByteCount;
 }
 
 -(BOOL)callCompletionBlockOnOriginalThread
@@ -350,6 +627,12 @@ NSString * const kCMISExceptionVersioning              = @"versioning";
     return YES;
 }
 
+- (void)executeResponseDataBlock:(NSData*)data {
+    if (self.responseDataBlock) {
+        self.responseDataBlock(data);
+    }
+}
+
 - (void)executeCompletionBlockResponse:(CMISHttpResponse*)response {
     [self executeCompletionBlockResponse:response error:nil];
 }
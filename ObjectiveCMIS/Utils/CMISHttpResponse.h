@@ -24,6 +24,36 @@
 @property NSInteger statusCode;
 @property (nonatomic, strong) NSString *statusCodeMessage;
 @property (nonatomic, strong, readonly) NSData *data;
+@property (nonatomic, strong, readonly) NSDictionary *headers;
+
+/// the number of body bytes received over the network, smaller than decodedByteCount if the body was compressed
+@property (nonatomic, assign) unsigned long long wireByteCount;
+
+/// the number of body bytes after decoding
+@property (nonatomic, assign) unsigned long long decodedByteCount;
+
+/// the time in seconds between sending the request and receiving the response headers
+@property (nonatomic, assign) NSTimeInterval timeToFirstByte;
+
+/// the number of times the request was sent, greater than 1 if it was retried
+@property (nonatomic, assign) NSUInteger attemptCount;
+
+/// the hash of the content sent or received, in the format of cmis:contentStreamHash, nil if content hashing is not enabled
+@property (nonatomic, strong) NSString *contentHash;
+
+/**
+ * The result parsed from the response data, kept by the validation cache so unchanged responses are not parsed again.
+ * A result conforming to NSCopying is copied when it is set and whenever it is returned, the elements of an array are
+ * copied one by one. Callers answered from the same cached response never share the objects they may modify, so each
+ * caller should read the property only once.
+ */
+@property (copy) id parsedResult;
+
+/// returns the value of the given header, the name is matched case-insensitively
+- (NSString *)valueForHeader:(NSString *)headerName;
+
+/// returns the value of the given header from a header dictionary, the name is matched case-insensitively
++ (NSString *)valueForHeader:(NSString *)headerName headers:(NSDictionary *)headers;
 
 /// wrapper for returned NSHTTPURLResponse and retrieved data
 + (CMISHttpResponse *)responseUsingURLHTTPResponse:(NSHTTPURLResponse *)HTTPURLResponse
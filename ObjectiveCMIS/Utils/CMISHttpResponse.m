@@ -23,6 +23,7 @@
 @interface CMISHttpResponse ()
 
 @property (nonatomic, strong) NSData *data;
+@property (nonatomic, strong) NSDictionary *headers;
 @property (nonatomic, strong) NSString *responseString;
 
 @end
@@ -30,6 +31,7 @@
 
 @implementation CMISHttpResponse
 
+@synthesize parsedResult = _parsedResult;
 
 + (CMISHttpResponse *)responseUsingURLHTTPResponse:(NSHTTPURLResponse *)httpUrlResponse
                                               data:(NSData *)data
@@ -37,6 +39,7 @@
     CMISHttpResponse *httpResponse = [[CMISHttpResponse alloc] init];
     httpResponse.statusCode = httpUrlResponse.statusCode;
     httpResponse.data = data;
+    httpResponse.headers = httpUrlResponse.allHeaderFields;
     httpResponse.statusCodeMessage = [NSHTTPURLResponse localizedStringForStatusCode:[httpUrlResponse statusCode]];
     return httpResponse;
 }
@@ -49,10 +52,56 @@
     CMISHttpResponse *httpResponse = [[CMISHttpResponse alloc] init];
     httpResponse.statusCode = statusCode;
     httpResponse.statusCodeMessage = message;
+    httpResponse.headers = headers;
     httpResponse.data = data;
     return httpResponse;
 }
 
+- (id)parsedResult
+{
+    @synchronized(self) {
+        return [CMISHttpResponse deepCopyOfParsedResult:_parsedResult];
+    }
+}
+
+- (void)setParsedResult:(id)parsedResult
+{
+    @synchronized(self) {
+        _parsedResult = [CMISHttpResponse deepCopyOfParsedResult:parsedResult];
+    }
+}
+
+/// copies the parsed result, an array is copied together with its elements as copying it only copies the references
++ (id)deepCopyOfParsedResult:(id)parsedResult
+{
+    if ([parsedResult isKindOfClass:[NSArray class]]) {
+        NSMutableArray *elements = [NSMutableArray arrayWithCapacity:[parsedResult count]];
+        for (id element in parsedResult) {
+            [elements addObject:[CMISHttpResponse deepCopyOfParsedResult:element]];
+        }
+        return [elements copy];
+    }
+    return [parsedResult conformsToProtocol:@protocol(NSCopying)] ? [parsedResult copy] : parsedResult;
+}
+
+- (NSString *)valueForHeader:(NSString *)headerName
+{
+    return [CMISHttpResponse valueForHeader:headerName headers:self.headers];
+}
+
++ (NSString *)valueForHeader:(NSString *)headerName headers:(NSDictionary *)headers
+{
+    NSString *value = [headers objectForKey:headerName];
+    if (value == nil) {
+        for (NSString *name in headers) {
+            if ([name caseInsensitiveCompare:headerName] == NSOrderedSame) {
+                return [headers objectForKey:name];
+            }
+        }
+    }
+    return value;
+}
+
 
 - (NSString*)responseString
 {
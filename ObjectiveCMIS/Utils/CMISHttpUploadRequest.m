@@ -26,19 +26,18 @@
 #import "CMISHttpUploadRequest.h"
 #import "CMISBase64Encoder.h"
 #import "CMISAtomEntryWriter.h"
+#import "CMISUploadPipeline.h"
+#import "CMISContentHasher.h"
+#import "CMISBindingSession.h"
+#import "CMISSessionParameters.h"
 #import "CMISLog.h"
 #import "CMISErrors.h"
 
-/**
- this is the buffer size for the input/output stream pair containing the base64 encoded data
- */
-const NSUInteger kFullBufferSize = 32768;
-/**
- this is the buffer size for the raw data. It must be an integer multiple of 3. Base64 encoding uses
- 4 bytes for each 3 bytes of raw data. Therefore, the amount of raw data we take is
- kFullBufferSize/4 * 3.
- */
-const NSUInteger kRawBufferSize = 24576;
+// Default size of the raw content chunks read from the source input stream
+#define DEFAULT_UPLOAD_CHUNK_SIZE (256 * 1024)
+
+// the number of chunks buffered per upload, one is encoded while the other one is sent
+#define UPLOAD_BUFFER_COUNT 2
 
 /**
  A category that extends the NSStream class in order to pair an inputstream with an outputstream.
@@ -52,12 +51,14 @@ const NSUInteger kRawBufferSize = 24576;
 
 @interface NSStream (StreamPair)
 + (void)createBoundInputStream:(NSInputStream **)inputStreamPtr
-                  outputStream:(NSOutputStream **)outputStreamPtr;
+                  outputStream:(NSOutputStream **)outputStreamPtr
+                    bufferSize:(NSUInteger)bufferSize;
 @end
 
 @implementation NSStream (StreamPair)
 + (void)createBoundInputStream:(NSInputStream **)inputStreamPtr
                   outputStream:(NSOutputStream **)outputStreamPtr
+                    bufferSize:(NSUInteger)bufferSize
 {
     CFReadStreamRef readStream;
     CFWriteStreamRef writeStream;
@@ -69,7 +70,7 @@ const NSUInteger kRawBufferSize = 24576;
     CFStreamCreateBoundPair(NULL,
                             ((inputStreamPtr != nil) ? &readStream : NULL),
                             ((outputStreamPtr != nil) ? &writeStream : NULL),
-                            (CFIndex)kFullBufferSize);
+                            (CFIndex)bufferSize);
     
     if (inputStreamPtr != NULL) {
         *inputStreamPtr  = CFBridgingRelease(readStream);
@@ -93,9 +94,10 @@ const NSUInteger kRawBufferSize = 24576;
 @property (nonatomic, strong) NSData *streamStartData;
 @property (nonatomic, strong) NSData *streamEndData;
 @property (nonatomic, assign) unsigned long long encodedLength;
-@property (nonatomic, strong) NSData *dataBuffer;
-@property (nonatomic, assign, readwrite) size_t bufferOffset;
-@property (nonatomic, assign, readwrite) size_t bufferLimit;
+@property (nonatomic, assign) BOOL encodedLengthKnown;
+@property (nonatomic, strong) CMISUploadPipeline *pipeline;
+@property (nonatomic, strong) CMISContentHasher *contentHasher;
+@property (nonatomic, weak) NSThread *pumpThread;
 
 @end
 
@@ -118,10 +120,15 @@ const NSUInteger kRawBufferSize = 24576;
     httpRequest.additionalHeaders = additionalHeaders;
     httpRequest.bytesExpected = bytesExpected;
     httpRequest.session = session;
-    httpRequest.useCombinedInputStream = NO;
+    httpRequest.contentHasher = [CMISContentHasher hasherForSession:session];
+    // the content can only be hashed on its way through the upload pipeline
+    httpRequest.useCombinedInputStream = (httpRequest.contentHasher != nil);
     httpRequest.combinedInputStream = nil;
     httpRequest.encoderStream = nil;
     
+    if (httpRequest.useCombinedInputStream) {
+        [httpRequest prepareStreams];
+    }
     if (![httpRequest startRequest:urlRequest]) {
         httpRequest = nil;
     }
@@ -153,6 +160,7 @@ const NSUInteger kRawBufferSize = 24576;
     httpRequest.useCombinedInputStream = YES;
     httpRequest.base64Encoding = useBase64Encoding;
     httpRequest.session = session;
+    httpRequest.contentHasher = [CMISContentHasher hasherForSession:session];
     
     [httpRequest prepareStreams];
     if (![httpRequest startRequest:urlRequest]) {
@@ -177,13 +185,13 @@ const NSUInteger kRawBufferSize = 24576;
 }
 
 /**
- if we are using on-the-go base64 encoding, we will use the combinedInputStream in URL connections/request.
- In this case a little extra work is required: i.e. we need to provide the length of the encoded data stream (including
- the XML data).
+ if we are using the combinedInputStream in URL connections/request, a little extra work is required: i.e. we need to
+ provide the length of the (encoded) data stream including the start and end data, so the body is not sent in chunks.
+ If the length of the content is not known, the body is sent in chunks instead.
  */
 - (BOOL)startRequest:(NSMutableURLRequest*)urlRequest
 {
-    if (self.useCombinedInputStream && self.combinedInputStream && self.base64Encoding) {
+    if (self.useCombinedInputStream && self.combinedInputStream && self.encodedLengthKnown) {
         NSMutableDictionary *headers = [NSMutableDictionary dictionaryWithDictionary:self.additionalHeaders];
         [headers setValue:[NSString stringWithFormat:@"%llu", self.encodedLength] forKey:@"Content-Length"];
         self.additionalHeaders = [NSDictionary dictionaryWithDictionary:headers];
@@ -203,6 +211,16 @@ const NSUInteger kRawBufferSize = 24576;
     return [self.urlSession uploadTaskWithStreamedRequest:request];
 }
 
+- (BOOL)shouldUseValidationCache
+{
+    return NO;
+}
+
+- (BOOL)canRetryRequest
+{
+    return NO; // the body stream can not be rewound
+}
+
 #pragma mark CMISCancellableRequest method
 
 - (void)cancel
@@ -235,6 +253,9 @@ const NSUInteger kRawBufferSize = 24576;
 }
 
 - (void)didCompleteWithError:(NSError *)error {
+    if (!error && self.pipeline.isAtEnd) {
+        self.contentHash = [self.contentHasher finish];
+    }
     [super didCompleteWithError:error];
     if (self.useCombinedInputStream) {
         if (error) {
@@ -256,6 +277,8 @@ const NSUInteger kRawBufferSize = 24576;
 
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend
 {
+    [super URLSession:session task:task didSendBodyData:bytesSent totalBytesSent:totalBytesSent totalBytesExpectedToSend:totalBytesExpectedToSend];
+    
     if (self.progressBlock) {
         if (self.useCombinedInputStream && self.base64Encoding) {
             // Show the actual transmitted raw data size to the user, not the base64 encoded size
@@ -297,18 +320,13 @@ const NSUInteger kRawBufferSize = 24576;
  Any action on the output stream (like close) will also affect this combinedInputStream.
  
  Note 2:
- since we are encoding "on the fly" we are dealing with 2 different buffer sizes. The encoded buffer size kFullBufferSize, and the
- buffer size of the raw/non-encoded data kRawBufferSize.
+ the body is produced by a CMISUploadPipeline, which reads and encodes the content in chunks on its own queue.
+ The chunks are written to the encoderStream straight from the pipeline's buffers, as long as the stream has space available.
+ If the next chunk is not ready yet, the pipeline's dataAvailableBlock resumes writing on the thread the encoderStream is
+ scheduled on.
  
- Note 3:
- the reading from the source input stream, as well as the writing to the encoderStream is regulated via 2 variables: bufferLimit and bufferOffset
- bufferLimit is the size of the XML data or the No of bytes read in from the raw data set (inputstream)
- At each readIn, the bufferOffset will be reset to 0 to indicate a free buffer to write to.
- When the data are finally written to the output stream, both bufferLimit and bufferOffset should be having the same value (unless we attempt to
- write more bytes than are available in the buffer).
- 
- Once we reach the end of the raw data set, both bufferLimit and bufferOffset are set to 0. This indicates that the outputStream (and its paired
- input stream) can be closed.
+ Once the pipeline reaches the end of the start data, content and end data, the outputStream (and its paired input stream)
+ is closed.
  
  (Final Note:The Apple source code discourages removing the stream from the runloop in this method as it can cause random crashes.)
  */
@@ -344,69 +362,7 @@ const NSUInteger kRawBufferSize = 24576;
                 }
             }
             
-            if (self.bufferOffset == self.bufferLimit) {
-                if (self.streamStartData != nil) {
-                    self.streamStartData = nil;
-                    self.bufferOffset = 0;
-                    self.bufferLimit = 0;
-                }
-                if (self.inputStream != nil) {
-                    NSInteger rawBytesRead;
-                    uint8_t rawBuffer[kRawBufferSize];
-                    rawBytesRead = [self.inputStream read:rawBuffer maxLength:kRawBufferSize];
-                    if (-1 == rawBytesRead) {
-                        [self stopSendWithStatus:@"Error while reading from source input stream"];
-                    } else if (0 != rawBytesRead) {
-                        
-                        NSData *encodedBuffer;
-                        if (self.base64Encoding) {
-                            encodedBuffer = [CMISBase64Encoder dataByEncodingText:[NSData dataWithBytes:rawBuffer length:rawBytesRead]];
-                        } else {
-                            encodedBuffer = [NSData dataWithBytes:rawBuffer length:rawBytesRead];
-                        }
-                        self.dataBuffer = [NSData dataWithData:encodedBuffer];
-                        self.bufferOffset = 0;
-                        self.bufferLimit = encodedBuffer.length;
-                    } else {
-                        [self.inputStream close];
-                        self.inputStream = nil;
-                        self.bufferOffset = 0;
-                        self.bufferLimit = self.streamEndData.length;
-                        self.dataBuffer = [NSData dataWithData:self.streamEndData];
-                        self.streamEndData = nil;
-                    }
-                    if ((self.bufferLimit == self.bufferOffset) && self.encoderStream != nil) {
-                        self.encoderStream.delegate = nil;
-                        [self.encoderStream close];
-                    }
-                } else if (self.streamEndData != nil) {
-                    self.bufferOffset = 0;
-                    self.bufferLimit = self.streamEndData.length;
-                    self.dataBuffer = [NSData dataWithData:self.streamEndData];
-                    self.streamEndData = nil;
-                }
-                
-                if ((self.bufferOffset == self.bufferLimit) && (self.encoderStream != nil)) {
-                    self.encoderStream.delegate = nil;
-                    [self.encoderStream close];
-                }
-                
-            }
-            if (self.bufferOffset != self.bufferLimit) {
-                NSUInteger length = self.dataBuffer.length;
-                uint8_t buffer[length];
-                [self.dataBuffer getBytes:buffer length:length];
-                NSInteger bytesWritten;
-                bytesWritten = [self.encoderStream write:&buffer[self.bufferOffset] maxLength:self.bufferLimit - self.bufferOffset];
-                if (bytesWritten <= 0) {
-                    [self stopSendWithStatus:@"Network write error"];
-                    NSError *cmisError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection detailedDescription:@"Network write error"];
-                    [self didCompleteWithError:cmisError];
-                } else {
-                    self.bufferOffset += bytesWritten;
-                }
-            }
-            
+            [self pumpBodyData];
         }
             break;
 
@@ -429,11 +385,6 @@ const NSUInteger kRawBufferSize = 24576;
 
 - (void)prepareStreams
 {
-    self.bufferOffset = 0;
-    
-    self.bufferLimit = self.streamStartData.length;
-    self.dataBuffer = [NSData dataWithData:self.streamStartData];
-    
     unsigned long long bytesExpected = self.bytesExpected;
     
     if (self.base64Encoding) {
@@ -448,14 +399,39 @@ const NSUInteger kRawBufferSize = 24576;
     // update the originally provided expected bytes with encoded length
     self.bytesExpected = encodedLength;
     self.encodedLength = self.bytesExpected;
+    self.encodedLengthKnown = (bytesExpected > 0 || self.inputStream == nil);
     
     if (self.inputStream.streamStatus != NSStreamStatusOpen) {
         [self.inputStream open];
     }
     
+    NSUInteger chunkSize = [[self.session objectForKey:kCMISSessionParameterUploadChunkSize defaultValue:@(DEFAULT_UPLOAD_CHUNK_SIZE)] unsignedIntegerValue];
+    self.pipeline = [[CMISUploadPipeline alloc] initWithInputStream:self.inputStream
+                                                          startData:self.streamStartData
+                                                            endData:self.streamEndData
+                                                     base64Encoding:self.base64Encoding
+                                                          chunkSize:chunkSize
+                                                        bufferCount:UPLOAD_BUFFER_COUNT];
+    self.pipeline.contentHasher = self.contentHasher;
+    // the pipeline owns the source stream from now on
+    self.inputStream = nil;
+    self.streamStartData = nil;
+    self.streamEndData = nil;
+    
+    self.pumpThread = [NSThread currentThread];
+    __weak CMISHttpUploadRequest *weakSelf = self;
+    self.pipeline.dataAvailableBlock = ^{
+        CMISHttpUploadRequest *strongSelf = weakSelf;
+        NSThread *pumpThread = strongSelf.pumpThread;
+        if (pumpThread) {
+            [strongSelf performSelector:@selector(pumpBodyData) onThread:pumpThread withObject:nil waitUntilDone:NO];
+        }
+    };
+    [self.pipeline start];
+    
     NSInputStream *requestInputStream;
     NSOutputStream *outputStream;
-    [NSStream createBoundInputStream:&requestInputStream outputStream:&outputStream];
+    [NSStream createBoundInputStream:&requestInputStream outputStream:&outputStream bufferSize:self.pipeline.encodedChunkSize];
     assert(requestInputStream != nil);
     assert(outputStream != nil);
     self.combinedInputStream = requestInputStream;
@@ -465,6 +441,38 @@ const NSUInteger kRawBufferSize = 24576;
     [self.encoderStream open];
 }
 
+/**
+ writes body data from the pipeline to the encoderStream until the stream is full or the pipeline has no data ready
+ */
+- (void)pumpBodyData
+{
+    while (self.encoderStream != nil && self.encoderStream.hasSpaceAvailable) {
+        NSUInteger length = 0;
+        const uint8_t *bytes = [self.pipeline availableBytes:&length];
+        if (bytes == NULL) {
+            if (self.pipeline.error) {
+                NSError *readError = self.pipeline.error;
+                [self stopSendWithStatus:@"Error while reading from source input stream"];
+                [self didCompleteWithError:readError];
+            } else if (self.pipeline.isAtEnd) {
+                self.encoderStream.delegate = nil;
+                [self.encoderStream close];
+            }
+            // otherwise the dataAvailableBlock continues once the next chunk is ready
+            return;
+        }
+        
+        NSInteger bytesWritten = [self.encoderStream write:bytes maxLength:length];
+        if (bytesWritten <= 0) {
+            [self stopSendWithStatus:@"Network write error"];
+            NSError *cmisError = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection detailedDescription:@"Network write error"];
+            [self didCompleteWithError:cmisError];
+            return;
+        }
+        [self.pipeline consumeBytes:bytesWritten];
+    }
+}
+
 
 + (unsigned long long)base64EncodedLength:(unsigned long long)contentSize
 {
@@ -491,11 +499,11 @@ const NSUInteger kRawBufferSize = 24576;
     if (nil != statusString) {
         CMISLogTrace(@"Upload request terminated: Message is %@", statusString);
     }
-    self.bufferOffset = 0;
-    self.bufferLimit  = 0;
-    self.dataBuffer = nil;
-    if (self.urlSession != nil) {
-        [self.urlSession invalidateAndCancel];
+    [self.pipeline cancel];
+    self.pipeline.dataAvailableBlock = nil;
+    if (self.sessionTask != nil) {
+        [self.sessionTask cancel];
+        self.sessionTask = nil;
         self.urlSession = nil;
     }
     if (self.encoderStream != nil) {
@@ -0,0 +1,77 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class CMISBindingSession;
+@class CMISHttpResponse;
+
+/**
+ * Keeps responses carrying an ETag or Last-Modified validator together with the result parsed from them.
+ *
+ * Before a GET request is sent, the validators of a cached response are added as If-None-Match and
+ * If-Modified-Since headers. If the server answers with 304 Not Modified the cached response is returned instead,
+ * including its parsed result, so the body neither has to be downloaded nor parsed again.
+ * The cache is bounded by a memory budget, least recently used responses are evicted first.
+ */
+@interface CMISHttpValidationCache : NSObject
+
+/// the number of requests answered from the cache after the server confirmed the cached response with 304
+@property (nonatomic, assign, readonly) NSUInteger hitCount;
+
+/// the number of requests that had to download and parse the full response
+@property (nonatomic, assign, readonly) NSUInteger missCount;
+
+/// the memory budget in bytes
+@property (nonatomic, assign, readonly) NSUInteger memoryBudget;
+
+/// the estimated memory used by the cached responses in bytes
+@property (nonatomic, assign, readonly) NSUInteger memoryUsage;
+
+- (id)initWithBindingSession:(CMISBindingSession *)bindingSession;
+
+/**
+ * Builds the key a response is cached under, made of the URL, the identity of the authenticated user and all request
+ * headers except the credentials and validators, so representations negotiated differently are kept apart.
+ * Must be called once all other headers have been added to the request.
+ */
++ (NSString *)keyForRequest:(NSURLRequest *)urlRequest session:(CMISBindingSession *)session;
+
+/**
+ * Adds the validators of the cached response for the given key to the request.
+ * @return the cached response the request is validated against or nil if there is none
+ */
+- (CMISHttpResponse *)addValidatorsToRequest:(NSMutableURLRequest *)urlRequest forKey:(NSString *)key;
+
+/**
+ * Processes the response of a request.
+ * A 304 response is replaced by the cached response it validated. A 200 response carrying validators is stored.
+ * @param httpResponse the response received from the server
+ * @param cachedResponse the response returned by addValidatorsToRequest:forKey: for the request
+ * @param key the key the request was validated with
+ * @return the response to hand over to the caller
+ */
+- (CMISHttpResponse *)responseForResponse:(CMISHttpResponse *)httpResponse
+                           cachedResponse:(CMISHttpResponse *)cachedResponse
+                                   forKey:(NSString *)key;
+
+/// Removes all cached responses.
+- (void)removeAll;
+
+@end
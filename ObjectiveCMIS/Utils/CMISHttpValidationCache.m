@@ -0,0 +1,179 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import "CMISHttpValidationCache.h"
+#import "CMISHttpResponse.h"
+#import "CMISBindingSession.h"
+#import "CMISLog.h"
+
+// Default memory budget of the validation cache is 4 MB
+#define DEFAULT_VALIDATION_CACHE_SIZE (4 * 1024 * 1024)
+
+// the parsed result is estimated to use as much memory as the response data
+#define PARSED_RESULT_COST_FACTOR 2
+
+@interface CMISHttpValidationCache ()
+
+@property (nonatomic, assign, readwrite) NSUInteger hitCount;
+@property (nonatomic, assign, readwrite) NSUInteger missCount;
+@property (nonatomic, assign, readwrite) NSUInteger memoryBudget;
+@property (nonatomic, assign, readwrite) NSUInteger memoryUsage;
+@property (nonatomic, strong) NSMutableDictionary *responses;
+@property (nonatomic, strong) NSMutableArray *keysByLastUse; // least recently used key first
+
+@end
+
+@implementation CMISHttpValidationCache
+
+- (id)initWithBindingSession:(CMISBindingSession *)bindingSession
+{
+    self = [super init];
+    if (self) {
+        _responses = [[NSMutableDictionary alloc] init];
+        _keysByLastUse = [[NSMutableArray alloc] init];
+        _memoryBudget = DEFAULT_VALIDATION_CACHE_SIZE;
+        
+        id validationCacheSize = [bindingSession objectForKey:kCMISSessionParameterValidationCacheSize];
+        if (validationCacheSize != nil) {
+            if ([validationCacheSize isKindOfClass:[NSNumber class]]) {
+                _memoryBudget = [validationCacheSize unsignedIntegerValue];
+            } else {
+                CMISLogError(@"Invalid object set for %@ session parameter. Ignoring and using default instead", kCMISSessionParameterValidationCacheSize);
+            }
+        }
+    }
+    return self;
+}
+
++ (NSString *)keyForRequest:(NSURLRequest *)urlRequest session:(CMISBindingSession *)session
+{
+    // the authentication provider holds the credentials, so it identifies the user together with the username
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%@|%@|%p",
+                            urlRequest.URL.absoluteString, session.username ? session.username : @"", session.authenticationProvider];
+    
+    NSDictionary *headers = urlRequest.allHTTPHeaderFields;
+    NSArray *headerNames = [headers.allKeys sortedArrayUsingSelector:@selector(caseInsensitiveCompare:)];
+    for (NSString *headerName in headerNames) {
+        NSString *lowercaseName = headerName.lowercaseString;
+        if ([lowercaseName isEqualToString:@"authorization"] || [lowercaseName isEqualToString:@"cookie"] ||
+            [lowercaseName isEqualToString:@"if-none-match"] || [lowercaseName isEqualToString:@"if-modified-since"]) {
+            continue;
+        }
+        [key appendFormat:@"|%@:%@", lowercaseName, [headers objectForKey:headerName]];
+    }
+    
+    return key;
+}
+
+- (CMISHttpResponse *)addValidatorsToRequest:(NSMutableURLRequest *)urlRequest forKey:(NSString *)key
+{
+    if (self.memoryBudget == 0) {
+        return nil;
+    }
+    
+    CMISHttpResponse *cachedResponse = nil;
+    @synchronized(self) {
+        cachedResponse = [self.responses objectForKey:key];
+    }
+    
+    if (cachedResponse) {
+        NSString *etag = [cachedResponse valueForHeader:@"ETag"];
+        if (etag) {
+            [urlRequest setValue:etag forHTTPHeaderField:@"If-None-Match"];
+        }
+        NSString *lastModified = [cachedResponse valueForHeader:@"Last-Modified"];
+        if (lastModified) {
+            [urlRequest setValue:lastModified forHTTPHeaderField:@"If-Modified-Since"];
+        }
+    }
+    
+    return cachedResponse;
+}
+
+- (CMISHttpResponse *)responseForResponse:(CMISHttpResponse *)httpResponse
+                           cachedResponse:(CMISHttpResponse *)cachedResponse
+                                   forKey:(NSString *)key
+{
+    if (self.memoryBudget == 0 || httpResponse == nil) {
+        return httpResponse;
+    }
+    
+    if (httpResponse.statusCode == 304 && cachedResponse) {
+        @synchronized(self) {
+            self.hitCount++;
+            if ([self.responses objectForKey:key] == cachedResponse) {
+                [self.keysByLastUse removeObject:key];
+                [self.keysByLastUse addObject:key];
+            }
+        }
+        CMISLogDebug(@"Response for %@ not modified, using cached response", key);
+        return cachedResponse;
+    }
+    
+    if (httpResponse.statusCode == 200) {
+        @synchronized(self) {
+            self.missCount++;
+            [self removeResponseForKey:key];
+            
+            NSUInteger cost = [CMISHttpValidationCache costForResponse:httpResponse];
+            BOOL hasValidator = [httpResponse valueForHeader:@"ETag"] || [httpResponse valueForHeader:@"Last-Modified"];
+            if (hasValidator && cost <= self.memoryBudget) {
+                [self.responses setObject:httpResponse forKey:key];
+                [self.keysByLastUse addObject:key];
+                self.memoryUsage += cost;
+                
+                // evict the least recently used responses until the budget is met
+                while (self.memoryUsage > self.memoryBudget && self.keysByLastUse.count > 0) {
+                    [self removeResponseForKey:[self.keysByLastUse objectAtIndex:0]];
+                }
+            }
+        }
+    }
+    
+    return httpResponse;
+}
+
+- (void)removeAll
+{
+    @synchronized(self) {
+        [self.responses removeAllObjects];
+        [self.keysByLastUse removeAllObjects];
+        self.memoryUsage = 0;
+    }
+}
+
+#pragma mark Private methods
+
+/// must be called while holding the lock
+- (void)removeResponseForKey:(NSString *)key
+{
+    CMISHttpResponse *httpResponse = [self.responses objectForKey:key];
+    if (httpResponse) {
+        self.memoryUsage -= [CMISHttpValidationCache costForResponse:httpResponse];
+        [self.responses removeObjectForKey:key];
+        [self.keysByLastUse removeObject:key];
+    }
+}
+
++ (NSUInteger)costForResponse:(CMISHttpResponse *)httpResponse
+{
+    return httpResponse.data.length * PARSED_RESULT_COST_FACTOR;
+}
+
+@end
@@ -0,0 +1,78 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+@class CMISJSONReader;
+
+/**
+ * Receives the events of a CMISJSONReader in document order. Each value is either a container, reported by its start
+ * and end, or a plain value: an NSString, an NSNumber (booleans are kCFBooleanTrue and kCFBooleanFalse) or NSNull,
+ * the same objects NSJSONSerialization returns.
+ */
+@protocol CMISJSONReaderDelegate <NSObject>
+
+- (void)readerDidStartObject:(CMISJSONReader *)reader;
+
+- (void)readerDidEndObject:(CMISJSONReader *)reader;
+
+- (void)readerDidStartArray:(CMISJSONReader *)reader;
+
+- (void)readerDidEndArray:(CMISJSONReader *)reader;
+
+/// called with the key of each member of an object, before the events of its value
+- (void)reader:(CMISJSONReader *)reader didReadKey:(NSString *)key;
+
+/// called with each plain value, i.e. with anything but an array or an object
+- (void)reader:(CMISJSONReader *)reader didReadValue:(id)value;
+
+@end
+
+/**
+ * An event based JSON reader that reports the tokens of a UTF-8 encoded document to its delegate while the document
+ * is handed to it in chunks, so no Foundation object tree has to be built for the whole document.
+ *
+ * The reader accepts the same documents as NSJSONSerialization without options, i.e. the top level value must be an
+ * array or an object, and fails with the same error domain and code. Keys are interned, so the keys repeated by every
+ * object of a large result are only created once.
+ * A reader must only be used from one thread at a time.
+ */
+@interface CMISJSONReader : NSObject
+
+@property (nonatomic, weak) id<CMISJSONReaderDelegate> delegate;
+
+/// the error reading has failed with, or nil
+@property (nonatomic, strong, readonly) NSError *error;
+
+/// the number of arrays and objects that have started but not ended yet
+@property (nonatomic, assign, readonly) NSUInteger depth;
+
+- (id)initWithDelegate:(id<CMISJSONReaderDelegate>)delegate;
+
+/// reads the next chunk of the document, returns NO once reading has failed or was aborted
+- (BOOL)appendData:(NSData *)data;
+
+/// reads the end of the document, returns NO if the document is incomplete or reading has failed or was aborted
+- (BOOL)finishReading;
+
+/// stops reading, no more events are reported. May be called by the delegate
+- (void)abortReading;
+
+@end
@@ -0,0 +1,674 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import "CMISJSONReader.h"
+#import <xlocale.h>
+
+// Maximum number of nested arrays and objects
+#define MAX_DEPTH 512
+
+// Number of keys that are interned, must be a power of two
+#define KEY_CACHE_SIZE 256
+
+// Keys longer than this are not interned
+#define KEY_CACHE_KEY_LENGTH 48
+
+#pragma mark -
+#pragma mark Tokenizer
+
+typedef enum {
+    CMISJSONEventStartObject,
+    CMISJSONEventEndObject,
+    CMISJSONEventStartArray,
+    CMISJSONEventEndArray,
+    CMISJSONEventKey,
+    CMISJSONEventString,
+    CMISJSONEventInteger,
+    CMISJSONEventDouble,
+    CMISJSONEventTrue,
+    CMISJSONEventFalse,
+    CMISJSONEventNull
+} CMISJSONEvent;
+
+typedef enum {
+    CMISJSONStateValue,
+    CMISJSONStateValueOrEnd,
+    CMISJSONStateKey,
+    CMISJSONStateKeyOrEnd,
+    CMISJSONStateColon,
+    CMISJSONStateCommaOrEnd,
+    CMISJSONStateDone
+} CMISJSONState;
+
+/// a key or a plain value; strings are UTF-8 with all escape sequences decoded, but not validated
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+    long long integerValue;
+    double doubleValue;
+} CMISJSONToken;
+
+/// handles an event, returns 0 to stop the tokenizer
+typedef int (*CMISJSONEventHandler)(void *context, CMISJSONEvent event, const CMISJSONToken *token);
+
+typedef struct {
+    CMISJSONState state;
+    size_t depth;
+    uint8_t containers[MAX_DEPTH];
+    uint8_t *buffer;
+    size_t bufferCapacity;
+    size_t position;
+    const uint8_t *chunk;
+    const char *error;
+    size_t errorPosition;
+    int stopped;
+} CMISJSONTokenizer;
+
+/// records the error at the position p of the current chunk
+static void CMISJSONFail(CMISJSONTokenizer *tokenizer, const uint8_t *p, const char *error)
+{
+    tokenizer->error = error;
+    tokenizer->errorPosition = tokenizer->position + (p - tokenizer->chunk);
+}
+
+static int CMISJSONEnsureBuffer(CMISJSONTokenizer *tokenizer, size_t capacity)
+{
+    if (tokenizer->bufferCapacity < capacity) {
+        uint8_t *buffer = realloc(tokenizer->buffer, capacity);
+        if (!buffer) {
+            return 0;
+        }
+        tokenizer->buffer = buffer;
+        tokenizer->bufferCapacity = capacity;
+    }
+    return 1;
+}
+
+static int CMISJSONHexValue(const uint8_t *p, uint32_t *value)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < 4; i++) {
+        uint8_t c = p[i];
+        if (c >= '0' && c <= '9') {
+            result = (result << 4) | (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            result = (result << 4) | (uint32_t)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            result = (result << 4) | (uint32_t)(c - 'A' + 10);
+        } else {
+            return 0;
+        }
+    }
+    *value = result;
+    return 1;
+}
+
+/// decodes the escape sequences of a string into out, which must be as long as the string. Returns the decoded length or -1
+static long CMISJSONUnescape(const uint8_t *p, const uint8_t *end, uint8_t *out)
+{
+    uint8_t *o = out;
+    while (p < end) {
+        if (*p != '\\') {
+            *o++ = *p++;
+            continue;
+        }
+        p++; // the scanner has made sure an escaped character follows
+        switch (*p++) {
+            case '"': *o++ = '"'; break;
+            case '\\': *o++ = '\\'; break;
+            case '/': *o++ = '/'; break;
+            case 'b': *o++ = '\b'; break;
+            case 'f': *o++ = '\f'; break;
+            case 'n': *o++ = '\n'; break;
+            case 'r': *o++ = '\r'; break;
+            case 't': *o++ = '\t'; break;
+            case 'u': {
+                uint32_t codePoint;
+                if (end - p < 4 || !CMISJSONHexValue(p, &codePoint)) {
+                    return -1;
+                }
+                p += 4;
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) { // a high surrogate must be followed by a low surrogate
+                    uint32_t lowSurrogate;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !CMISJSONHexValue(p + 2, &lowSurrogate)
+                        || lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+                        return -1;
+                    }
+                    p += 6;
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+                } else if (codePoint >= 0xDC00 && codePoint <= 0xDFFF) {
+                    return -1;
+                }
+
+                // the UTF-8 sequence is never longer than the escape sequence
+                if (codePoint < 0x80) {
+                    *o++ = (uint8_t)codePoint;
+                } else if (codePoint < 0x800) {
+                    *o++ = (uint8_t)(0xC0 | (codePoint >> 6));
+                    *o++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+                } else if (codePoint < 0x10000) {
+                    *o++ = (uint8_t)(0xE0 | (codePoint >> 12));
+                    *o++ = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+                    *o++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+                } else {
+                    *o++ = (uint8_t)(0xF0 | (codePoint >> 18));
+                    *o++ = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+                    *o++ = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+                    *o++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+    }
+    return o - out;
+}
+
+/// scans the string starting at the quote p. Returns the position after the closing quote, or NULL if the string is incomplete or invalid
+static const uint8_t *CMISJSONReadString(CMISJSONTokenizer *tokenizer, const uint8_t *p, const uint8_t *end, CMISJSONToken *token)
+{
+    const uint8_t *start = p + 1;
+    const uint8_t *q = start;
+    int escaped = 0;
+    while (q < end) {
+        uint8_t c = *q;
+        if (c == '"') {
+            break;
+        } else if (c == '\\') {
+            escaped = 1;
+            q += 2;
+        } else if (c < 0x20) {
+            CMISJSONFail(tokenizer, q, "Unescaped control character");
+            return NULL;
+        } else {
+            q++;
+        }
+    }
+    if (q >= end) {
+        return NULL;
+    }
+
+    if (escaped) {
+        if (!CMISJSONEnsureBuffer(tokenizer, q - start)) {
+            CMISJSONFail(tokenizer, p, "Out of memory");
+            return NULL;
+        }
+        long length = CMISJSONUnescape(start, q, tokenizer->buffer);
+        if (length < 0) {
+            CMISJSONFail(tokenizer, p, "Invalid escape sequence");
+            return NULL;
+        }
+        token->bytes = tokenizer->buffer;
+        token->length = (size_t)length;
+    } else {
+        token->bytes = start;
+        token->length = q - start;
+    }
+    return q + 1;
+}
+
+static int CMISJSONIsDigit(uint8_t c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// scans the number starting at p. Returns the position after the number, or NULL if the number is incomplete or invalid
+static const uint8_t *CMISJSONReadNumber(CMISJSONTokenizer *tokenizer, const uint8_t *p, const uint8_t *end, int final, CMISJSONEvent *event, CMISJSONToken *token)
+{
+    const uint8_t *q = p;
+    int isInteger = 1;
+
+    if (*q == '-') {
+        q++;
+    }
+    if (q < end && *q == '0') {
+        q++;
+    } else if (q < end && CMISJSONIsDigit(*q)) {
+        while (q < end && CMISJSONIsDigit(*q)) q++;
+    } else {
+        goto incompleteOrInvalid;
+    }
+    if (q < end && *q == '.') {
+        isInteger = 0;
+        q++;
+        if (q == end || !CMISJSONIsDigit(*q)) goto incompleteOrInvalid;
+        while (q < end && CMISJSONIsDigit(*q)) q++;
+    }
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        isInteger = 0;
+        q++;
+        if (q < end && (*q == '+' || *q == '-')) q++;
+        if (q == end || !CMISJSONIsDigit(*q)) goto incompleteOrInvalid;
+        while (q < end && CMISJSONIsDigit(*q)) q++;
+    }
+    if (q == end && !final) {
+        return NULL; // more digits may follow in the next chunk
+    }
+
+    size_t length = q - p;
+    if (isInteger) {
+        // accumulate negatively, so the smallest long long fits as well
+        long long value = 0;
+        const uint8_t *digit = (*p == '-') ? p + 1 : p;
+        for (; digit < q; digit++) {
+            int d = *digit - '0';
+            if (value < (LLONG_MIN + d) / 10) {
+                isInteger = 0; // too large, read it as a double instead
+                break;
+            }
+            value = value * 10 - d;
+        }
+        if (isInteger) {
+            if (*p != '-') {
+                if (value == LLONG_MIN) {
+                    isInteger = 0;
+                } else {
+                    value = -value;
+                }
+            }
+            if (isInteger) {
+                *event = CMISJSONEventInteger;
+                token->integerValue = value;
+                return q;
+            }
+        }
+    }
+
+    if (!CMISJSONEnsureBuffer(tokenizer, length + 1)) {
+        CMISJSONFail(tokenizer, p, "Out of memory");
+        return NULL;
+    }
+    memcpy(tokenizer->buffer, p, length);
+    tokenizer->buffer[length] = 0;
+    *event = CMISJSONEventDouble;
+    token->doubleValue = strtod_l((const char *)tokenizer->buffer, NULL, NULL); // the C locale
+    return q;
+
+incompleteOrInvalid:
+    if (q < end || final) {
+        CMISJSONFail(tokenizer, q, "Invalid number");
+    }
+    return NULL;
+}
+
+/// scans the literal starting at p. Returns the position after the literal, or NULL if the literal is incomplete or invalid
+static const uint8_t *CMISJSONReadLiteral(CMISJSONTokenizer *tokenizer, const uint8_t *p, const uint8_t *end, int final, const char *literal, size_t length)
+{
+    size_t available = (size_t)(end - p) < length ? (size_t)(end - p) : length;
+    if (memcmp(p, literal, available) != 0 || (available < length && final)) {
+        CMISJSONFail(tokenizer, p, "Invalid value");
+        return NULL;
+    }
+    return (available < length) ? NULL : p + length;
+}
+
+static void CMISJSONEmit(CMISJSONTokenizer *tokenizer, CMISJSONEvent event, const CMISJSONToken *token, CMISJSONEventHandler handler, void *context)
+{
+    if (!handler(context, event, token)) {
+        tokenizer->stopped = 1;
+    }
+}
+
+static void CMISJSONEndValue(CMISJSONTokenizer *tokenizer)
+{
+    tokenizer->state = (tokenizer->depth == 0) ? CMISJSONStateDone : CMISJSONStateCommaOrEnd;
+}
+
+static void CMISJSONEndContainer(CMISJSONTokenizer *tokenizer, CMISJSONEventHandler handler, void *context)
+{
+    uint8_t container = tokenizer->containers[--tokenizer->depth];
+    CMISJSONEmit(tokenizer, (container == '{') ? CMISJSONEventEndObject : CMISJSONEventEndArray, NULL, handler, context);
+    CMISJSONEndValue(tokenizer);
+}
+
+/**
+ * Reads the tokens of the given bytes and reports them to the handler. Returns the number of bytes consumed; the
+ * remaining bytes belong to a token that is continued by the next chunk and must be handed over again with it.
+ */
+static size_t CMISJSONTokenize(CMISJSONTokenizer *tokenizer, const uint8_t *bytes, size_t length, int final, CMISJSONEventHandler handler, void *context)
+{
+    const uint8_t *p = bytes;
+    const uint8_t *end = bytes + length;
+    CMISJSONToken token;
+    tokenizer->chunk = bytes;
+
+    while (!tokenizer->error && !tokenizer->stopped) {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+            p++;
+        }
+        if (p == end) {
+            break;
+        }
+
+        const uint8_t *next = NULL;
+        uint8_t c = *p;
+
+        switch (tokenizer->state) {
+            case CMISJSONStateDone:
+                CMISJSONFail(tokenizer, p, "Garbage at end");
+                break;
+
+            case CMISJSONStateColon:
+                if (c == ':') {
+                    next = p + 1;
+                    tokenizer->state = CMISJSONStateValue;
+                } else {
+                    CMISJSONFail(tokenizer, p, "No value for key in object");
+                }
+                break;
+
+            case CMISJSONStateCommaOrEnd: {
+                uint8_t container = tokenizer->containers[tokenizer->depth - 1];
+                if (c == ',') {
+                    next = p + 1;
+                    tokenizer->state = (container == '{') ? CMISJSONStateKey : CMISJSONStateValue;
+                } else if ((c == '}' && container == '{') || (c == ']' && container == '[')) {
+                    next = p + 1;
+                    CMISJSONEndContainer(tokenizer, handler, context);
+                } else {
+                    CMISJSONFail(tokenizer, p, (container == '{') ? "Badly formed object" : "Badly formed array");
+                }
+                break;
+            }
+
+            case CMISJSONStateKeyOrEnd:
+                if (c == '}') {
+                    next = p + 1;
+                    CMISJSONEndContainer(tokenizer, handler, context);
+                    break;
+                }
+                // no break, a key must follow
+            case CMISJSONStateKey:
+                if (c != '"') {
+                    CMISJSONFail(tokenizer, p, "No string key for value in object");
+                    break;
+                }
+                next = CMISJSONReadString(tokenizer, p, end, &token);
+                if (next) {
+                    tokenizer->state = CMISJSONStateColon;
+                    CMISJSONEmit(tokenizer, CMISJSONEventKey, &token, handler, context);
+                }
+                break;
+
+            case CMISJSONStateValueOrEnd:
+                if (c == ']') {
+                    next = p + 1;
+                    CMISJSONEndContainer(tokenizer, handler, context);
+                    break;
+                }
+                // no break, a value must follow
+            case CMISJSONStateValue:
+                if (tokenizer->depth == 0 && c != '{' && c != '[') {
+                    CMISJSONFail(tokenizer, p, "JSON text did not start with array or object");
+                    break;
+                }
+
+                if (c == '{' || c == '[') {
+                    if (tokenizer->depth == MAX_DEPTH) {
+                        CMISJSONFail(tokenizer, p, "Too many nested arrays or dictionaries");
+                        break;
+                    }
+                    next = p + 1;
+                    tokenizer->containers[tokenizer->depth++] = c;
+                    tokenizer->state = (c == '{') ? CMISJSONStateKeyOrEnd : CMISJSONStateValueOrEnd;
+                    CMISJSONEmit(tokenizer, (c == '{') ? CMISJSONEventStartObject : CMISJSONEventStartArray, NULL, handler, context);
+                } else {
+                    CMISJSONEvent event = CMISJSONEventNull;
+                    if (c == '"') {
+                        event = CMISJSONEventString;
+                        next = CMISJSONReadString(tokenizer, p, end, &token);
+                    } else if (c == '-' || CMISJSONIsDigit(c)) {
+                        next = CMISJSONReadNumber(tokenizer, p, end, final, &event, &token);
+                    } else if (c == 't') {
+                        event = CMISJSONEventTrue;
+                        next = CMISJSONReadLiteral(tokenizer, p, end, final, "true", 4);
+                    } else if (c == 'f') {
+                        event = CMISJSONEventFalse;
+                        next = CMISJSONReadLiteral(tokenizer, p, end, final, "false", 5);
+                    } else if (c == 'n') {
+                        event = CMISJSONEventNull;
+                        next = CMISJSONReadLiteral(tokenizer, p, end, final, "null", 4);
+                    } else {
+                        CMISJSONFail(tokenizer, p, "Invalid value");
+                        break;
+                    }
+                    if (next) {
+                        CMISJSONEndValue(tokenizer);
+                        CMISJSONEmit(tokenizer, event, &token, handler, context);
+                    }
+                }
+                break;
+        }
+
+        if (!next) {
+            break; // failed, or the token is continued by the next chunk
+        }
+        p = next;
+    }
+
+    tokenizer->position += p - bytes;
+    return p - bytes;
+}
+
+#pragma mark -
+#pragma mark Reader
+
+@interface CMISJSONReader ()
+{
+    CMISJSONTokenizer _tokenizer;
+    NSMutableData *_pendingData;
+    NSString *_keyCacheStrings[KEY_CACHE_SIZE];
+    size_t _keyCacheLengths[KEY_CACHE_SIZE];
+    uint8_t _keyCacheBytes[KEY_CACHE_SIZE][KEY_CACHE_KEY_LENGTH];
+}
+
+@property (nonatomic, strong, readwrite) NSError *error;
+@property (nonatomic, assign) BOOL aborted;
+
+- (int)handleEvent:(CMISJSONEvent)event token:(const CMISJSONToken *)token;
+
+@end
+
+static int CMISJSONReaderHandleEvent(void *context, CMISJSONEvent event, const CMISJSONToken *token)
+{
+    return [(__bridge CMISJSONReader *)context handleEvent:event token:token];
+}
+
+@implementation CMISJSONReader
+
+- (id)init
+{
+    return [self initWithDelegate:nil];
+}
+
+- (id)initWithDelegate:(id<CMISJSONReaderDelegate>)delegate
+{
+    self = [super init];
+    if (self) {
+        _delegate = delegate;
+        _pendingData = [[NSMutableData alloc] init];
+        _tokenizer.state = CMISJSONStateValue;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    free(_tokenizer.buffer);
+}
+
+- (NSUInteger)depth
+{
+    return _tokenizer.depth;
+}
+
+- (BOOL)appendData:(NSData *)data
+{
+    if (self.error || self.aborted) {
+        return NO;
+    }
+    
+    if (_pendingData.length == 0) {
+        // only the beginning of a token continued by the next chunk is copied
+        size_t consumed = [self readBytes:data.bytes length:data.length final:NO];
+        if (!self.error && consumed < data.length) {
+            [_pendingData appendBytes:(const uint8_t *)data.bytes + consumed length:data.length - consumed];
+        }
+    } else {
+        [_pendingData appendData:data];
+        size_t consumed = [self readBytes:_pendingData.bytes length:_pendingData.length final:NO];
+        [_pendingData replaceBytesInRange:NSMakeRange(0, consumed) withBytes:NULL length:0];
+    }
+    return !self.error && !self.aborted;
+}
+
+- (BOOL)finishReading
+{
+    if (self.error || self.aborted) {
+        return NO;
+    }
+    
+    [self readBytes:_pendingData.bytes length:_pendingData.length final:YES];
+    _pendingData.length = 0;
+    if (!self.error && !self.aborted && _tokenizer.state != CMISJSONStateDone) {
+        _tokenizer.error = (_tokenizer.position == 0) ? "No value" : "Unexpected end of file during JSON parse";
+        _tokenizer.errorPosition = _tokenizer.position;
+        [self failWithTokenizerError];
+    }
+    return !self.error && !self.aborted;
+}
+
+- (void)abortReading
+{
+    self.aborted = YES;
+}
+
+#pragma mark -
+#pragma mark Private helper methods
+
+- (size_t)readBytes:(const void *)bytes length:(size_t)length final:(BOOL)final
+{
+    size_t consumed = CMISJSONTokenize(&_tokenizer, bytes, length, final, CMISJSONReaderHandleEvent, (__bridge void *)self);
+    if (_tokenizer.error && !self.error) {
+        [self failWithTokenizerError];
+    }
+    return consumed;
+}
+
+- (void)failWithTokenizerError
+{
+    [self failWithDescription:[NSString stringWithFormat:@"%s around character %lu.", _tokenizer.error, (unsigned long)_tokenizer.errorPosition]];
+}
+
+- (void)failWithDescription:(NSString *)description
+{
+    // the domain and code NSJSONSerialization uses
+    self.error = [NSError errorWithDomain:NSCocoaErrorDomain
+                                     code:NSPropertyListReadCorruptError
+                                 userInfo:@{NSDebugDescriptionErrorKey : description}];
+}
+
+- (int)handleEvent:(CMISJSONEvent)event token:(const CMISJSONToken *)token
+{
+    id<CMISJSONReaderDelegate> delegate = self.delegate;
+    switch (event) {
+        case CMISJSONEventStartObject:
+            [delegate readerDidStartObject:self];
+            break;
+        case CMISJSONEventEndObject:
+            [delegate readerDidEndObject:self];
+            break;
+        case CMISJSONEventStartArray:
+            [delegate readerDidStartArray:self];
+            break;
+        case CMISJSONEventEndArray:
+            [delegate readerDidEndArray:self];
+            break;
+        case CMISJSONEventKey: {
+            NSString *key = [self keyForToken:token];
+            if (!key) {
+                return 0;
+            }
+            [delegate reader:self didReadKey:key];
+            break;
+        }
+        case CMISJSONEventString: {
+            NSString *string = [self stringForToken:token];
+            if (!string) {
+                return 0;
+            }
+            [delegate reader:self didReadValue:string];
+            break;
+        }
+        case CMISJSONEventInteger:
+            [delegate reader:self didReadValue:[NSNumber numberWithLongLong:token->integerValue]];
+            break;
+        case CMISJSONEventDouble:
+            [delegate reader:self didReadValue:[NSNumber numberWithDouble:token->doubleValue]];
+            break;
+        case CMISJSONEventTrue:
+            [delegate reader:self didReadValue:(__bridge NSNumber *)kCFBooleanTrue];
+            break;
+        case CMISJSONEventFalse:
+            [delegate reader:self didReadValue:(__bridge NSNumber *)kCFBooleanFalse];
+            break;
+        case CMISJSONEventNull:
+            [delegate reader:self didReadValue:[NSNull null]];
+            break;
+    }
+    return !self.aborted;
+}
+
+- (NSString *)stringForToken:(const CMISJSONToken *)token
+{
+    NSString *string = [[NSString alloc] initWithBytes:token->bytes length:token->length encoding:NSUTF8StringEncoding];
+    if (!string) {
+        [self failWithDescription:[NSString stringWithFormat:@"Invalid UTF-8 string around character %lu.", (unsigned long)_tokenizer.position]];
+    }
+    return string;
+}
+
+- (NSString *)keyForToken:(const CMISJSONToken *)token
+{
+    if (token->length > KEY_CACHE_KEY_LENGTH) {
+        return [self stringForToken:token];
+    }
+    
+    // FNV-1a hash of the key
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < token->length; i++) {
+        hash = (hash ^ token->bytes[i]) * 16777619u;
+    }
+    NSUInteger slot = hash & (KEY_CACHE_SIZE - 1);
+    
+    if (_keyCacheStrings[slot] && _keyCacheLengths[slot] == token->length && memcmp(_keyCacheBytes[slot], token->bytes, token->length) == 0) {
+        return _keyCacheStrings[slot];
+    }
+    
+    NSString *key = [self stringForToken:token];
+    if (key) {
+        _keyCacheStrings[slot] = key;
+        _keyCacheLengths[slot] = token->length;
+        memcpy(_keyCacheBytes[slot], token->bytes, token->length);
+    }
+    return key;
+}
+
+@end
@@ -0,0 +1,57 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+/**
+ * A multipart/form-data request body that is produced while it is read.
+ *
+ * Only the parts are kept, the bytes of each part are generated when reading reaches it and content parts are read
+ * straight from their input streams. The length of the body is known before reading as long as the length of every
+ * content part is known.
+ *
+ * The stream is meant to be read synchronously, e.g. by CMISHttpUploadRequest; it can not be scheduled in a run loop.
+ */
+@interface CMISMultipartFormDataStream : NSInputStream
+
+@property (nonatomic, strong, readonly) NSString *boundary;
+
+/// the value for the Content-Type header of the request
+@property (nonatomic, strong, readonly) NSString *contentType;
+
+/// the exact length of the body in bytes, or -1 if the length of a content part is not known
+@property (nonatomic, assign, readonly) long long length;
+
+- (id)initWithBoundary:(NSString *)boundary;
+
+/// adds a text/plain part with the given name and value
+- (void)addFieldWithName:(NSString *)name value:(NSString *)value;
+
+/**
+ * adds a binary part read from the given stream.
+ * @param contentDisposition the value of the Content-Disposition header of the part
+ * @param length the number of bytes the stream provides, or -1 if it is not known
+ */
+- (void)addPartWithContentDisposition:(NSString *)contentDisposition
+                            mediaType:(NSString *)mediaType
+                          inputStream:(NSInputStream *)inputStream
+                               length:(long long)length;
+
+@end
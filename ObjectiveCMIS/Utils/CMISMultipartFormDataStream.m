@@ -0,0 +1,320 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISMultipartFormDataStream.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+
+/**
+ A part of the body, either a text field or content read from an input stream.
+ */
+@interface CMISMultipartFormDataPart : NSObject
+
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, strong) NSString *value;
+@property (nonatomic, strong) NSString *contentDisposition;
+@property (nonatomic, strong) NSString *mediaType;
+@property (nonatomic, strong) NSInputStream *inputStream;
+@property (nonatomic, assign) long long length;
+
+@end
+
+@implementation CMISMultipartFormDataPart
+@end
+
+
+@interface CMISMultipartFormDataStream ()
+{
+    __weak id<NSStreamDelegate> _delegate;
+}
+
+@property (nonatomic, strong, readwrite) NSString *boundary;
+@property (nonatomic, strong) NSMutableArray *parts;
+@property (nonatomic, assign) NSStreamStatus status;
+@property (nonatomic, strong) NSError *error;
+
+// reading state: the segments left of the current part and the segment being read
+@property (nonatomic, assign) BOOL preambleRead;
+@property (nonatomic, assign) NSUInteger nextPartIndex;
+@property (nonatomic, assign) BOOL closingDelimiterRead;
+@property (nonatomic, strong) NSMutableArray *segments;
+@property (nonatomic, strong) NSData *currentData;
+@property (nonatomic, assign) NSUInteger currentDataOffset;
+@property (nonatomic, strong) CMISMultipartFormDataPart *currentPart;
+@property (nonatomic, assign) unsigned long long currentPartBytesRead;
+
+@end
+
+
+@implementation CMISMultipartFormDataStream
+
+- (id)initWithBoundary:(NSString *)boundary
+{
+    self = [super init];
+    if (self) {
+        _boundary = boundary;
+        _parts = [[NSMutableArray alloc] init];
+        _segments = [[NSMutableArray alloc] init];
+        _status = NSStreamStatusNotOpen;
+    }
+    return self;
+}
+
+- (NSString *)contentType
+{
+    return [NSString stringWithFormat:@"multipart/form-data; boundary=%@", self.boundary];
+}
+
+- (void)addFieldWithName:(NSString *)name value:(NSString *)value
+{
+    CMISMultipartFormDataPart *part = [[CMISMultipartFormDataPart alloc] init];
+    part.name = name;
+    part.value = value;
+    [self.parts addObject:part];
+}
+
+- (void)addPartWithContentDisposition:(NSString *)contentDisposition
+                            mediaType:(NSString *)mediaType
+                          inputStream:(NSInputStream *)inputStream
+                               length:(long long)length
+{
+    CMISMultipartFormDataPart *part = [[CMISMultipartFormDataPart alloc] init];
+    part.contentDisposition = contentDisposition;
+    part.mediaType = mediaType;
+    part.inputStream = inputStream;
+    part.length = length;
+    [self.parts addObject:part];
+}
+
+- (long long)length
+{
+    long long length = [self preambleData].length + [self closingDelimiterData].length;
+    for (CMISMultipartFormDataPart *part in self.parts) {
+        @autoreleasepool {
+            if (part.inputStream) {
+                if (part.length < 0) {
+                    return -1;
+                }
+                length += [self headerDataForPart:part].length + part.length + [self partEndData].length;
+            } else {
+                length += [self headerDataForPart:part].length;
+            }
+        }
+    }
+    return length;
+}
+
+#pragma mark Body data
+
+- (NSData *)preambleData
+{
+    return [@"\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)partEndData
+{
+    return [@"\r\n" dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (NSData *)closingDelimiterData
+{
+    return [[NSString stringWithFormat:@"--%@--\r\n", self.boundary] dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+/// the delimiter and headers of the part, followed by the value of a field part
+- (NSData *)headerDataForPart:(CMISMultipartFormDataPart *)part
+{
+    NSString *header;
+    if (part.inputStream) {
+        header = [NSString stringWithFormat:@"--%@\r\nContent-Disposition: %@\r\nContent-Type: %@\r\nContent-Transfer-Encoding: binary\r\n\r\n",
+                  self.boundary, part.contentDisposition, part.mediaType];
+    } else {
+        header = [NSString stringWithFormat:@"--%@\r\nContent-Disposition: form-data; name=\"%@\"\r\nContent-Type: text/plain; charset=utf-8\r\n\r\n%@\r\n",
+                  self.boundary, part.name, part.value];
+    }
+    return [header dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+/// moves on to the next segment of the body; returns NO at the end of the body
+- (BOOL)loadNextSegment
+{
+    if (self.segments.count == 0) {
+        if (!self.preambleRead) {
+            self.preambleRead = YES;
+            [self.segments addObject:[self preambleData]];
+        } else if (self.nextPartIndex < self.parts.count) {
+            CMISMultipartFormDataPart *part = self.parts[self.nextPartIndex++];
+            [self.segments addObject:[self headerDataForPart:part]];
+            if (part.inputStream) {
+                [self.segments addObject:part];
+                [self.segments addObject:[self partEndData]];
+            }
+        } else if (!self.closingDelimiterRead) {
+            self.closingDelimiterRead = YES;
+            [self.segments addObject:[self closingDelimiterData]];
+        } else {
+            return NO;
+        }
+    }
+    
+    id segment = self.segments.firstObject;
+    [self.segments removeObjectAtIndex:0];
+    if ([segment isKindOfClass:[NSData class]]) {
+        self.currentData = segment;
+        self.currentDataOffset = 0;
+    } else {
+        self.currentPart = segment;
+        self.currentPartBytesRead = 0;
+        if (self.currentPart.inputStream.streamStatus == NSStreamStatusNotOpen) {
+            [self.currentPart.inputStream open];
+        }
+    }
+    return YES;
+}
+
+- (NSInteger)failWithError:(NSError *)error
+{
+    CMISLogError(@"Could not read multipart body: %@", error);
+    self.error = error;
+    self.status = NSStreamStatusError;
+    return -1;
+}
+
+#pragma mark NSInputStream methods
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)length
+{
+    if (self.status == NSStreamStatusAtEnd) {
+        return 0;
+    } else if (self.status != NSStreamStatusOpen) {
+        return -1;
+    }
+    
+    NSUInteger totalBytesRead = 0;
+    while (totalBytesRead < length) {
+        if (self.currentData) {
+            NSUInteger bytesToCopy = MIN(length - totalBytesRead, self.currentData.length - self.currentDataOffset);
+            [self.currentData getBytes:buffer + totalBytesRead range:NSMakeRange(self.currentDataOffset, bytesToCopy)];
+            self.currentDataOffset += bytesToCopy;
+            totalBytesRead += bytesToCopy;
+            if (self.currentDataOffset == self.currentData.length) {
+                self.currentData = nil;
+            }
+        } else if (self.currentPart) {
+            CMISMultipartFormDataPart *part = self.currentPart;
+            NSInteger bytesRead = [part.inputStream read:buffer + totalBytesRead maxLength:length - totalBytesRead];
+            if (bytesRead < 0) {
+                NSError *streamError = part.inputStream.streamError;
+                return [self failWithError:(streamError ? [CMISErrors cmisError:streamError cmisErrorCode:kCMISErrorCodeStorage]
+                                                        : [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage detailedDescription:@"Could not read content stream"])];
+            }
+            
+            self.currentPartBytesRead += bytesRead;
+            totalBytesRead += bytesRead;
+            // the announced length of the body has to be kept, whatever the content stream provides
+            if ((part.length >= 0 && self.currentPartBytesRead > (unsigned long long)part.length) ||
+                (bytesRead == 0 && part.length >= 0 && self.currentPartBytesRead != (unsigned long long)part.length)) {
+                return [self failWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                                           detailedDescription:@"Content stream length does not match the expected length"]];
+            }
+            if (bytesRead == 0) {
+                [part.inputStream close];
+                self.currentPart = nil;
+            }
+        } else if (![self loadNextSegment]) {
+            self.status = NSStreamStatusAtEnd;
+            break;
+        }
+    }
+    return totalBytesRead;
+}
+
+- (BOOL)getBuffer:(uint8_t **)buffer length:(NSUInteger *)length
+{
+    return NO;
+}
+
+- (BOOL)hasBytesAvailable
+{
+    return self.status == NSStreamStatusOpen;
+}
+
+#pragma mark NSStream methods
+
+- (void)open
+{
+    if (self.status == NSStreamStatusNotOpen) {
+        self.status = NSStreamStatusOpen;
+    }
+}
+
+- (void)close
+{
+    for (CMISMultipartFormDataPart *part in self.parts) {
+        [part.inputStream close];
+    }
+    self.currentData = nil;
+    self.currentPart = nil;
+    [self.segments removeAllObjects];
+    if (self.status != NSStreamStatusError) {
+        self.status = NSStreamStatusClosed;
+    }
+}
+
+- (id<NSStreamDelegate>)delegate
+{
+    return _delegate;
+}
+
+- (void)setDelegate:(id<NSStreamDelegate>)delegate
+{
+    _delegate = delegate;
+}
+
+- (NSStreamStatus)streamStatus
+{
+    return self.status;
+}
+
+- (NSError *)streamError
+{
+    return self.error;
+}
+
+- (void)scheduleInRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+    // only read synchronously
+}
+
+- (void)removeFromRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+}
+
+- (id)propertyForKey:(NSString *)key
+{
+    return nil;
+}
+
+- (BOOL)setProperty:(id)property forKey:(NSString *)key
+{
+    return NO;
+}
+
+@end
@@ -77,40 +77,65 @@
 }
 
 
-- (void)internalConvertObject:(NSArray *)objectDatas position:(NSInteger)position completionBlock:(void (^)(NSMutableArray *objects, NSError *error))completionBlock
+- (void)internalConvertObjects:(NSArray *)objectDatas position:(NSUInteger)position convertedObjects:(NSMutableArray *)objects completionBlock:(void (^)(NSArray *objects, NSError *error))completionBlock
 {
-    [self convertObject:[objectDatas objectAtIndex:position]
-        completionBlock:^(CMISObject *object, NSError *error) {
-            if(error){
-                completionBlock(nil, error);
-            } else {
-                if (position == 0) {
-                    NSMutableArray *objects = [[NSMutableArray alloc] initWithCapacity:objectDatas.count];
-                    if (object != nil) {
-                        [objects addObject:object];
-                    }
-                    completionBlock(objects, error);
-                } else {
-                    [self internalConvertObject:objectDatas position:(position - 1) completionBlock:^(NSMutableArray *objects, NSError *error) {
-                        if (object != nil) {
-                            [objects addObject:object];
-                        }
-                        completionBlock(objects, error);
-                    }];
+    for (; position < objectDatas.count; position++) {
+        __block BOOL completed = NO;
+        __block BOOL returned = NO;
+        __block NSError *conversionError = nil;
+        [self convertObject:[objectDatas objectAtIndex:position]
+            completionBlock:^(CMISObject *object, NSError *error) {
+                if (object != nil && error == nil) {
+                    [objects addObject:object];
                 }
-            }
-        }];
+                if (!returned) {
+                    completed = YES;
+                    conversionError = error;
+                } else if (error) {
+                    completionBlock(nil, error);
+                } else { // the conversion has waited for its type definition, continue with the next object
+                    [self internalConvertObjects:objectDatas position:(position + 1) convertedObjects:objects completionBlock:completionBlock];
+                }
+            }];
+        returned = YES;
+        
+        if (!completed) {
+            return;
+        } else if (conversionError) {
+            completionBlock(nil, conversionError);
+            return;
+        }
+    }
+    completionBlock(objects, nil);
 }
 
 
 - (void)convertObjects:(NSArray *)objectDatas completionBlock:(void (^)(NSArray *objects, NSError *error))completionBlock
 {
     if (objectDatas.count > 0) {
-        [self internalConvertObject:objectDatas
-                           position:(objectDatas.count - 1) // start recursion with last item
-                    completionBlock:^(NSMutableArray *objects, NSError *error) {
-                        completionBlock(objects, error);
-                    }];
+        // retrieve the type definitions of all objects at once, instead of one at a time while converting them
+        NSMutableOrderedSet *typeIds = [NSMutableOrderedSet orderedSet];
+        for (CMISObjectData *objectData in objectDatas) {
+            id objectTypeId = [objectData.properties propertyValueForId:kCMISPropertyObjectTypeId];
+            if ([objectTypeId isKindOfClass:[NSString class]]) {
+                [typeIds addObject:objectTypeId];
+            }
+            
+            for (id secondaryTypeId in [objectData.properties propertyMultiValueById:kCMISPropertySecondaryObjectTypeIds]) {
+                if ([secondaryTypeId isKindOfClass:[NSString class]]) {
+                    [typeIds addObject:secondaryTypeId];
+                }
+            }
+        }
+        
+        [self retrieveTypeDefinitions:typeIds.array
+                      completionBlock:^(NSArray *typeDefinitions, NSError *error) {
+                          // errors are reported by the conversion of the object the type definition is needed for
+                          [self internalConvertObjects:objectDatas
+                                              position:0
+                                      convertedObjects:[[NSMutableArray alloc] initWithCapacity:objectDatas.count]
+                                       completionBlock:completionBlock];
+                      }];
     } else {
         completionBlock([[NSArray alloc] init], nil);
     }
@@ -456,37 +481,44 @@
     }
 }
 
-- (void)retrieveTypeDefinitions:(NSArray *)objectTypeIds position:(NSInteger)position completionBlock:(void (^)(NSMutableArray *typeDefinitions, NSError *error))completionBlock
+- (void)retrieveTypeDefinitions:(NSArray *)objectTypeIds completionBlock:(void (^)(NSArray *typeDefinitions, NSError *error))completionBlock
 {
-    [self.session retrieveTypeDefinition:[objectTypeIds objectAtIndex:position]
-                         completionBlock:^(CMISTypeDefinition *typeDefinition, NSError *error) {
-            if(error){
-                completionBlock(nil, error);
-            } else {
-                if (position == 0) {
-                    NSMutableArray *typeDefinitions = [[NSMutableArray alloc] initWithCapacity:objectTypeIds.count];
-                    [typeDefinitions addObject:typeDefinition];
-                    completionBlock(typeDefinitions, error);
+    if (objectTypeIds.count == 0) {
+        completionBlock([[NSArray alloc] init], nil);
+        return;
+    }
+    
+    // retrieve all type definitions at the same time, each distinct type id once
+    NSOrderedSet *distinctTypeIds = [NSOrderedSet orderedSetWithArray:objectTypeIds];
+    NSMutableDictionary *typeDefinitionsById = [[NSMutableDictionary alloc] initWithCapacity:distinctTypeIds.count];
+    __block NSUInteger pendingCount = distinctTypeIds.count;
+    __block NSError *firstError = nil;
+    for (NSString *objectTypeId in distinctTypeIds) {
+        [self.session retrieveTypeDefinition:objectTypeId
+                             completionBlock:^(CMISTypeDefinition *typeDefinition, NSError *error) {
+            if (error) {
+                if (!firstError) {
+                    firstError = error;
+                }
+            } else if (typeDefinition) {
+                typeDefinitionsById[objectTypeId] = typeDefinition;
+            }
+            
+            if (--pendingCount == 0) {
+                if (firstError) {
+                    completionBlock(nil, firstError);
                 } else {
-                    [self retrieveTypeDefinitions:objectTypeIds position:(position - 1) completionBlock:^(NSMutableArray *typeDefinitions, NSError *error) {
-                        [typeDefinitions addObject:typeDefinition];
-                        completionBlock(typeDefinitions, error);
-                    }];
+                    NSMutableArray *typeDefinitions = [[NSMutableArray alloc] initWithCapacity:objectTypeIds.count];
+                    for (NSString *typeId in objectTypeIds) {
+                        CMISTypeDefinition *typeDefinition = typeDefinitionsById[typeId];
+                        if (typeDefinition) {
+                            [typeDefinitions addObject:typeDefinition];
+                        }
+                    }
+                    completionBlock(typeDefinitions, nil);
                 }
             }
         }];
-}
-
-- (void)retrieveTypeDefinitions:(NSArray *)objectTypeIds completionBlock:(void (^)(NSArray *typeDefinitions, NSError *error))completionBlock
-{
-    if (objectTypeIds.count > 0) {
-        [self retrieveTypeDefinitions:objectTypeIds
-                           position:(objectTypeIds.count - 1) // start recursion with last item
-                    completionBlock:^(NSMutableArray *typeDefinitions, NSError *error) {
-                        completionBlock(typeDefinitions, error);
-                    }];
-    } else {
-        completionBlock([[NSArray alloc] init], nil);
     }
 }
 
@@ -0,0 +1,80 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CMISRequest.h"
+#import "CMISObjectService.h"
+
+@class CMISContentHasher;
+
+/**
+ * Downloads a content stream to a file using several concurrent range requests.
+ *
+ * The content is split into byte ranges of about the same size which are written into their place in a file of the
+ * final size. The first range is requested alone. As soon as its response headers have arrived, the remaining ranges
+ * are requested at the same time if the server answered with the requested range; if it sends the whole content
+ * instead, that content is used as is and no further requests are made.
+ * Every range must have the total length and ETag of the first one, so all ranges come from the same content. The file
+ * is moved to the requested path once all ranges have been received with their expected length.
+ */
+@interface CMISParallelDownload : NSObject <CMISCancellableRequest>
+
+/// the length of the content stream
+@property (nonatomic, assign, readonly) unsigned long long contentLength;
+
+/// NO if the server ignored the range request and sent the whole content instead
+@property (nonatomic, assign, readonly) BOOL rangesSupported;
+
+/// if set, the assembled file is hashed before it is moved and the hash is set as contentHash of the request handle
+@property (nonatomic, strong) CMISContentHasher *contentHasher;
+
+/**
+ * Splits content of the given length into ranges of about the same size.
+ * Returns an array of ranges, each range being an array of two NSNumbers: the offset and the length of the range.
+ */
++ (NSArray *)rangesForContentLength:(unsigned long long)contentLength rangeCount:(NSUInteger)rangeCount;
+
+/**
+ * Initialises the download.
+ * @param objectService the object service used to request the ranges
+ * @param objectId the id of the object to download the content of
+ * @param streamId the id of the rendition to download or nil for the content stream
+ * @param contentLength the length of the content stream
+ * @param rangeCount the number of ranges to split the content into
+ */
+- (id)initWithObjectService:(id<CMISObjectService>)objectService
+                   objectId:(NSString *)objectId
+                   streamId:(NSString *)streamId
+              contentLength:(unsigned long long)contentLength
+                 rangeCount:(NSUInteger)rangeCount;
+
+/**
+ * Downloads the content to the given file path, replacing an existing file only once all data has been received.
+ * Must be called on a thread with a run loop, all blocks are called on that thread.
+ * @param cmisRequest the request handle of the caller, cancelling it cancels all range requests
+ * @param completionBlock called with nil if the content has been downloaded successfully
+ * @param progressBlock called with the number of bytes received for all ranges
+ */
+- (void)downloadToFile:(NSString *)filePath
+           cmisRequest:(CMISRequest *)cmisRequest
+       completionBlock:(void (^)(NSError *error))completionBlock
+         progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock;
+
+@end
@@ -0,0 +1,415 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISParallelDownload.h"
+#import "CMISFileRangeOutputStream.h"
+#import "CMISHttpDownloadRequest.h"
+#import "CMISHttpResponse.h"
+#import "CMISContentHasher.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+// extension of the file the ranges are written to before it is moved to the requested file path
+#define RANGES_FILE_EXTENSION @"cmisranges"
+
+@interface CMISParallelDownload ()
+
+@property (nonatomic, strong) id<CMISObjectService> objectService;
+@property (nonatomic, strong) NSString *objectId;
+@property (nonatomic, strong) NSString *streamId;
+@property (nonatomic, assign, readwrite) unsigned long long contentLength;
+@property (nonatomic, assign, readwrite) BOOL rangesSupported;
+@property (nonatomic, assign) NSUInteger rangeCount;
+@property (nonatomic, strong) NSArray *ranges;
+@property (nonatomic, strong) NSString *filePath;
+@property (nonatomic, strong) NSString *temporaryFilePath;
+@property (nonatomic, assign) int fileDescriptor;
+@property (nonatomic, weak) CMISRequest *cmisRequest;
+@property (nonatomic, weak) NSThread *originalThread;
+@property (nonatomic, strong) NSMutableDictionary *rangeRequests; // CMISRequest per index of a started range
+@property (nonatomic, assign) BOOL remainingRangesStarted;
+@property (nonatomic, strong) NSString *entityTag; // ETag of the first range
+@property (nonatomic, strong) NSMutableArray *rangeProgress; // bytes downloaded per range
+@property (nonatomic, assign) unsigned long long bytesDownloaded;
+@property (nonatomic, assign) NSUInteger pendingRanges;
+@property (nonatomic, assign) BOOL finished;
+@property (nonatomic, copy) void (^completionBlock)(NSError *error);
+@property (nonatomic, copy) void (^progressBlock)(unsigned long long bytesDownloaded, unsigned long long bytesTotal);
+
+@end
+
+
+@implementation CMISParallelDownload
+
++ (NSArray *)rangesForContentLength:(unsigned long long)contentLength rangeCount:(NSUInteger)rangeCount
+{
+    rangeCount = (NSUInteger)MIN(MAX(rangeCount, 1), MAX(contentLength, 1));
+    
+    NSMutableArray *ranges = [NSMutableArray arrayWithCapacity:rangeCount];
+    unsigned long long rangeLength = contentLength / rangeCount;
+    unsigned long long remainder = contentLength % rangeCount;
+    unsigned long long offset = 0;
+    for (NSUInteger i = 0; i < rangeCount; i++) {
+        // the first ranges take one byte more if the content does not split evenly
+        unsigned long long length = rangeLength + (i < remainder ? 1 : 0);
+        [ranges addObject:@[@(offset), @(length)]];
+        offset += length;
+    }
+    return ranges;
+}
+
+- (id)initWithObjectService:(id<CMISObjectService>)objectService
+                   objectId:(NSString *)objectId
+                   streamId:(NSString *)streamId
+              contentLength:(unsigned long long)contentLength
+                 rangeCount:(NSUInteger)rangeCount
+{
+    self = [super init];
+    if (self) {
+        _objectService = objectService;
+        _objectId = objectId;
+        _streamId = streamId;
+        _contentLength = contentLength;
+        _rangeCount = rangeCount;
+        _rangesSupported = YES;
+        _fileDescriptor = -1;
+    }
+    return self;
+}
+
+- (void)downloadToFile:(NSString *)filePath
+           cmisRequest:(CMISRequest *)cmisRequest
+       completionBlock:(void (^)(NSError *error))completionBlock
+         progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
+{
+    if (cmisRequest.isCancelled) {
+        if (completionBlock) {
+            completionBlock([CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                            detailedDescription:@"Request was cancelled"]);
+        }
+        return;
+    }
+    
+    self.filePath = filePath;
+    self.temporaryFilePath = [filePath stringByAppendingPathExtension:RANGES_FILE_EXTENSION];
+    self.cmisRequest = cmisRequest;
+    self.originalThread = [NSThread currentThread];
+    self.completionBlock = completionBlock;
+    self.progressBlock = progressBlock;
+    
+    // the file gets its final size up front, the ranges are written into their place as they arrive
+    self.fileDescriptor = open(self.temporaryFilePath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (self.fileDescriptor < 0 || ftruncate(self.fileDescriptor, (off_t)self.contentLength) != 0) {
+        [self finishWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                              detailedDescription:[NSString stringWithFormat:@"Could not create file %@", self.temporaryFilePath]]];
+        return;
+    }
+    
+    self.ranges = [CMISParallelDownload rangesForContentLength:self.contentLength rangeCount:self.rangeCount];
+    self.rangeRequests = [NSMutableDictionary dictionaryWithCapacity:self.ranges.count];
+    self.rangeProgress = [NSMutableArray arrayWithCapacity:self.ranges.count];
+    for (NSUInteger i = 0; i < self.ranges.count; i++) {
+        [self.rangeProgress addObject:@0];
+    }
+    
+    cmisRequest.httpRequest = self;
+    
+    // the response to the first range tells whether the server honours range requests, the others start once it arrives
+    [self startRangeAtIndex:0];
+}
+
+#pragma mark CMISCancellableRequest method
+
+- (void)cancel
+{
+    [self finishWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                          detailedDescription:@"Request was cancelled"]];
+}
+
+#pragma mark Private methods
+
+- (void)startRangeAtIndex:(NSUInteger)index
+{
+    NSArray *range = [self.ranges objectAtIndex:index];
+    unsigned long long offset = [[range objectAtIndex:0] unsignedLongLongValue];
+    unsigned long long length = [[range objectAtIndex:1] unsignedLongLongValue];
+    
+    // the first range accepts the whole content, in case the server does not honour the range
+    CMISFileRangeOutputStream *outputStream = [[CMISFileRangeOutputStream alloc] initWithFileDescriptor:self.fileDescriptor
+                                                                                                offset:offset
+                                                                                         maximumLength:(index == 0 ? 0 : length)];
+    @synchronized(self) {
+        if (self.finished) {
+            return;
+        }
+        self.pendingRanges++;
+    }
+    
+    CMISRequest *rangeRequest = [self.objectService downloadContentOfObject:self.objectId
+                                                                   streamId:self.streamId
+                                                             toOutputStream:outputStream
+                                                                     offset:[NSDecimalNumber decimalNumberWithMantissa:offset exponent:0 isNegative:NO]
+                                                                     length:[NSDecimalNumber decimalNumberWithMantissa:length exponent:0 isNegative:NO]
+                                                            completionBlock:^(NSError *error) {
+                                                                [self rangeAtIndex:index didCompleteWithOutputStream:outputStream error:error];
+                                                            } progressBlock:^(unsigned long long bytesDownloaded, unsigned long long bytesTotal) {
+                                                                [self rangeAtIndex:index didDownloadBytes:bytesDownloaded];
+                                                            }];
+    if (rangeRequest) {
+        @synchronized(self) {
+            [self.rangeRequests setObject:rangeRequest forKey:@(index)];
+        }
+    }
+}
+
+- (void)rangeAtIndex:(NSUInteger)index didDownloadBytes:(unsigned long long)bytesDownloaded
+{
+    unsigned long long previousBytesDownloaded = [[self.rangeProgress objectAtIndex:index] unsignedLongLongValue];
+    [self.rangeProgress replaceObjectAtIndex:index withObject:@(bytesDownloaded)];
+    self.bytesDownloaded = self.bytesDownloaded + bytesDownloaded - previousBytesDownloaded;
+    
+    if (self.progressBlock && !self.finished) {
+        self.progressBlock(self.bytesDownloaded, self.contentLength);
+    }
+    
+    if (index == 0) {
+        [self checkFirstResponse];
+    }
+}
+
+- (void)rangeAtIndex:(NSUInteger)index didCompleteWithOutputStream:(CMISFileRangeOutputStream *)outputStream error:(NSError *)error
+{
+    BOOL finished;
+    @synchronized(self) {
+        self.pendingRanges--;
+        finished = self.finished;
+    }
+    if (finished) {
+        [self closeFileIfIdle];
+        return;
+    }
+    
+    if (error) {
+        [self finishWithError:error];
+        return;
+    }
+    
+    if (index == 0) {
+        [self checkFirstResponse];
+        if (self.finished) {
+            return;
+        }
+    }
+    
+    unsigned long long expectedLength = [[[self.ranges objectAtIndex:index] objectAtIndex:1] unsignedLongLongValue];
+    if (!self.rangesSupported) {
+        expectedLength = self.contentLength;
+    } else if (index == 0 && !self.remainingRangesStarted && self.ranges.count > 1) {
+        // without access to the response headers, the length of the first range tells whether the server honoured it
+        if (outputStream.bytesWritten == self.contentLength) {
+            CMISLogDebug(@"Server ignored range request for object %@, downloaded whole content", self.objectId);
+            self.rangesSupported = NO;
+            [self finishWithError:nil];
+            return;
+        } else if (outputStream.bytesWritten == expectedLength) {
+            [self startRemainingRanges];
+            return;
+        }
+    } else if (index > 0) {
+        NSHTTPURLResponse *response = [self responseOfRangeAtIndex:index];
+        NSError *responseError = response ? [self errorForResponse:response ofRangeAtIndex:index] : nil;
+        if (responseError) {
+            [self finishWithError:responseError];
+            return;
+        }
+    }
+    
+    if (outputStream.bytesWritten != expectedLength) {
+        NSString *detailedDescription = [NSString stringWithFormat:@"Received %llu bytes for range %lu instead of %llu",
+                                         outputStream.bytesWritten, (unsigned long)index, expectedLength];
+        [self finishWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection detailedDescription:detailedDescription]];
+    } else if (self.pendingRanges == 0) {
+        [self finishWithError:nil];
+    }
+}
+
+/// decides from the response to the first range whether the remaining ranges are requested
+- (void)checkFirstResponse
+{
+    if (self.remainingRangesStarted || !self.rangesSupported || self.finished || self.ranges.count < 2) {
+        return;
+    }
+    
+    NSHTTPURLResponse *response = [self responseOfRangeAtIndex:0];
+    if (response == nil) {
+        return; // decided by the length of the first range once it has completed
+    }
+    
+    if (response.statusCode != 206) {
+        CMISLogDebug(@"Server ignored range request for object %@, downloading whole content", self.objectId);
+        self.rangesSupported = NO;
+        return;
+    }
+    
+    NSError *error = [self errorForResponse:response ofRangeAtIndex:0];
+    if (error) {
+        [self finishWithError:error];
+    } else {
+        [self startRemainingRanges];
+    }
+}
+
+- (void)startRemainingRanges
+{
+    self.remainingRangesStarted = YES;
+    for (NSUInteger i = 1; i < self.ranges.count; i++) {
+        [self startRangeAtIndex:i];
+    }
+}
+
+/// returns the response headers received for a range, or nil if they are not known (yet)
+- (NSHTTPURLResponse *)responseOfRangeAtIndex:(NSUInteger)index
+{
+    CMISRequest *rangeRequest = nil;
+    @synchronized(self) {
+        rangeRequest = [self.rangeRequests objectForKey:@(index)];
+    }
+    id httpRequest = rangeRequest.httpRequest;
+    return [httpRequest isKindOfClass:[CMISHttpRequest class]] ? [httpRequest response] : nil;
+}
+
+/// checks that a response contains the requested range of the same version of the content as the first range
+- (NSError *)errorForResponse:(NSHTTPURLResponse *)response ofRangeAtIndex:(NSUInteger)index
+{
+    unsigned long long offset = [[[self.ranges objectAtIndex:index] objectAtIndex:0] unsignedLongLongValue];
+    NSString *contentRange = [CMISHttpResponse valueForHeader:@"Content-Range" headers:response.allHeaderFields];
+    unsigned long long firstBytePosition = 0;
+    unsigned long long totalLength = 0;
+    if (response.statusCode != 206 ||
+        ![CMISHttpDownloadRequest parseContentRange:contentRange firstBytePosition:&firstBytePosition totalLength:&totalLength] ||
+        firstBytePosition != offset || (totalLength != 0 && totalLength != self.contentLength)) {
+        return [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection
+                               detailedDescription:[NSString stringWithFormat:@"Unexpected content range %@ for range %lu of %llu bytes",
+                                                    contentRange, (unsigned long)index, self.contentLength]];
+    }
+    
+    NSString *entityTag = [CMISHttpResponse valueForHeader:@"ETag" headers:response.allHeaderFields];
+    if (index == 0) {
+        self.entityTag = entityTag;
+    } else if (self.entityTag && entityTag && ![entityTag isEqualToString:self.entityTag]) {
+        return [CMISErrors createCMISErrorWithCode:kCMISErrorCodeConnection
+                               detailedDescription:[NSString stringWithFormat:@"Content of object %@ changed while its ranges were downloaded", self.objectId]];
+    }
+    return nil;
+}
+
+/// closes the file once no range request can write to it anymore
+- (void)closeFileIfIdle
+{
+    @synchronized(self) {
+        if (self.pendingRanges == 0 && self.fileDescriptor >= 0) {
+            close(self.fileDescriptor);
+            self.fileDescriptor = -1;
+        }
+    }
+}
+
+- (void)finishWithError:(NSError *)error
+{
+    NSArray *rangeRequests = nil;
+    @synchronized(self) {
+        if (self.finished) {
+            return;
+        }
+        self.finished = YES;
+        rangeRequests = self.rangeRequests.allValues;
+        self.rangeRequests = nil;
+    }
+    
+    if (error) {
+        for (CMISRequest *rangeRequest in rangeRequests) {
+            [rangeRequest cancel];
+        }
+    }
+    
+    // cancelled range requests may still write to the file until they complete, it is closed once they are done
+    [self closeFileIfIdle];
+    
+    if (error || self.contentHasher == nil) {
+        [self completeWithError:error];
+        return;
+    }
+    
+    // the ranges arrive out of order, so the assembled file is hashed once it is complete, off the calling thread
+    CMISContentHasher *contentHasher = self.contentHasher;
+    NSString *temporaryFilePath = self.temporaryFilePath;
+    unsigned long long contentLength = self.contentLength;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        NSString *contentHash = nil;
+        if ([contentHasher updateWithContentsOfFile:temporaryFilePath length:contentLength]) {
+            contentHash = [contentHasher finish];
+        }
+        NSThread *originalThread = self.originalThread ?: [NSThread mainThread];
+        [self performSelector:@selector(completeWithContentHash:) onThread:originalThread withObject:contentHash waitUntilDone:NO];
+    });
+}
+
+- (void)completeWithContentHash:(NSString *)contentHash
+{
+    CMISRequest *cmisRequest = self.cmisRequest;
+    if (cmisRequest.isCancelled) {
+        [self completeWithError:[CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                                detailedDescription:@"Request was cancelled"]];
+        return;
+    }
+    
+    if (contentHash == nil) {
+        CMISLogWarning(@"Could not hash downloaded content of object %@", self.objectId);
+    }
+    cmisRequest.contentHash = contentHash;
+    [self completeWithError:nil];
+}
+
+/// moves the file to the requested path if there is no error and calls the completion block
+- (void)completeWithError:(NSError *)error
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    if (!error) {
+        [fileManager removeItemAtPath:self.filePath error:nil];
+        if (![fileManager moveItemAtPath:self.temporaryFilePath toPath:self.filePath error:nil]) {
+            error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                    detailedDescription:[NSString stringWithFormat:@"Could not move downloaded file to %@", self.filePath]];
+        }
+    }
+    if (error) {
+        [fileManager removeItemAtPath:self.temporaryFilePath error:nil];
+    }
+    
+    void (^completionBlock)(NSError *error) = self.completionBlock;
+    self.completionBlock = nil;
+    self.progressBlock = nil;
+    if (completionBlock) {
+        completionBlock(error);
+    }
+}
+
+@end
@@ -0,0 +1,70 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import "CMISEnums.h"
+
+@class CMISRequest;
+@class CMISHttpResponse;
+@class CMISBindingSession;
+
+/**
+ * Shares a single in-flight request among all callers issuing an identical idempotent request at the same time.
+ *
+ * The first caller starts the shared request, callers arriving while it is running are attached to it and receive
+ * the same response. The shared request runs with the highest priority of the attached callers. Cancellation is reference counted: cancelling one caller only detaches that caller, the shared
+ * request is cancelled once all attached callers have cancelled.
+ */
+@interface CMISRequestCoalescer : NSObject
+
+/**
+ * Builds the key identifying identical requests, made of the URL, the identity of the authenticated user and the
+ * additional request headers.
+ */
++ (NSString *)keyForUrl:(NSURL *)url session:(CMISBindingSession *)session headers:(NSDictionary *)additionalHeaders;
+
+/**
+ * Attaches the caller to the in-flight request with the given key or starts a new one.
+ * The start block is only called if there is no in-flight request for the key. It must start the request using the
+ * provided shared CMISRequest (used to cancel the request once all callers have cancelled) and call the provided
+ * completion block exactly once.
+ * The completion block of each caller is called on the thread the caller invoked this method from.
+ * If the caller has a higher priority than the in-flight request, the priority of the shared CMISRequest is raised,
+ * which moves the request to another queue of the scheduler if it has not been started yet.
+ * @param key the key identifying the request, see keyForUrl:session:headers:
+ * @param priority the priority of the caller, CMISRequestPriorityDefault is treated as interactive
+ * @param cmisRequest the request handle of the caller
+ * @param completionBlock the completion block of the caller
+ * @param startBlock starts the shared request
+ */
+- (void)invokeRequestWithKey:(NSString *)key
+                    priority:(CMISRequestPriority)priority
+                 cmisRequest:(CMISRequest *)cmisRequest
+             completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+                  startBlock:(void (^)(CMISRequest *sharedRequest, void (^sharedCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)))startBlock;
+
+/// @name Statistics
+
+/// the number of shared requests currently in flight
+- (NSUInteger)inFlightRequestCount;
+
+/// the number of callers that were attached to an already running request instead of starting their own
+- (NSUInteger)coalescedRequestCount;
+
+@end
@@ -0,0 +1,279 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import "CMISRequestCoalescer.h"
+#import "CMISRequest.h"
+#import "CMISHttpResponse.h"
+#import "CMISBindingSession.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+
+@class CMISInFlightRequest;
+
+/**
+ A caller attached to an in-flight request. It is set as the http request of the caller's CMISRequest, so
+ cancelling the CMISRequest detaches the caller from the shared request.
+ */
+@interface CMISCoalescedRequest : NSObject <CMISCancellableRequest>
+
+@property (nonatomic, weak) CMISRequestCoalescer *coalescer;
+@property (nonatomic, strong) CMISInFlightRequest *inFlightRequest;
+@property (nonatomic, strong) NSThread *thread;
+@property (nonatomic, copy) void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error);
+@property (nonatomic, strong) CMISHttpResponse *response;
+@property (nonatomic, strong) NSError *error;
+
+- (void)deliverResponse:(CMISHttpResponse *)httpResponse error:(NSError *)error;
+
+@end
+
+/**
+ The shared request together with the callers waiting for its response.
+ */
+@interface CMISInFlightRequest : NSObject
+
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, strong) CMISRequest *sharedRequest;
+@property (nonatomic, strong) NSMutableArray *callers;
+
+@end
+
+
+@interface CMISRequestCoalescer ()
+{
+    NSUInteger _coalescedRequestCount;
+}
+
+@property (nonatomic, strong) NSMutableDictionary *inFlightRequests;
+
+- (void)cancelCoalescedRequest:(CMISCoalescedRequest *)coalescedRequest;
+
+@end
+
+
+@implementation CMISRequestCoalescer
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _inFlightRequests = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
++ (NSString *)keyForUrl:(NSURL *)url session:(CMISBindingSession *)session headers:(NSDictionary *)additionalHeaders
+{
+    // the authentication provider holds the credentials, so it identifies the user together with the username
+    NSMutableString *key = [NSMutableString stringWithFormat:@"%@|%@|%p",
+                            url.absoluteString, session.username ? session.username : @"", session.authenticationProvider];
+    
+    NSArray *headerNames = [additionalHeaders.allKeys sortedArrayUsingSelector:@selector(caseInsensitiveCompare:)];
+    for (NSString *headerName in headerNames) {
+        [key appendFormat:@"|%@:%@", headerName.lowercaseString, [additionalHeaders objectForKey:headerName]];
+    }
+    
+    return key;
+}
+
+- (void)invokeRequestWithKey:(NSString *)key
+                    priority:(CMISRequestPriority)priority
+                 cmisRequest:(CMISRequest *)cmisRequest
+             completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+                  startBlock:(void (^)(CMISRequest *sharedRequest, void (^sharedCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)))startBlock
+{
+    if (cmisRequest.isCancelled) {
+        if (completionBlock) {
+            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                                 detailedDescription:@"Request was cancelled"]);
+        }
+        return;
+    }
+    
+    CMISCoalescedRequest *coalescedRequest = [[CMISCoalescedRequest alloc] init];
+    coalescedRequest.coalescer = self;
+    coalescedRequest.thread = [NSThread currentThread];
+    coalescedRequest.completionBlock = completionBlock;
+    
+    CMISInFlightRequest *inFlightRequest = nil;
+    BOOL startRequest = NO;
+    BOOL raisePriority = NO;
+    @synchronized(self) {
+        inFlightRequest = [self.inFlightRequests objectForKey:key];
+        if (inFlightRequest == nil) {
+            inFlightRequest = [[CMISInFlightRequest alloc] init];
+            inFlightRequest.key = key;
+            inFlightRequest.sharedRequest = [[CMISRequest alloc] init];
+            inFlightRequest.sharedRequest.priority = priority;
+            [self.inFlightRequests setObject:inFlightRequest forKey:key];
+            startRequest = YES;
+        } else {
+            _coalescedRequestCount++;
+            raisePriority = [CMISRequestCoalescer rankOfPriority:priority] < [CMISRequestCoalescer rankOfPriority:inFlightRequest.sharedRequest.priority];
+        }
+        coalescedRequest.inFlightRequest = inFlightRequest;
+        [inFlightRequest.callers addObject:coalescedRequest];
+    }
+    
+    // cancelling the caller's request only detaches the caller
+    cmisRequest.httpRequest = coalescedRequest;
+    
+    if (raisePriority) {
+        // a caller waiting for the response must not be held back by the lower priority of an earlier caller
+        CMISLogDebug(@"Raising priority of in-flight request %@", key);
+        inFlightRequest.sharedRequest.priority = priority;
+    }
+    
+    if (startRequest) {
+        startBlock(inFlightRequest.sharedRequest, ^(CMISHttpResponse *httpResponse, NSError *error) {
+            [self inFlightRequest:inFlightRequest didCompleteWithResponse:httpResponse error:error];
+        });
+    } else {
+        CMISLogDebug(@"Attached request to in-flight request %@", key);
+    }
+}
+
+#pragma mark Statistics
+
+- (NSUInteger)inFlightRequestCount
+{
+    @synchronized(self) {
+        return self.inFlightRequests.count;
+    }
+}
+
+- (NSUInteger)coalescedRequestCount
+{
+    @synchronized(self) {
+        return _coalescedRequestCount;
+    }
+}
+
+#pragma mark Private methods
+
+/// orders the priorities, a lower rank is served first
++ (NSUInteger)rankOfPriority:(CMISRequestPriority)priority
+{
+    switch (priority) {
+        case CMISRequestPriorityBackground:
+            return 1;
+        case CMISRequestPriorityBulk:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+- (void)inFlightRequest:(CMISInFlightRequest *)inFlightRequest didCompleteWithResponse:(CMISHttpResponse *)httpResponse error:(NSError *)error
+{
+    NSArray *callers = nil;
+    @synchronized(self) {
+        // requests issued from now on must not get this response anymore
+        if ([self.inFlightRequests objectForKey:inFlightRequest.key] == inFlightRequest) {
+            [self.inFlightRequests removeObjectForKey:inFlightRequest.key];
+        }
+        callers = [inFlightRequest.callers copy];
+        [inFlightRequest.callers removeAllObjects];
+    }
+    
+    for (CMISCoalescedRequest *coalescedRequest in callers) {
+        [coalescedRequest deliverResponse:httpResponse error:error];
+    }
+}
+
+- (void)cancelCoalescedRequest:(CMISCoalescedRequest *)coalescedRequest
+{
+    CMISRequest *sharedRequest = nil;
+    @synchronized(self) {
+        CMISInFlightRequest *inFlightRequest = coalescedRequest.inFlightRequest;
+        if (![inFlightRequest.callers containsObject:coalescedRequest]) {
+            return; // the response has already been delivered
+        }
+        [inFlightRequest.callers removeObject:coalescedRequest];
+        
+        // the shared request is only cancelled once no caller is waiting for it anymore
+        if (inFlightRequest.callers.count == 0) {
+            if ([self.inFlightRequests objectForKey:inFlightRequest.key] == inFlightRequest) {
+                [self.inFlightRequests removeObjectForKey:inFlightRequest.key];
+            }
+            sharedRequest = inFlightRequest.sharedRequest;
+        }
+    }
+    
+    void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error) = coalescedRequest.completionBlock;
+    coalescedRequest.completionBlock = nil;
+    if (completionBlock) {
+        completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                             detailedDescription:@"Request was cancelled"]);
+    }
+    
+    [sharedRequest cancel];
+}
+
+@end
+
+
+@implementation CMISCoalescedRequest
+
+- (void)deliverResponse:(CMISHttpResponse *)httpResponse error:(NSError *)error
+{
+    self.response = httpResponse;
+    self.error = error;
+    
+    NSThread *thread = self.thread;
+    if (thread == nil || thread == [NSThread currentThread] || thread.isFinished) {
+        [self executeCompletionBlock];
+    } else {
+        // call the completion block on the thread the caller issued the request from
+        [self performSelector:@selector(executeCompletionBlock) onThread:thread withObject:nil waitUntilDone:NO];
+    }
+}
+
+- (void)executeCompletionBlock
+{
+    void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error) = self.completionBlock;
+    self.completionBlock = nil;
+    self.thread = nil;
+    if (completionBlock) {
+        completionBlock(self.response, self.error);
+    }
+}
+
+#pragma mark CMISCancellableRequest method
+
+- (void)cancel
+{
+    [self.coalescer cancelCoalescedRequest:self];
+}
+
+@end
+
+
+@implementation CMISInFlightRequest
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _callers = [[NSMutableArray alloc] init];
+    }
+    return self;
+}
+
+@end
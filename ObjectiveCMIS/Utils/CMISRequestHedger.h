@@ -0,0 +1,76 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+@class CMISRequest;
+@class CMISHttpResponse;
+
+/**
+ * Sends a second copy of a slow idempotent request to cut the latency tail caused by slow server nodes.
+ *
+ * The time to the first response byte is recorded per host. If a request has not received its response headers
+ * after the configured percentile of these times, a duplicate request is started. The first successful response is
+ * handed over to the caller and the other request is cancelled. The time recorded is always that of the original
+ * request; if it is cancelled before its response headers arrive, the time it has waited is recorded as a lower bound.
+ * No request is duplicated until enough samples have been recorded for a host.
+ */
+@interface CMISRequestHedger : NSObject
+
+/**
+ * Returns the delay after which a request to the given host is duplicated or -1 if not enough samples have been
+ * recorded for the host yet.
+ * @param host the host the request is sent to
+ * @param percentile the percentile (0 - 100) of the recorded times to first byte to wait for
+ * @param minimumDelay the minimum delay to return
+ */
+- (NSTimeInterval)hedgeDelayForHost:(NSString *)host percentile:(double)percentile minimumDelay:(NSTimeInterval)minimumDelay;
+
+/// Records the time it took a request to the given host to receive the response headers.
+- (void)recordTimeToFirstByte:(NSTimeInterval)timeToFirstByte forHost:(NSString *)host;
+
+/**
+ * Starts a request and duplicates it if it has not received its response headers after the hedge delay.
+ * The start block is called once for the original request and once more for the duplicate. It must start the
+ * request using the provided CMISRequest (used to cancel the request that lost) and call the provided completion
+ * block exactly once. Both calls happen on the thread this method is called from, which must run a run loop.
+ * @param host the host the request is sent to
+ * @param percentile the percentile of the recorded times to first byte after which the request is duplicated
+ * @param minimumDelay the minimum time to wait before the request is duplicated
+ * @param cmisRequest the request handle of the caller, cancelling it cancels both requests
+ * @param completionBlock called once with the first successful response or the last error
+ * @param startBlock starts a request
+ */
+- (void)invokeRequestForHost:(NSString *)host
+                  percentile:(double)percentile
+                minimumDelay:(NSTimeInterval)minimumDelay
+                 cmisRequest:(CMISRequest *)cmisRequest
+             completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+                  startBlock:(void (^)(CMISRequest *attemptRequest, void (^attemptCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)))startBlock;
+
+/// @name Statistics
+
+/// the number of duplicate requests sent
+- (NSUInteger)hedgedRequestCount;
+
+/// the number of duplicate requests that returned before the original request
+- (NSUInteger)hedgeWinCount;
+
+@end
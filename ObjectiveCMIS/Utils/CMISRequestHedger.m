@@ -0,0 +1,349 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISRequestHedger.h"
+#import "CMISRequest.h"
+#import "CMISHttpRequest.h"
+#import "CMISHttpResponse.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+
+// the number of times to first byte kept per host
+#define MAX_LATENCY_SAMPLES 100
+
+// the number of times to first byte needed before requests to a host are duplicated
+#define MIN_LATENCY_SAMPLES 20
+
+/**
+ A request that may be sent twice. It is set as the http request of the caller's CMISRequest, so cancelling
+ the CMISRequest cancels both the original and the duplicate request.
+ */
+@interface CMISHedgedRequest : NSObject <CMISCancellableRequest>
+
+@property (nonatomic, weak) CMISRequestHedger *hedger;
+@property (nonatomic, strong) NSString *host;
+@property (nonatomic, assign) CMISRequestPriority priority;
+@property (nonatomic, strong) NSMutableArray *attemptRequests; // CMISRequest objects, the original request first
+@property (nonatomic, assign) NSUInteger runningAttempts;
+@property (nonatomic, assign) BOOL finished;
+@property (nonatomic, assign) NSTimeInterval hedgeDelay;
+@property (nonatomic, strong) NSDate *originalStartDate;
+@property (nonatomic, assign) BOOL originalCompleted;
+@property (nonatomic, copy) void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error);
+@property (nonatomic, copy) void (^startBlock)(CMISRequest *attemptRequest, void (^attemptCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error));
+
+- (void)startAttempt;
+
+@end
+
+
+@interface CMISRequestHedger ()
+{
+    NSUInteger _hedgedRequestCount;
+    NSUInteger _hedgeWinCount;
+}
+
+@property (nonatomic, strong) NSMutableDictionary *samplesByHost; // NSMutableArray of NSNumber per host, oldest first
+
+- (void)hedgedRequestDidStartDuplicate:(CMISHedgedRequest *)hedgedRequest;
+- (void)hedgedRequestDidWinWithDuplicate:(CMISHedgedRequest *)hedgedRequest;
+
+@end
+
+
+@implementation CMISRequestHedger
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _samplesByHost = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (NSTimeInterval)hedgeDelayForHost:(NSString *)host percentile:(double)percentile minimumDelay:(NSTimeInterval)minimumDelay
+{
+    NSArray *sortedSamples = nil;
+    @synchronized(self) {
+        NSArray *samples = [self.samplesByHost objectForKey:(host ? host.lowercaseString : @"")];
+        if (samples.count < MIN_LATENCY_SAMPLES) {
+            return -1;
+        }
+        sortedSamples = [samples sortedArrayUsingSelector:@selector(compare:)];
+    }
+    
+    double fraction = MIN(MAX(percentile, 0), 100) / 100.0;
+    NSUInteger rank = MIN((NSUInteger)ceil(fraction * sortedSamples.count), sortedSamples.count);
+    NSUInteger index = rank > 0 ? rank - 1 : 0;
+    return MAX([[sortedSamples objectAtIndex:index] doubleValue], minimumDelay);
+}
+
+- (void)recordTimeToFirstByte:(NSTimeInterval)timeToFirstByte forHost:(NSString *)host
+{
+    if (timeToFirstByte <= 0) {
+        return;
+    }
+    
+    NSString *hostKey = host ? host.lowercaseString : @"";
+    @synchronized(self) {
+        NSMutableArray *samples = [self.samplesByHost objectForKey:hostKey];
+        if (samples == nil) {
+            samples = [[NSMutableArray alloc] initWithCapacity:MAX_LATENCY_SAMPLES];
+            [self.samplesByHost setObject:samples forKey:hostKey];
+        }
+        if (samples.count >= MAX_LATENCY_SAMPLES) {
+            [samples removeObjectAtIndex:0];
+        }
+        [samples addObject:@(timeToFirstByte)];
+    }
+}
+
+- (void)invokeRequestForHost:(NSString *)host
+                  percentile:(double)percentile
+                minimumDelay:(NSTimeInterval)minimumDelay
+                 cmisRequest:(CMISRequest *)cmisRequest
+             completionBlock:(void (^)(CMISHttpResponse *httpResponse, NSError *error))completionBlock
+                  startBlock:(void (^)(CMISRequest *attemptRequest, void (^attemptCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error)))startBlock
+{
+    if (cmisRequest.isCancelled) {
+        if (completionBlock) {
+            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                                 detailedDescription:@"Request was cancelled"]);
+        }
+        return;
+    }
+    
+    CMISHedgedRequest *hedgedRequest = [[CMISHedgedRequest alloc] init];
+    hedgedRequest.hedger = self;
+    hedgedRequest.host = host;
+    hedgedRequest.priority = cmisRequest.priority;
+    hedgedRequest.completionBlock = completionBlock;
+    hedgedRequest.startBlock = startBlock;
+    
+    cmisRequest.httpRequest = hedgedRequest;
+    
+    [hedgedRequest startAttempt];
+    
+    NSTimeInterval hedgeDelay = [self hedgeDelayForHost:host percentile:percentile minimumDelay:minimumDelay];
+    if (hedgeDelay >= 0) {
+        hedgedRequest.hedgeDelay = hedgeDelay;
+        // the timer runs on the current thread so both requests deliver their result to the same thread
+        [hedgedRequest performSelector:@selector(hedgeDelayDidElapse) withObject:nil afterDelay:hedgeDelay];
+    }
+}
+
+#pragma mark Statistics
+
+- (NSUInteger)hedgedRequestCount
+{
+    @synchronized(self) {
+        return _hedgedRequestCount;
+    }
+}
+
+- (NSUInteger)hedgeWinCount
+{
+    @synchronized(self) {
+        return _hedgeWinCount;
+    }
+}
+
+#pragma mark Private methods
+
+- (void)hedgedRequestDidStartDuplicate:(CMISHedgedRequest *)hedgedRequest
+{
+    @synchronized(self) {
+        _hedgedRequestCount++;
+    }
+}
+
+- (void)hedgedRequestDidWinWithDuplicate:(CMISHedgedRequest *)hedgedRequest
+{
+    @synchronized(self) {
+        _hedgeWinCount++;
+    }
+}
+
+@end
+
+
+@implementation CMISHedgedRequest
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _attemptRequests = [[NSMutableArray alloc] initWithCapacity:2];
+    }
+    return self;
+}
+
+- (void)startAttempt
+{
+    CMISRequest *attemptRequest = [[CMISRequest alloc] init];
+    
+    void (^startBlock)(CMISRequest *attemptRequest, void (^attemptCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error));
+    @synchronized(self) {
+        if (self.finished) {
+            return;
+        }
+        attemptRequest.priority = self.priority;
+        if (self.attemptRequests.count == 0) {
+            self.originalStartDate = [NSDate date];
+        }
+        [self.attemptRequests addObject:attemptRequest];
+        self.runningAttempts++;
+        startBlock = self.startBlock;
+    }
+    
+    startBlock(attemptRequest, ^(CMISHttpResponse *httpResponse, NSError *error) {
+        [self attemptRequest:attemptRequest didCompleteWithResponse:httpResponse error:error];
+    });
+}
+
+- (void)hedgeDelayDidElapse
+{
+    CMISRequest *originalRequest = nil;
+    @synchronized(self) {
+        if (self.finished || self.attemptRequests.count != 1) {
+            return;
+        }
+        originalRequest = self.attemptRequests.firstObject;
+    }
+    
+    // a request still waiting for a slot or already receiving its response is not duplicated
+    id httpRequest = originalRequest.httpRequest;
+    if (![httpRequest isKindOfClass:[CMISHttpRequest class]] || [httpRequest timeToFirstByte] > 0) {
+        return;
+    }
+    
+    CMISLogDebug(@"No response from host %@ yet, sending duplicate request", self.host);
+    [self.hedger hedgedRequestDidStartDuplicate:self];
+    [self startAttempt];
+}
+
+- (void)attemptRequest:(CMISRequest *)attemptRequest didCompleteWithResponse:(CMISHttpResponse *)httpResponse error:(NSError *)error
+{
+    NSArray *losingRequests = nil;
+    void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error) = nil;
+    BOOL duplicateWon = NO;
+    NSTimeInterval originalTimeToFirstByte = 0;
+    @synchronized(self) {
+        self.runningAttempts--;
+        if (self.attemptRequests.firstObject == attemptRequest) {
+            self.originalCompleted = YES;
+        }
+        if (self.finished) {
+            return;
+        }
+        
+        // a failed request waits for the other one to complete, it may still succeed
+        if (httpResponse == nil && self.runningAttempts > 0) {
+            return;
+        }
+        
+        self.finished = YES;
+        completionBlock = self.completionBlock;
+        self.completionBlock = nil;
+        self.startBlock = nil;
+        
+        NSMutableArray *otherRequests = [self.attemptRequests mutableCopy];
+        [otherRequests removeObject:attemptRequest];
+        losingRequests = otherRequests;
+        duplicateWon = httpResponse && self.attemptRequests.firstObject != attemptRequest;
+        if (duplicateWon) {
+            originalTimeToFirstByte = [self originalTimeToFirstByte];
+        }
+    }
+    
+    [NSObject cancelPreviousPerformRequestsWithTarget:self selector:@selector(hedgeDelayDidElapse) object:nil];
+    
+    // the samples describe the original requests, a duplicate only runs after the original was slow
+    if (duplicateWon) {
+        [self.hedger recordTimeToFirstByte:originalTimeToFirstByte forHost:self.host];
+        [self.hedger hedgedRequestDidWinWithDuplicate:self];
+    } else if (httpResponse) {
+        [self.hedger recordTimeToFirstByte:httpResponse.timeToFirstByte forHost:self.host];
+    }
+    
+    for (CMISRequest *losingRequest in losingRequests) {
+        [losingRequest cancel];
+    }
+    
+    if (completionBlock) {
+        completionBlock(httpResponse, error);
+    }
+}
+
+/// returns the time to first byte of the original request, or a lower bound if it is about to be cancelled without a response
+- (NSTimeInterval)originalTimeToFirstByte
+{
+    id httpRequest = [self.attemptRequests.firstObject httpRequest];
+    if ([httpRequest isKindOfClass:[CMISHttpRequest class]] && [httpRequest timeToFirstByte] > 0) {
+        return [httpRequest timeToFirstByte];
+    }
+    if (self.originalCompleted) {
+        return 0; // failed without a response, nothing to record
+    }
+    return MAX(-[self.originalStartDate timeIntervalSinceNow], self.hedgeDelay);
+}
+
+#pragma mark CMISCancellableRequest methods
+
+- (void)updatePriority:(CMISRequestPriority)priority
+{
+    NSArray *attemptRequests = nil;
+    @synchronized(self) {
+        self.priority = priority;
+        attemptRequests = [self.attemptRequests copy];
+    }
+    
+    for (CMISRequest *attemptRequest in attemptRequests) {
+        attemptRequest.priority = priority;
+    }
+}
+
+- (void)cancel
+{
+    NSArray *attemptRequests = nil;
+    void (^completionBlock)(CMISHttpResponse *httpResponse, NSError *error) = nil;
+    @synchronized(self) {
+        if (self.finished) {
+            return;
+        }
+        self.finished = YES;
+        completionBlock = self.completionBlock;
+        self.completionBlock = nil;
+        self.startBlock = nil;
+        attemptRequests = [self.attemptRequests copy];
+    }
+    
+    for (CMISRequest *attemptRequest in attemptRequests) {
+        [attemptRequest cancel];
+    }
+    
+    if (completionBlock) {
+        completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeCancelled
+                                             detailedDescription:@"Request was cancelled"]);
+    }
+}
+
+@end
@@ -0,0 +1,72 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import <Foundation/Foundation.h>
+#import "CMISEnums.h"
+
+@class CMISRequest;
+
+/**
+ * Limits the number of requests running concurrently against a host.
+ *
+ * Requests exceeding the limit are queued per priority class. When a running request finishes, the next request is
+ * taken from the interactive queue first, then from the background and finally from the bulk queue.
+ * If more than one request is allowed per host, the last free slot is reserved for interactive requests so these
+ * never have to wait behind a large amount of background or bulk work.
+ */
+@interface CMISRequestScheduler : NSObject
+
+/**
+ * Schedules a request. The start block is invoked as soon as a slot is available for the host, on the thread
+ * this method was called from. The start block must call the provided finished block exactly once when the request
+ * has completed, so the slot can be given to the next queued request.
+ * If the CMISRequest is cancelled while the request is still queued, the request is removed from the queue and
+ * the cancel block is called instead of the start block.
+ * @param host the host the request is sent to
+ * @param priority the priority class of the request, CMISRequestPriorityDefault is treated as interactive
+ * @param maxConcurrentRequests the maximum number of requests allowed to run concurrently against the host
+ * @param cmisRequest the request handle, used to cancel the request while queued
+ * @param startBlock starts the request
+ * @param cancelBlock called if the request got cancelled while queued
+ */
+- (void)scheduleRequestForHost:(NSString *)host
+                      priority:(CMISRequestPriority)priority
+         maxConcurrentRequests:(NSUInteger)maxConcurrentRequests
+                   cmisRequest:(CMISRequest *)cmisRequest
+                    startBlock:(void (^)(void (^finishedBlock)(void)))startBlock
+                   cancelBlock:(void (^)(void))cancelBlock;
+
+/// @name Statistics
+
+/// the number of requests currently waiting in all queues
+- (NSUInteger)queuedRequestCount;
+
+/// the number of requests currently waiting in the queue of the given priority class
+- (NSUInteger)queuedRequestCountForPriority:(CMISRequestPriority)priority;
+
+/// the number of requests currently running against the given host
+- (NSUInteger)runningRequestCountForHost:(NSString *)host;
+
+/// the average time requests of the given priority class waited in the queue before being started
+- (NSTimeInterval)averageWaitTimeForPriority:(CMISRequestPriority)priority;
+
+/// the longest time a request of the given priority class waited in the queue before being started
+- (NSTimeInterval)maximumWaitTimeForPriority:(CMISRequestPriority)priority;
+
+@end
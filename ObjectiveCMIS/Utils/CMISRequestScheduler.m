@@ -0,0 +1,380 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import "CMISRequestScheduler.h"
+#import "CMISRequest.h"
+#import "CMISLog.h"
+
+// the number of priority classes that get their own queue
+#define PRIORITY_CLASS_COUNT 3
+
+typedef NS_ENUM(NSInteger, CMISScheduledRequestState)
+{
+    CMISScheduledRequestStateQueued,
+    CMISScheduledRequestStateRunning,
+    CMISScheduledRequestStateFinished,
+    CMISScheduledRequestStateCancelled
+};
+
+@class CMISRequestSchedulerHost;
+
+/**
+ A request waiting for or holding a slot. While queued it is set as the http request of the CMISRequest, so
+ cancelling the CMISRequest removes it from the queue and changing its priority moves it to another queue.
+ */
+@interface CMISScheduledRequest : NSObject <CMISCancellableRequest>
+
+@property (nonatomic, weak) CMISRequestScheduler *scheduler;
+@property (nonatomic, strong) CMISRequestSchedulerHost *host;
+@property (nonatomic, assign) NSUInteger priorityIndex;
+@property (nonatomic, assign) CMISScheduledRequestState state;
+@property (nonatomic, strong) NSDate *enqueueDate;
+@property (nonatomic, strong) NSThread *thread;
+@property (nonatomic, copy) void (^startBlock)(void (^finishedBlock)(void));
+@property (nonatomic, copy) void (^cancelBlock)(void);
+
+- (void)start;
+
+@end
+
+/**
+ Queues and running request count of a single host.
+ */
+@interface CMISRequestSchedulerHost : NSObject
+
+@property (nonatomic, strong) NSString *name;
+@property (nonatomic, assign) NSUInteger maxConcurrentRequests;
+@property (nonatomic, assign) NSUInteger runningRequests;
+@property (nonatomic, strong) NSArray *queues; // one NSMutableArray per priority class
+
+@end
+
+
+@interface CMISRequestScheduler ()
+{
+    // wait time statistics per priority class
+    NSTimeInterval _totalWaitTimes[PRIORITY_CLASS_COUNT];
+    NSTimeInterval _maximumWaitTimes[PRIORITY_CLASS_COUNT];
+    NSUInteger _startedRequests[PRIORITY_CLASS_COUNT];
+}
+
+@property (nonatomic, strong) NSMutableDictionary *hosts;
+
+- (void)requestDidStart:(CMISScheduledRequest *)scheduledRequest;
+- (void)requestDidFinish:(CMISScheduledRequest *)scheduledRequest;
+- (void)cancelQueuedRequest:(CMISScheduledRequest *)scheduledRequest;
+- (void)changePriority:(CMISRequestPriority)priority ofQueuedRequest:(CMISScheduledRequest *)scheduledRequest;
+
+@end
+
+
+@implementation CMISRequestScheduler
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _hosts = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (void)scheduleRequestForHost:(NSString *)host
+                      priority:(CMISRequestPriority)priority
+         maxConcurrentRequests:(NSUInteger)maxConcurrentRequests
+                   cmisRequest:(CMISRequest *)cmisRequest
+                    startBlock:(void (^)(void (^finishedBlock)(void)))startBlock
+                   cancelBlock:(void (^)(void))cancelBlock
+{
+    CMISScheduledRequest *scheduledRequest = [[CMISScheduledRequest alloc] init];
+    scheduledRequest.scheduler = self;
+    scheduledRequest.priorityIndex = [CMISRequestScheduler priorityIndexForPriority:priority];
+    scheduledRequest.enqueueDate = [NSDate date];
+    scheduledRequest.thread = [NSThread currentThread];
+    scheduledRequest.startBlock = startBlock;
+    scheduledRequest.cancelBlock = cancelBlock;
+
+    NSArray *startableRequests = nil;
+    @synchronized(self) {
+        NSString *hostKey = host ? host.lowercaseString : @"";
+        CMISRequestSchedulerHost *schedulerHost = [self.hosts objectForKey:hostKey];
+        if (schedulerHost == nil) {
+            schedulerHost = [[CMISRequestSchedulerHost alloc] init];
+            schedulerHost.name = hostKey;
+            [self.hosts setObject:schedulerHost forKey:hostKey];
+        }
+        schedulerHost.maxConcurrentRequests = MAX(maxConcurrentRequests, 1);
+
+        scheduledRequest.host = schedulerHost;
+        [[schedulerHost.queues objectAtIndex:scheduledRequest.priorityIndex] addObject:scheduledRequest];
+
+        startableRequests = [self dequeueStartableRequestsForHost:schedulerHost];
+    }
+
+    if (![startableRequests containsObject:scheduledRequest]) {
+        CMISLogDebug(@"Queued request for host %@, %lu requests waiting", host, (unsigned long)[self queuedRequestCount]);
+
+        // the queued request can be cancelled and re-prioritised through the CMISRequest until it gets started
+        cmisRequest.httpRequest = scheduledRequest;
+        
+        // the priority may have been changed before the request was queued
+        if (cmisRequest.priority != CMISRequestPriorityDefault && cmisRequest.priority != priority) {
+            [self changePriority:cmisRequest.priority ofQueuedRequest:scheduledRequest];
+        }
+    }
+
+    [self startRequests:startableRequests];
+}
+
+#pragma mark Statistics
+
+- (NSUInteger)queuedRequestCount
+{
+    NSUInteger count = 0;
+    for (NSUInteger index = 0; index < PRIORITY_CLASS_COUNT; index++) {
+        count += [self queuedRequestCountForPriorityIndex:index];
+    }
+    return count;
+}
+
+- (NSUInteger)queuedRequestCountForPriority:(CMISRequestPriority)priority
+{
+    return [self queuedRequestCountForPriorityIndex:[CMISRequestScheduler priorityIndexForPriority:priority]];
+}
+
+- (NSUInteger)runningRequestCountForHost:(NSString *)host
+{
+    @synchronized(self) {
+        CMISRequestSchedulerHost *schedulerHost = [self.hosts objectForKey:(host ? host.lowercaseString : @"")];
+        return schedulerHost.runningRequests;
+    }
+}
+
+- (NSTimeInterval)averageWaitTimeForPriority:(CMISRequestPriority)priority
+{
+    NSUInteger index = [CMISRequestScheduler priorityIndexForPriority:priority];
+    @synchronized(self) {
+        if (_startedRequests[index] == 0) {
+            return 0;
+        }
+        return _totalWaitTimes[index] / _startedRequests[index];
+    }
+}
+
+- (NSTimeInterval)maximumWaitTimeForPriority:(CMISRequestPriority)priority
+{
+    NSUInteger index = [CMISRequestScheduler priorityIndexForPriority:priority];
+    @synchronized(self) {
+        return _maximumWaitTimes[index];
+    }
+}
+
+#pragma mark Private methods
+
++ (NSUInteger)priorityIndexForPriority:(CMISRequestPriority)priority
+{
+    switch (priority) {
+        case CMISRequestPriorityBackground:
+            return 1;
+        case CMISRequestPriorityBulk:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+- (NSUInteger)queuedRequestCountForPriorityIndex:(NSUInteger)index
+{
+    NSUInteger count = 0;
+    @synchronized(self) {
+        for (CMISRequestSchedulerHost *schedulerHost in self.hosts.allValues) {
+            count += [[schedulerHost.queues objectAtIndex:index] count];
+        }
+    }
+    return count;
+}
+
+/// must be called while holding the lock, the returned requests are already marked as running
+- (NSArray *)dequeueStartableRequestsForHost:(CMISRequestSchedulerHost *)schedulerHost
+{
+    NSMutableArray *startableRequests = [NSMutableArray array];
+
+    // keep the last slot for interactive requests if there is more than one slot
+    NSUInteger reservedSlots = (schedulerHost.maxConcurrentRequests > 1) ? 1 : 0;
+
+    BOOL slotFound = YES;
+    while (slotFound && schedulerHost.runningRequests < schedulerHost.maxConcurrentRequests) {
+        slotFound = NO;
+        for (NSUInteger index = 0; index < PRIORITY_CLASS_COUNT; index++) {
+            NSMutableArray *queue = [schedulerHost.queues objectAtIndex:index];
+            NSUInteger limit = (index == 0) ? schedulerHost.maxConcurrentRequests : schedulerHost.maxConcurrentRequests - reservedSlots;
+            if (queue.count > 0 && schedulerHost.runningRequests < limit) {
+                CMISScheduledRequest *scheduledRequest = [queue objectAtIndex:0];
+                [queue removeObjectAtIndex:0];
+                scheduledRequest.state = CMISScheduledRequestStateRunning;
+                schedulerHost.runningRequests++;
+                [startableRequests addObject:scheduledRequest];
+                slotFound = YES;
+                break;
+            }
+        }
+    }
+
+    return startableRequests;
+}
+
+- (void)startRequests:(NSArray *)scheduledRequests
+{
+    for (CMISScheduledRequest *scheduledRequest in scheduledRequests) {
+        NSThread *thread = scheduledRequest.thread;
+        if (thread == nil || thread == [NSThread currentThread] || thread.isFinished) {
+            [scheduledRequest start];
+        } else {
+            // start the request on the thread it was scheduled from, so completion blocks are called on that thread as well
+            [scheduledRequest performSelector:@selector(start) onThread:thread withObject:nil waitUntilDone:NO];
+        }
+    }
+}
+
+- (void)requestDidStart:(CMISScheduledRequest *)scheduledRequest
+{
+    NSTimeInterval waitTime = -[scheduledRequest.enqueueDate timeIntervalSinceNow];
+    NSUInteger index = scheduledRequest.priorityIndex;
+    @synchronized(self) {
+        _totalWaitTimes[index] += waitTime;
+        _startedRequests[index]++;
+        if (waitTime > _maximumWaitTimes[index]) {
+            _maximumWaitTimes[index] = waitTime;
+        }
+    }
+}
+
+- (void)requestDidFinish:(CMISScheduledRequest *)scheduledRequest
+{
+    NSArray *startableRequests = nil;
+    @synchronized(self) {
+        if (scheduledRequest.state != CMISScheduledRequestStateRunning) {
+            return; // finished block called more than once
+        }
+        scheduledRequest.state = CMISScheduledRequestStateFinished;
+
+        CMISRequestSchedulerHost *schedulerHost = scheduledRequest.host;
+        schedulerHost.runningRequests--;
+        startableRequests = [self dequeueStartableRequestsForHost:schedulerHost];
+    }
+
+    [self startRequests:startableRequests];
+}
+
+- (void)cancelQueuedRequest:(CMISScheduledRequest *)scheduledRequest
+{
+    @synchronized(self) {
+        if (scheduledRequest.state != CMISScheduledRequestStateQueued) {
+            return; // already started, the request itself will handle the cancellation
+        }
+        scheduledRequest.state = CMISScheduledRequestStateCancelled;
+        [[scheduledRequest.host.queues objectAtIndex:scheduledRequest.priorityIndex] removeObject:scheduledRequest];
+    }
+
+    CMISLogDebug(@"Removed cancelled request from queue of host %@", scheduledRequest.host.name);
+
+    if (scheduledRequest.cancelBlock) {
+        scheduledRequest.cancelBlock();
+    }
+    scheduledRequest.startBlock = nil;
+    scheduledRequest.cancelBlock = nil;
+}
+
+- (void)changePriority:(CMISRequestPriority)priority ofQueuedRequest:(CMISScheduledRequest *)scheduledRequest
+{
+    NSUInteger priorityIndex = [CMISRequestScheduler priorityIndexForPriority:priority];
+    NSArray *startableRequests = nil;
+    @synchronized(self) {
+        if (scheduledRequest.state != CMISScheduledRequestStateQueued || scheduledRequest.priorityIndex == priorityIndex) {
+            return; // already started or nothing to move
+        }
+        CMISRequestSchedulerHost *schedulerHost = scheduledRequest.host;
+        [[schedulerHost.queues objectAtIndex:scheduledRequest.priorityIndex] removeObject:scheduledRequest];
+        scheduledRequest.priorityIndex = priorityIndex;
+        [[schedulerHost.queues objectAtIndex:priorityIndex] addObject:scheduledRequest];
+        
+        // an interactive request may take the reserved slot right away
+        startableRequests = [self dequeueStartableRequestsForHost:schedulerHost];
+    }
+    
+    CMISLogDebug(@"Moved queued request of host %@ to priority queue %lu", scheduledRequest.host.name, (unsigned long)priorityIndex);
+    
+    [self startRequests:startableRequests];
+}
+
+@end
+
+
+@implementation CMISScheduledRequest
+
+- (void)start
+{
+    CMISRequestScheduler *scheduler = self.scheduler;
+    [scheduler requestDidStart:self];
+
+    void (^startBlock)(void (^finishedBlock)(void)) = self.startBlock;
+    self.startBlock = nil;
+    self.cancelBlock = nil;
+    self.thread = nil;
+
+    if (startBlock) {
+        startBlock(^{
+            [scheduler requestDidFinish:self];
+        });
+    } else {
+        [scheduler requestDidFinish:self];
+    }
+}
+
+#pragma mark CMISCancellableRequest methods
+
+- (void)cancel
+{
+    [self.scheduler cancelQueuedRequest:self];
+}
+
+- (void)updatePriority:(CMISRequestPriority)priority
+{
+    [self.scheduler changePriority:priority ofQueuedRequest:self];
+}
+
+@end
+
+
+@implementation CMISRequestSchedulerHost
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        NSMutableArray *queues = [NSMutableArray arrayWithCapacity:PRIORITY_CLASS_COUNT];
+        for (NSUInteger index = 0; index < PRIORITY_CLASS_COUNT; index++) {
+            [queues addObject:[NSMutableArray array]];
+        }
+        _queues = queues;
+    }
+    return self;
+}
+
+@end
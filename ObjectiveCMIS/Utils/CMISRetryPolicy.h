@@ -0,0 +1,91 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CMISNetworkProvider.h"
+
+@class CMISBindingSession;
+
+/**
+ * Decides whether a failed request is sent again and how long to wait before doing so.
+ *
+ * Only idempotent requests (GET, PUT, DELETE) are retried, and only if the connection failed or the server
+ * responded with 429, 502, 503 or 504. The delay grows exponentially with every attempt, is capped and randomised
+ * (full jitter) so clients failing at the same time do not retry at the same time. A delay requested by the server
+ * with a Retry-After header is honoured.
+ *
+ * Every binding session has a retry budget: each request adds a fraction of a retry to the budget and each retry
+ * takes one, so while a server is failing the number of retries stays proportional to the number of requests.
+ */
+@interface CMISRetryPolicy : NSObject
+
+/// the maximum number of retries of a single request, 0 disables retries
+@property (nonatomic, assign) NSUInteger maxRetries;
+
+/// the delay before the first retry in seconds
+@property (nonatomic, assign) NSTimeInterval baseDelay;
+
+/// the maximum delay before a retry in seconds
+@property (nonatomic, assign) NSTimeInterval maxDelay;
+
+/// the number of retries added to the budget with every request
+@property (nonatomic, assign) double budgetRatio;
+
+/// the number of retries currently left in the budget
+@property (nonatomic, assign, readonly) double availableBudget;
+
+/// the number of retries performed so far
+@property (nonatomic, assign, readonly) NSUInteger retryCount;
+
+/// the number of retries refused because the budget was exhausted
+@property (nonatomic, assign, readonly) NSUInteger budgetExhaustedCount;
+
+- (id)initWithBindingSession:(CMISBindingSession *)bindingSession;
+
+/// Adds the share of a new request to the retry budget. Must be called once per request, not per attempt.
+- (void)requestWillStart;
+
+/**
+ * Decides whether a failed attempt is retried. If so, one retry is taken from the budget.
+ * @param httpRequestMethod the method of the request
+ * @param attempt the number of the attempt that failed, starting with 1
+ * @param statusCode the status code of the response or 0 if no response was received
+ * @param retryAfter the value of the Retry-After header of the response (optional)
+ * @param error the error the attempt failed with (optional)
+ * @param delay set to the time to wait before the next attempt
+ * @return YES if the request should be sent again
+ */
+- (BOOL)shouldRetryRequestWithMethod:(CMISHttpRequestMethod)httpRequestMethod
+                             attempt:(NSUInteger)attempt
+                          statusCode:(NSInteger)statusCode
+                          retryAfter:(NSString *)retryAfter
+                               error:(NSError *)error
+                               delay:(NSTimeInterval *)delay;
+
+/// returns YES if a response with the given status code is worth retrying
++ (BOOL)isRetryableStatusCode:(NSInteger)statusCode;
+
+/// returns YES if a request that failed with the given transport error is worth retrying
++ (BOOL)isRetryableError:(NSError *)error;
+
+/// parses a Retry-After header given in seconds or as HTTP date, returns -1 if the value is invalid
++ (NSTimeInterval)delayForRetryAfterHeader:(NSString *)retryAfter;
+
+@end
@@ -0,0 +1,173 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISRetryPolicy.h"
+#import "CMISBindingSession.h"
+#import "CMISLog.h"
+
+// Default number of retries per request
+#define DEFAULT_MAX_RETRIES 2
+
+// Default delay before the first retry in seconds
+#define DEFAULT_RETRY_BASE_DELAY 0.5
+
+// Default maximum delay before a retry in seconds
+#define DEFAULT_RETRY_MAX_DELAY 10.0
+
+// Default retry budget, one retry for every five requests
+#define DEFAULT_RETRY_BUDGET_RATIO 0.2
+
+// the budget a session starts with and never exceeds, so a few retries are possible right after the session was created
+#define RETRY_BUDGET_RESERVE 10.0
+
+@interface CMISRetryPolicy ()
+
+@property (nonatomic, assign, readwrite) double availableBudget;
+@property (nonatomic, assign, readwrite) NSUInteger retryCount;
+@property (nonatomic, assign, readwrite) NSUInteger budgetExhaustedCount;
+
+@end
+
+@implementation CMISRetryPolicy
+
+- (id)initWithBindingSession:(CMISBindingSession *)bindingSession
+{
+    self = [super init];
+    if (self) {
+        _maxRetries = [[bindingSession objectForKey:kCMISSessionParameterMaxRetries defaultValue:@(DEFAULT_MAX_RETRIES)] unsignedIntegerValue];
+        _baseDelay = [[bindingSession objectForKey:kCMISSessionParameterRetryBaseDelay defaultValue:@(DEFAULT_RETRY_BASE_DELAY)] doubleValue];
+        _maxDelay = [[bindingSession objectForKey:kCMISSessionParameterRetryMaxDelay defaultValue:@(DEFAULT_RETRY_MAX_DELAY)] doubleValue];
+        _budgetRatio = [[bindingSession objectForKey:kCMISSessionParameterRetryBudgetRatio defaultValue:@(DEFAULT_RETRY_BUDGET_RATIO)] doubleValue];
+        _availableBudget = RETRY_BUDGET_RESERVE;
+    }
+    return self;
+}
+
+- (void)requestWillStart
+{
+    @synchronized(self) {
+        _availableBudget = MIN(_availableBudget + _budgetRatio, RETRY_BUDGET_RESERVE);
+    }
+}
+
+- (BOOL)shouldRetryRequestWithMethod:(CMISHttpRequestMethod)httpRequestMethod
+                             attempt:(NSUInteger)attempt
+                          statusCode:(NSInteger)statusCode
+                          retryAfter:(NSString *)retryAfter
+                               error:(NSError *)error
+                               delay:(NSTimeInterval *)delay
+{
+    if (httpRequestMethod == HTTP_POST || attempt > self.maxRetries) {
+        return NO;
+    }
+    
+    if (error) {
+        if (![CMISRetryPolicy isRetryableError:error]) {
+            return NO;
+        }
+    } else if (![CMISRetryPolicy isRetryableStatusCode:statusCode]) {
+        return NO;
+    }
+    
+    // exponential backoff with full jitter
+    double exponentialDelay = MIN(self.maxDelay, self.baseDelay * pow(2.0, (double)(attempt - 1)));
+    NSTimeInterval retryDelay = exponentialDelay * ((double)arc4random_uniform(1001) / 1000.0);
+    
+    if (retryAfter) {
+        NSTimeInterval requestedDelay = [CMISRetryPolicy delayForRetryAfterHeader:retryAfter];
+        if (requestedDelay > self.maxDelay) {
+            CMISLogDebug(@"Not retrying request, server asked to wait %.1f seconds", requestedDelay);
+            return NO;
+        }
+        retryDelay = MAX(retryDelay, requestedDelay);
+    }
+    
+    @synchronized(self) {
+        if (_availableBudget < 1.0) {
+            _budgetExhaustedCount++;
+            CMISLogDebug(@"Not retrying request, retry budget exhausted");
+            return NO;
+        }
+        _availableBudget -= 1.0;
+        _retryCount++;
+    }
+    
+    if (delay) {
+        *delay = retryDelay;
+    }
+    return YES;
+}
+
++ (BOOL)isRetryableStatusCode:(NSInteger)statusCode
+{
+    return statusCode == 429 || statusCode == 502 || statusCode == 503 || statusCode == 504;
+}
+
++ (BOOL)isRetryableError:(NSError *)error
+{
+    if (![error.domain isEqualToString:NSURLErrorDomain]) {
+        return NO;
+    }
+    
+    switch (error.code) {
+        case NSURLErrorTimedOut:
+        case NSURLErrorNetworkConnectionLost:
+        case NSURLErrorCannotConnectToHost:
+        case NSURLErrorCannotFindHost:
+        case NSURLErrorDNSLookupFailed:
+            return YES;
+        default:
+            return NO;
+    }
+}
+
++ (NSTimeInterval)delayForRetryAfterHeader:(NSString *)retryAfter
+{
+    NSString *value = [retryAfter stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    if (value.length == 0) {
+        return -1;
+    }
+    
+    NSScanner *scanner = [NSScanner scannerWithString:value];
+    NSInteger seconds = 0;
+    if ([scanner scanInteger:&seconds] && scanner.isAtEnd) {
+        return seconds >= 0 ? (NSTimeInterval)seconds : -1;
+    }
+    
+    static NSDateFormatter *httpDateFormatter = nil;
+    static dispatch_once_t predicate = 0;
+    dispatch_once(&predicate, ^{
+        httpDateFormatter = [[NSDateFormatter alloc] init];
+        httpDateFormatter.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+        httpDateFormatter.timeZone = [NSTimeZone timeZoneWithAbbreviation:@"GMT"];
+        httpDateFormatter.dateFormat = @"EEE',' dd MMM yyyy HH':'mm':'ss 'GMT'";
+    });
+    
+    NSDate *date = nil;
+    @synchronized(httpDateFormatter) {
+        date = [httpDateFormatter dateFromString:value];
+    }
+    if (date == nil) {
+        return -1;
+    }
+    return MAX([date timeIntervalSinceNow], 0);
+}
+
+@end
@@ -0,0 +1,47 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+#import "CMISDownloadSink.h"
+
+/**
+ * Writes a download to an NSOutputStream on a separate queue, so a slow stream does not hold up the network callbacks.
+ *
+ * At most the buffer limit of received data is kept waiting to be written. When the limit is exceeded, the
+ * backpressure block asks the request to pause receiving data until half of the buffered data has been written.
+ */
+@interface CMISStreamDownloadSink : NSObject <CMISDownloadSink>
+
+/// the stream written to
+@property (nonatomic, strong, readonly) NSOutputStream *outputStream;
+
+/// the number of bytes received but not written yet
+@property (readonly) NSUInteger bufferedByteCount;
+
+@property (copy) void (^backpressureBlock)(BOOL paused);
+
+/**
+ * Initialises the sink.
+ * @param outputStream the stream to write to; it is opened unless it is open already and closed when the sink is closed
+ * @param bufferLimit the number of bytes that can be waiting to be written before receiving data is paused
+ */
+- (id)initWithOutputStream:(NSOutputStream *)outputStream bufferLimit:(NSUInteger)bufferLimit;
+
+@end
@@ -0,0 +1,139 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISStreamDownloadSink.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+
+@interface CMISStreamDownloadSink ()
+
+@property (nonatomic, strong, readwrite) NSOutputStream *outputStream;
+@property (nonatomic, assign) NSUInteger bufferLimit;
+@property (nonatomic, strong) dispatch_queue_t writeQueue;
+@property (readwrite) NSUInteger bufferedByteCount;
+@property (readwrite) unsigned long long bytesWritten;
+@property (strong, readwrite) NSError *error;
+@property (assign) BOOL paused;
+
+@end
+
+
+@implementation CMISStreamDownloadSink
+
+- (id)initWithOutputStream:(NSOutputStream *)outputStream bufferLimit:(NSUInteger)bufferLimit
+{
+    self = [super init];
+    if (self) {
+        _outputStream = outputStream;
+        _bufferLimit = MAX(bufferLimit, 1);
+        _writeQueue = dispatch_queue_create("org.apache.chemistry.objectivecmis.downloadsink", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (BOOL)openWithExpectedLength:(unsigned long long)expectedLength error:(NSError **)error
+{
+    // the stream is only used on the write queue
+    __block BOOL isStreamReady = NO;
+    dispatch_sync(self.writeQueue, ^{
+        isStreamReady = self.outputStream.streamStatus == NSStreamStatusOpen;
+        if (!isStreamReady) {
+            [self.outputStream open];
+            isStreamReady = self.outputStream.streamStatus == NSStreamStatusOpen;
+        }
+    });
+    
+    if (!isStreamReady && error) {
+        *error = [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage
+                                 detailedDescription:@"Could not open output stream"];
+    }
+    return isStreamReady;
+}
+
+- (void)writeData:(NSData *)data
+{
+    if (self.error) {
+        return;
+    }
+    
+    BOOL pause = NO;
+    @synchronized(self) {
+        self.bufferedByteCount += data.length;
+        if (!self.paused && self.bufferedByteCount > self.bufferLimit) {
+            self.paused = pause = YES;
+        }
+    }
+    if (pause && self.backpressureBlock) {
+        self.backpressureBlock(YES);
+    }
+    
+    dispatch_async(self.writeQueue, ^{
+        [self writeBufferedData:data];
+    });
+}
+
+- (void)closeWithCompletionBlock:(void (^)(NSError *error))completionBlock
+{
+    // runs after all buffered data has been written
+    dispatch_async(self.writeQueue, ^{
+        [self.outputStream close];
+        if (completionBlock) {
+            completionBlock(self.error);
+        }
+    });
+}
+
+#pragma mark Private methods
+
+- (void)writeBufferedData:(NSData *)data
+{
+    if (!self.error) {
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+            NSUInteger offset = 0;
+            while (offset < byteRange.length) {
+                NSInteger written = [self.outputStream write:(const uint8_t *)bytes + offset maxLength:byteRange.length - offset];
+                if (written <= 0) {
+                    CMISLogError(@"Error while writing downloaded data to stream");
+                    NSError *streamError = self.outputStream.streamError;
+                    self.error = streamError ? [CMISErrors cmisError:streamError cmisErrorCode:kCMISErrorCodeStorage]
+                                             : [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage detailedDescription:@"Could not write downloaded data"];
+                    *stop = YES;
+                    return;
+                }
+                offset += written;
+            }
+            self.bytesWritten += byteRange.length;
+        }];
+    }
+    
+    BOOL resume = NO;
+    @synchronized(self) {
+        self.bufferedByteCount -= data.length;
+        if (self.paused && (self.bufferedByteCount <= self.bufferLimit / 2 || self.error)) {
+            self.paused = NO;
+            resume = YES;
+        }
+    }
+    if (resume && self.backpressureBlock) {
+        self.backpressureBlock(NO);
+    }
+}
+
+@end
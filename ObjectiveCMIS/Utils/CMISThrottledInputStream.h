@@ -0,0 +1,44 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+
+#import <Foundation/Foundation.h>
+
+@class CMISBandwidthLimiter;
+
+/**
+ * An input stream reading from another stream no faster than a bandwidth limiter allows.
+ *
+ * Reads are split into chunks of the size suggested by the limiter and block until the limiter lets the data through.
+ * The stream is meant to be read synchronously, e.g. by CMISHttpUploadRequest; it can not be scheduled in a run loop.
+ */
+@interface CMISThrottledInputStream : NSInputStream
+
+/// the number of bytes read from the stream
+@property (nonatomic, assign, readonly) unsigned long long bytesRead;
+
+/**
+ * Initialises the stream.
+ * @param inputStream the stream to read from, it is opened and closed with this stream
+ * @param bandwidthLimiter the limiter shared by all transfers that are limited together
+ */
+- (id)initWithInputStream:(NSInputStream *)inputStream bandwidthLimiter:(CMISBandwidthLimiter *)bandwidthLimiter;
+
+@end
@@ -0,0 +1,122 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+
+#import "CMISThrottledInputStream.h"
+#import "CMISBandwidthLimiter.h"
+
+@interface CMISThrottledInputStream ()
+
+@property (nonatomic, strong) NSInputStream *inputStream;
+@property (nonatomic, strong) CMISBandwidthLimiter *bandwidthLimiter;
+@property (nonatomic, assign, readwrite) unsigned long long bytesRead;
+@property (nonatomic, weak) id<NSStreamDelegate> streamDelegate;
+
+@end
+
+
+@implementation CMISThrottledInputStream
+
+- (id)initWithInputStream:(NSInputStream *)inputStream bandwidthLimiter:(CMISBandwidthLimiter *)bandwidthLimiter
+{
+    self = [super init];
+    if (self) {
+        _inputStream = inputStream;
+        _bandwidthLimiter = bandwidthLimiter;
+    }
+    return self;
+}
+
+#pragma mark NSStream methods
+
+- (void)open
+{
+    if (self.inputStream.streamStatus == NSStreamStatusNotOpen) {
+        [self.inputStream open];
+    }
+}
+
+- (void)close
+{
+    [self.inputStream close];
+}
+
+- (NSStreamStatus)streamStatus
+{
+    return self.inputStream.streamStatus;
+}
+
+- (NSError *)streamError
+{
+    return self.inputStream.streamError;
+}
+
+- (id<NSStreamDelegate>)delegate
+{
+    return self.streamDelegate;
+}
+
+- (void)setDelegate:(id<NSStreamDelegate>)delegate
+{
+    self.streamDelegate = delegate;
+}
+
+- (id)propertyForKey:(NSString *)key
+{
+    return [self.inputStream propertyForKey:key];
+}
+
+- (BOOL)setProperty:(id)property forKey:(NSString *)key
+{
+    return NO;
+}
+
+- (void)scheduleInRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+    // only read synchronously
+}
+
+- (void)removeFromRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+}
+
+#pragma mark NSInputStream methods
+
+- (BOOL)hasBytesAvailable
+{
+    return self.inputStream.hasBytesAvailable;
+}
+
+- (BOOL)getBuffer:(uint8_t **)buffer length:(NSUInteger *)length
+{
+    return NO;
+}
+
+- (NSInteger)read:(uint8_t *)buffer maxLength:(NSUInteger)length
+{
+    NSInteger bytesRead = [self.inputStream read:buffer maxLength:MIN(length, self.bandwidthLimiter.maximumChunkLength)];
+    if (bytesRead > 0) {
+        self.bytesRead += bytesRead;
+        [self.bandwidthLimiter waitForBytes:(NSUInteger)bytesRead];
+    }
+    return bytesRead;
+}
+
+@end
@@ -0,0 +1,117 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+
+#import "CMISThrottledOutputStream.h"
+#import "CMISBandwidthLimiter.h"
+
+@interface CMISThrottledOutputStream ()
+
+@property (nonatomic, strong) NSOutputStream *outputStream;
+@property (nonatomic, strong) CMISBandwidthLimiter *bandwidthLimiter;
+@property (nonatomic, assign, readwrite) unsigned long long bytesWritten;
+@property (nonatomic, weak) id<NSStreamDelegate> streamDelegate;
+
+@end
+
+
+@implementation CMISThrottledOutputStream
+
+- (id)initWithOutputStream:(NSOutputStream *)outputStream bandwidthLimiter:(CMISBandwidthLimiter *)bandwidthLimiter
+{
+    self = [super init];
+    if (self) {
+        _outputStream = outputStream;
+        _bandwidthLimiter = bandwidthLimiter;
+    }
+    return self;
+}
+
+#pragma mark NSStream methods
+
+- (void)open
+{
+    if (self.outputStream.streamStatus == NSStreamStatusNotOpen) {
+        [self.outputStream open];
+    }
+}
+
+- (void)close
+{
+    [self.outputStream close];
+}
+
+- (NSStreamStatus)streamStatus
+{
+    return self.outputStream.streamStatus;
+}
+
+- (NSError *)streamError
+{
+    return self.outputStream.streamError;
+}
+
+- (id<NSStreamDelegate>)delegate
+{
+    return self.streamDelegate;
+}
+
+- (void)setDelegate:(id<NSStreamDelegate>)delegate
+{
+    self.streamDelegate = delegate;
+}
+
+- (id)propertyForKey:(NSString *)key
+{
+    return [self.outputStream propertyForKey:key];
+}
+
+- (BOOL)setProperty:(id)property forKey:(NSString *)key
+{
+    return NO;
+}
+
+- (void)scheduleInRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+    // only written synchronously
+}
+
+- (void)removeFromRunLoop:(NSRunLoop *)runLoop forMode:(NSString *)mode
+{
+}
+
+#pragma mark NSOutputStream methods
+
+- (BOOL)hasSpaceAvailable
+{
+    return self.outputStream.hasSpaceAvailable;
+}
+
+- (NSInteger)write:(const uint8_t *)buffer maxLength:(NSUInteger)length
+{
+    NSInteger bytesWritten = [self.outputStream write:buffer maxLength:MIN(length, self.bandwidthLimiter.maximumChunkLength)];
+    if (bytesWritten > 0) {
+        self.bytesWritten += bytesWritten;
+        [self.bandwidthLimiter waitForBytes:(NSUInteger)bytesWritten];
+    }
+    return bytesWritten;
+}
+
+@end
@@ -0,0 +1,78 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class CMISBindingSession;
+
+/**
+ * Process wide pool of long-lived NSURLSession objects.
+ *
+ * A session is shared by all requests targeting the same host, using the same authentication provider and
+ * the same session configuration, so connections (keep-alive and HTTP/2) are reused across requests.
+ * The pool is the delegate of every session it owns and forwards the delegate callbacks of a task to the
+ * handler that was registered when the task was created.
+ *
+ * Sessions are invalidated (after their running tasks have finished) once no binding session uses them anymore.
+ */
+@interface CMISURLSessionPool : NSObject
+
+/// the shared pool instance
++ (CMISURLSessionPool *)sharedPool;
+
+/// the number of sessions currently held by the pool
+@property (nonatomic, assign, readonly) NSUInteger sessionCount;
+
+/**
+ * Creates a task for the given request on the pooled session matching the URL and binding session.
+ * The task factory is called with the pooled session and must return a new, not yet resumed task.
+ * All delegate callbacks of the returned task are forwarded to the given handler.
+ * @param urlRequest the request the task will be created for
+ * @param bindingSession the binding session providing authentication provider and session configuration
+ * @param handler the object receiving the task's NSURLSession delegate callbacks
+ * @param taskFactory creates the task on the given session
+ * @return the created task or nil if the factory did not create one
+ */
+- (NSURLSessionTask *)taskForRequest:(NSURLRequest *)urlRequest
+                      bindingSession:(CMISBindingSession *)bindingSession
+                             handler:(id<NSURLSessionTaskDelegate>)handler
+                         taskFactory:(NSURLSessionTask * (^)(NSURLSession *urlSession))taskFactory;
+
+/**
+ * Keeps the connections of the pooled session for the given URL and binding session open while it is idle.
+ * The keep alive block is called on a background queue whenever no request has been sent on the session for the
+ * interval; it should send lightweight requests through the network provider. The block is no longer called once the
+ * session has been released. Background sessions are not kept alive.
+ * @param url the URL of the service
+ * @param bindingSession the binding session the connections are kept for
+ * @param interval the number of seconds after which idle connections are used again
+ * @param keepAliveBlock sends the requests keeping the connections open
+ */
+- (void)keepConnectionsAliveToURL:(NSURL *)url
+                   bindingSession:(CMISBindingSession *)bindingSession
+                         interval:(NSTimeInterval)interval
+                   keepAliveBlock:(void (^)(void))keepAliveBlock;
+
+/**
+ * Releases all sessions used by the given binding session.
+ * Sessions that are not used by any other binding session are invalidated once their running tasks have finished.
+ */
+- (void)releaseSessionsForBindingSession:(CMISBindingSession *)bindingSession;
+
+@end
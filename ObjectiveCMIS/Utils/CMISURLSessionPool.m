@@ -0,0 +1,327 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+#import "CMISURLSessionPool.h"
+#import "CMISURLSessionUtil.h"
+#import "CMISBindingSession.h"
+#import "CMISConstants.h"
+#import "CMISLog.h"
+
+/**
+ A pooled session together with the bookkeeping needed to route delegate callbacks to the per-task handlers.
+ The entry is the delegate of its session; the session keeps the entry alive until it has been invalidated.
+ */
+@interface CMISURLSessionPoolEntry : NSObject <NSURLSessionDelegate, NSURLSessionTaskDelegate, NSURLSessionDataDelegate, NSURLSessionDownloadDelegate>
+
+@property (nonatomic, strong) NSString *key;
+@property (nonatomic, strong) NSURLSession *urlSession;
+@property (nonatomic, strong) id<CMISAuthenticationProvider> authenticationProvider;
+@property (nonatomic, strong) NSMutableDictionary *handlers;
+@property (nonatomic, strong) NSMutableSet *owners;
+@property (nonatomic, strong) NSDate *lastActivityDate;
+@property (nonatomic, strong) dispatch_source_t keepAliveTimer;
+
+- (id)handlerForTask:(NSURLSessionTask *)task;
+
+@end
+
+
+@interface CMISURLSessionPool ()
+
+@property (nonatomic, strong) NSMutableDictionary *entries;
+
+@end
+
+
+@implementation CMISURLSessionPool
+
++ (CMISURLSessionPool *)sharedPool
+{
+    static CMISURLSessionPool *sharedPool = nil;
+    static dispatch_once_t predicate = 0;
+
+    dispatch_once(&predicate, ^{
+        sharedPool = [[self alloc] init];
+    });
+
+    return sharedPool;
+}
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _entries = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (NSUInteger)sessionCount
+{
+    @synchronized(self) {
+        return self.entries.count;
+    }
+}
+
+- (NSURLSessionTask *)taskForRequest:(NSURLRequest *)urlRequest
+                      bindingSession:(CMISBindingSession *)bindingSession
+                             handler:(id<NSURLSessionTaskDelegate>)handler
+                         taskFactory:(NSURLSessionTask * (^)(NSURLSession *urlSession))taskFactory
+{
+    // the lock is held until the task is registered so the session can not be invalidated in between
+    @synchronized(self) {
+        CMISURLSessionPoolEntry *entry = [self entryForURL:urlRequest.URL bindingSession:bindingSession];
+        entry.lastActivityDate = [NSDate date];
+
+        NSURLSessionTask *task = taskFactory(entry.urlSession);
+        if (task) {
+            @synchronized(entry) {
+                [entry.handlers setObject:handler forKey:@(task.taskIdentifier)];
+            }
+        }
+        return task;
+    }
+}
+
+- (void)keepConnectionsAliveToURL:(NSURL *)url
+                   bindingSession:(CMISBindingSession *)bindingSession
+                         interval:(NSTimeInterval)interval
+                   keepAliveBlock:(void (^)(void))keepAliveBlock
+{
+    if (url == nil || interval <= 0 || keepAliveBlock == nil ||
+        [[CMISURLSessionPool keyForURL:url bindingSession:bindingSession] hasPrefix:@"background|"]) {
+        return;
+    }
+
+    @synchronized(self) {
+        CMISURLSessionPoolEntry *entry = [self entryForURL:url bindingSession:bindingSession];
+        if (entry.keepAliveTimer) {
+            return;
+        }
+
+        dispatch_source_t timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0));
+        uint64_t nanoseconds = (uint64_t)(interval * NSEC_PER_SEC);
+        dispatch_source_set_timer(timer, dispatch_time(DISPATCH_TIME_NOW, nanoseconds), nanoseconds, nanoseconds / 10);
+
+        __weak CMISURLSessionPool *weakSelf = self;
+        __weak CMISURLSessionPoolEntry *weakEntry = entry;
+        dispatch_source_set_event_handler(timer, ^{
+            CMISURLSessionPool *pool = weakSelf;
+            CMISURLSessionPoolEntry *timerEntry = weakEntry;
+            if (pool == nil || timerEntry == nil) {
+                return;
+            }
+            BOOL idle;
+            @synchronized(pool) {
+                // only connections that were not used by real requests are at risk of being closed by the server
+                idle = [pool.entries objectForKey:timerEntry.key] == timerEntry &&
+                       -[timerEntry.lastActivityDate timeIntervalSinceNow] >= interval / 2;
+            }
+            if (idle) {
+                keepAliveBlock();
+            }
+        });
+        entry.keepAliveTimer = timer;
+        dispatch_resume(timer);
+    }
+}
+
+- (void)releaseSessionsForBindingSession:(CMISBindingSession *)bindingSession
+{
+    NSValue *owner = [NSValue valueWithNonretainedObject:bindingSession];
+
+    @synchronized(self) {
+        for (NSString *key in self.entries.allKeys) {
+            CMISURLSessionPoolEntry *entry = [self.entries objectForKey:key];
+            [entry.owners removeObject:owner];
+            if (entry.owners.count == 0) {
+                CMISLogDebug(@"Invalidating pooled network session for key %@", key);
+
+                if (entry.keepAliveTimer) {
+                    dispatch_source_cancel(entry.keepAliveTimer);
+                    entry.keepAliveTimer = nil;
+                }
+
+                // running tasks are allowed to finish, the session releases its delegate once invalidated
+                [entry.urlSession finishTasksAndInvalidate];
+                [self.entries removeObjectForKey:key];
+            }
+        }
+    }
+}
+
+#pragma mark Private methods
+
+/// must be called while holding the lock, returns the entry for the URL and binding session creating it if needed
+- (CMISURLSessionPoolEntry *)entryForURL:(NSURL *)url bindingSession:(CMISBindingSession *)bindingSession
+{
+    NSString *key = [CMISURLSessionPool keyForURL:url bindingSession:bindingSession];
+    CMISURLSessionPoolEntry *entry = [self.entries objectForKey:key];
+    if (entry == nil) {
+        entry = [[CMISURLSessionPoolEntry alloc] init];
+        entry.key = key;
+        entry.lastActivityDate = [NSDate date];
+        entry.authenticationProvider = bindingSession.authenticationProvider;
+        entry.urlSession = [NSURLSession sessionWithConfiguration:[CMISURLSessionUtil sessionConfigurationWithParameters:bindingSession]
+                                                         delegate:entry
+                                                    delegateQueue:nil];
+        [self.entries setObject:entry forKey:key];
+
+        CMISLogDebug(@"Created pooled network session for key %@", key);
+    }
+    [entry.owners addObject:[NSValue valueWithNonretainedObject:bindingSession]];
+    return entry;
+}
+
++ (NSString *)keyForURL:(NSURL *)url bindingSession:(CMISBindingSession *)bindingSession
+{
+    id useBackgroundSession = [bindingSession objectForKey:kCMISSessionParameterUseBackgroundNetworkSession];
+    if (useBackgroundSession && [useBackgroundSession boolValue]) {
+        // only one session per background identifier may exist in a process, regardless of the host
+        NSString *backgroundId = [bindingSession objectForKey:kCMISSessionParameterBackgroundNetworkSessionId
+                                                 defaultValue:kCMISDefaultBackgroundNetworkSessionId];
+        return [NSString stringWithFormat:@"background|%@", backgroundId];
+    }
+
+    // the authentication provider is part of the key as it answers the session level challenges
+    return [NSString stringWithFormat:@"%@://%@:%@|%p|default",
+            url.scheme.lowercaseString, url.host.lowercaseString, url.port ? url.port : @"", bindingSession.authenticationProvider];
+}
+
+@end
+
+
+@implementation CMISURLSessionPoolEntry
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        _handlers = [[NSMutableDictionary alloc] init];
+        _owners = [[NSMutableSet alloc] init];
+    }
+    return self;
+}
+
+- (id)handlerForTask:(NSURLSessionTask *)task
+{
+    @synchronized(self) {
+        return [self.handlers objectForKey:@(task.taskIdentifier)];
+    }
+}
+
+#pragma mark Session delegate methods
+
+- (void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)error
+{
+    if (error) {
+        CMISLogDebug(@"Pooled network session for key %@ became invalid: %@", self.key, error);
+    }
+
+    @synchronized(self) {
+        [self.handlers removeAllObjects];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session didReceiveChallenge:(NSURLAuthenticationChallenge *)challenge completionHandler:(void (^)(NSURLSessionAuthChallengeDisposition, NSURLCredential *))completionHandler
+{
+    [self.authenticationProvider didReceiveChallenge:challenge completionHandler:completionHandler];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error
+{
+    id handler = [self handlerForTask:task];
+    @synchronized(self) {
+        [self.handlers removeObjectForKey:@(task.taskIdentifier)];
+    }
+
+    if ([handler respondsToSelector:@selector(URLSession:task:didCompleteWithError:)]) {
+        [handler URLSession:session task:task didCompleteWithError:error];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
+{
+    id handler = [self handlerForTask:task];
+    if ([handler respondsToSelector:@selector(URLSession:task:didFinishCollectingMetrics:)]) {
+        [handler URLSession:session task:task didFinishCollectingMetrics:metrics];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task needNewBodyStream:(void (^)(NSInputStream *))completionHandler
+{
+    id handler = [self handlerForTask:task];
+    if ([handler respondsToSelector:@selector(URLSession:task:needNewBodyStream:)]) {
+        [handler URLSession:session task:task needNewBodyStream:completionHandler];
+    } else {
+        completionHandler(nil);
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didSendBodyData:(int64_t)bytesSent totalBytesSent:(int64_t)totalBytesSent totalBytesExpectedToSend:(int64_t)totalBytesExpectedToSend
+{
+    id handler = [self handlerForTask:task];
+    if ([handler respondsToSelector:@selector(URLSession:task:didSendBodyData:totalBytesSent:totalBytesExpectedToSend:)]) {
+        [handler URLSession:session task:task didSendBodyData:bytesSent totalBytesSent:totalBytesSent totalBytesExpectedToSend:totalBytesExpectedToSend];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)response completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
+{
+    id handler = [self handlerForTask:dataTask];
+    if ([handler respondsToSelector:@selector(URLSession:dataTask:didReceiveResponse:completionHandler:)]) {
+        [handler URLSession:session dataTask:dataTask didReceiveResponse:response completionHandler:completionHandler];
+    } else {
+        completionHandler(NSURLSessionResponseAllow);
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data
+{
+    id handler = [self handlerForTask:dataTask];
+    if ([handler respondsToSelector:@selector(URLSession:dataTask:didReceiveData:)]) {
+        [handler URLSession:session dataTask:dataTask didReceiveData:data];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didFinishDownloadingToURL:(NSURL *)location
+{
+    id handler = [self handlerForTask:downloadTask];
+    if ([handler respondsToSelector:@selector(URLSession:downloadTask:didFinishDownloadingToURL:)]) {
+        [handler URLSession:session downloadTask:downloadTask didFinishDownloadingToURL:location];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didWriteData:(int64_t)bytesWritten totalBytesWritten:(int64_t)totalBytesWritten totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite
+{
+    id handler = [self handlerForTask:downloadTask];
+    if ([handler respondsToSelector:@selector(URLSession:downloadTask:didWriteData:totalBytesWritten:totalBytesExpectedToWrite:)]) {
+        [handler URLSession:session downloadTask:downloadTask didWriteData:bytesWritten totalBytesWritten:totalBytesWritten totalBytesExpectedToWrite:totalBytesExpectedToWrite];
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didResumeAtOffset:(int64_t)fileOffset expectedTotalBytes:(int64_t)expectedTotalBytes
+{
+    id handler = [self handlerForTask:downloadTask];
+    if ([handler respondsToSelector:@selector(URLSession:downloadTask:didResumeAtOffset:expectedTotalBytes:)]) {
+        [handler URLSession:session downloadTask:downloadTask didResumeAtOffset:fileOffset expectedTotalBytes:expectedTotalBytes];
+    }
+}
+
+@end
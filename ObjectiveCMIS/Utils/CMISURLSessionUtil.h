@@ -23,6 +23,10 @@
 
 @interface CMISURLSessionUtil : NSObject
 
+/// Creates the session configuration to use for the given binding session
++ (NSURLSessionConfiguration *)sessionConfigurationWithParameters:(CMISBindingSession *)session;
+
+/// Creates a new, unpooled session. The caller is responsible for invalidating the session when done.
 + (NSURLSession *)internalUrlSessionWithParameters:(CMISBindingSession *)session delegate:(id <NSURLSessionDelegate>)delegate;
 
 @end
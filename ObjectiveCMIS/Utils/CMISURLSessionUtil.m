@@ -24,7 +24,7 @@
 
 @implementation CMISURLSessionUtil
 
-+ (NSURLSession *)internalUrlSessionWithParameters:(CMISBindingSession *)session delegate:(id <NSURLSessionDelegate>)delegate
++ (NSURLSessionConfiguration *)sessionConfigurationWithParameters:(CMISBindingSession *)session
 {
     // determine the type of session configuration to create
     NSURLSessionConfiguration *sessionConfiguration = nil;
@@ -48,9 +48,12 @@
         sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
     }
     
-    //TODO: do we have a memory leak? need to call invalidateAndCancel or resetWithCompletionHandler when done, see also docu from sessionWithConfiguration:delegate:delegateQueue: method
-    // create session
-    return [NSURLSession sessionWithConfiguration:sessionConfiguration delegate:delegate delegateQueue:nil];
+    return sessionConfiguration;
+}
+
++ (NSURLSession *)internalUrlSessionWithParameters:(CMISBindingSession *)session delegate:(id <NSURLSessionDelegate>)delegate
+{
+    return [NSURLSession sessionWithConfiguration:[self sessionConfigurationWithParameters:session] delegate:delegate delegateQueue:nil];
 }
 
 @end
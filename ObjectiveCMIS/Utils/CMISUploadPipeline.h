@@ -0,0 +1,77 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+@class CMISContentHasher;
+
+/**
+ * Produces the body of an upload: the start data, the content of a source stream (optionally base64 encoded) and the end data.
+ *
+ * The content is read and encoded on a separate queue into a small ring of reusable chunk buffers, so the next chunk is
+ * prepared while the previous one is being sent. The consumer writes straight from the returned buffers and hands them
+ * back with consumeBytes:, no data is copied between reading the source and writing it to the network.
+ */
+@interface CMISUploadPipeline : NSObject
+
+/// the size of the largest chunk handed out by availableBytes:
+@property (nonatomic, assign, readonly) NSUInteger encodedChunkSize;
+
+/// the error reading the source stream, if any
+@property (strong, readonly) NSError *error;
+
+/// YES once all data has been consumed
+@property (readonly, getter=isAtEnd) BOOL atEnd;
+
+/// hashes the raw content before it is encoded, must be set before the pipeline is started
+@property (nonatomic, strong) CMISContentHasher *contentHasher;
+
+/// called on the producer queue whenever a chunk becomes available after availableBytes: returned NULL
+@property (copy) void (^dataAvailableBlock)(void);
+
+/**
+ * Initialises the pipeline.
+ * @param inputStream the source stream, it must be open and is closed when the pipeline has read it or is cancelled
+ * @param chunkSize the size of the raw chunks read from the source stream, rounded down to a multiple of 3 when base64 encoding
+ * @param bufferCount the number of chunk buffers, at least 2
+ */
+- (id)initWithInputStream:(NSInputStream *)inputStream
+                startData:(NSData *)startData
+                  endData:(NSData *)endData
+           base64Encoding:(BOOL)base64Encoding
+                chunkSize:(NSUInteger)chunkSize
+              bufferCount:(NSUInteger)bufferCount;
+
+/// starts reading from the source stream
+- (void)start;
+
+/**
+ * Returns the next bytes to send, or NULL if no data is available yet, the end has been reached or an error occurred.
+ * The returned bytes remain valid until they are consumed.
+ */
+- (const uint8_t *)availableBytes:(NSUInteger *)length;
+
+/// marks the given number of bytes returned by availableBytes: as sent
+- (void)consumeBytes:(NSUInteger)length;
+
+/// stops reading from the source stream and closes it
+- (void)cancel;
+
+@end
@@ -0,0 +1,286 @@
+/*
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing,
+  software distributed under the License is distributed on an
+  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+  KIND, either express or implied.  See the License for the
+  specific language governing permissions and limitations
+  under the License.
+ */
+
+
+#import "CMISUploadPipeline.h"
+#import "CMISBase64Encoder.h"
+#import "CMISContentHasher.h"
+#import "CMISErrors.h"
+#import "CMISLog.h"
+
+typedef NS_ENUM(NSInteger, CMISUploadPipelinePhase) {
+    CMISUploadPipelinePhaseStartData,
+    CMISUploadPipelinePhaseContent,
+    CMISUploadPipelinePhaseEndData,
+    CMISUploadPipelinePhaseDone
+};
+
+/**
+ One slot of the ring. The raw buffer is sent directly when no encoding is needed, otherwise it is encoded into the
+ encoded buffer. A filled slot belongs to the consumer until it has been consumed completely.
+ */
+@interface CMISUploadPipelineBuffer : NSObject
+
+@property (nonatomic, strong) NSMutableData *rawData;
+@property (nonatomic, strong) NSMutableData *encodedData;
+@property (nonatomic, assign) NSUInteger length;
+@property (nonatomic, assign) BOOL filled;
+@property (nonatomic, readonly) const uint8_t *bytes;
+
+@end
+
+@implementation CMISUploadPipelineBuffer
+
+- (const uint8_t *)bytes
+{
+    return (self.encodedData ? self.encodedData.bytes : self.rawData.bytes);
+}
+
+@end
+
+
+@interface CMISUploadPipeline ()
+
+@property (nonatomic, strong) NSInputStream *inputStream;
+@property (nonatomic, strong) NSData *startData;
+@property (nonatomic, strong) NSData *endData;
+@property (nonatomic, assign) BOOL base64Encoding;
+@property (nonatomic, assign) NSUInteger rawChunkSize;
+@property (nonatomic, assign, readwrite) NSUInteger encodedChunkSize;
+@property (nonatomic, strong) NSArray *buffers;
+@property (nonatomic, strong) dispatch_queue_t producerQueue;
+@property (nonatomic, assign) NSUInteger producerIndex;
+@property (nonatomic, assign) NSUInteger consumerIndex;
+@property (nonatomic, assign) NSUInteger consumerOffset;
+@property (nonatomic, assign) CMISUploadPipelinePhase phase;
+@property (nonatomic, assign) BOOL started;
+@property (nonatomic, assign) BOOL producing;
+@property (nonatomic, assign) BOOL sourceFinished;
+@property (nonatomic, assign) BOOL cancelled;
+@property (nonatomic, assign) BOOL waitingForData;
+@property (strong, readwrite) NSError *error;
+@property (readwrite, getter=isAtEnd) BOOL atEnd;
+
+@end
+
+
+@implementation CMISUploadPipeline
+
+- (id)initWithInputStream:(NSInputStream *)inputStream
+                startData:(NSData *)startData
+                  endData:(NSData *)endData
+           base64Encoding:(BOOL)base64Encoding
+                chunkSize:(NSUInteger)chunkSize
+              bufferCount:(NSUInteger)bufferCount
+{
+    self = [super init];
+    if (self) {
+        _inputStream = inputStream;
+        _startData = startData;
+        _endData = endData;
+        _base64Encoding = base64Encoding;
+        _sourceFinished = (inputStream == nil);
+        _phase = CMISUploadPipelinePhaseStartData;
+        
+        // base64 encodes groups of 3 bytes, only the last chunk may end with padding
+        _rawChunkSize = base64Encoding ? MAX(chunkSize / 3, 1) * 3 : MAX(chunkSize, 1);
+        _encodedChunkSize = base64Encoding ? _rawChunkSize / 3 * 4 : _rawChunkSize;
+        
+        NSMutableArray *buffers = [NSMutableArray array];
+        for (NSUInteger i = 0; i < MAX(bufferCount, 2); i++) {
+            CMISUploadPipelineBuffer *buffer = [[CMISUploadPipelineBuffer alloc] init];
+            buffer.rawData = [NSMutableData dataWithLength:_rawChunkSize];
+            if (base64Encoding) {
+                buffer.encodedData = [NSMutableData dataWithLength:_encodedChunkSize];
+            }
+            [buffers addObject:buffer];
+        }
+        _buffers = buffers;
+        _producerQueue = dispatch_queue_create("org.apache.chemistry.objectivecmis.uploadpipeline", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)start
+{
+    @synchronized(self) {
+        self.started = YES;
+        [self scheduleProducer];
+    }
+}
+
+- (const uint8_t *)availableBytes:(NSUInteger *)length
+{
+    @synchronized(self) {
+        *length = 0;
+        if (self.error || self.cancelled) {
+            return NULL;
+        }
+        
+        if (self.phase == CMISUploadPipelinePhaseStartData) {
+            if (self.consumerOffset < self.startData.length) {
+                *length = self.startData.length - self.consumerOffset;
+                return (const uint8_t *)self.startData.bytes + self.consumerOffset;
+            }
+            self.phase = CMISUploadPipelinePhaseContent;
+            self.consumerOffset = 0;
+        }
+        
+        if (self.phase == CMISUploadPipelinePhaseContent) {
+            CMISUploadPipelineBuffer *buffer = self.buffers[self.consumerIndex];
+            if (buffer.filled) {
+                *length = buffer.length - self.consumerOffset;
+                return buffer.bytes + self.consumerOffset;
+            }
+            if (!self.sourceFinished) {
+                self.waitingForData = YES;
+                return NULL;
+            }
+            self.phase = CMISUploadPipelinePhaseEndData;
+            self.consumerOffset = 0;
+        }
+        
+        if (self.phase == CMISUploadPipelinePhaseEndData) {
+            if (self.consumerOffset < self.endData.length) {
+                *length = self.endData.length - self.consumerOffset;
+                return (const uint8_t *)self.endData.bytes + self.consumerOffset;
+            }
+            self.phase = CMISUploadPipelinePhaseDone;
+            self.atEnd = YES;
+        }
+        
+        return NULL;
+    }
+}
+
+- (void)consumeBytes:(NSUInteger)length
+{
+    @synchronized(self) {
+        self.consumerOffset += length;
+        if (self.phase == CMISUploadPipelinePhaseContent) {
+            CMISUploadPipelineBuffer *buffer = self.buffers[self.consumerIndex];
+            if (self.consumerOffset >= buffer.length) {
+                // hand the buffer back to the producer
+                buffer.filled = NO;
+                buffer.length = 0;
+                self.consumerIndex = (self.consumerIndex + 1) % self.buffers.count;
+                self.consumerOffset = 0;
+                [self scheduleProducer];
+            }
+        }
+    }
+}
+
+- (void)cancel
+{
+    @synchronized(self) {
+        if (self.cancelled) {
+            return;
+        }
+        self.cancelled = YES;
+        self.dataAvailableBlock = nil;
+        // a running producer closes the stream once its read returns
+        if (!self.producing && !self.sourceFinished) {
+            [self.inputStream close];
+        }
+    }
+}
+
+#pragma mark Private methods
+
+/// must be called while synchronized on self
+- (void)scheduleProducer
+{
+    if (!self.started || self.producing || self.sourceFinished || self.cancelled) {
+        return;
+    }
+    CMISUploadPipelineBuffer *buffer = self.buffers[self.producerIndex];
+    if (buffer.filled) {
+        return;
+    }
+    
+    self.producing = YES;
+    dispatch_async(self.producerQueue, ^{
+        [self fillBuffer:buffer];
+    });
+}
+
+- (void)fillBuffer:(CMISUploadPipelineBuffer *)buffer
+{
+    uint8_t *rawBytes = buffer.rawData.mutableBytes;
+    NSUInteger rawLength = 0;
+    NSError *readError = nil;
+    BOOL endOfStream = NO;
+    
+    // fill the whole chunk, a short read in the middle of the content would otherwise put base64 padding into the body
+    while (rawLength < self.rawChunkSize && !self.cancelled) {
+        NSInteger bytesRead = [self.inputStream read:rawBytes + rawLength maxLength:self.rawChunkSize - rawLength];
+        if (bytesRead < 0) {
+            NSError *streamError = self.inputStream.streamError;
+            readError = streamError ? [CMISErrors cmisError:streamError cmisErrorCode:kCMISErrorCodeStorage]
+                                    : [CMISErrors createCMISErrorWithCode:kCMISErrorCodeStorage detailedDescription:@"Error while reading from source input stream"];
+            break;
+        } else if (bytesRead == 0) {
+            endOfStream = YES;
+            break;
+        }
+        rawLength += bytesRead;
+    }
+    
+    // the hash covers the content as it was read, not the encoded body
+    [self.contentHasher updateWithBytes:rawBytes length:rawLength];
+    
+    if (self.base64Encoding && rawLength > 0) {
+        buffer.length = [CMISBase64Encoder encodeBytes:rawBytes length:rawLength toBuffer:buffer.encodedData.mutableBytes];
+    } else {
+        buffer.length = rawLength;
+    }
+    
+    void (^dataAvailableBlock)(void) = nil;
+    @synchronized(self) {
+        self.producing = NO;
+        if (self.cancelled || readError || endOfStream) {
+            self.sourceFinished = YES;
+            [self.inputStream close];
+        }
+        if (self.cancelled) {
+            return;
+        }
+        
+        if (readError) {
+            CMISLogError(@"Could not read upload content: %@", readError);
+            self.error = readError;
+        } else if (buffer.length > 0) {
+            buffer.filled = YES;
+            self.producerIndex = (self.producerIndex + 1) % self.buffers.count;
+        }
+        
+        if (self.waitingForData) {
+            self.waitingForData = NO;
+            dataAvailableBlock = self.dataAvailableBlock;
+        }
+        [self scheduleProducer];
+    }
+    
+    if (dataAvailableBlock) {
+        dataAvailableBlock();
+    }
+}
+
+@end
@@ -38,12 +38,363 @@
 #import "CMISAtomPubServiceDocumentParser.h"
 #import "CMISAtomWorkspace.h"
 #import "CMISRequest.h"
+#import "CMISHttpRequest.h"
 #import "CMISErrors.h"
 #import "CMISDateUtil.h"
 #import "CMISLog.h"
 #import "CMISURLUtil.h"
 #import "CMISMimeHelper.h"
 #import "CMISQueryStatement.h"
+#import "CMISRequestScheduler.h"
+#import "CMISRequestCoalescer.h"
+#import "CMISHttpResponse.h"
+#import "CMISHttpValidationCache.h"
+#import "CMISHttpContentCoder.h"
+#import "CMISRetryPolicy.h"
+#import "CMISRequestHedger.h"
+#import "CMISCircuitBreaker.h"
+#import "CMISURLSessionPool.h"
+#import "CMISDefaultNetworkProvider.h"
+#import "CMISStandardAuthenticationProvider.h"
+#import "CMISHttpDownloadRequest.h"
+#import "CMISParallelDownload.h"
+#import "CMISBrowserObjectService.h"
+#import "CMISFileRangeOutputStream.h"
+#import "CMISFileDownloadSink.h"
+#import "CMISStreamDownloadSink.h"
+#import "CMISUploadPipeline.h"
+#import "CMISBase64Encoder.h"
+#import "CMISHttpUploadRequest.h"
+#import "CMISBindingSession.h"
+#import "CMISBase64Decoder.h"
+#import "CMISAtomEntryWriter.h"
+#import "CMISMultipartFormDataStream.h"
+#import "CMISBroswerFormDataWriter.h"
+#import "CMISChunkedUpload.h"
+#import "CMISBandwidthLimiter.h"
+#import "CMISThrottledInputStream.h"
+#import "CMISTransferManager.h"
+#import "CMISContentHasher.h"
+#import "CMISXMLParser.h"
+#import "CMISJSONReader.h"
+#import "CMISBrowserObjectReader.h"
+#if !TARGET_OS_IPHONE
+#import "CMISCurlNetworkProvider.h"
+#endif
+#import "CMISBrowserUtil.h"
+#import "CMISBrowserTypeCache.h"
+#import "CMISBrowserBaseService+Protected.h"
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+/**
+ * Drives the token based AtomPub parsers from NSXMLParser, the engine they were built on before CMISXMLParser.
+ * Serves as the reference for the results and the speed of CMISXMLParser.
+ */
+@interface CMISReferenceXMLParser : CMISXMLParser <NSXMLParserDelegate>
+
+@property (nonatomic, strong) NSXMLParser *foundationParser;
+@property (nonatomic, strong) NSMutableString *characters;
+@property (nonatomic, strong) NSString *currentElementName;
+@property (nonatomic, strong) NSString *currentNamespaceURI;
+@property (nonatomic, strong) NSDictionary *currentAttributes;
+
+@end
+
+@implementation CMISReferenceXMLParser
+
+- (id)initWithData:(NSData *)data
+{
+    self = [super initWithData:data];
+    if (self) {
+        self.foundationParser = [[NSXMLParser alloc] initWithData:data];
+        [self.foundationParser setShouldProcessNamespaces:YES];
+        [self.foundationParser setDelegate:self];
+        self.characters = [NSMutableString string];
+    }
+    return self;
+}
+
+- (BOOL)parse
+{
+    return [self.foundationParser parse];
+}
+
+- (void)abortParsing
+{
+    [self.foundationParser abortParsing];
+}
+
+- (NSError *)parserError
+{
+    return self.foundationParser.parserError;
+}
+
+- (NSString *)text
+{
+    return self.characters;
+}
+
+- (NSString *)elementName
+{
+    return self.currentElementName;
+}
+
+- (NSString *)namespaceURI
+{
+    return self.currentNamespaceURI;
+}
+
+- (NSDictionary *)attributes
+{
+    return self.currentAttributes;
+}
+
+- (NSString *)valueForAttribute:(CMISXMLName)name
+{
+    return [self.currentAttributes objectForKey:[CMISXMLParser stringForName:name]];
+}
+
+- (void)parser:(NSXMLParser *)parser didStartElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName attributes:(NSDictionary *)attributeDict
+{
+    self.characters = [NSMutableString string];
+    self.currentElementName = elementName;
+    self.currentNamespaceURI = namespaceURI;
+    self.currentAttributes = attributeDict;
+    
+    id delegate = self.delegate;
+    if ([delegate respondsToSelector:@selector(parser:didStartElement:inNamespace:)]) {
+        [delegate parser:self didStartElement:[CMISXMLParser nameForString:elementName] inNamespace:[CMISXMLParser namespaceForURI:namespaceURI]];
+    } else if ([delegate respondsToSelector:@selector(parser:didStartElement:namespaceURI:qualifiedName:attributes:)]) {
+        [delegate parser:self didStartElement:elementName namespaceURI:namespaceURI qualifiedName:qName attributes:attributeDict];
+    }
+    self.currentAttributes = nil;
+}
+
+- (void)parser:(NSXMLParser *)parser foundCharacters:(NSString *)string
+{
+    [self.characters appendString:string];
+    
+    id delegate = self.delegate;
+    if (![delegate respondsToSelector:@selector(parser:didStartElement:inNamespace:)] && [delegate respondsToSelector:@selector(parser:foundCharacters:)]) {
+        [delegate parser:self foundCharacters:string];
+    }
+}
+
+- (void)parser:(NSXMLParser *)parser didEndElement:(NSString *)elementName namespaceURI:(NSString *)namespaceURI qualifiedName:(NSString *)qName
+{
+    self.currentElementName = elementName;
+    self.currentNamespaceURI = namespaceURI;
+    
+    id delegate = self.delegate;
+    if ([delegate respondsToSelector:@selector(parser:didEndElement:inNamespace:)]) {
+        [delegate parser:self didEndElement:[CMISXMLParser nameForString:elementName] inNamespace:[CMISXMLParser namespaceForURI:namespaceURI]];
+    } else if ([delegate respondsToSelector:@selector(parser:didEndElement:namespaceURI:qualifiedName:)]) {
+        [delegate parser:self didEndElement:elementName namespaceURI:namespaceURI qualifiedName:qName];
+    }
+    self.characters = [NSMutableString string];
+}
+
+@end
+
+
+/**
+ * Builds the Foundation objects NSJSONSerialization returns from the events of a CMISJSONReader.
+ */
+@interface CMISJSONTreeBuilder : NSObject <CMISJSONReaderDelegate>
+
+@property (nonatomic, strong) NSMutableArray *containers;
+@property (nonatomic, strong) NSMutableArray *keys;
+@property (nonatomic, strong) id root;
+
+@end
+
+@implementation CMISJSONTreeBuilder
+
+- (id)init
+{
+    self = [super init];
+    if (self) {
+        self.containers = [NSMutableArray array];
+        self.keys = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)addValue:(id)value
+{
+    id container = self.containers.lastObject;
+    if (!container) {
+        self.root = value;
+    } else if ([container isKindOfClass:NSMutableArray.class]) {
+        [container addObject:value];
+    } else {
+        [container setObject:value forKey:self.keys.lastObject];
+        [self.keys removeLastObject];
+    }
+}
+
+- (void)readerDidStartObject:(CMISJSONReader *)reader
+{
+    [self.containers addObject:[NSMutableDictionary dictionary]];
+}
+
+- (void)readerDidEndObject:(CMISJSONReader *)reader
+{
+    id container = self.containers.lastObject;
+    [self.containers removeLastObject];
+    [self addValue:container];
+}
+
+- (void)readerDidStartArray:(CMISJSONReader *)reader
+{
+    [self.containers addObject:[NSMutableArray array]];
+}
+
+- (void)readerDidEndArray:(CMISJSONReader *)reader
+{
+    [self readerDidEndObject:reader];
+}
+
+- (void)reader:(CMISJSONReader *)reader didReadKey:(NSString *)key
+{
+    [self.keys addObject:key];
+}
+
+- (void)reader:(CMISJSONReader *)reader didReadValue:(id)value
+{
+    [self addValue:value];
+}
+
+@end
+
+
+/**
+ * A Browser binding service that serves type definitions on the next run loop turn instead of retrieving them from a repository.
+ */
+@interface CMISTypeDefinitionServiceStub : CMISBrowserBaseService
+
+@property (nonatomic, strong) NSMutableDictionary *typeDefinitions;
+@property (nonatomic, strong) NSMutableArray *requestedTypeIds;
+@property (nonatomic, assign) NSUInteger pendingRequestCount;
+@property (nonatomic, assign) NSUInteger maxPendingRequestCount;
+
+@end
+
+@implementation CMISTypeDefinitionServiceStub
+
+- (id)initWithBindingSession:(CMISBindingSession *)session
+{
+    self = [super initWithBindingSession:session];
+    if (self) {
+        self.typeDefinitions = [NSMutableDictionary dictionary];
+        self.requestedTypeIds = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (CMISRequest *)retrieveTypeDefinitionInternal:(NSString *)typeId
+                                    cmisRequest:(CMISRequest *)cmisRequest
+                                completionBlock:(void (^)(CMISTypeDefinition *typeDefinition, NSError *error))completionBlock
+{
+    [self.requestedTypeIds addObject:typeId];
+    self.pendingRequestCount++;
+    self.maxPendingRequestCount = MAX(self.maxPendingRequestCount, self.pendingRequestCount);
+    
+    void (^responseBlock)(void) = ^{
+        self.pendingRequestCount--;
+        CMISTypeDefinition *typeDefinition = self.typeDefinitions[typeId];
+        if (typeDefinition) {
+            completionBlock(typeDefinition, nil);
+        } else {
+            completionBlock(nil, [CMISErrors createCMISErrorWithCode:kCMISErrorCodeObjectNotFound detailedDescription:typeId]);
+        }
+    };
+    [self performSelector:@selector(executeBlock:) onThread:[NSThread currentThread] withObject:responseBlock waitUntilDone:NO];
+    return cmisRequest;
+}
+
+- (void)executeBlock:(void (^)(void))block
+{
+    block();
+}
+
+@end
+
+
+/**
+ * A Browser binding object service that serves byte ranges of its content on the next run loop turns instead of
+ * retrieving them from a repository. Each response has the headers a server honouring range requests sends.
+ */
+@interface CMISRangeObjectServiceStub : CMISBrowserObjectService
+
+@property (nonatomic, strong) NSData *content;
+@property (nonatomic, strong) NSMutableDictionary *entityTags; // ETag per offset, "v1" if not set
+@property (nonatomic, strong) NSMutableArray *startedOffsets;
+@property (nonatomic, assign) NSUInteger startedRangeCountAtFirstCompletion;
+
+@end
+
+@implementation CMISRangeObjectServiceStub
+
+- (id)initWithBindingSession:(CMISBindingSession *)session
+{
+    self = [super initWithBindingSession:session];
+    if (self) {
+        self.entityTags = [NSMutableDictionary dictionary];
+        self.startedOffsets = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (CMISRequest*)downloadContentOfObject:(NSString *)objectId
+                               streamId:(NSString *)streamId
+                         toOutputStream:(NSOutputStream *)outputStream
+                                 offset:(NSDecimalNumber*)offset
+                                 length:(NSDecimalNumber*)length
+                        completionBlock:(void (^)(NSError *error))completionBlock
+                          progressBlock:(void (^)(unsigned long long bytesDownloaded, unsigned long long bytesTotal))progressBlock
+{
+    NSUInteger rangeOffset = offset.unsignedIntegerValue;
+    NSUInteger rangeLength = length.unsignedIntegerValue;
+    [self.startedOffsets addObject:@(rangeOffset)];
+    
+    NSString *entityTag = self.entityTags[@(rangeOffset)] ?: @"\"v1\"";
+    NSString *contentRange = [NSString stringWithFormat:@"bytes %lu-%lu/%lu", (unsigned long)rangeOffset,
+                              (unsigned long)(rangeOffset + rangeLength - 1), (unsigned long)self.content.length];
+    CMISHttpRequest *httpRequest = [[CMISHttpRequest alloc] initWithHttpMethod:HTTP_GET completionBlock:nil];
+    httpRequest.response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"http://127.0.0.1:1/content"]
+                                                       statusCode:206
+                                                      HTTPVersion:@"HTTP/1.1"
+                                                     headerFields:@{@"Content-Range": contentRange, @"ETag": entityTag}];
+    CMISRequest *cmisRequest = [[CMISRequest alloc] init];
+    cmisRequest.httpRequest = httpRequest;
+    
+    // the body arrives on one run loop turn and the request completes on a later one
+    void (^dataBlock)(void) = ^{
+        [outputStream open];
+        [outputStream write:(const uint8_t *)self.content.bytes + rangeOffset maxLength:rangeLength];
+        progressBlock(rangeLength, rangeLength);
+        [self performSelector:@selector(executeBlock:) onThread:[NSThread currentThread] withObject:^{
+            if (self.startedRangeCountAtFirstCompletion == 0) {
+                self.startedRangeCountAtFirstCompletion = self.startedOffsets.count;
+            }
+            [outputStream close];
+            completionBlock(nil);
+        } waitUntilDone:NO];
+    };
+    [self performSelector:@selector(executeBlock:) onThread:[NSThread currentThread] withObject:dataBlock waitUntilDone:NO];
+    return cmisRequest;
+}
+
+- (void)executeBlock:(void (^)(void))block
+{
+    block();
+}
+
+@end
+
 
 @interface ObjectiveCMISTests ()
 
@@ -275,6 +626,38 @@
     }];
 }
 
+- (void)testRetrieveFolderChildrenIncrementally
+{
+    [self runTest:^ {
+        id<CMISNavigationService> navigationService = self.session.binding.navigationService;
+        if (![navigationService respondsToSelector:@selector(retrieveChildren:orderBy:filter:relationships:renditionFilter:includeAllowableActions:includePathSegment:skipCount:maxItems:entryBlock:completionBlock:)]) {
+            self.testCompleted = YES; // the binding does not stream children
+            return;
+        }
+        
+        __block NSUInteger entryCount = 0;
+        [navigationService retrieveChildren:self.rootFolder.identifier
+                                    orderBy:nil
+                                     filter:nil
+                              relationships:CMISIncludeRelationshipNone
+                            renditionFilter:nil
+                    includeAllowableActions:NO
+                         includePathSegment:NO
+                                  skipCount:nil
+                                   maxItems:nil
+                                 entryBlock:^(CMISObjectData *objectData) {
+                                     XCTAssertNotNil(objectData.identifier, @"Entry should have an identifier");
+                                     entryCount++;
+                                 }
+                            completionBlock:^(CMISObjectList *objectList, NSError *error) {
+                                XCTAssertNil(error, @"Got error while retrieving children: %@", [error description]);
+                                XCTAssertEqual(objectList.objects.count, (NSUInteger)0, @"Children should only be handed to the entry block");
+                                XCTAssertTrue(entryCount >= 3, @"There should be at least 3 children");
+                                self.testCompleted = YES;
+                            }];
+    }];
+}
+
 - (void)testRetrieveFolderChildrenUsingPaging
 {
     [self runTest:^ {
@@ -1388,6 +1771,120 @@
      }];
 }
 
+- (void)testChunkedChangeContentOfDocument
+{
+    [self runTest:^ {
+         // Upload test file
+         [self uploadTestFileWithCompletionBlock:^(CMISDocument *originalDocument) {
+             // Change content of test file in parts of 16 bytes
+             [self.session.sessionParameters setObject:@16 forKey:kCMISSessionParameterUploadPartSize];
+             NSString *newContentFilePath = [[NSBundle bundleForClass:[self class]] pathForResource:@"test_file_2.txt" ofType:nil];
+             NSString *checkpointFilePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"chunked_upload_checkpoint.plist"];
+             __block NSUInteger partCount = 0;
+             __block long long previousUploadedBytes = -1;
+             [originalDocument changeContentToContentOfFile:newContentFilePath
+                                                   mimeType:@"text/plain"
+                                         checkpointFilePath:checkpointFilePath
+                                            completionBlock:^(NSError *error) {
+                 [self.session.sessionParameters removeKey:kCMISSessionParameterUploadPartSize];
+                 XCTAssertNil(error, @"Got error while changing content of document in parts: %@", [error description]);
+                 XCTAssertTrue(partCount > 1, @"Expected content to be uploaded in several parts");
+                 XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:checkpointFilePath], @"Checkpoint file should be removed");
+                 
+                 // some repos will up the version when uploading new content
+                 [originalDocument retrieveObjectOfLatestVersionWithMajorVersion:NO completionBlock:^(CMISDocument *latestVersionOfDocument, NSError *error) {
+                     NSData *content = [NSData dataWithContentsOfFile:newContentFilePath];
+                     XCTAssertEqual(latestVersionOfDocument.contentStreamLength, (unsigned long long)content.length, @"Content length does not match");
+                     
+                     [self deleteDocumentAndVerify:originalDocument completionBlock:^{
+                         self.testCompleted = YES;
+                     }];
+                 }];
+             } partCompletionBlock:^(NSUInteger partIndex, unsigned long long partLength, double bytesPerSecond) {
+                 XCTAssertEqual(partIndex, partCount, @"Parts should be acknowledged in order");
+                 XCTAssertTrue(partLength <= 16, @"Part is larger than the part size");
+                 partCount++;
+             } progressBlock:^(unsigned long long bytesUploaded, unsigned long long bytesTotal) {
+                 XCTAssertTrue((long long)bytesUploaded >= previousUploadedBytes, @"Progress went backwards");
+                 previousUploadedBytes = bytesUploaded;
+             }];
+         }];
+     }];
+}
+
+- (void)testTransferManagerUploads
+{
+    [self runTest:^ {
+        // files of different sizes, so the manager has something to order
+        NSMutableArray *jobs = [NSMutableArray array];
+        for (NSUInteger i = 0; i < 3; i++) {
+            NSString *fileName = [NSString stringWithFormat:@"transfer_test_%lu_%@.txt", (unsigned long)i, [self stringFromCurrentDate]];
+            NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:fileName];
+            NSData *content = [[@"" stringByPaddingToLength:(i + 1) * 1024 withString:@"transfer " startingAtIndex:0] dataUsingEncoding:NSUTF8StringEncoding];
+            [content writeToFile:filePath atomically:YES];
+            NSDictionary *properties = @{kCMISPropertyName : fileName, kCMISPropertyObjectTypeId : kCMISPropertyObjectTypeIdValueDocument};
+            [jobs addObject:[CMISTransferJob uploadJobWithFilePath:filePath mimeType:@"text/plain" properties:properties toFolder:self.rootFolder]];
+        }
+        
+        CMISTransferManager *transferManager = [[CMISTransferManager alloc] initWithSession:self.session];
+        transferManager.maxConcurrentTransfers = 2;
+        transferManager.bandwidthLimit = 64 * 1024;
+        __block NSUInteger maxRunningJobCount = 0;
+        transferManager.progressBlock = ^(unsigned long long bytesTransferred, unsigned long long bytesTotal, double bytesPerSecond) {
+            XCTAssertTrue(bytesTransferred <= bytesTotal, @"More bytes transferred than expected");
+            maxRunningJobCount = MAX(maxRunningJobCount, transferManager.runningJobCount);
+        };
+        transferManager.completionBlock = ^(NSArray *failedJobs) {
+            XCTAssertEqual(failedJobs.count, (NSUInteger)0, @"Expected all uploads to succeed");
+            XCTAssertEqual(transferManager.bytesTransferred, transferManager.bytesTotal, @"Expected all bytes to be transferred");
+            XCTAssertTrue(maxRunningJobCount <= 2, @"More jobs running than allowed");
+            XCTAssertEqual(transferManager.jobs.count, (NSUInteger)0, @"Expected the finished jobs to be dropped");
+            
+            __block NSUInteger remainingDeletes = jobs.count;
+            for (CMISTransferJob *job in jobs) {
+                XCTAssertEqual(job.state, CMISTransferStateSucceeded, @"Job did not succeed");
+                [[NSFileManager defaultManager] removeItemAtPath:job.filePath error:nil];
+                [self.session.binding.objectService deleteObject:job.objectId allVersions:YES completionBlock:^(BOOL objectDeleted, NSError *error) {
+                    XCTAssertTrue(objectDeleted, @"Could not delete uploaded document: %@", [error description]);
+                    if (--remainingDeletes == 0) {
+                        self.testCompleted = YES;
+                    }
+                }];
+            }
+        };
+        
+        [transferManager addJobs:jobs];
+        // the largest file is started first
+        XCTAssertEqual(((CMISTransferJob *)[jobs objectAtIndex:2]).state, CMISTransferStateRunning, @"Largest job should be running");
+        XCTAssertEqual(((CMISTransferJob *)[jobs objectAtIndex:0]).state, CMISTransferStateQueued, @"Smallest job should be queued");
+    }];
+}
+
+- (void)testDownloadWithContentHash
+{
+    [self runTest:^ {
+        [self uploadTestFileWithCompletionBlock:^(CMISDocument *document) {
+            [self.session.sessionParameters setObject:@(CMISContentHashAlgorithmSHA256) forKey:kCMISSessionParameterContentHashAlgorithm];
+            NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"content_hash_download.txt"];
+            __block CMISRequest *request = nil;
+            request = [document downloadContentToFile:filePath completionBlock:^(NSError *error) {
+                [self.session.sessionParameters removeKey:kCMISSessionParameterContentHashAlgorithm];
+                XCTAssertNil(error, @"Got error while downloading content with hashing enabled: %@", [error description]);
+                
+                // the hash computed while downloading must match the hash of the file
+                CMISContentHasher *hasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmSHA256];
+                [hasher updateWithData:[NSData dataWithContentsOfFile:filePath]];
+                XCTAssertEqualObjects(request.contentHash, [hasher finish], @"Hash of downloaded content is wrong");
+                [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+                
+                [self deleteDocumentAndVerify:document completionBlock:^{
+                    self.testCompleted = YES;
+                }];
+            } progressBlock:nil];
+        }];
+    }];
+}
+
 - (void)testDeleteContentOfDocument
 {
     [self runTest:^ {
@@ -1877,81 +2374,449 @@
     testFolderChildrenXml(@"FolderChildren-opencmis", YES);
 }
 
-// This test test the extension levels Allowable Actions, Object, and Properties, with simplicity
-// the same extension elements are used at each of the different levels
-- (void)testParsedExtensionElementsFromAtomFeedXml
+// Test that a feed parsed while it is received gives the same entries as the whole feed
+- (void)testIncrementalAtomFeedParsing
 {
-    static NSString *exampleUri = @"http://www.example.com";
+    NSString *filePath = [[NSBundle bundleForClass:[self class]] pathForResource:@"FolderChildren-opencmis" ofType:@"xml"];
+    NSData *atomData = [[NSData alloc] initWithContentsOfFile:filePath];
+    XCTAssertNotNil(atomData, @"FolderChildren-opencmis.xml is missing from the test target!");
     
-    // Local Blocks
-    void (^testSimpleRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
-        [self checkExtensionElement:rootExtElement withName:@"testExtSimpleRoot" namespaceUri:exampleUri attributeCount:0 childrenCount:1 hasValue:NO];
-        
-        CMISExtensionElement *simpleChildExtElement = rootExtElement.children.lastObject;
-        [self checkExtensionElement:simpleChildExtElement withName:@"simpleChild" namespaceUri:@"http://www.example.com" attributeCount:0 childrenCount:0 hasValue:YES];
-        XCTAssertTrue([simpleChildExtElement.value isEqualToString:@"simpleChildValue"], @"Expected value 'simpleChildValue' but was '%@'", simpleChildExtElement.value);
-    };
+    CMISAtomFeedParser *feedParser = [[CMISAtomFeedParser alloc] initWithData:atomData];
+    XCTAssertTrue([feedParser parseAndReturnError:nil], @"Failed to parse FolderChildren-opencmis.xml");
     
-    void (^testComplexRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
-        [self checkExtensionElement:rootExtElement withName:@"testExtRoot" namespaceUri:exampleUri attributeCount:0 childrenCount:5 hasValue:NO];
-        // Children Depth=1
-        [self checkExtensionElement:[rootExtElement.children objectAtIndex:0] withName:@"testExtChildLevel1A" namespaceUri:exampleUri attributeCount:0 childrenCount:0 hasValue:YES];
-        [self checkExtensionElement:[rootExtElement.children objectAtIndex:1] withName:@"testExtChildLevel1A" namespaceUri:exampleUri attributeCount:0 childrenCount:0 hasValue:YES];
-        [self checkExtensionElement:[rootExtElement.children objectAtIndex:2] withName:@"testExtChildLevel1B" namespaceUri:exampleUri attributeCount:1 childrenCount:1 hasValue:NO];
-        [self checkExtensionElement:[rootExtElement.children objectAtIndex:3] withName:@"testExtChildLevel1B" namespaceUri:exampleUri attributeCount:1 childrenCount:0 hasValue:NO];
-        [self checkExtensionElement:[rootExtElement.children objectAtIndex:4] withName:@"testExtChildLevel1B" namespaceUri:exampleUri attributeCount:1 childrenCount:0 hasValue:YES];
-        
-        CMISExtensionElement *level1ExtElement = [rootExtElement.children objectAtIndex:2];
-        
-        CMISExtensionElement *level2ExtElement = level1ExtElement.children.lastObject;
-        [self checkExtensionElement:level2ExtElement withName:@"testExtChildLevel2" namespaceUri:exampleUri attributeCount:1 childrenCount:1 hasValue:NO];
-        
-        CMISExtensionElement *level3ExtElement = level2ExtElement.children.lastObject;
-        [self checkExtensionElement:level3ExtElement withName:@"testExtChildLevel3" namespaceUri:exampleUri attributeCount:1 childrenCount:0 hasValue:YES];
-    };
+    NSMutableArray *entries = [NSMutableArray array];
+    CMISAtomFeedParser *incrementalParser = [[CMISAtomFeedParser alloc] initWithEntryBlock:^(CMISObjectData *objectData) {
+        XCTAssertTrue([NSThread isMainThread], @"Entries should be handed over on the calling thread");
+        [entries addObject:objectData];
+    }];
     
-    NSString *filePath = [[NSBundle bundleForClass:[self class]] pathForResource:@"AtomFeedWithExtensions" ofType:@"xml"];
+    // hand over the feed in small chunks, as they would arrive from the network
+    NSUInteger chunkLength = 333;
+    for (NSUInteger offset = 0; offset < atomData.length; offset += chunkLength) {
+        [incrementalParser appendData:[atomData subdataWithRange:NSMakeRange(offset, MIN(chunkLength, atomData.length - offset))]];
+    }
+    [incrementalParser finishWithCompletionBlock:^(NSError *error) {
+        XCTAssertNil(error, @"Failed to parse feed incrementally: %@", error);
+        XCTAssertEqual(entries.count, feedParser.entries.count, @"Unexpected number of entries");
+        XCTAssertNil(incrementalParser.entries, @"Entries should not be kept by an incremental parser");
+        XCTAssertEqual(incrementalParser.numItems, feedParser.numItems, @"Unexpected number of items");
+        
+        // the reused entry parser must not carry state from one entry to the next
+        for (NSUInteger i = 0; i < entries.count; i++) {
+            CMISObjectData *objectData = entries[i];
+            CMISObjectData *expectedObjectData = feedParser.entries[i];
+            XCTAssertEqualObjects(objectData.identifier, expectedObjectData.identifier, @"Unexpected entry");
+            XCTAssertEqual(objectData.properties.propertyList.count, expectedObjectData.properties.propertyList.count, @"Unexpected number of properties");
+            XCTAssertEqual(objectData.properties.extensions.count, expectedObjectData.properties.extensions.count, @"Unexpected number of extensions");
+            XCTAssertEqual(objectData.linkRelations.linkRelationSet.count, expectedObjectData.linkRelations.linkRelationSet.count, @"Unexpected number of links");
+        }
+        self.testCompleted = YES;
+    }];
+    [self waitForCompletion:10];
+}
+
+// Test that CMISXMLParser gives the same entries as NSXMLParser
+- (void)testXMLParserMatchesReferenceParser
+{
+    NSString *filePath = [[NSBundle bundleForClass:[self class]] pathForResource:@"FolderChildren-opencmis" ofType:@"xml"];
     NSData *atomData = [[NSData alloc] initWithContentsOfFile:filePath];
-    XCTAssertNotNil(atomData, @"AtomFeedWithExtensions.xml is missing from the test target!");
+    XCTAssertNotNil(atomData, @"FolderChildren-opencmis.xml is missing from the test target!");
     
-    NSError *error = nil;
     CMISAtomFeedParser *feedParser = [[CMISAtomFeedParser alloc] initWithData:atomData];
-    XCTAssertTrue([feedParser parseAndReturnError:&error], @"Failed to parse AtomFeedWithExtensions.xml");
+    XCTAssertTrue([feedParser parseAndReturnError:nil], @"Failed to parse FolderChildren-opencmis.xml");
     
-    NSArray *entries = feedParser.entries;
-    XCTAssertTrue(entries.count == 2, @"Expected 2 parsed entry objects, but found %lu", (unsigned long)entries.count);
+    NSMutableArray *referenceEntries = [NSMutableArray array];
+    CMISAtomFeedParser *referenceFeedParser = [[CMISAtomFeedParser alloc] initWithEntryBlock:^(CMISObjectData *objectData) {
+        [referenceEntries addObject:objectData];
+    }];
+    CMISReferenceXMLParser *referenceParser = [[CMISReferenceXMLParser alloc] initWithData:atomData];
+    [referenceParser setDelegate:referenceFeedParser];
+    XCTAssertTrue([referenceParser parse], @"Failed to parse FolderChildren-opencmis.xml with NSXMLParser");
     
-    for (CMISObjectData *objectData  in entries) {
-        XCTAssertTrue(objectData.extensions.count == 2, @"Expected 2 extension elements, but found %lu", (unsigned long)objectData.extensions.count);
-        testSimpleRootExtensionElement([objectData.extensions objectAtIndex:0]);
-        testComplexRootExtensionElement([objectData.extensions objectAtIndex:1]);
-        
-        XCTAssertTrue(objectData.allowableActions.extensions.count == 2, @"Expected 2 extension elements, but found %lu", (unsigned long)objectData.allowableActions.extensions.count);
-        testSimpleRootExtensionElement([objectData.allowableActions.extensions objectAtIndex:0]);
-        testComplexRootExtensionElement([objectData.allowableActions.extensions objectAtIndex:1]);
+    XCTAssertEqual(feedParser.numItems, referenceFeedParser.numItems, @"Unexpected number of items");
+    XCTAssertEqual(feedParser.linkRelations.linkRelationSet.count, referenceFeedParser.linkRelations.linkRelationSet.count, @"Unexpected number of feed links");
+    XCTAssertEqual(feedParser.entries.count, referenceEntries.count, @"Unexpected number of entries");
+    for (NSUInteger i = 0; i < referenceEntries.count; i++) {
+        CMISObjectData *objectData = feedParser.entries[i];
+        CMISObjectData *referenceObjectData = referenceEntries[i];
+        XCTAssertEqualObjects(objectData.identifier, referenceObjectData.identifier, @"Unexpected entry");
+        XCTAssertEqual(objectData.baseType, referenceObjectData.baseType, @"Unexpected base type");
+        XCTAssertEqualObjects(objectData.contentUrl, referenceObjectData.contentUrl, @"Unexpected content url");
+        XCTAssertEqual(objectData.renditions.count, referenceObjectData.renditions.count, @"Unexpected number of renditions");
+        XCTAssertEqual(objectData.extensions.count, referenceObjectData.extensions.count, @"Unexpected number of extensions");
+        XCTAssertEqual(objectData.linkRelations.linkRelationSet.count, referenceObjectData.linkRelations.linkRelationSet.count, @"Unexpected number of links");
+        XCTAssertEqual(objectData.allowableActions.allowableActionsSet.count, referenceObjectData.allowableActions.allowableActionsSet.count, @"Unexpected allowable actions");
         
-        NSArray *extensions = objectData.properties.extensions;
-        XCTAssertTrue(extensions.count == 2, @"Expected only one extension element but encountered %lu", (unsigned long)extensions.count);
-        testSimpleRootExtensionElement([objectData.properties.extensions objectAtIndex:0]);
-        testComplexRootExtensionElement([objectData.properties.extensions objectAtIndex:1]);
+        NSDictionary *properties = objectData.properties.propertiesDictionary;
+        NSDictionary *referenceProperties = referenceObjectData.properties.propertiesDictionary;
+        XCTAssertEqualObjects([NSSet setWithArray:[properties allKeys]], [NSSet setWithArray:[referenceProperties allKeys]], @"Unexpected properties");
+        for (NSString *propertyId in referenceProperties) {
+            CMISPropertyData *property = properties[propertyId];
+            CMISPropertyData *referenceProperty = referenceProperties[propertyId];
+            XCTAssertEqual(property.type, referenceProperty.type, @"Unexpected type of %@", propertyId);
+            XCTAssertEqualObjects(property.displayName, referenceProperty.displayName, @"Unexpected display name of %@", propertyId);
+            XCTAssertEqualObjects(property.queryName, referenceProperty.queryName, @"Unexpected query name of %@", propertyId);
+            XCTAssertEqualObjects(property.values, referenceProperty.values, @"Unexpected values of %@", propertyId);
+        }
     }
 }
 
-
-- (void)testParsedExtensionElementsFromAtomPubService
+- (void)testXMLParserErrorsAndEntities
 {
-    static NSString *exampleUri = @"http://www.example.com";
+    // entities in attribute values and text are decoded
+    NSString *feed = @"<feed xmlns=\"http://www.w3.org/2005/Atom\" xmlns:cmisra=\"http://docs.oasis-open.org/ns/cmis/restatom/200908/\">"
+                     @"<link rel=\"next\" href=\"http://localhost/children?skipCount=10&amp;maxItems=10\"/>"
+                     @"<cmisra:numItems>1&#50;</cmisra:numItems></feed>";
+    CMISAtomFeedParser *feedParser = [[CMISAtomFeedParser alloc] initWithData:[feed dataUsingEncoding:NSUTF8StringEncoding]];
+    NSError *error = nil;
+    XCTAssertTrue([feedParser parseAndReturnError:&error], @"Failed to parse feed: %@", error);
+    XCTAssertEqualObjects([feedParser.linkRelations linkHrefForRel:@"next"], @"http://localhost/children?skipCount=10&maxItems=10");
+    XCTAssertEqual(feedParser.numItems, 12);
     
-    // Local Blocks
-    void (^testSimpleRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
-        [self checkExtensionElement:rootExtElement withName:@"testExtSimpleRoot" namespaceUri:exampleUri attributeCount:0 childrenCount:1 hasValue:NO];
-        
-        CMISExtensionElement *simpleChildExtElement = rootExtElement.children.lastObject;
-        [self checkExtensionElement:simpleChildExtElement withName:@"simpleChild" namespaceUri:@"http://www.example.com" attributeCount:0 childrenCount:0 hasValue:YES];
-        XCTAssertTrue([simpleChildExtElement.value isEqualToString:@"simpleChildValue"], @"Expected value 'simpleChildValue' but was '%@'", simpleChildExtElement.value);
-    };
+    // malformed documents fail with the NSXMLParser error domain
+    feedParser = [[CMISAtomFeedParser alloc] initWithData:[@"<feed><entry></feed>" dataUsingEncoding:NSUTF8StringEncoding]];
+    error = nil;
+    XCTAssertFalse([feedParser parseAndReturnError:&error], @"Malformed feed should not be parsed");
+    XCTAssertEqualObjects(error.domain, NSXMLParserErrorDomain);
     
-    void (^testComplexRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
+    // declared and external entities are never resolved
+    NSString *entityFeed = @"<!DOCTYPE feed [<!ENTITY secret SYSTEM \"file:///etc/passwd\">]>"
+                           @"<feed xmlns=\"http://www.w3.org/2005/Atom\"><link rel=\"self\" href=\"&secret;\"/></feed>";
+    feedParser = [[CMISAtomFeedParser alloc] initWithData:[entityFeed dataUsingEncoding:NSUTF8StringEncoding]];
+    error = nil;
+    XCTAssertFalse([feedParser parseAndReturnError:&error], @"Declared entities should not be resolved");
+    XCTAssertNil([feedParser.linkRelations linkHrefForRel:@"self"]);
+    
+    // a document handed over in chunks is parsed up to the error
+    CMISXMLParser *parser = [[CMISXMLParser alloc] init];
+    XCTAssertTrue([parser appendData:[@"<feed><ent" dataUsingEncoding:NSUTF8StringEncoding]]);
+    [parser appendData:[@"ry></feed>" dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertFalse([parser finishParsing]);
+    XCTAssertEqualObjects(parser.parserError.domain, NSXMLParserErrorDomain);
+    XCTAssertFalse([parser appendData:[@"<feed/>" dataUsingEncoding:NSUTF8StringEncoding]], @"Parsing should not continue after an error");
+}
+
+// Test that CMISJSONReader reports the values NSJSONSerialization returns, however the document is split into chunks
+- (void)testJSONReaderMatchesFoundationSerialization
+{
+    NSString *json = @"{\"objects\":[{\"succinctProperties\":{\"cmis:name\":\"Caf\\u00e9 \\\"menu\\\"\\n\\ud83d\\ude00\","
+                     @"\"cmis:contentStreamLength\":1024,\"cmis:creationDate\":1388534400000,\"rating\":-2.5e3,"
+                     @"\"cmis:isLatestVersion\":true,\"cmis:checkinComment\":null,\"cmis:secondaryObjectTypeIds\":[\"P:cm:titled\",\"P:cm:author\"]}},"
+                     @"{\"succinctProperties\":{}}],\"hasMoreItems\":false,\"numItems\":-9223372036854775808,\"nested\":[[],{},[[1,2],{\"a\":[false]}]]}";
+    NSData *jsonData = [json dataUsingEncoding:NSUTF8StringEncoding];
+    id expected = [NSJSONSerialization JSONObjectWithData:jsonData options:0 error:nil];
+    XCTAssertNotNil(expected);
+    
+    for (NSUInteger chunkLength = 1; chunkLength <= jsonData.length; chunkLength = chunkLength * 2 + 1) {
+        CMISJSONTreeBuilder *builder = [[CMISJSONTreeBuilder alloc] init];
+        CMISJSONReader *reader = [[CMISJSONReader alloc] initWithDelegate:builder];
+        for (NSUInteger offset = 0; offset < jsonData.length; offset += chunkLength) {
+            XCTAssertTrue([reader appendData:[jsonData subdataWithRange:NSMakeRange(offset, MIN(chunkLength, jsonData.length - offset))]]);
+        }
+        XCTAssertTrue([reader finishReading], @"Failed to read document in chunks of %lu bytes: %@", (unsigned long)chunkLength, reader.error);
+        XCTAssertEqual(reader.depth, 0);
+        XCTAssertEqualObjects(builder.root, expected, @"Unexpected values in chunks of %lu bytes", (unsigned long)chunkLength);
+    }
+}
+
+- (void)testJSONReaderErrors
+{
+    NSArray *invalidDocuments = @[@"", @"42", @"[1,]", @"{\"a\" 1}", @"[01]", @"[1.]", @"[\"\\ud800\"]", @"[\"\\q\"]",
+                                  @"[tru]", @"{\"a\":1", @"{\"a\":1} x", @"[\"a\nb\"]"];
+    for (NSString *document in invalidDocuments) {
+        NSData *data = [document dataUsingEncoding:NSUTF8StringEncoding];
+        XCTAssertNil([NSJSONSerialization JSONObjectWithData:data options:0 error:nil], @"%@ should be invalid", document);
+        
+        CMISJSONReader *reader = [[CMISJSONReader alloc] initWithDelegate:[[CMISJSONTreeBuilder alloc] init]];
+        [reader appendData:data];
+        XCTAssertFalse([reader finishReading], @"%@ should not be read", document);
+        XCTAssertEqualObjects(reader.error.domain, NSCocoaErrorDomain);
+        XCTAssertEqual(reader.error.code, NSPropertyListReadCorruptError);
+    }
+    
+    // invalid UTF-8
+    const uint8_t invalidBytes[] = {'[', '"', 0xC3, 0x28, '"', ']'};
+    CMISJSONReader *reader = [[CMISJSONReader alloc] initWithDelegate:[[CMISJSONTreeBuilder alloc] init]];
+    XCTAssertFalse([reader appendData:[NSData dataWithBytes:invalidBytes length:sizeof(invalidBytes)]]);
+    XCTAssertNotNil(reader.error);
+    XCTAssertFalse([reader appendData:[@"[]" dataUsingEncoding:NSUTF8StringEncoding]], @"Reading should not continue after an error");
+}
+
+- (NSString *)browserJSONObjectWithId:(NSString *)objectId baseTypeId:(NSString *)baseTypeId name:(NSString *)name
+{
+    return [NSString stringWithFormat:@"{\"properties\":{"
+            @"\"cmis:objectId\":{\"id\":\"cmis:objectId\",\"localName\":\"objectId\",\"displayName\":\"Object Id\",\"queryName\":\"cmis:objectId\",\"type\":\"id\",\"cardinality\":\"single\",\"value\":\"%@\"},"
+            @"\"cmis:baseTypeId\":{\"id\":\"cmis:baseTypeId\",\"localName\":\"baseTypeId\",\"displayName\":\"Base Type Id\",\"queryName\":\"cmis:baseTypeId\",\"type\":\"id\",\"cardinality\":\"single\",\"value\":\"%@\"},"
+            @"\"cmis:name\":{\"id\":\"cmis:name\",\"localName\":\"name\",\"displayName\":\"Name\",\"queryName\":\"cmis:name\",\"type\":\"string\",\"cardinality\":\"single\",\"value\":\"%@\"},"
+            @"\"cmis:creationDate\":{\"id\":\"cmis:creationDate\",\"localName\":\"creationDate\",\"displayName\":\"Creation Date\",\"queryName\":\"cmis:creationDate\",\"type\":\"datetime\",\"cardinality\":\"single\",\"value\":1388534400000},"
+            @"\"cmis:contentStreamLength\":{\"id\":\"cmis:contentStreamLength\",\"localName\":\"contentStreamLength\",\"displayName\":\"Content Stream Length\",\"queryName\":\"cmis:contentStreamLength\",\"type\":\"integer\",\"cardinality\":\"single\",\"value\":1024},"
+            @"\"cmis:isLatestVersion\":{\"id\":\"cmis:isLatestVersion\",\"localName\":\"isLatestVersion\",\"displayName\":\"Is Latest Version\",\"queryName\":\"cmis:isLatestVersion\",\"type\":\"boolean\",\"cardinality\":\"single\",\"value\":true},"
+            @"\"cmis:secondaryObjectTypeIds\":{\"id\":\"cmis:secondaryObjectTypeIds\",\"localName\":\"secondaryObjectTypeIds\",\"displayName\":\"Secondary Type Ids\",\"queryName\":\"cmis:secondaryObjectTypeIds\",\"type\":\"id\",\"cardinality\":\"multi\",\"value\":[\"P:cm:titled\",\"P:cm:author\"]}"
+            @"},\"allowableActions\":{\"canGetProperties\":true,\"canDeleteObject\":false}}", objectId, baseTypeId, name];
+}
+
+- (void)testBrowserObjectReaderReadsFullProperties
+{
+    NSString *json = [NSString stringWithFormat:@"{\"objects\":[{\"object\":%@,\"pathSegment\":\"menu.txt\"},{\"object\":%@}],\"hasMoreItems\":true,\"numItems\":42}",
+                      [self browserJSONObjectWithId:@"doc-1" baseTypeId:@"cmis:document" name:@"Caf\\u00e9 \\\"menu\\\".txt"],
+                      [self browserJSONObjectWithId:@"folder-1" baseTypeId:@"cmis:folder" name:@"Menus"]];
+    NSData *jsonData = [json dataUsingEncoding:NSUTF8StringEncoding];
+    
+    // buffered
+    __block CMISObjectList *objectList = nil;
+    [CMISBrowserUtil objectListFromJSONData:jsonData typeCache:nil isQueryResult:NO completionBlock:^(CMISObjectList *list, NSError *error) {
+        XCTAssertNil(error, @"Failed to read object list: %@", error);
+        objectList = list;
+    }];
+    XCTAssertNotNil(objectList, @"Objects with full properties should be converted without waiting");
+    XCTAssertTrue(objectList.hasMoreItems);
+    XCTAssertEqual(objectList.numItems, 42);
+    XCTAssertEqual(objectList.objects.count, 2);
+    
+    CMISObjectData *document = objectList.objects[0];
+    XCTAssertEqualObjects(document.identifier, @"doc-1");
+    XCTAssertEqual(document.baseType, CMISBaseTypeDocument);
+    XCTAssertEqualObjects([document.properties propertyValueForId:@"cmis:name"], @"Caf\u00e9 \"menu\".txt");
+    XCTAssertEqualObjects([document.properties propertyForId:@"cmis:name"].displayName, @"Name");
+    XCTAssertEqualObjects([document.properties propertyForId:@"cmis:creationDate"].propertyDateTimeValue, [NSDate dateWithTimeIntervalSince1970:1388534400]);
+    XCTAssertEqualObjects([document.properties propertyForId:@"cmis:contentStreamLength"].propertyIntegerValue, @1024);
+    XCTAssertEqualObjects([document.properties propertyForId:@"cmis:isLatestVersion"].propertyBooleanValue, @YES);
+    NSArray *secondaryTypeIds = @[@"P:cm:titled", @"P:cm:author"];
+    XCTAssertEqualObjects([document.properties propertyMultiValueById:@"cmis:secondaryObjectTypeIds"], secondaryTypeIds);
+    XCTAssertEqual(document.allowableActions.allowableActionsSet.count, 1);
+    
+    CMISObjectData *folder = objectList.objects[1];
+    XCTAssertEqualObjects(folder.identifier, @"folder-1");
+    XCTAssertEqual(folder.baseType, CMISBaseTypeFolder);
+    
+    // incremental, in small chunks
+    NSMutableArray *objects = [NSMutableArray array];
+    CMISBrowserObjectReader *reader = [[CMISBrowserObjectReader alloc] initWithResponse:CMISBrowserObjectReaderResponseObjectList typeCache:nil objectBlock:^(CMISObjectData *objectData) {
+        [objects addObject:objectData];
+    }];
+    NSUInteger chunkLength = 17;
+    for (NSUInteger offset = 0; offset < jsonData.length; offset += chunkLength) {
+        XCTAssertTrue([reader appendData:[jsonData subdataWithRange:NSMakeRange(offset, MIN(chunkLength, jsonData.length - offset))]]);
+        if (offset < jsonData.length / 2) {
+            XCTAssertTrue(objects.count < 2, @"The second object should not be complete yet");
+        }
+    }
+    [reader finishWithCompletionBlock:^(CMISObjectList *list, NSError *error) {
+        XCTAssertNil(error, @"Failed to read object list: %@", error);
+        XCTAssertEqual(list.objects.count, 0, @"Objects should not be kept by an incremental reader");
+        XCTAssertEqual(list.numItems, 42);
+        XCTAssertEqual(objects.count, 2);
+        XCTAssertEqualObjects([objects.lastObject identifier], @"folder-1");
+        self.testCompleted = YES;
+    }];
+    [self waitForCompletion:10];
+    
+    // a single object, and a malformed response
+    [CMISBrowserUtil objectDataFromJSONData:[[self browserJSONObjectWithId:@"doc-2" baseTypeId:@"cmis:document" name:@"b"] dataUsingEncoding:NSUTF8StringEncoding]
+                                  typeCache:nil
+                            completionBlock:^(CMISObjectData *objectData, NSError *error) {
+                                XCTAssertNil(error);
+                                XCTAssertEqualObjects(objectData.identifier, @"doc-2");
+                            }];
+    __block NSError *parseError = nil;
+    [CMISBrowserUtil objectListFromJSONData:[@"{\"objects\":[" dataUsingEncoding:NSUTF8StringEncoding] typeCache:nil isQueryResult:NO completionBlock:^(CMISObjectList *list, NSError *error) {
+        parseError = error;
+    }];
+    XCTAssertEqual(parseError.code, kCMISErrorCodeRuntime);
+}
+
+- (CMISPropertyDefinition *)propertyDefinitionWithId:(NSString *)propertyId type:(CMISPropertyType)propertyType cardinality:(CMISCardinality)cardinality
+{
+    CMISPropertyDefinition *propertyDefinition = [[CMISPropertyDefinition alloc] init];
+    propertyDefinition.identifier = propertyId;
+    propertyDefinition.localName = propertyId;
+    propertyDefinition.queryName = propertyId;
+    propertyDefinition.displayName = [propertyId stringByAppendingString:@" display name"];
+    propertyDefinition.propertyType = propertyType;
+    propertyDefinition.cardinality = cardinality;
+    return propertyDefinition;
+}
+
+/// a Browser binding service without a connection, with the cmis:document and P:cm:titled type definitions in the type definition cache of its session
+- (CMISTypeDefinitionServiceStub *)browserServiceWithCachedTypeDefinitions
+{
+    CMISSessionParameters *parameters = [[CMISSessionParameters alloc] initWithBindingType:CMISBindingTypeBrowser];
+    parameters.browserUrl = [NSURL URLWithString:@"http://127.0.0.1:1/"];
+    parameters.repositoryId = @"repository";
+    CMISBindingSession *bindingSession = [[CMISBindingSession alloc] initWithSessionParameters:parameters];
+    
+    CMISTypeDefinition *documentType = [[CMISTypeDefinition alloc] init];
+    documentType.identifier = @"cmis:document";
+    documentType.baseTypeId = CMISBaseTypeDocument;
+    [documentType addPropertyDefinition:[self propertyDefinitionWithId:@"cmis:objectId" type:CMISPropertyTypeId cardinality:CMISCardinalitySingle]];
+    [documentType addPropertyDefinition:[self propertyDefinitionWithId:@"cmis:baseTypeId" type:CMISPropertyTypeId cardinality:CMISCardinalitySingle]];
+    [documentType addPropertyDefinition:[self propertyDefinitionWithId:@"cmis:objectTypeId" type:CMISPropertyTypeId cardinality:CMISCardinalitySingle]];
+    [documentType addPropertyDefinition:[self propertyDefinitionWithId:@"cmis:name" type:CMISPropertyTypeString cardinality:CMISCardinalitySingle]];
+    [documentType addPropertyDefinition:[self propertyDefinitionWithId:@"cmis:creationDate" type:CMISPropertyTypeDateTime cardinality:CMISCardinalitySingle]];
+    [documentType addPropertyDefinition:[self propertyDefinitionWithId:@"cmis:contentStreamLength" type:CMISPropertyTypeInteger cardinality:CMISCardinalitySingle]];
+    [documentType addPropertyDefinition:[self propertyDefinitionWithId:@"cmis:secondaryObjectTypeIds" type:CMISPropertyTypeId cardinality:CMISCardinalityMulti]];
+    [bindingSession.typeDefinitionCache addTypeDefinition:documentType repositoryId:parameters.repositoryId];
+    
+    CMISTypeDefinition *titledType = [[CMISTypeDefinition alloc] init];
+    titledType.identifier = @"P:cm:titled";
+    titledType.baseTypeId = CMISBaseTypeSecondary;
+    [titledType addPropertyDefinition:[self propertyDefinitionWithId:@"cm:title" type:CMISPropertyTypeString cardinality:CMISCardinalitySingle]];
+    [titledType addPropertyDefinition:[self propertyDefinitionWithId:@"cm:lastReviewed" type:CMISPropertyTypeDateTime cardinality:CMISCardinalitySingle]];
+    [bindingSession.typeDefinitionCache addTypeDefinition:titledType repositoryId:parameters.repositoryId];
+    
+    return [[CMISTypeDefinitionServiceStub alloc] initWithBindingSession:bindingSession];
+}
+
+- (NSString *)browserSuccinctJSONObjectWithId:(NSString *)objectId
+{
+    return [NSString stringWithFormat:@"{\"succinctProperties\":{"
+            @"\"cmis:objectId\":\"%@\",\"cmis:baseTypeId\":\"cmis:document\",\"cmis:objectTypeId\":\"cmis:document\",\"cmis:name\":\"%@.txt\","
+            @"\"cmis:creationDate\":1388534400000,\"cmis:contentStreamLength\":1024,\"cmis:secondaryObjectTypeIds\":[\"P:cm:titled\"],"
+            @"\"cm:title\":\"Title of %@\",\"cm:lastReviewed\":1388620800000"
+            @"},\"allowableActions\":{\"canGetProperties\":true}}", objectId, objectId, objectId];
+}
+
+- (void)testBrowserUtilConvertsSuccinctPropertiesWithCachedTypeDefinitions
+{
+    CMISBrowserBaseService *service = [self browserServiceWithCachedTypeDefinitions];
+    CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:service.bindingSession.repositoryId bindingService:service];
+    XCTAssertTrue([typeCache cachedTypeDefinition:@"cmis:document" typeDefinition:NULL]);
+    XCTAssertFalse([typeCache cachedTypeDefinition:@"cmis:folder" typeDefinition:NULL]);
+    
+    NSString *json = [NSString stringWithFormat:@"{\"objects\":[{\"object\":%@},{\"object\":%@}],\"hasMoreItems\":false,\"numItems\":2}",
+                      [self browserSuccinctJSONObjectWithId:@"doc-1"], [self browserSuccinctJSONObjectWithId:@"doc-2"]];
+    __block CMISObjectList *objectList = nil;
+    [CMISBrowserUtil objectListFromJSONData:[json dataUsingEncoding:NSUTF8StringEncoding] typeCache:typeCache isQueryResult:NO completionBlock:^(CMISObjectList *list, NSError *error) {
+        XCTAssertNil(error, @"Failed to convert object list: %@", error);
+        objectList = list;
+    }];
+    XCTAssertNotNil(objectList, @"Objects should be converted without waiting when all type definitions are cached");
+    XCTAssertEqual(objectList.objects.count, 2);
+    
+    CMISObjectData *document = objectList.objects[1];
+    XCTAssertEqualObjects(document.identifier, @"doc-2");
+    XCTAssertEqual(document.baseType, CMISBaseTypeDocument);
+    XCTAssertEqual([document.properties propertyForId:@"cmis:creationDate"].type, CMISPropertyTypeDateTime);
+    XCTAssertEqualObjects([document.properties propertyForId:@"cmis:creationDate"].propertyDateTimeValue, [NSDate dateWithTimeIntervalSince1970:1388534400]);
+    XCTAssertEqualObjects([document.properties propertyForId:@"cmis:name"].displayName, @"cmis:name display name");
+    XCTAssertEqual([document.properties propertyForId:@"cm:lastReviewed"].type, CMISPropertyTypeDateTime, @"Secondary type properties should be typed by the secondary type");
+    XCTAssertEqualObjects([document.properties propertyValueForId:@"cm:title"], @"Title of doc-2");
+}
+
+- (void)testBrowserObjectReaderRetrievesTypeDefinitionsAtOnce
+{
+    CMISTypeDefinitionServiceStub *service = [self browserServiceWithCachedTypeDefinitions];
+    NSMutableString *json = [NSMutableString stringWithString:@"{\"results\":["];
+    for (NSUInteger i = 0; i < 40; i++) {
+        NSString *typeId = [NSString stringWithFormat:@"D:test:type%lu", (unsigned long)(i % 8)];
+        NSString *secondaryTypeId = [NSString stringWithFormat:@"P:test:aspect%lu", (unsigned long)(i % 4)];
+        for (NSString *identifier in @[typeId, secondaryTypeId]) {
+            if (!service.typeDefinitions[identifier]) {
+                CMISTypeDefinition *typeDefinition = [[CMISTypeDefinition alloc] init];
+                typeDefinition.identifier = identifier;
+                [typeDefinition addPropertyDefinition:[self propertyDefinitionWithId:[identifier stringByAppendingString:@":date"] type:CMISPropertyTypeDateTime cardinality:CMISCardinalitySingle]];
+                service.typeDefinitions[identifier] = typeDefinition;
+            }
+        }
+        [json appendFormat:@"%@{\"succinctProperties\":{\"cmis:objectId\":\"doc-%lu\",\"cmis:baseTypeId\":\"cmis:document\",\"cmis:objectTypeId\":\"%@\","
+         @"\"cmis:secondaryObjectTypeIds\":[\"%@\"],\"%@:date\":1388534400000,\"%@:date\":1388534400000}}",
+         (i > 0 ? @"," : @""), (unsigned long)i, typeId, secondaryTypeId, typeId, secondaryTypeId];
+    }
+    [json appendString:@"],\"hasMoreItems\":false,\"numItems\":40}"];
+    
+    CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:service.bindingSession.repositoryId bindingService:service];
+    [CMISBrowserUtil objectListFromJSONData:[json dataUsingEncoding:NSUTF8StringEncoding] typeCache:typeCache isQueryResult:YES completionBlock:^(CMISObjectList *objectList, NSError *error) {
+        XCTAssertNil(error, @"Failed to convert query result: %@", error);
+        XCTAssertEqual(objectList.objects.count, 40);
+        
+        CMISObjectData *objectData = objectList.objects.lastObject;
+        XCTAssertEqualObjects(objectData.identifier, @"doc-39");
+        XCTAssertEqual([objectData.properties propertyForId:@"D:test:type7:date"].type, CMISPropertyTypeDateTime);
+        XCTAssertEqual([objectData.properties propertyForId:@"P:test:aspect3:date"].type, CMISPropertyTypeDateTime);
+        self.testCompleted = YES;
+    }];
+    [self waitForCompletion:10];
+    
+    XCTAssertEqual(service.requestedTypeIds.count, 12, @"Every type definition should be retrieved once: %@", service.requestedTypeIds);
+    XCTAssertEqual([NSSet setWithArray:service.requestedTypeIds].count, 12);
+    XCTAssertTrue(service.maxPendingRequestCount >= 10, @"The type definitions of the objects read while the first ones were retrieved should be retrieved at the same time, at most %lu were", (unsigned long)service.maxPendingRequestCount);
+}
+
+// This test test the extension levels Allowable Actions, Object, and Properties, with simplicity
+// the same extension elements are used at each of the different levels
+- (void)testParsedExtensionElementsFromAtomFeedXml
+{
+    static NSString *exampleUri = @"http://www.example.com";
+    
+    // Local Blocks
+    void (^testSimpleRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
+        [self checkExtensionElement:rootExtElement withName:@"testExtSimpleRoot" namespaceUri:exampleUri attributeCount:0 childrenCount:1 hasValue:NO];
+        
+        CMISExtensionElement *simpleChildExtElement = rootExtElement.children.lastObject;
+        [self checkExtensionElement:simpleChildExtElement withName:@"simpleChild" namespaceUri:@"http://www.example.com" attributeCount:0 childrenCount:0 hasValue:YES];
+        XCTAssertTrue([simpleChildExtElement.value isEqualToString:@"simpleChildValue"], @"Expected value 'simpleChildValue' but was '%@'", simpleChildExtElement.value);
+    };
+    
+    void (^testComplexRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
+        [self checkExtensionElement:rootExtElement withName:@"testExtRoot" namespaceUri:exampleUri attributeCount:0 childrenCount:5 hasValue:NO];
+        // Children Depth=1
+        [self checkExtensionElement:[rootExtElement.children objectAtIndex:0] withName:@"testExtChildLevel1A" namespaceUri:exampleUri attributeCount:0 childrenCount:0 hasValue:YES];
+        [self checkExtensionElement:[rootExtElement.children objectAtIndex:1] withName:@"testExtChildLevel1A" namespaceUri:exampleUri attributeCount:0 childrenCount:0 hasValue:YES];
+        [self checkExtensionElement:[rootExtElement.children objectAtIndex:2] withName:@"testExtChildLevel1B" namespaceUri:exampleUri attributeCount:1 childrenCount:1 hasValue:NO];
+        [self checkExtensionElement:[rootExtElement.children objectAtIndex:3] withName:@"testExtChildLevel1B" namespaceUri:exampleUri attributeCount:1 childrenCount:0 hasValue:NO];
+        [self checkExtensionElement:[rootExtElement.children objectAtIndex:4] withName:@"testExtChildLevel1B" namespaceUri:exampleUri attributeCount:1 childrenCount:0 hasValue:YES];
+        
+        CMISExtensionElement *level1ExtElement = [rootExtElement.children objectAtIndex:2];
+        
+        CMISExtensionElement *level2ExtElement = level1ExtElement.children.lastObject;
+        [self checkExtensionElement:level2ExtElement withName:@"testExtChildLevel2" namespaceUri:exampleUri attributeCount:1 childrenCount:1 hasValue:NO];
+        
+        CMISExtensionElement *level3ExtElement = level2ExtElement.children.lastObject;
+        [self checkExtensionElement:level3ExtElement withName:@"testExtChildLevel3" namespaceUri:exampleUri attributeCount:1 childrenCount:0 hasValue:YES];
+    };
+    
+    NSString *filePath = [[NSBundle bundleForClass:[self class]] pathForResource:@"AtomFeedWithExtensions" ofType:@"xml"];
+    NSData *atomData = [[NSData alloc] initWithContentsOfFile:filePath];
+    XCTAssertNotNil(atomData, @"AtomFeedWithExtensions.xml is missing from the test target!");
+    
+    NSError *error = nil;
+    CMISAtomFeedParser *feedParser = [[CMISAtomFeedParser alloc] initWithData:atomData];
+    XCTAssertTrue([feedParser parseAndReturnError:&error], @"Failed to parse AtomFeedWithExtensions.xml");
+    
+    NSArray *entries = feedParser.entries;
+    XCTAssertTrue(entries.count == 2, @"Expected 2 parsed entry objects, but found %lu", (unsigned long)entries.count);
+    
+    for (CMISObjectData *objectData  in entries) {
+        XCTAssertTrue(objectData.extensions.count == 2, @"Expected 2 extension elements, but found %lu", (unsigned long)objectData.extensions.count);
+        testSimpleRootExtensionElement([objectData.extensions objectAtIndex:0]);
+        testComplexRootExtensionElement([objectData.extensions objectAtIndex:1]);
+        
+        XCTAssertTrue(objectData.allowableActions.extensions.count == 2, @"Expected 2 extension elements, but found %lu", (unsigned long)objectData.allowableActions.extensions.count);
+        testSimpleRootExtensionElement([objectData.allowableActions.extensions objectAtIndex:0]);
+        testComplexRootExtensionElement([objectData.allowableActions.extensions objectAtIndex:1]);
+        
+        NSArray *extensions = objectData.properties.extensions;
+        XCTAssertTrue(extensions.count == 2, @"Expected only one extension element but encountered %lu", (unsigned long)extensions.count);
+        testSimpleRootExtensionElement([objectData.properties.extensions objectAtIndex:0]);
+        testComplexRootExtensionElement([objectData.properties.extensions objectAtIndex:1]);
+    }
+}
+
+
+- (void)testParsedExtensionElementsFromAtomPubService
+{
+    static NSString *exampleUri = @"http://www.example.com";
+    
+    // Local Blocks
+    void (^testSimpleRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
+        [self checkExtensionElement:rootExtElement withName:@"testExtSimpleRoot" namespaceUri:exampleUri attributeCount:0 childrenCount:1 hasValue:NO];
+        
+        CMISExtensionElement *simpleChildExtElement = rootExtElement.children.lastObject;
+        [self checkExtensionElement:simpleChildExtElement withName:@"simpleChild" namespaceUri:@"http://www.example.com" attributeCount:0 childrenCount:0 hasValue:YES];
+        XCTAssertTrue([simpleChildExtElement.value isEqualToString:@"simpleChildValue"], @"Expected value 'simpleChildValue' but was '%@'", simpleChildExtElement.value);
+    };
+    
+    void (^testComplexRootExtensionElement)(CMISExtensionElement *) = ^(CMISExtensionElement *rootExtElement) {
         [self checkExtensionElement:rootExtElement withName:@"testExtRoot" namespaceUri:exampleUri attributeCount:0 childrenCount:5 hasValue:NO];
         // Children Depth=1
         [self checkExtensionElement:[rootExtElement.children objectAtIndex:0] withName:@"testExtChildLevel1A" namespaceUri:exampleUri attributeCount:0 childrenCount:0 hasValue:YES];
@@ -2711,6 +3576,1811 @@
     XCTAssertEqualObjects(@"SELECT * FROM cmis:document WHERE abc:dateTime = TIMESTAMP '2012-02-02T03:04:05.000Z'", [st queryString], @"wrong encoded query statement");
 }
 
+- (void)testRequestSchedulerPriorities
+{
+    CMISRequestScheduler *scheduler = [[CMISRequestScheduler alloc] init];
+    NSMutableArray *started = [NSMutableArray array];
+    NSMutableDictionary *finishedBlocks = [NSMutableDictionary dictionary];
+    __block BOOL cancelled = NO;
+    
+    void (^schedule)(NSString *, CMISRequestPriority, CMISRequest *) = ^(NSString *name, CMISRequestPriority priority, CMISRequest *cmisRequest) {
+        [scheduler scheduleRequestForHost:@"example.com"
+                                 priority:priority
+                    maxConcurrentRequests:2
+                              cmisRequest:cmisRequest
+                               startBlock:^(void (^finishedBlock)(void)) {
+                                   [started addObject:name];
+                                   finishedBlocks[name] = [finishedBlock copy];
+                               }
+                              cancelBlock:^{
+                                  cancelled = YES;
+                              }];
+    };
+    
+    CMISRequest *bulkRequest = [[CMISRequest alloc] init];
+    schedule(@"interactive1", CMISRequestPriorityInteractive, [[CMISRequest alloc] init]);
+    schedule(@"bulk", CMISRequestPriorityBulk, bulkRequest);
+    schedule(@"interactive2", CMISRequestPriorityInteractive, [[CMISRequest alloc] init]);
+    schedule(@"background", CMISRequestPriorityBackground, [[CMISRequest alloc] init]);
+    
+    // the last slot is reserved for interactive requests
+    XCTAssertEqualObjects(started, (@[@"interactive1", @"interactive2"]), @"expected interactive requests to be started");
+    XCTAssertEqual([scheduler runningRequestCountForHost:@"example.com"], (NSUInteger)2, @"expected 2 running requests");
+    XCTAssertEqual([scheduler queuedRequestCount], (NSUInteger)2, @"expected 2 queued requests");
+    
+    // a non interactive request only gets a slot if another one stays free
+    ((void (^)(void))finishedBlocks[@"interactive1"])();
+    XCTAssertEqual(started.count, (NSUInteger)2, @"expected no request to be started");
+    ((void (^)(void))finishedBlocks[@"interactive2"])();
+    XCTAssertEqualObjects(started.lastObject, @"background", @"expected background request to be started before bulk request");
+    XCTAssertEqual([scheduler queuedRequestCountForPriority:CMISRequestPriorityBulk], (NSUInteger)1, @"expected bulk request to be queued");
+    
+    // cancelling a queued request removes it from the queue
+    [bulkRequest cancel];
+    XCTAssertTrue(cancelled, @"expected cancel block to be called");
+    XCTAssertEqual([scheduler queuedRequestCount], (NSUInteger)0, @"expected empty queue");
+    ((void (^)(void))finishedBlocks[@"background"])();
+    XCTAssertEqual(started.count, (NSUInteger)3, @"expected cancelled request not to be started");
+    XCTAssertEqual([scheduler runningRequestCountForHost:@"example.com"], (NSUInteger)0, @"expected no running requests");
+}
+
+- (void)testRequestCoalescerSharesInFlightRequest
+{
+    CMISRequestCoalescer *coalescer = [[CMISRequestCoalescer alloc] init];
+    __block NSUInteger startCount = 0;
+    __block CMISRequest *sharedRequest = nil;
+    __block void (^sharedCompletionBlock)(CMISHttpResponse *httpResponse, NSError *error) = nil;
+    NSMutableArray *results = [NSMutableArray array];
+    
+    void (^startBlock)(CMISRequest *, void (^)(CMISHttpResponse *, NSError *)) = ^(CMISRequest *request, void (^completionBlock)(CMISHttpResponse *, NSError *)) {
+        startCount++;
+        sharedRequest = request;
+        sharedCompletionBlock = [completionBlock copy];
+    };
+    
+    CMISRequest *firstRequest = [[CMISRequest alloc] init];
+    CMISRequest *secondRequest = [[CMISRequest alloc] init];
+    CMISRequest *thirdRequest = [[CMISRequest alloc] init];
+    NSString *key = [CMISRequestCoalescer keyForUrl:[NSURL URLWithString:@"http://example.com/cmis?id=1"] session:nil headers:nil];
+    for (CMISRequest *request in @[firstRequest, secondRequest, thirdRequest]) {
+        [coalescer invokeRequestWithKey:key priority:CMISRequestPriorityDefault cmisRequest:request completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+            [results addObject:(error ? @(error.code) : @"response")];
+        } startBlock:startBlock];
+    }
+    XCTAssertEqual(startCount, (NSUInteger)1, @"expected only one request to be started");
+    XCTAssertEqual([coalescer coalescedRequestCount], (NSUInteger)2, @"expected two coalesced requests");
+    
+    // cancelling one caller must not cancel the shared request
+    [firstRequest cancel];
+    XCTAssertEqualObjects(results, (@[@(kCMISErrorCodeCancelled)]), @"expected cancelled caller to be notified");
+    XCTAssertFalse(sharedRequest.isCancelled, @"expected shared request to keep running");
+    
+    sharedCompletionBlock([[CMISHttpResponse alloc] init], nil);
+    XCTAssertEqualObjects(results, (@[@(kCMISErrorCodeCancelled), @"response", @"response"]), @"expected remaining callers to get the response");
+    XCTAssertEqual([coalescer inFlightRequestCount], (NSUInteger)0, @"expected no in-flight request");
+    
+    // the shared request is cancelled once all callers have cancelled
+    firstRequest = [[CMISRequest alloc] init];
+    secondRequest = [[CMISRequest alloc] init];
+    [coalescer invokeRequestWithKey:key priority:CMISRequestPriorityDefault cmisRequest:firstRequest completionBlock:nil startBlock:startBlock];
+    [coalescer invokeRequestWithKey:key priority:CMISRequestPriorityDefault cmisRequest:secondRequest completionBlock:nil startBlock:startBlock];
+    XCTAssertEqual(startCount, (NSUInteger)2, @"expected a new request to be started");
+    [firstRequest cancel];
+    XCTAssertFalse(sharedRequest.isCancelled, @"expected shared request to keep running");
+    [secondRequest cancel];
+    XCTAssertTrue(sharedRequest.isCancelled, @"expected shared request to be cancelled");
+}
+
+- (void)testRequestCoalescerRaisesPriorityOfQueuedRequest
+{
+    CMISRequestScheduler *scheduler = [[CMISRequestScheduler alloc] init];
+    CMISRequestCoalescer *coalescer = [[CMISRequestCoalescer alloc] init];
+    NSMutableArray *started = [NSMutableArray array];
+    
+    // one slot is taken, the remaining one is reserved for interactive requests
+    [scheduler scheduleRequestForHost:@"example.com"
+                             priority:CMISRequestPriorityInteractive
+                maxConcurrentRequests:2
+                          cmisRequest:[[CMISRequest alloc] init]
+                           startBlock:^(void (^finishedBlock)(void)) {
+                               [started addObject:@"running"];
+                           }
+                          cancelBlock:nil];
+    
+    void (^startBlock)(CMISRequest *, void (^)(CMISHttpResponse *, NSError *)) = ^(CMISRequest *sharedRequest, void (^completionBlock)(CMISHttpResponse *, NSError *)) {
+        [scheduler scheduleRequestForHost:@"example.com"
+                                 priority:sharedRequest.priority
+                    maxConcurrentRequests:2
+                              cmisRequest:sharedRequest
+                               startBlock:^(void (^finishedBlock)(void)) {
+                                   [started addObject:@"shared"];
+                               }
+                              cancelBlock:nil];
+    };
+    
+    NSString *key = [CMISRequestCoalescer keyForUrl:[NSURL URLWithString:@"http://example.com/cmis?id=1"] session:nil headers:nil];
+    [coalescer invokeRequestWithKey:key priority:CMISRequestPriorityBulk cmisRequest:[[CMISRequest alloc] init] completionBlock:nil startBlock:startBlock];
+    XCTAssertEqual([scheduler queuedRequestCountForPriority:CMISRequestPriorityBulk], (NSUInteger)1, @"expected the bulk request to be queued");
+    
+    // a caller of lower priority leaves the request where it is
+    [coalescer invokeRequestWithKey:key priority:CMISRequestPriorityBulk cmisRequest:[[CMISRequest alloc] init] completionBlock:nil startBlock:startBlock];
+    XCTAssertEqual([scheduler queuedRequestCountForPriority:CMISRequestPriorityBulk], (NSUInteger)1, @"expected the request to stay queued");
+    
+    // an interactive caller moves the shared request to the interactive queue, where it gets the reserved slot
+    [coalescer invokeRequestWithKey:key priority:CMISRequestPriorityInteractive cmisRequest:[[CMISRequest alloc] init] completionBlock:nil startBlock:startBlock];
+    XCTAssertEqual([scheduler queuedRequestCount], (NSUInteger)0, @"expected no queued request");
+    XCTAssertEqualObjects(started, (@[@"running", @"shared"]), @"expected the shared request to be started");
+    XCTAssertEqual([coalescer inFlightRequestCount], (NSUInteger)1, @"expected one in-flight request");
+}
+
+- (void)testHttpValidationCache
+{
+    CMISHttpValidationCache *cache = [[CMISHttpValidationCache alloc] initWithBindingSession:nil];
+    NSString *key = @"http://example.com/cmis?id=1";
+    NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:key]];
+    
+    // nothing to validate against yet
+    XCTAssertNil([cache addValidatorsToRequest:urlRequest forKey:key], @"expected no cached response");
+    XCTAssertNil([urlRequest valueForHTTPHeaderField:@"If-None-Match"], @"expected no validator header");
+    
+    CMISHttpResponse *response = [CMISHttpResponse responseWithStatusCode:200
+                                                            statusMessage:@"OK"
+                                                                  headers:@{@"ETag" : @"\"v1\"", @"Last-Modified" : @"Tue, 15 Nov 1994 12:45:26 GMT"}
+                                                             responseData:[@"<entry/>" dataUsingEncoding:NSUTF8StringEncoding]];
+    XCTAssertEqual([cache responseForResponse:response cachedResponse:nil forKey:key], response, @"expected response to be passed through");
+    response.parsedResult = @"parsed";
+    XCTAssertEqual(cache.missCount, (NSUInteger)1, @"expected one miss");
+    XCTAssertTrue(cache.memoryUsage > 0, @"expected response to be cached");
+    
+    // the validators of the cached response are sent and a 304 returns the cached response with its parsed result
+    CMISHttpResponse *cachedResponse = [cache addValidatorsToRequest:urlRequest forKey:key];
+    XCTAssertEqualObjects([urlRequest valueForHTTPHeaderField:@"If-None-Match"], @"\"v1\"", @"expected ETag validator");
+    XCTAssertEqualObjects([urlRequest valueForHTTPHeaderField:@"If-Modified-Since"], @"Tue, 15 Nov 1994 12:45:26 GMT", @"expected Last-Modified validator");
+    CMISHttpResponse *notModified = [CMISHttpResponse responseWithStatusCode:304 statusMessage:@"Not Modified" headers:nil responseData:nil];
+    CMISHttpResponse *result = [cache responseForResponse:notModified cachedResponse:cachedResponse forKey:key];
+    XCTAssertEqualObjects(result.parsedResult, @"parsed", @"expected parsed result of cached response");
+    XCTAssertEqual(cache.hitCount, (NSUInteger)1, @"expected one hit");
+    
+    // every caller answered from the cached response gets its own copy of the parsed result
+    CMISObjectData *objectData = [[CMISObjectData alloc] init];
+    objectData.identifier = @"1";
+    objectData.properties = [[CMISProperties alloc] init];
+    [objectData.properties addProperty:[CMISPropertyData createPropertyForId:kCMISPropertyName stringValue:@"name"]];
+    result.parsedResult = objectData;
+    CMISObjectData *firstResult = result.parsedResult;
+    [firstResult.properties addProperty:[CMISPropertyData createPropertyForId:kCMISPropertyName stringValue:@"changed"]];
+    CMISObjectData *secondResult = result.parsedResult;
+    XCTAssertTrue(firstResult != secondResult, @"expected a copy of the parsed result");
+    XCTAssertEqualObjects(secondResult.identifier, @"1");
+    XCTAssertEqualObjects([secondResult.properties propertyValueForId:kCMISPropertyName], @"name", @"expected the cached result to be unchanged");
+    XCTAssertEqualObjects([objectData.properties propertyValueForId:kCMISPropertyName], @"name", @"expected the parsed result to be copied when it is set");
+    
+    // the elements of an array are copied as well
+    CMISAtomWorkspace *workspace = [[CMISAtomWorkspace alloc] init];
+    workspace.repositoryInfo = [[CMISRepositoryInfo alloc] init];
+    workspace.repositoryInfo.identifier = @"repository";
+    result.parsedResult = @[workspace];
+    NSArray *firstWorkspaces = result.parsedResult;
+    ((CMISAtomWorkspace *)firstWorkspaces.firstObject).repositoryInfo.identifier = @"changed";
+    NSArray *secondWorkspaces = result.parsedResult;
+    XCTAssertTrue(firstWorkspaces.firstObject != secondWorkspaces.firstObject, @"expected a copy of each workspace");
+    XCTAssertEqualObjects(((CMISAtomWorkspace *)secondWorkspaces.firstObject).repositoryInfo.identifier, @"repository", @"expected the cached workspace to be unchanged");
+    XCTAssertEqualObjects(workspace.repositoryInfo.identifier, @"repository");
+    
+    [cache removeAll];
+    XCTAssertEqual(cache.memoryUsage, (NSUInteger)0, @"expected empty cache");
+    
+    // representations negotiated differently are cached apart, credentials are not part of the key
+    NSMutableURLRequest *germanRequest = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:key]];
+    [germanRequest setValue:@"de" forHTTPHeaderField:@"Accept-Language"];
+    [germanRequest setValue:@"Basic dXNlcjpwYXNz" forHTTPHeaderField:@"Authorization"];
+    NSMutableURLRequest *englishRequest = [germanRequest mutableCopy];
+    [englishRequest setValue:@"en" forHTTPHeaderField:@"Accept-Language"];
+    NSString *germanKey = [CMISHttpValidationCache keyForRequest:germanRequest session:nil];
+    XCTAssertFalse([germanKey isEqualToString:[CMISHttpValidationCache keyForRequest:englishRequest session:nil]]);
+    XCTAssertTrue([germanKey rangeOfString:@"dXNlcjpwYXNz"].location == NSNotFound, @"expected no credentials in the key");
+}
+
+- (void)testHttpContentCoder
+{
+    NSMutableString *text = [NSMutableString string];
+    for (int i = 0; i < 10000; i++) {
+        [text appendFormat:@"{\"cmis:objectId\":\"%d\"},", i];
+    }
+    NSData *data = [text dataUsingEncoding:NSUTF8StringEncoding];
+    
+    NSData *encodedData = [CMISHttpContentCoder gzipEncodedData:data];
+    XCTAssertNotNil(encodedData, @"expected encoded data");
+    XCTAssertTrue(encodedData.length < data.length, @"expected encoded data to be smaller");
+    
+    // plain data is never decoded, even if the header claims it is encoded
+    XCTAssertNil([CMISHttpContentCoder decoderForContentEncoding:@"gzip" data:data], @"expected no decoder for plain data");
+    XCTAssertNil([CMISHttpContentCoder decoderForContentEncoding:nil data:encodedData], @"expected no decoder without content encoding");
+    
+    // decode in small chunks as they would be received from the network
+    CMISHttpContentCoder *decoder = [CMISHttpContentCoder decoderForContentEncoding:@"gzip" data:encodedData];
+    XCTAssertNotNil(decoder, @"expected decoder for gzip data");
+    NSMutableData *decodedData = [NSMutableData data];
+    for (NSUInteger offset = 0; offset < encodedData.length; offset += 100) {
+        NSData *chunk = [encodedData subdataWithRange:NSMakeRange(offset, MIN(100, encodedData.length - offset))];
+        [decodedData appendData:[decoder decodeData:chunk]];
+    }
+    XCTAssertTrue(decoder.isFinished, @"expected end of encoded data");
+    XCTAssertEqualObjects(decodedData, data, @"expected decoded data to match original data");
+}
+
+- (void)testRetryPolicy
+{
+    CMISRetryPolicy *retryPolicy = [[CMISRetryPolicy alloc] initWithBindingSession:nil];
+    retryPolicy.maxRetries = 2;
+    retryPolicy.baseDelay = 1;
+    retryPolicy.maxDelay = 10;
+    retryPolicy.budgetRatio = 0;
+    NSError *timeoutError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    NSError *cancelledError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    NSTimeInterval delay = -1;
+    
+    // only idempotent requests failing with a transient error are retried
+    XCTAssertTrue([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:503 retryAfter:nil error:nil delay:&delay]);
+    XCTAssertTrue(delay >= 0 && delay <= 1, @"expected jittered delay within base delay");
+    XCTAssertTrue([retryPolicy shouldRetryRequestWithMethod:HTTP_DELETE attempt:1 statusCode:0 retryAfter:nil error:timeoutError delay:&delay]);
+    XCTAssertFalse([retryPolicy shouldRetryRequestWithMethod:HTTP_POST attempt:1 statusCode:503 retryAfter:nil error:nil delay:&delay]);
+    XCTAssertFalse([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:500 retryAfter:nil error:nil delay:&delay]);
+    XCTAssertFalse([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:0 retryAfter:nil error:cancelledError delay:&delay]);
+    XCTAssertFalse([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:3 statusCode:503 retryAfter:nil error:nil delay:&delay]);
+    
+    // the delay requested by the server is honoured unless it is too long
+    XCTAssertTrue([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:429 retryAfter:@"5" error:nil delay:&delay]);
+    XCTAssertEqual(delay, 5.0);
+    XCTAssertFalse([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:429 retryAfter:@"120" error:nil delay:&delay]);
+    XCTAssertEqual([CMISRetryPolicy delayForRetryAfterHeader:@"Tue, 15 Nov 1994 12:45:26 GMT"], 0.0);
+    XCTAssertEqual([CMISRetryPolicy delayForRetryAfterHeader:@"soon"], -1.0);
+    XCTAssertEqual(retryPolicy.retryCount, 3u);
+    
+    // without new requests the budget runs out
+    while (retryPolicy.availableBudget >= 1.0) {
+        XCTAssertTrue([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:503 retryAfter:nil error:nil delay:&delay]);
+    }
+    XCTAssertFalse([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:503 retryAfter:nil error:nil delay:&delay]);
+    XCTAssertEqual(retryPolicy.budgetExhaustedCount, 1u);
+    
+    retryPolicy.budgetRatio = 0.5;
+    [retryPolicy requestWillStart];
+    [retryPolicy requestWillStart];
+    XCTAssertTrue([retryPolicy shouldRetryRequestWithMethod:HTTP_GET attempt:1 statusCode:503 retryAfter:nil error:nil delay:&delay]);
+}
+
+- (void)testRequestHedgerDuplicatesSlowRequest
+{
+    CMISRequestHedger *hedger = [[CMISRequestHedger alloc] init];
+    XCTAssertEqual([hedger hedgeDelayForHost:@"example.com" percentile:95 minimumDelay:0], -1.0, @"expected no hedging without samples");
+    for (int i = 1; i <= 100; i++) {
+        [hedger recordTimeToFirstByte:i / 1000.0 forHost:@"example.com"];
+    }
+    XCTAssertEqualWithAccuracy([hedger hedgeDelayForHost:@"EXAMPLE.com" percentile:95 minimumDelay:0], 0.095, 0.0001);
+    XCTAssertEqualWithAccuracy([hedger hedgeDelayForHost:@"example.com" percentile:50 minimumDelay:0.2], 0.2, 0.0001);
+    
+    NSMutableArray *attemptRequests = [NSMutableArray array];
+    NSMutableArray *attemptCompletionBlocks = [NSMutableArray array];
+    __block CMISHttpResponse *result = nil;
+    [hedger invokeRequestForHost:@"example.com"
+                      percentile:10
+                    minimumDelay:0.01
+                     cmisRequest:[[CMISRequest alloc] init]
+                 completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                     result = httpResponse;
+                 }
+                      startBlock:^(CMISRequest *attemptRequest, void (^attemptCompletionBlock)(CMISHttpResponse *, NSError *)) {
+                          // a started request that has not received a response yet
+                          attemptRequest.httpRequest = [[CMISHttpRequest alloc] initWithHttpMethod:HTTP_GET completionBlock:nil];
+                          [attemptRequests addObject:attemptRequest];
+                          [attemptCompletionBlocks addObject:[attemptCompletionBlock copy]];
+                      }];
+    XCTAssertEqual(attemptRequests.count, (NSUInteger)1, @"expected the original request to be started");
+    
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2];
+    while (attemptRequests.count < 2 && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    XCTAssertEqual(attemptRequests.count, (NSUInteger)2, @"expected a duplicate request after the hedge delay");
+    XCTAssertEqual([hedger hedgedRequestCount], (NSUInteger)1);
+    
+    // the first response wins, the other request is cancelled
+    CMISHttpResponse *response = [[CMISHttpResponse alloc] init];
+    ((void (^)(CMISHttpResponse *, NSError *))attemptCompletionBlocks[1])(response, nil);
+    XCTAssertEqual(result, response, @"expected the response of the duplicate request");
+    XCTAssertTrue([attemptRequests[0] isCancelled], @"expected the original request to be cancelled");
+    XCTAssertEqual([hedger hedgeWinCount], (NSUInteger)1);
+    
+    // the cancelled original request is recorded with at least the hedge delay, replacing the oldest sample
+    XCTAssertEqualWithAccuracy([hedger hedgeDelayForHost:@"example.com" percentile:0 minimumDelay:0], 0.002, 0.0001);
+}
+
+- (void)testCircuitBreakerStates
+{
+    CMISCircuitBreaker *circuitBreaker = [[CMISCircuitBreaker alloc] initWithBindingSession:nil];
+    circuitBreaker.failureRatioThreshold = 0.5;
+    circuitBreaker.slowCallThreshold = 1;
+    circuitBreaker.openInterval = 60;
+    
+    NSMutableArray *states = [NSMutableArray array];
+    id observer = [[NSNotificationCenter defaultCenter] addObserverForName:kCMISCircuitBreakerStateDidChangeNotification
+                                                                    object:circuitBreaker
+                                                                     queue:nil
+                                                                usingBlock:^(NSNotification *notification) {
+                                                                    [states addObject:notification.userInfo[kCMISCircuitBreakerStateKey]];
+                                                                }];
+    
+    // the breaker opens once half of the recent requests failed or were too slow
+    for (int i = 0; i < 5; i++) {
+        XCTAssertTrue([circuitBreaker allowRequestToHost:@"example.com"]);
+        [circuitBreaker recordOutcomeForHost:@"example.com" success:YES duration:0.1];
+    }
+    for (int i = 0; i < 4; i++) {
+        XCTAssertTrue([circuitBreaker allowRequestToHost:@"example.com"]);
+        [circuitBreaker recordOutcomeForHost:@"example.com" success:NO duration:0.1];
+    }
+    XCTAssertEqual([circuitBreaker stateForHost:@"example.com"], CMISCircuitBreakerStateClosed);
+    XCTAssertTrue([circuitBreaker allowRequestToHost:@"example.com"]);
+    [circuitBreaker recordOutcomeForHost:@"example.com" success:YES duration:5];
+    XCTAssertEqual([circuitBreaker stateForHost:@"example.com"], CMISCircuitBreakerStateOpen);
+    
+    // requests are rejected while open, other hosts are not affected
+    XCTAssertFalse([circuitBreaker allowRequestToHost:@"EXAMPLE.com"]);
+    XCTAssertTrue([circuitBreaker allowRequestToHost:@"other.example.com"]);
+    XCTAssertEqual([circuitBreaker rejectedRequestCount], (NSUInteger)1);
+    
+    // after the open interval a single probe is let through
+    circuitBreaker.openInterval = 0;
+    XCTAssertTrue([circuitBreaker allowRequestToHost:@"example.com"]);
+    XCTAssertEqual([circuitBreaker stateForHost:@"example.com"], CMISCircuitBreakerStateHalfOpen);
+    XCTAssertFalse([circuitBreaker allowRequestToHost:@"example.com"]);
+    [circuitBreaker releaseRequestForHost:@"example.com"];
+    XCTAssertTrue([circuitBreaker allowRequestToHost:@"example.com"]);
+    [circuitBreaker recordOutcomeForHost:@"example.com" success:YES duration:0.1];
+    XCTAssertEqual([circuitBreaker stateForHost:@"example.com"], CMISCircuitBreakerStateClosed);
+    
+    [[NSNotificationCenter defaultCenter] removeObserver:observer];
+    XCTAssertEqualObjects(states, (@[@(CMISCircuitBreakerStateOpen), @(CMISCircuitBreakerStateHalfOpen), @(CMISCircuitBreakerStateClosed)]));
+}
+
+- (void)testCircuitBreakerIgnoresSlowTransfers
+{
+    NSData *content = [self randomDataOfLength:64 * 1024];
+    in_port_t port = 0;
+    int listenSocket = [self startContentServerOnPort:&port content:content chunkDelay:0.1];
+    XCTAssertTrue(listenSocket >= 0);
+    
+    CMISSessionParameters *parameters = [[CMISSessionParameters alloc] initWithBindingType:CMISBindingTypeBrowser];
+    parameters.browserUrl = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d/", port]];
+    [parameters setObject:@NO forKey:kCMISSessionParameterCheckNetworkReachability];
+    [parameters setObject:@0.3 forKey:kCMISSessionParameterCircuitBreakerSlowCallThreshold];
+    [parameters setObject:@0 forKey:kCMISSessionParameterCircuitBreakerOpenInterval];
+    parameters.networkProvider = [[CMISDefaultNetworkProvider alloc] init];
+    CMISBindingSession *bindingSession = [[CMISBindingSession alloc] initWithSessionParameters:parameters];
+    
+    // open the breaker, so the next request is the probe deciding whether it closes again
+    CMISCircuitBreaker *circuitBreaker = bindingSession.circuitBreaker;
+    for (NSUInteger index = 0; index < 10; index++) {
+        [circuitBreaker recordOutcomeForHost:@"127.0.0.1" success:NO duration:0];
+    }
+    XCTAssertEqual([circuitBreaker stateForHost:@"127.0.0.1"], CMISCircuitBreakerStateOpen);
+    
+    // the response headers arrive at once, the content takes longer than the slow call threshold
+    __block BOOL completed = NO;
+    NSOutputStream *outputStream = [NSOutputStream outputStreamToMemory];
+    NSDate *startDate = [NSDate date];
+    [bindingSession.networkProvider invoke:parameters.browserUrl
+                                httpMethod:HTTP_GET
+                                   session:bindingSession
+                              outputStream:outputStream
+                             bytesExpected:content.length
+                               cmisRequest:[[CMISRequest alloc] init]
+                           completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                               XCTAssertNil(error);
+                               XCTAssertEqual(httpResponse.statusCode, 200);
+                               completed = YES;
+                           }
+                             progressBlock:nil];
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:10];
+    while (!completed && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    XCTAssertTrue(completed);
+    XCTAssertTrue(-[startDate timeIntervalSinceNow] > 0.3, @"expected the transfer to exceed the slow call threshold");
+    XCTAssertEqualObjects([outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey], content);
+    XCTAssertEqual([circuitBreaker stateForHost:@"127.0.0.1"], CMISCircuitBreakerStateClosed,
+                   @"expected a slow but successful transfer to close the breaker");
+    
+    shutdown(listenSocket, SHUT_RDWR);
+    close(listenSocket);
+}
+
+- (void)testURLSessionPoolKeepAlive
+{
+    CMISURLSessionPool *pool = [[CMISURLSessionPool alloc] init];
+    NSURL *url = [NSURL URLWithString:@"http://127.0.0.1:9/cmis/atom"];
+    __block NSUInteger keepAliveCount = 0;
+    void (^keepAliveBlock)(void) = ^{
+        @synchronized(pool) {
+            keepAliveCount++;
+        }
+    };
+    
+    [pool keepConnectionsAliveToURL:url bindingSession:nil interval:0 keepAliveBlock:keepAliveBlock];
+    XCTAssertEqual(pool.sessionCount, (NSUInteger)0, @"expected no session without keep alive interval");
+    
+    // the idle session is kept alive until it is released
+    [pool keepConnectionsAliveToURL:url bindingSession:nil interval:0.05 keepAliveBlock:keepAliveBlock];
+    XCTAssertEqual(pool.sessionCount, (NSUInteger)1, @"expected a pooled session");
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2];
+    while ([timeout timeIntervalSinceNow] > 0) {
+        @synchronized(pool) {
+            if (keepAliveCount > 0) {
+                break;
+            }
+        }
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    @synchronized(pool) {
+        XCTAssertTrue(keepAliveCount > 0, @"expected the idle session to be kept alive");
+    }
+    
+    [pool releaseSessionsForBindingSession:nil];
+    XCTAssertEqual(pool.sessionCount, (NSUInteger)0, @"expected the session to be released");
+}
+
+- (void)testWarmUpConnections
+{
+    in_port_t port = 0;
+    NSMutableArray *requestHeaders = [NSMutableArray array];
+    int listenSocket = [self startUploadSinkServerOnPort:&port requestHeaders:requestHeaders];
+    XCTAssertTrue(listenSocket >= 0);
+    
+    CMISSessionParameters *parameters = [[CMISSessionParameters alloc] initWithBindingType:CMISBindingTypeBrowser];
+    parameters.browserUrl = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d/", port]];
+    parameters.username = @"user";
+    parameters.authenticationProvider = [[CMISStandardAuthenticationProvider alloc] initWithUsername:@"user" password:@"password"];
+    [parameters setObject:@NO forKey:kCMISSessionParameterCheckNetworkReachability];
+    [parameters setObject:@3 forKey:kCMISSessionParameterWarmUpConnections];
+    CMISDefaultNetworkProvider *networkProvider = [[CMISDefaultNetworkProvider alloc] init];
+    parameters.networkProvider = networkProvider;
+    CMISBindingSession *bindingSession = [[CMISBindingSession alloc] initWithSessionParameters:parameters];
+    
+    // nothing is sent when the session is created
+    [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+    @synchronized(requestHeaders) {
+        XCTAssertEqual(requestHeaders.count, (NSUInteger)0, @"expected no request before the repository info is requested");
+    }
+    
+    // the repository info request opens one connection, the others are opened by authenticated HEAD requests, once
+    [networkProvider warmUpConnectionsForSession:bindingSession];
+    [networkProvider warmUpConnectionsForSession:bindingSession];
+    XCTAssertEqual(networkProvider.warmUpRequestCount, (NSUInteger)2);
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:5];
+    while ([timeout timeIntervalSinceNow] > 0) {
+        @synchronized(requestHeaders) {
+            if (requestHeaders.count >= 2) {
+                break;
+            }
+        }
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    @synchronized(requestHeaders) {
+        XCTAssertEqual(requestHeaders.count, (NSUInteger)2);
+        for (NSString *header in requestHeaders) {
+            XCTAssertTrue([header hasPrefix:@"HEAD / "], @"expected a HEAD request: %@", header);
+            XCTAssertTrue([header rangeOfString:@"Authorization: Basic" options:NSCaseInsensitiveSearch].location != NSNotFound,
+                          @"expected the credentials of the session: %@", header);
+        }
+    }
+    
+    shutdown(listenSocket, SHUT_RDWR);
+    close(listenSocket);
+}
+
+- (void)testDefaultNetworkProvider
+{
+    [self runNetworkProviderTestsWithProvider:[[CMISDefaultNetworkProvider alloc] init]];
+}
+
+#if !TARGET_OS_IPHONE
+- (void)testCurlNetworkProvider
+{
+    CMISCurlNetworkProvider *networkProvider = [[CMISCurlNetworkProvider alloc] initWithMaxConnectionsPerHost:2];
+    XCTAssertNotNil(networkProvider, @"expected libcurl 7.68.0 or later");
+    if (networkProvider) {
+        [self runNetworkProviderTestsWithProvider:networkProvider];
+        XCTAssertEqual(networkProvider.activeTransferCount, (NSUInteger)0, @"expected all transfers to be finished");
+    }
+}
+#endif
+
+/**
+ Runs the requests of the CMISNetworkProvider protocol against a local server, the same for every provider.
+ */
+- (void)runNetworkProviderTestsWithProvider:(id<CMISNetworkProvider>)networkProvider
+{
+    NSData *content = [self randomDataOfLength:256 * 1024];
+    NSMutableArray *requests = [NSMutableArray array];
+    in_port_t port = 0;
+    int listenSocket = [self startContentServerOnPort:&port content:content chunkDelay:0 requests:requests];
+    XCTAssertTrue(listenSocket >= 0);
+    in_port_t slowPort = 0;
+    int slowListenSocket = [self startContentServerOnPort:&slowPort content:content chunkDelay:0.2 requests:nil];
+    XCTAssertTrue(slowListenSocket >= 0);
+    
+    CMISSessionParameters *parameters = [[CMISSessionParameters alloc] initWithBindingType:CMISBindingTypeBrowser];
+    parameters.browserUrl = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d/", port]];
+    parameters.authenticationProvider = [[CMISStandardAuthenticationProvider alloc] initWithUsername:@"user" password:@"password"];
+    parameters.networkProvider = networkProvider;
+    [parameters setObject:@NO forKey:kCMISSessionParameterCheckNetworkReachability];
+    [parameters setObject:@0 forKey:kCMISSessionParameterMaxRetries];
+    CMISBindingSession *bindingSession = [[CMISBindingSession alloc] initWithSessionParameters:parameters];
+    NSURL *contentUrl = [parameters.browserUrl URLByAppendingPathComponent:@"content"];
+    
+    // completion and progress blocks are called on this thread
+    __block NSUInteger completedCount = 0;
+    void (^waitForCompletions)(NSUInteger) = ^(NSUInteger expectedCount) {
+        NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:10];
+        while (completedCount < expectedCount && [timeout timeIntervalSinceNow] > 0) {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+        }
+        XCTAssertEqual(completedCount, expectedCount, @"expected the completion block to be called once per request");
+    };
+    NSDictionary *(^requestWithPath)(NSString *, NSString *) = ^NSDictionary *(NSString *method, NSString *path) {
+        @synchronized(requests) {
+            for (NSDictionary *request in requests) {
+                if ([request[@"method"] isEqualToString:method] && [request[@"path"] isEqualToString:path]) {
+                    return request;
+                }
+            }
+        }
+        return nil;
+    };
+    
+    // uploads: an in-memory body, a streamed body and a base64 encoded body between start and end data
+    NSData *body = [@"cmisaction=createDocument" dataUsingEncoding:NSUTF8StringEncoding];
+    [networkProvider invokePOST:[parameters.browserUrl URLByAppendingPathComponent:@"form"]
+                        session:bindingSession
+                           body:body
+                        headers:@{@"Content-Type" : @"application/x-www-form-urlencoded"}
+                    cmisRequest:[[CMISRequest alloc] init]
+                completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                    XCTAssertNil(error);
+                    XCTAssertEqual(httpResponse.statusCode, 201);
+                    completedCount++;
+                }];
+    __block unsigned long long bytesUploaded = 0;
+    [networkProvider invoke:[parameters.browserUrl URLByAppendingPathComponent:@"stream"]
+                 httpMethod:HTTP_PUT
+                    session:bindingSession
+                inputStream:[NSInputStream inputStreamWithData:content]
+                    headers:nil
+              bytesExpected:content.length
+                cmisRequest:[[CMISRequest alloc] init]
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertNil(error);
+                XCTAssertEqual(httpResponse.statusCode, 201);
+                completedCount++;
+            }
+              progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+                  bytesUploaded = bytesTransferred;
+              }];
+    NSData *startData = [@"<entry><content>" dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *endData = [@"</content></entry>" dataUsingEncoding:NSUTF8StringEncoding];
+    [networkProvider invoke:[parameters.browserUrl URLByAppendingPathComponent:@"base64"]
+                 httpMethod:HTTP_POST
+                    session:bindingSession
+                inputStream:[NSInputStream inputStreamWithData:content]
+                    headers:@{@"Content-Type" : @"application/atom+xml;type=entry"}
+              bytesExpected:content.length
+                cmisRequest:[[CMISRequest alloc] init]
+                  startData:startData
+                    endData:endData
+          useBase64Encoding:YES
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertNil(error);
+                XCTAssertEqual(httpResponse.statusCode, 201);
+                completedCount++;
+            }
+              progressBlock:nil];
+    waitForCompletions(3);
+    XCTAssertTrue(bytesUploaded > 0 && bytesUploaded <= content.length, @"expected upload progress: %llu", bytesUploaded);
+    
+    NSDictionary *formRequest = requestWithPath(@"POST", @"/form");
+    XCTAssertEqualObjects(formRequest[@"body"], body);
+    XCTAssertTrue([formRequest[@"header"] rangeOfString:@"Content-Type: application/x-www-form-urlencoded" options:NSCaseInsensitiveSearch].location != NSNotFound);
+    XCTAssertTrue([formRequest[@"header"] rangeOfString:@"Authorization: Basic" options:NSCaseInsensitiveSearch].location != NSNotFound,
+                  @"expected the credentials of the session");
+    XCTAssertEqualObjects(requestWithPath(@"PUT", @"/stream")[@"body"], content);
+    NSMutableData *expectedBody = [NSMutableData dataWithData:startData];
+    [expectedBody appendData:[CMISBase64Encoder dataByEncodingText:content]];
+    [expectedBody appendData:endData];
+    XCTAssertEqualObjects(requestWithPath(@"POST", @"/base64")[@"body"], expectedBody);
+    
+    // requests without a body and downloads into memory, a stream and a file
+    completedCount = 0;
+    [networkProvider invoke:contentUrl
+                 httpMethod:HTTP_HEAD
+                    session:bindingSession
+                       body:nil
+                    headers:nil
+                cmisRequest:[[CMISRequest alloc] init]
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertNil(error);
+                XCTAssertEqual(httpResponse.statusCode, 200);
+                XCTAssertEqual(httpResponse.data.length, (NSUInteger)0, @"expected no body");
+                completedCount++;
+            }];
+    [networkProvider invokeGET:contentUrl
+                       session:bindingSession
+                   cmisRequest:[[CMISRequest alloc] init]
+               completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                   XCTAssertNil(error);
+                   XCTAssertEqual(httpResponse.statusCode, 200);
+                   XCTAssertEqualObjects(httpResponse.data, content);
+                   completedCount++;
+               }];
+    [networkProvider invokeDELETE:contentUrl
+                          session:bindingSession
+                      cmisRequest:[[CMISRequest alloc] init]
+                  completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                      XCTAssertNil(error);
+                      XCTAssertEqual(httpResponse.statusCode, 204);
+                      completedCount++;
+                  }];
+    NSOutputStream *outputStream = [NSOutputStream outputStreamToMemory];
+    __block unsigned long long bytesDownloaded = 0;
+    [networkProvider invoke:contentUrl
+                 httpMethod:HTTP_GET
+                    session:bindingSession
+               outputStream:outputStream
+              bytesExpected:content.length
+                cmisRequest:[[CMISRequest alloc] init]
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertNil(error);
+                XCTAssertEqual(httpResponse.statusCode, 200);
+                completedCount++;
+            }
+              progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+                  bytesDownloaded = bytesTransferred;
+                  XCTAssertEqual(bytesTotal, (unsigned long long)content.length);
+              }];
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [networkProvider invoke:contentUrl
+                 httpMethod:HTTP_GET
+                    session:bindingSession
+             outputFilePath:filePath
+              bytesExpected:content.length
+                cmisRequest:[[CMISRequest alloc] init]
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertNil(error);
+                XCTAssertEqual(httpResponse.statusCode, 200);
+                completedCount++;
+            }
+              progressBlock:nil];
+    waitForCompletions(5);
+    XCTAssertTrue(bytesDownloaded > 0 && bytesDownloaded <= content.length, @"expected download progress: %llu", bytesDownloaded);
+    XCTAssertEqualObjects([outputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey], content);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:filePath], content);
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+    
+    // the body of an error response is turned into the error, it is not written to the output
+    completedCount = 0;
+    NSOutputStream *errorOutputStream = [NSOutputStream outputStreamToMemory];
+    [networkProvider invoke:[parameters.browserUrl URLByAppendingPathComponent:@"missing"]
+                 httpMethod:HTTP_GET
+                    session:bindingSession
+               outputStream:errorOutputStream
+              bytesExpected:0
+                cmisRequest:[[CMISRequest alloc] init]
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertEqual(error.code, kCMISErrorCodeObjectNotFound);
+                XCTAssertEqualObjects(error.localizedFailureReason, @"Object not found: missing");
+                completedCount++;
+            }
+              progressBlock:nil];
+    waitForCompletions(1);
+    XCTAssertEqual([[errorOutputStream propertyForKey:NSStreamDataWrittenToMemoryStreamKey] length], (NSUInteger)0);
+    
+    // cancelling a running download calls the completion block once with a cancellation error
+    completedCount = 0;
+    CMISRequest *cancelledRequest = [[CMISRequest alloc] init];
+    [networkProvider invoke:[NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d/content", slowPort]]
+                 httpMethod:HTTP_GET
+                    session:bindingSession
+               outputStream:[NSOutputStream outputStreamToMemory]
+              bytesExpected:content.length
+                cmisRequest:cancelledRequest
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertNil(httpResponse);
+                XCTAssertEqual(error.code, kCMISErrorCodeCancelled);
+                completedCount++;
+            }
+              progressBlock:^(unsigned long long bytesTransferred, unsigned long long bytesTotal) {
+                  XCTAssertTrue(bytesTransferred < content.length, @"expected the download to be cancelled before it completed");
+                  [cancelledRequest cancel];
+              }];
+    waitForCompletions(1);
+    [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.3]];
+    XCTAssertEqual(completedCount, (NSUInteger)1, @"expected no further completion after the cancellation");
+    
+    // a refused connection fails with a connection error
+    shutdown(listenSocket, SHUT_RDWR);
+    close(listenSocket);
+    completedCount = 0;
+    [networkProvider invoke:contentUrl
+                 httpMethod:HTTP_POST
+                    session:bindingSession
+                       body:body
+                    headers:nil
+                cmisRequest:[[CMISRequest alloc] init]
+            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                XCTAssertNil(httpResponse);
+                XCTAssertEqual(error.code, kCMISErrorCodeConnection);
+                completedCount++;
+            }];
+    waitForCompletions(1);
+    
+    shutdown(slowListenSocket, SHUT_RDWR);
+    close(slowListenSocket);
+}
+
+- (void)testParseContentRange
+{
+    unsigned long long firstBytePosition = 0, totalLength = 0;
+    
+    XCTAssertTrue([CMISHttpDownloadRequest parseContentRange:@"bytes 100-199/200" firstBytePosition:&firstBytePosition totalLength:&totalLength]);
+    XCTAssertEqual(firstBytePosition, 100ULL);
+    XCTAssertEqual(totalLength, 200ULL);
+    
+    // the total length may be unknown
+    XCTAssertTrue([CMISHttpDownloadRequest parseContentRange:@"bytes 0-99/*" firstBytePosition:&firstBytePosition totalLength:&totalLength]);
+    XCTAssertEqual(firstBytePosition, 0ULL);
+    XCTAssertEqual(totalLength, 0ULL);
+    
+    XCTAssertFalse([CMISHttpDownloadRequest parseContentRange:nil firstBytePosition:&firstBytePosition totalLength:&totalLength]);
+    XCTAssertFalse([CMISHttpDownloadRequest parseContentRange:@"bytes */200" firstBytePosition:&firstBytePosition totalLength:&totalLength]);
+    XCTAssertFalse([CMISHttpDownloadRequest parseContentRange:@"bytes 100-99/200" firstBytePosition:&firstBytePosition totalLength:&totalLength]);
+    XCTAssertFalse([CMISHttpDownloadRequest parseContentRange:@"bytes 100-199/150" firstBytePosition:&firstBytePosition totalLength:&totalLength]);
+}
+
+- (void)testResumedDownloadContentHash
+{
+    NSData *content = [self randomDataOfLength:256 * 1024];
+    NSMutableArray *requests = [NSMutableArray array];
+    in_port_t port = 0;
+    int listenSocket = [self startContentServerOnPort:&port content:content chunkDelay:0.1 requests:requests];
+    XCTAssertTrue(listenSocket >= 0);
+    
+    CMISSessionParameters *parameters = [[CMISSessionParameters alloc] initWithBindingType:CMISBindingTypeBrowser];
+    parameters.browserUrl = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d/", port]];
+    parameters.networkProvider = [[CMISDefaultNetworkProvider alloc] init];
+    [parameters setObject:@NO forKey:kCMISSessionParameterCheckNetworkReachability];
+    [parameters setObject:@0 forKey:kCMISSessionParameterMaxRetries];
+    [parameters setObject:@(CMISContentHashAlgorithmSHA256) forKey:kCMISSessionParameterContentHashAlgorithm];
+    CMISBindingSession *bindingSession = [[CMISBindingSession alloc] initWithSessionParameters:parameters];
+    NSURL *contentUrl = [parameters.browserUrl URLByAppendingPathComponent:@"content"];
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    NSString *partialFilePath = [filePath stringByAppendingPathExtension:@"cmispart"];
+    NSString *infoFilePath = [partialFilePath stringByAppendingPathExtension:@"plist"];
+    
+    CMISContentHasher *hasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmSHA256];
+    [hasher updateWithData:content];
+    NSString *expectedHash = [hasher finish];
+    
+    // downloads the content to the file, cancelling it after the first progress if requested
+    CMISHttpResponse *(^download)(BOOL) = ^CMISHttpResponse *(BOOL cancel) {
+        __block BOOL completed = NO;
+        __block CMISHttpResponse *response = nil;
+        CMISRequest *request = [[CMISRequest alloc] init];
+        [parameters.networkProvider invoke:contentUrl
+                                httpMethod:HTTP_GET
+                                   session:bindingSession
+                            outputFilePath:filePath
+                             bytesExpected:content.length
+                               cmisRequest:request
+                           completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                               XCTAssertTrue(cancel ? error.code == kCMISErrorCodeCancelled : error == nil, @"unexpected error: %@", error);
+                               response = httpResponse;
+                               completed = YES;
+                           }
+                             progressBlock:^(unsigned long long bytesDownloaded, unsigned long long bytesTotal) {
+                                 if (cancel) {
+                                     [request cancel];
+                                 }
+                             }];
+        NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:10];
+        while (!completed && [timeout timeIntervalSinceNow] > 0) {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+        }
+        XCTAssertTrue(completed);
+        return response;
+    };
+    
+    // a cancelled download keeps the received bytes
+    download(YES);
+    unsigned long long partialLength = [[[NSFileManager defaultManager] attributesOfItemAtPath:partialFilePath error:nil] fileSize];
+    XCTAssertTrue(partialLength > 0 && partialLength < content.length, @"expected a partial file: %llu", partialLength);
+    
+    // the resumed download hashes the kept bytes together with the received ones
+    CMISHttpResponse *response = download(NO);
+    XCTAssertEqual(response.statusCode, 206);
+    XCTAssertEqualObjects(response.contentHash, expectedHash);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:filePath], content);
+    NSString *expectedRange = [NSString stringWithFormat:@"Range: bytes=%llu-", partialLength];
+    XCTAssertTrue([[requests.lastObject objectForKey:@"header"] rangeOfString:expectedRange].location != NSNotFound);
+    
+    // if the content has changed the server sends all of it, the hash of the kept bytes is dropped
+    download(YES);
+    NSMutableDictionary *info = [NSMutableDictionary dictionaryWithContentsOfFile:infoFilePath];
+    XCTAssertNotNil(info);
+    [info setObject:@"\"changed\"" forKey:@"etag"];
+    [info writeToFile:infoFilePath atomically:YES];
+    response = download(NO);
+    XCTAssertEqual(response.statusCode, 200);
+    XCTAssertEqualObjects(response.contentHash, expectedHash);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:filePath], content);
+    
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+    shutdown(listenSocket, SHUT_RDWR);
+    close(listenSocket);
+}
+
+- (void)testParallelDownloadRanges
+{
+    NSArray *ranges = [CMISParallelDownload rangesForContentLength:10 rangeCount:3];
+    XCTAssertEqual(ranges.count, (NSUInteger)3);
+    XCTAssertEqualObjects(ranges[0], (@[@0, @4]));
+    XCTAssertEqualObjects(ranges[1], (@[@4, @3]));
+    XCTAssertEqualObjects(ranges[2], (@[@7, @3]));
+    
+    // every range has at least one byte
+    ranges = [CMISParallelDownload rangesForContentLength:2 rangeCount:4];
+    XCTAssertEqual(ranges.count, (NSUInteger)2);
+    XCTAssertEqualObjects(ranges[1], (@[@1, @1]));
+}
+
+- (void)testParallelDownloadStartsRangesOnFirstResponse
+{
+    CMISSessionParameters *parameters = [[CMISSessionParameters alloc] initWithBindingType:CMISBindingTypeBrowser];
+    parameters.browserUrl = [NSURL URLWithString:@"http://127.0.0.1:1/"];
+    parameters.repositoryId = @"repository";
+    CMISBindingSession *bindingSession = [[CMISBindingSession alloc] initWithSessionParameters:parameters];
+    CMISRangeObjectServiceStub *objectService = [[CMISRangeObjectServiceStub alloc] initWithBindingSession:bindingSession];
+    objectService.content = [@"abcdefghij" dataUsingEncoding:NSUTF8StringEncoding];
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    
+    __block BOOL completed = NO;
+    __block NSError *downloadError = nil;
+    CMISParallelDownload *download = [[CMISParallelDownload alloc] initWithObjectService:objectService objectId:@"object" streamId:nil
+                                                                           contentLength:objectService.content.length rangeCount:3];
+    [download downloadToFile:filePath cmisRequest:[[CMISRequest alloc] init] completionBlock:^(NSError *error) {
+        downloadError = error;
+        completed = YES;
+    } progressBlock:nil];
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2];
+    while (!completed && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    XCTAssertTrue(completed);
+    XCTAssertNil(downloadError);
+    XCTAssertEqual(objectService.startedRangeCountAtFirstCompletion, (NSUInteger)3, @"expected all ranges to be started before the first one completed");
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil], @"abcdefghij");
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+    
+    // the assembled file is hashed before the request completes
+    CMISContentHasher *expectedHasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmSHA256];
+    [expectedHasher updateWithData:objectService.content];
+    CMISRequest *cmisRequest = [[CMISRequest alloc] init];
+    completed = NO;
+    download = [[CMISParallelDownload alloc] initWithObjectService:objectService objectId:@"object" streamId:nil
+                                                     contentLength:objectService.content.length rangeCount:3];
+    download.contentHasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmSHA256];
+    [download downloadToFile:filePath cmisRequest:cmisRequest completionBlock:^(NSError *error) {
+        downloadError = error;
+        completed = YES;
+    } progressBlock:nil];
+    timeout = [NSDate dateWithTimeIntervalSinceNow:2];
+    while (!completed && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    XCTAssertTrue(completed);
+    XCTAssertNil(downloadError);
+    XCTAssertEqualObjects(cmisRequest.contentHash, [expectedHasher finish]);
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+    
+    // a range of another version of the content fails the download
+    objectService.entityTags[@7] = @"\"v2\"";
+    completed = NO;
+    download = [[CMISParallelDownload alloc] initWithObjectService:objectService objectId:@"object" streamId:nil
+                                                     contentLength:objectService.content.length rangeCount:3];
+    [download downloadToFile:filePath cmisRequest:[[CMISRequest alloc] init] completionBlock:^(NSError *error) {
+        downloadError = error;
+        completed = YES;
+    } progressBlock:nil];
+    timeout = [NSDate dateWithTimeIntervalSinceNow:2];
+    while (!completed && [timeout timeIntervalSinceNow] > 0) {
+        [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    }
+    XCTAssertTrue(completed);
+    XCTAssertEqual(downloadError.code, kCMISErrorCodeConnection);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:filePath], @"expected no file for inconsistent ranges");
+}
+
+- (void)testFileRangeOutputStream
+{
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    int fileDescriptor = open(filePath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    XCTAssertTrue(fileDescriptor >= 0);
+    
+    // the second range is written first
+    CMISFileRangeOutputStream *secondRange = [[CMISFileRangeOutputStream alloc] initWithFileDescriptor:fileDescriptor offset:3 maximumLength:3];
+    [secondRange open];
+    XCTAssertEqual([secondRange write:(const uint8_t *)"def" maxLength:3], (NSInteger)3);
+    XCTAssertEqual([secondRange write:(const uint8_t *)"g" maxLength:1], (NSInteger)-1, @"expected the range length to be enforced");
+    XCTAssertEqual(secondRange.streamStatus, NSStreamStatusError);
+    
+    CMISFileRangeOutputStream *firstRange = [[CMISFileRangeOutputStream alloc] initWithFileDescriptor:fileDescriptor offset:0 maximumLength:0];
+    [firstRange open];
+    XCTAssertEqual([firstRange write:(const uint8_t *)"ab" maxLength:2], (NSInteger)2);
+    XCTAssertEqual([firstRange write:(const uint8_t *)"c" maxLength:1], (NSInteger)1);
+    [firstRange close];
+    XCTAssertEqual(firstRange.bytesWritten, 3ULL);
+    close(fileDescriptor);
+    
+    NSString *content = [NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertEqualObjects(content, @"abcdef");
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+}
+
+- (void)testFileDownloadSink
+{
+    NSString *filePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    
+    CMISFileDownloadSink *sink = [[CMISFileDownloadSink alloc] initWithFilePath:filePath append:NO];
+    XCTAssertTrue([sink openWithExpectedLength:1024 error:nil]);
+    [sink writeData:[@"abc" dataUsingEncoding:NSUTF8StringEncoding]];
+    [sink closeWithCompletionBlock:^(NSError *error) {
+        XCTAssertNil(error);
+    }];
+    
+    // space reserved for the expected length does not count as content
+    XCTAssertEqual([[[NSFileManager defaultManager] attributesOfItemAtPath:filePath error:nil] fileSize], 3ULL);
+    
+    sink = [[CMISFileDownloadSink alloc] initWithFilePath:filePath append:YES];
+    XCTAssertTrue([sink openWithExpectedLength:0 error:nil]);
+    [sink writeData:[@"def" dataUsingEncoding:NSUTF8StringEncoding]];
+    [sink closeWithCompletionBlock:nil];
+    XCTAssertEqual(sink.bytesWritten, 3ULL);
+    
+    NSString *content = [NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil];
+    XCTAssertEqualObjects(content, @"abcdef");
+    [[NSFileManager defaultManager] removeItemAtPath:filePath error:nil];
+}
+
+- (void)testStreamDownloadSinkBackpressure
+{
+    NSOutputStream *outputStream = [NSOutputStream outputStreamToMemory];
+    CMISStreamDownloadSink *sink = [[CMISStreamDownloadSink alloc] initWithOutputStream:outputStream bufferLimit:4];
+    NSMutableArray *pauseStates = [NSMutableArray array];
+    sink.backpressureBlock = ^(BOOL paused) {
+        @synchronized(pauseStates) {
+            [pauseStates addObject:@(paused)];
+        }
+    };
+    XCTAssertTrue([sink openWithExpectedLength:0 error:nil]);
+    
+    // more data than the buffer limit pauses receiving right away
+    [sink writeData:[@"abcdefgh" dataUsingEncoding:NSUTF8StringEncoding]];
+    @synchronized(pauseStates) {
+        XCTAssertEqualObjects(pauseStates.firstObject, @YES);
+    }
+    
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    [sink closeWithCompletionBlock:^(NSError *error) {
+        XCTAssertNil(error);
+        dispatch_semaphore_signal(semaphore);
+    }];
+    XCTAssertEqual(dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+    
+    // receiving is resumed once the data has been written
+    XCTAssertEqualObjects(pauseStates, (@[@YES, @NO]));
+    XCTAssertEqual(sink.bufferedByteCount, (NSUInteger)0);
+    XCTAssertEqual(sink.bytesWritten, 8ULL);
+}
+
+- (void)testUploadPipeline
+{
+    NSData *startData = [@"<start>" dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *endData = [@"<end>" dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *content = [@"The quick brown fox jumps over the lazy dog" dataUsingEncoding:NSUTF8StringEncoding];
+    NSInputStream *inputStream = [NSInputStream inputStreamWithData:content];
+    [inputStream open];
+    
+    // a chunk size that is not a multiple of 3 must not put base64 padding in the middle of the content
+    CMISUploadPipeline *pipeline = [[CMISUploadPipeline alloc] initWithInputStream:inputStream
+                                                                         startData:startData
+                                                                           endData:endData
+                                                                    base64Encoding:YES
+                                                                         chunkSize:10
+                                                                       bufferCount:2];
+    XCTAssertEqual(pipeline.encodedChunkSize, (NSUInteger)12);
+    
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    pipeline.dataAvailableBlock = ^{
+        dispatch_semaphore_signal(semaphore);
+    };
+    [pipeline start];
+    
+    NSMutableData *body = [NSMutableData data];
+    while (!pipeline.isAtEnd && !pipeline.error) {
+        NSUInteger length = 0;
+        const uint8_t *bytes = [pipeline availableBytes:&length];
+        if (bytes) {
+            // consume in small pieces, as a full network stream would
+            NSUInteger consumed = MIN(length, 5);
+            [body appendBytes:bytes length:consumed];
+            [pipeline consumeBytes:consumed];
+        } else if (!pipeline.isAtEnd && !pipeline.error) {
+            XCTAssertEqual(dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC)), 0);
+        }
+    }
+    
+    XCTAssertNil(pipeline.error);
+    NSMutableData *expectedBody = [NSMutableData dataWithData:startData];
+    [expectedBody appendData:[CMISBase64Encoder dataByEncodingText:content]];
+    [expectedBody appendData:endData];
+    XCTAssertEqualObjects(body, expectedBody);
+    XCTAssertEqual(inputStream.streamStatus, NSStreamStatusClosed);
+}
+
+/**
+ Starts a minimal HTTP server on the loopback interface that reads and discards request bodies.
+ Returns the listening socket, the server stops when it is closed.
+ */
+- (int)startUploadSinkServerOnPort:(in_port_t *)port
+{
+    return [self startUploadSinkServerOnPort:port requestHeaders:nil];
+}
+
+/// starts the upload sink server, adding the header of each request it receives to the given array
+- (int)startUploadSinkServerOnPort:(in_port_t *)port requestHeaders:(NSMutableArray *)requestHeaders
+{
+    int listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    if (listenSocket < 0 || bind(listenSocket, (struct sockaddr *)&address, addressLength) != 0 ||
+        listen(listenSocket, 8) != 0 || getsockname(listenSocket, (struct sockaddr *)&address, &addressLength) != 0) {
+        return -1;
+    }
+    *port = ntohs(address.sin_port);
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        int connection;
+        while ((connection = accept(listenSocket, NULL, NULL)) >= 0) {
+            NSMutableData *header = [NSMutableData data];
+            uint8_t buffer[65536];
+            ssize_t bytesRead;
+            NSRange headerEnd = NSMakeRange(NSNotFound, 0);
+            while (headerEnd.location == NSNotFound && (bytesRead = read(connection, buffer, sizeof(buffer))) > 0) {
+                [header appendBytes:buffer length:bytesRead];
+                headerEnd = [header rangeOfData:[@"\r\n\r\n" dataUsingEncoding:NSASCIIStringEncoding] options:0 range:NSMakeRange(0, header.length)];
+            }
+            if (headerEnd.location != NSNotFound) {
+                NSString *headerString = [[NSString alloc] initWithData:[header subdataWithRange:NSMakeRange(0, headerEnd.location)] encoding:NSASCIIStringEncoding];
+                @synchronized(requestHeaders) {
+                    [requestHeaders addObject:headerString];
+                }
+                long long remaining = 0;
+                for (NSString *line in [headerString componentsSeparatedByString:@"\r\n"]) {
+                    if ([line.lowercaseString hasPrefix:@"content-length:"]) {
+                        remaining = [[line substringFromIndex:15] longLongValue];
+                    }
+                }
+                remaining -= header.length - NSMaxRange(headerEnd);
+                while (remaining > 0 && (bytesRead = read(connection, buffer, sizeof(buffer))) > 0) {
+                    remaining -= bytesRead;
+                }
+                const char *response = "HTTP/1.1 201 Created\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+                write(connection, response, strlen(response));
+            }
+            close(connection);
+        }
+    });
+    return listenSocket;
+}
+
+/**
+ Starts a minimal HTTP server on the loopback interface that answers GET requests with the given content. The response
+ headers are sent right away, the content follows in chunks with the given delay between them.
+ Returns the listening socket, the server stops when it is closed.
+ */
+- (int)startContentServerOnPort:(in_port_t *)port content:(NSData *)content chunkDelay:(NSTimeInterval)chunkDelay
+{
+    return [self startContentServerOnPort:port content:content chunkDelay:chunkDelay requests:nil];
+}
+
+/**
+ Starts the content server, adding each request it receives to the given array as dictionary with the method, path,
+ header and body. GET and HEAD requests get the content, a range of it if requested and the If-Range header matches the
+ ETag, requests to /missing a CMIS error response, POST and PUT requests 201 and DELETE requests 204.
+ */
+- (int)startContentServerOnPort:(in_port_t *)port content:(NSData *)content chunkDelay:(NSTimeInterval)chunkDelay requests:(NSMutableArray *)requests
+{
+    int listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_len = sizeof(address);
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addressLength = sizeof(address);
+    if (listenSocket < 0 || bind(listenSocket, (struct sockaddr *)&address, addressLength) != 0 ||
+        listen(listenSocket, 8) != 0 || getsockname(listenSocket, (struct sockaddr *)&address, &addressLength) != 0) {
+        return -1;
+    }
+    *port = ntohs(address.sin_port);
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        int connection;
+        while ((connection = accept(listenSocket, NULL, NULL)) >= 0) {
+            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [self serveContentRequestOnConnection:connection content:content chunkDelay:chunkDelay requests:requests];
+                close(connection);
+            });
+        }
+    });
+    return listenSocket;
+}
+
+/// reads one request from the connection and answers it, see startContentServerOnPort:content:chunkDelay:requests:
+- (void)serveContentRequestOnConnection:(int)connection content:(NSData *)content chunkDelay:(NSTimeInterval)chunkDelay requests:(NSMutableArray *)requests
+{
+    NSData *headerSeparator = [@"\r\n\r\n" dataUsingEncoding:NSASCIIStringEncoding];
+    NSData *lineSeparator = [@"\r\n" dataUsingEncoding:NSASCIIStringEncoding];
+    NSMutableData *received = [NSMutableData data];
+    uint8_t buffer[65536];
+    ssize_t bytesRead;
+    NSRange headerEnd = NSMakeRange(NSNotFound, 0);
+    while (headerEnd.location == NSNotFound && (bytesRead = read(connection, buffer, sizeof(buffer))) > 0) {
+        [received appendBytes:buffer length:bytesRead];
+        headerEnd = [received rangeOfData:headerSeparator options:0 range:NSMakeRange(0, received.length)];
+    }
+    if (headerEnd.location == NSNotFound) {
+        return;
+    }
+    
+    NSString *header = [[NSString alloc] initWithData:[received subdataWithRange:NSMakeRange(0, headerEnd.location)] encoding:NSASCIIStringEncoding];
+    NSArray *requestLine = [[header componentsSeparatedByString:@"\r\n"].firstObject componentsSeparatedByString:@" "];
+    NSString *method = requestLine.count > 1 ? requestLine[0] : @"";
+    NSString *path = requestLine.count > 1 ? requestLine[1] : @"";
+    long long contentLength = 0;
+    BOOL chunked = NO;
+    long long rangeStart = -1;
+    NSString *ifRange = nil;
+    for (NSString *line in [header componentsSeparatedByString:@"\r\n"]) {
+        NSString *lowercaseLine = line.lowercaseString;
+        if ([lowercaseLine hasPrefix:@"content-length:"]) {
+            contentLength = [[line substringFromIndex:15] longLongValue];
+        } else if ([lowercaseLine hasPrefix:@"range: bytes="]) {
+            rangeStart = [[line substringFromIndex:13] longLongValue];
+        } else if ([lowercaseLine hasPrefix:@"if-range:"]) {
+            ifRange = [[line substringFromIndex:9] stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+        } else if ([lowercaseLine hasPrefix:@"transfer-encoding:"] && [lowercaseLine rangeOfString:@"chunked"].location != NSNotFound) {
+            chunked = YES;
+        } else if ([lowercaseLine hasPrefix:@"expect:"] && [lowercaseLine rangeOfString:@"100-continue"].location != NSNotFound) {
+            const char *continueResponse = "HTTP/1.1 100 Continue\r\n\r\n";
+            write(connection, continueResponse, strlen(continueResponse));
+        }
+    }
+    [received replaceBytesInRange:NSMakeRange(0, NSMaxRange(headerEnd)) withBytes:NULL length:0];
+    
+    // read the body, a chunked body is decoded
+    NSMutableData *body = [NSMutableData data];
+    if (chunked) {
+        BOOL finished = NO;
+        while (!finished) {
+            NSRange lineEnd = [received rangeOfData:lineSeparator options:0 range:NSMakeRange(0, received.length)];
+            if (lineEnd.location != NSNotFound) {
+                NSString *sizeLine = [[NSString alloc] initWithData:[received subdataWithRange:NSMakeRange(0, lineEnd.location)] encoding:NSASCIIStringEncoding];
+                unsigned long long chunkSize = strtoull(sizeLine.UTF8String, NULL, 16);
+                if (received.length >= NSMaxRange(lineEnd) + chunkSize + 2) {
+                    [body appendData:[received subdataWithRange:NSMakeRange(NSMaxRange(lineEnd), (NSUInteger)chunkSize)]];
+                    [received replaceBytesInRange:NSMakeRange(0, NSMaxRange(lineEnd) + (NSUInteger)chunkSize + 2) withBytes:NULL length:0];
+                    finished = chunkSize == 0;
+                    continue;
+                }
+            }
+            if ((bytesRead = read(connection, buffer, sizeof(buffer))) <= 0) {
+                return;
+            }
+            [received appendBytes:buffer length:bytesRead];
+        }
+    } else {
+        [body appendData:received];
+        while ((long long)body.length < contentLength && (bytesRead = read(connection, buffer, sizeof(buffer))) > 0) {
+            [body appendBytes:buffer length:bytesRead];
+        }
+    }
+    @synchronized(requests) {
+        [requests addObject:@{@"method" : method, @"path" : path, @"header" : header, @"body" : body}];
+    }
+    
+    NSString *responseHeader = nil;
+    NSData *responseBody = nil;
+    if ([path hasPrefix:@"/missing"]) {
+        responseBody = [@"{\"exception\":\"objectNotFound\",\"message\":\"Object not found: missing\"}" dataUsingEncoding:NSUTF8StringEncoding];
+        responseHeader = [NSString stringWithFormat:@"HTTP/1.1 404 Not Found\r\nContent-Type: application/json\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n",
+                          (unsigned long)responseBody.length];
+    } else if ([method isEqualToString:@"GET"] && rangeStart >= 0 && rangeStart < (long long)content.length &&
+               (ifRange == nil || [ifRange isEqualToString:@"\"content\""])) {
+        responseBody = [content subdataWithRange:NSMakeRange((NSUInteger)rangeStart, content.length - (NSUInteger)rangeStart)];
+        responseHeader = [NSString stringWithFormat:@"HTTP/1.1 206 Partial Content\r\nContent-Type: application/octet-stream\r\nETag: \"content\"\r\n"
+                          "Content-Range: bytes %lld-%lu/%lu\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n",
+                          rangeStart, (unsigned long)content.length - 1, (unsigned long)content.length, (unsigned long)responseBody.length];
+    } else if ([method isEqualToString:@"GET"] || [method isEqualToString:@"HEAD"]) {
+        responseBody = [method isEqualToString:@"GET"] ? content : nil;
+        responseHeader = [NSString stringWithFormat:@"HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nETag: \"content\"\r\nContent-Length: %lu\r\nConnection: close\r\n\r\n",
+                          (unsigned long)content.length];
+    } else if ([method isEqualToString:@"DELETE"]) {
+        responseHeader = @"HTTP/1.1 204 No Content\r\nConnection: close\r\n\r\n";
+    } else {
+        responseHeader = @"HTTP/1.1 201 Created\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    write(connection, responseHeader.UTF8String, strlen(responseHeader.UTF8String));
+    
+    // the body is sent in chunks, so a delay makes the transfer take longer than waiting for the response
+    NSUInteger chunkLength = MAX(responseBody.length / 8, 1);
+    for (NSUInteger offset = 0; offset < responseBody.length; offset += chunkLength) {
+        if (chunkDelay > 0) {
+            [NSThread sleepForTimeInterval:chunkDelay];
+        }
+        if (write(connection, (const uint8_t *)responseBody.bytes + offset, MIN(chunkLength, responseBody.length - offset)) < 0) {
+            return; // the client went away, e.g. after cancelling
+        }
+    }
+}
+
+- (void)testUploadThroughput
+{
+    in_port_t port = 0;
+    int listenSocket = [self startUploadSinkServerOnPort:&port];
+    XCTAssertTrue(listenSocket >= 0);
+    
+    CMISSessionParameters *parameters = [[CMISSessionParameters alloc] initWithBindingType:CMISBindingTypeBrowser];
+    parameters.browserUrl = [NSURL URLWithString:[NSString stringWithFormat:@"http://127.0.0.1:%d/", port]];
+    [parameters setObject:@NO forKey:kCMISSessionParameterCheckNetworkReachability];
+    CMISBindingSession *bindingSession = [[CMISBindingSession alloc] initWithSessionParameters:parameters];
+    
+    NSData *content = [NSMutableData dataWithLength:32 * 1024 * 1024];
+    NSData *startData = [@"<entry><content>" dataUsingEncoding:NSUTF8StringEncoding];
+    NSData *endData = [@"</content></entry>" dataUsingEncoding:NSUTF8StringEncoding];
+    
+    // base64 encoded upload of 32MB, the AtomPub binding's path through the upload pump
+    [self measureBlock:^{
+        __block BOOL completed = NO;
+        NSMutableURLRequest *urlRequest = [NSMutableURLRequest requestWithURL:parameters.browserUrl];
+        [CMISHttpUploadRequest startRequest:urlRequest
+                                 httpMethod:HTTP_POST
+                                inputStream:[NSInputStream inputStreamWithData:content]
+                                    headers:nil
+                              bytesExpected:content.length
+                                    session:bindingSession
+                                  startData:startData
+                                    endData:endData
+                          useBase64Encoding:YES
+                            completionBlock:^(CMISHttpResponse *httpResponse, NSError *error) {
+                                XCTAssertNil(error);
+                                XCTAssertEqual(httpResponse.statusCode, 201);
+                                completed = YES;
+                            }
+                              progressBlock:nil];
+        
+        NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:60];
+        while (!completed && [timeout timeIntervalSinceNow] > 0) {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+        }
+        XCTAssertTrue(completed);
+    }];
+    
+    shutdown(listenSocket, SHUT_RDWR);
+    close(listenSocket);
+}
+
+/**
+ The byte at a time encoder CMISBase64Encoder used before it was vectorized, as reference for results and speed
+ */
+- (NSData *)referenceBase64EncodedData:(NSData *)plainText
+{
+    static char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    NSUInteger encodedLength = (4 * (([plainText length] / 3) + (1 - (3 - ([plainText length] % 3)) / 3)));
+    NSMutableData *encodedData = [[NSMutableData alloc] initWithLength:encodedLength];
+    char *outputBuffer = encodedData.mutableBytes;
+    unsigned char *inputBuffer = (unsigned char *) [plainText bytes];
+    
+    NSInteger j = 0;
+    for (NSInteger i = 0; i < [plainText length]; i += 3) {
+        NSUInteger remain = [plainText length] - i;
+        outputBuffer[j++] = alphabet[(inputBuffer[i] & 0xFC) >> 2];
+        outputBuffer[j++] = alphabet[((inputBuffer[i] & 0x03) << 4) | ((remain > 1) ? ((inputBuffer[i + 1] & 0xF0) >> 4) : 0)];
+        outputBuffer[j++] = (remain > 1) ? alphabet[((inputBuffer[i + 1] & 0x0F) << 2) | ((remain > 2) ? ((inputBuffer[i + 2] & 0xC0) >> 6) : 0)] : '=';
+        outputBuffer[j++] = (remain > 2) ? alphabet[inputBuffer[i + 2] & 0x3F] : '=';
+    }
+    return encodedData;
+}
+
+- (NSData *)randomDataOfLength:(NSUInteger)length
+{
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    arc4random_buf(data.mutableBytes, length);
+    return data;
+}
+
+- (void)testBase64Encoding
+{
+    XCTAssertEqualObjects([CMISBase64Encoder stringByEncodingText:[@"" dataUsingEncoding:NSUTF8StringEncoding]], @"");
+    XCTAssertEqualObjects([CMISBase64Encoder stringByEncodingText:[@"f" dataUsingEncoding:NSUTF8StringEncoding]], @"Zg==");
+    XCTAssertEqualObjects([CMISBase64Encoder stringByEncodingText:[@"fo" dataUsingEncoding:NSUTF8StringEncoding]], @"Zm8=");
+    XCTAssertEqualObjects([CMISBase64Encoder stringByEncodingText:[@"foobar" dataUsingEncoding:NSUTF8StringEncoding]], @"Zm9vYmFy");
+    
+    // lengths around the vector block sizes
+    for (NSUInteger length = 0; length < 200; length++) {
+        NSData *data = [self randomDataOfLength:length];
+        XCTAssertEqualObjects([CMISBase64Encoder dataByEncodingText:data], [self referenceBase64EncodedData:data], @"length %lu", (unsigned long)length);
+    }
+    
+    // streaming gives the same result however the data is split up
+    NSData *data = [self randomDataOfLength:1000];
+    NSData *expected = [self referenceBase64EncodedData:data];
+    for (NSUInteger chunkSize = 1; chunkSize < 70; chunkSize++) {
+        CMISBase64Encoder *encoder = [[CMISBase64Encoder alloc] init];
+        NSMutableData *encoded = [NSMutableData data];
+        char buffer[128];
+        for (NSUInteger offset = 0; offset < data.length; offset += chunkSize) {
+            NSUInteger length = MIN(chunkSize, data.length - offset);
+            NSUInteger encodedLength = [encoder appendBytes:(const uint8_t *)data.bytes + offset length:length toBuffer:buffer];
+            XCTAssertTrue(encodedLength <= [CMISBase64Encoder encodedLengthForLength:length + 2]);
+            [encoded appendBytes:buffer length:encodedLength];
+        }
+        [encoded appendBytes:buffer length:[encoder finishToBuffer:buffer]];
+        XCTAssertEqualObjects(encoded, expected, @"chunk size %lu", (unsigned long)chunkSize);
+    }
+    
+    // short reads from a stream must not put padding into the middle of the data
+    NSInputStream *inputStream = [NSInputStream inputStreamWithData:data];
+    [inputStream open];
+    NSString *encodedString = [CMISBase64Encoder encodeContentFromInputStream:inputStream];
+    XCTAssertEqualObjects([encodedString dataUsingEncoding:NSUTF8StringEncoding], expected);
+}
+
+- (void)testBase64Decoding
+{
+    XCTAssertEqualObjects([CMISBase64Decoder dataByDecodingText:[@"Zm9vYmFy" dataUsingEncoding:NSUTF8StringEncoding]], [@"foobar" dataUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertEqualObjects([CMISBase64Decoder dataByDecodingText:[@"Zm8=" dataUsingEncoding:NSUTF8StringEncoding]], [@"fo" dataUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertEqualObjects([CMISBase64Decoder dataByDecodingText:[@" Zm9v\r\nYmE=\n" dataUsingEncoding:NSUTF8StringEncoding]], [@"fooba" dataUsingEncoding:NSUTF8StringEncoding]);
+    XCTAssertNil([CMISBase64Decoder dataByDecodingText:[@"Zm9vY" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertNil([CMISBase64Decoder dataByDecodingText:[@"Zm=vYmFy" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertNil([CMISBase64Decoder dataByDecodingText:[@"Zm8=Zm8=" dataUsingEncoding:NSUTF8StringEncoding]]);
+    XCTAssertNil([CMISBase64Decoder dataByDecodingText:[@"Zm9v*mFy" dataUsingEncoding:NSUTF8StringEncoding]]);
+    
+    for (NSUInteger length = 0; length < 200; length++) {
+        NSData *data = [self randomDataOfLength:length];
+        XCTAssertEqualObjects([CMISBase64Decoder dataByDecodingText:[self referenceBase64EncodedData:data]], data, @"length %lu", (unsigned long)length);
+    }
+    
+    // an invalid character behind a long valid run is found by the vector path as well
+    NSMutableData *encoded = [[self referenceBase64EncodedData:[self randomDataOfLength:300]] mutableCopy];
+    ((char *)encoded.mutableBytes)[250] = '.';
+    XCTAssertNil([CMISBase64Decoder dataByDecodingText:encoded]);
+    
+    // streaming with line breaks every 76 characters, split into odd chunks
+    NSData *data = [self randomDataOfLength:5000];
+    NSString *lines = [[CMISBase64Encoder stringByEncodingText:data] stringByReplacingOccurrencesOfString:@"(.{76})" withString:@"$1\r\n" options:NSRegularExpressionSearch range:NSMakeRange(0, 6668)];
+    NSData *lineData = [lines dataUsingEncoding:NSUTF8StringEncoding];
+    CMISBase64Decoder *decoder = [[CMISBase64Decoder alloc] init];
+    NSMutableData *decoded = [NSMutableData data];
+    uint8_t buffer[256];
+    for (NSUInteger offset = 0; offset < lineData.length; offset += 97) {
+        NSUInteger length = MIN(97, lineData.length - offset);
+        NSUInteger decodedLength = [decoder decodeBytes:(const char *)lineData.bytes + offset length:length toBuffer:buffer];
+        XCTAssertNotEqual(decodedLength, NSNotFound);
+        [decoded appendBytes:buffer length:decodedLength];
+    }
+    XCTAssertTrue([decoder finish]);
+    XCTAssertEqualObjects(decoded, data);
+}
+
+- (void)testBase64EncodingPerformance
+{
+    NSData *data = [self randomDataOfLength:32 * 1024 * 1024];
+    [self measureBlock:^{
+        XCTAssertEqual([CMISBase64Encoder dataByEncodingText:data].length, (NSUInteger)44739244);
+    }];
+}
+
+- (void)testBase64ReferenceEncodingPerformance
+{
+    NSData *data = [self randomDataOfLength:32 * 1024 * 1024];
+    [self measureBlock:^{
+        XCTAssertEqual([self referenceBase64EncodedData:data].length, (NSUInteger)44739244);
+    }];
+}
+
+- (void)testBase64DecodingPerformance
+{
+    NSData *data = [self randomDataOfLength:32 * 1024 * 1024];
+    NSData *encoded = [CMISBase64Encoder dataByEncodingText:data];
+    [self measureBlock:^{
+        XCTAssertEqual([CMISBase64Decoder dataByDecodingText:encoded].length, data.length);
+    }];
+}
+
+- (NSData *)atomFeedDataWithEntryCount:(NSUInteger)entryCount
+{
+    // a recorded children feed, its two entries are repeated
+    NSString *filePath = [[NSBundle bundleForClass:[self class]] pathForResource:@"FolderChildren-opencmis" ofType:@"xml"];
+    NSString *feed = [NSString stringWithContentsOfFile:filePath encoding:NSUTF8StringEncoding error:nil];
+    NSRange firstEntry = [feed rangeOfString:@"<atom:entry>"];
+    NSRange lastEntry = [feed rangeOfString:@"</atom:entry>" options:NSBackwardsSearch];
+    NSString *entries = [feed substringWithRange:NSMakeRange(firstEntry.location, NSMaxRange(lastEntry) - firstEntry.location)];
+    
+    NSMutableString *recordedFeed = [NSMutableString stringWithString:[feed substringToIndex:firstEntry.location]];
+    for (NSUInteger i = 0; i < entryCount / 2; i++) {
+        [recordedFeed appendString:entries];
+    }
+    [recordedFeed appendString:[feed substringFromIndex:NSMaxRange(lastEntry)]];
+    return [recordedFeed dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)measureAtomFeedParsingWithParserClass:(Class)parserClass
+{
+    NSUInteger entryCount = 2000;
+    NSData *feedData = [self atomFeedDataWithEntryCount:entryCount];
+    
+    [self measureBlock:^{
+        __block NSUInteger parsedEntryCount = 0;
+        CMISAtomFeedParser *feedParser = [[CMISAtomFeedParser alloc] initWithEntryBlock:^(CMISObjectData *objectData) {
+            parsedEntryCount++;
+        }];
+        CMISXMLParser *parser = [[parserClass alloc] initWithData:feedData];
+        [parser setDelegate:feedParser];
+        
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        XCTAssertTrue([parser parse]);
+        CFAbsoluteTime duration = CFAbsoluteTimeGetCurrent() - start;
+        
+        XCTAssertEqual(parsedEntryCount, entryCount);
+        CMISLogInfo(@"%@ parsed %.0f entries per second", NSStringFromClass(parserClass), parsedEntryCount / duration);
+    }];
+}
+
+- (void)testAtomFeedParsingPerformance
+{
+    [self measureAtomFeedParsingWithParserClass:[CMISXMLParser class]];
+}
+
+- (void)testAtomFeedReferenceParsingPerformance
+{
+    [self measureAtomFeedParsingWithParserClass:[CMISReferenceXMLParser class]];
+}
+
+- (NSData *)browserObjectListDataWithObjectCount:(NSUInteger)objectCount
+{
+    NSMutableString *json = [NSMutableString stringWithString:@"{\"objects\":["];
+    for (NSUInteger i = 0; i < objectCount; i++) {
+        NSString *objectId = [NSString stringWithFormat:@"doc-%lu", (unsigned long)i];
+        [json appendFormat:@"%@{\"object\":%@}", (i > 0 ? @"," : @""), [self browserJSONObjectWithId:objectId baseTypeId:@"cmis:document" name:objectId]];
+    }
+    [json appendFormat:@"],\"hasMoreItems\":false,\"numItems\":%lu}", (unsigned long)objectCount];
+    return [json dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)testBrowserObjectListReadingPerformance
+{
+    NSUInteger objectCount = 10000;
+    NSData *jsonData = [self browserObjectListDataWithObjectCount:objectCount];
+    
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        __block NSUInteger readObjectCount = 0;
+        [CMISBrowserUtil objectListFromJSONData:jsonData typeCache:nil isQueryResult:NO completionBlock:^(CMISObjectList *objectList, NSError *error) {
+            readObjectCount = objectList.objects.count;
+        }];
+        CFAbsoluteTime duration = CFAbsoluteTimeGetCurrent() - start;
+        
+        XCTAssertEqual(readObjectCount, objectCount);
+        CMISLogInfo(@"CMISBrowserObjectReader read %.0f objects per second", readObjectCount / duration);
+    }];
+}
+
+// Materialises the response with NSJSONSerialization and converts the object tree, like the Browser binding did before CMISBrowserObjectReader
+- (void)testBrowserObjectListReferenceReadingPerformance
+{
+    NSUInteger objectCount = 10000;
+    NSData *jsonData = [self browserObjectListDataWithObjectCount:objectCount];
+    
+    [self measureBlock:^{
+        CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+        NSDictionary *jsonDictionary = [NSJSONSerialization JSONObjectWithData:jsonData options:0 error:nil];
+        NSMutableArray *objects = [NSMutableArray array];
+        for (NSDictionary *item in jsonDictionary[@"objects"]) {
+            NSDictionary *propertiesJson = item[@"object"][@"properties"];
+            CMISObjectData *objectData = [[CMISObjectData alloc] init];
+            objectData.properties = [[CMISProperties alloc] init];
+            for (NSString *propertyId in propertiesJson) {
+                [objectData.properties addProperty:[CMISBrowserUtil convertProperty:propertyId propertyDictionary:propertiesJson[propertyId] error:nil]];
+            }
+            objectData.identifier = [objectData.properties propertyValueForId:@"cmis:objectId"];
+            [objects addObject:objectData];
+        }
+        CFAbsoluteTime duration = CFAbsoluteTimeGetCurrent() - start;
+        
+        XCTAssertEqual(objects.count, objectCount);
+        CMISLogInfo(@"NSJSONSerialization read %.0f objects per second", objects.count / duration);
+    }];
+}
+
+- (NSData *)browserSuccinctObjectListDataWithObjectCount:(NSUInteger)objectCount
+{
+    NSMutableString *json = [NSMutableString stringWithString:@"{\"objects\":["];
+    for (NSUInteger i = 0; i < objectCount; i++) {
+        [json appendFormat:@"%@{\"object\":%@}", (i > 0 ? @"," : @""), [self browserSuccinctJSONObjectWithId:[NSString stringWithFormat:@"doc-%lu", (unsigned long)i]]];
+    }
+    [json appendFormat:@"],\"hasMoreItems\":false,\"numItems\":%lu}", (unsigned long)objectCount];
+    return [json dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)measureBrowserSuccinctObjectListConversionWithBlock:(NSUInteger (^)(NSArray *objectsJson, CMISBrowserTypeCache *typeCache))conversionBlock name:(NSString *)name
+{
+    CMISBrowserBaseService *service = [self browserServiceWithCachedTypeDefinitions];
+    NSMutableDictionary *objectsJsonByCount = [NSMutableDictionary dictionary];
+    for (NSNumber *objectCount in @[@100, @1000, @10000, @50000]) {
+        NSData *jsonData = [self browserSuccinctObjectListDataWithObjectCount:objectCount.unsignedIntegerValue];
+        objectsJsonByCount[objectCount] = [NSJSONSerialization JSONObjectWithData:jsonData options:0 error:nil][@"objects"];
+    }
+    
+    [self measureBlock:^{
+        for (NSNumber *objectCount in [objectsJsonByCount.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+            CMISBrowserTypeCache *typeCache = [[CMISBrowserTypeCache alloc] initWithRepositoryId:service.bindingSession.repositoryId bindingService:service];
+            CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+            NSUInteger convertedCount = conversionBlock(objectsJsonByCount[objectCount], typeCache);
+            CFAbsoluteTime duration = CFAbsoluteTimeGetCurrent() - start;
+            
+            XCTAssertEqual(convertedCount, objectCount.unsignedIntegerValue);
+            CMISLogInfo(@"%@ converted %@ objects at %.0f objects per second", name, objectCount, convertedCount / duration);
+        }
+    }];
+}
+
+- (void)testBrowserSuccinctObjectListConversionPerformance
+{
+    [self measureBrowserSuccinctObjectListConversionWithBlock:^NSUInteger(NSArray *objectsJson, CMISBrowserTypeCache *typeCache) {
+        __block NSUInteger convertedCount = 0;
+        for (NSDictionary *item in objectsJson) {
+            NSDictionary *objectJson = item[@"object"];
+            [CMISBrowserUtil convertObjectData:[[CMISObjectData alloc] init] members:objectJson succinctProperties:objectJson[@"succinctProperties"] typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
+                if (objectData) {
+                    convertedCount++;
+                }
+            }];
+        }
+        return convertedCount;
+    } name:@"CMISBrowserUtil"];
+}
+
+- (void)executeBlock:(void (^)(void))block
+{
+    block();
+}
+
+// Converts every object in its own run loop turn, like the recursive conversion of CMISBrowserUtil did to keep its call stack small
+- (void)testBrowserSuccinctObjectListReferenceConversionPerformance
+{
+    [self measureBrowserSuccinctObjectListConversionWithBlock:^NSUInteger(NSArray *objectsJson, CMISBrowserTypeCache *typeCache) {
+        __block NSUInteger convertedCount = 0;
+        __block NSUInteger position = 0;
+        __block void (^convertNextObject)(void);
+        convertNextObject = ^{
+            NSDictionary *objectJson = objectsJson[position][@"object"];
+            [CMISBrowserUtil convertObjectData:[[CMISObjectData alloc] init] members:objectJson succinctProperties:objectJson[@"succinctProperties"] typeCache:typeCache completionBlock:^(CMISObjectData *objectData, NSError *error) {
+                if (objectData) {
+                    convertedCount++;
+                }
+                if (++position < objectsJson.count) {
+                    [self performSelector:@selector(executeBlock:) onThread:[NSThread currentThread] withObject:convertNextObject waitUntilDone:NO];
+                }
+            }];
+        };
+        convertNextObject();
+        while (position < objectsJson.count) {
+            [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+        }
+        convertNextObject = nil;
+        return convertedCount;
+    } name:@"Run loop hop per object"];
+}
+
+- (void)testAtomEntryStartAndEndData
+{
+    CMISProperties *properties = [[CMISProperties alloc] init];
+    [properties addProperty:[CMISPropertyData createPropertyForId:kCMISPropertyName stringValue:@"Q&A.txt"]];
+    [properties addProperty:[CMISPropertyData createPropertyForId:kCMISPropertyObjectTypeId idValue:@"cmis:document"]];
+    NSData *content = [@"streamed entry content" dataUsingEncoding:NSUTF8StringEncoding];
+    
+    CMISAtomEntryWriter *writer = [[CMISAtomEntryWriter alloc] init];
+    writer.cmisProperties = properties;
+    writer.mimeType = @"text/plain";
+    NSData *startData = [writer entryStartData];
+    NSData *endData = [writer entryEndData];
+    
+    // the streamed entry is the same as the entry generated in memory
+    CMISAtomEntryWriter *memoryWriter = [[CMISAtomEntryWriter alloc] init];
+    memoryWriter.cmisProperties = properties;
+    memoryWriter.mimeType = @"text/plain";
+    memoryWriter.inputStream = [NSInputStream inputStreamWithData:content];
+    [memoryWriter.inputStream open];
+    memoryWriter.generateXmlInMemory = YES;
+    NSData *expectedEntry = [[memoryWriter generateAtomEntryXml] dataUsingEncoding:NSUTF8StringEncoding];
+    
+    NSMutableData *entry = [NSMutableData dataWithData:startData];
+    [entry appendData:[CMISBase64Encoder dataByEncodingText:content]];
+    [entry appendData:endData];
+    XCTAssertEqualObjects(entry, expectedEntry);
+}
+
+- (NSData *)dataByReadingStream:(NSInputStream *)inputStream bufferSize:(NSUInteger)bufferSize
+{
+    NSMutableData *data = [NSMutableData data];
+    uint8_t buffer[bufferSize];
+    NSInteger bytesRead;
+    [inputStream open];
+    while ((bytesRead = [inputStream read:buffer maxLength:bufferSize]) > 0) {
+        [data appendBytes:buffer length:bytesRead];
+    }
+    return (bytesRead < 0 ? nil : data);
+}
+
+- (void)testMultipartFormDataStream
+{
+    CMISMultipartFormDataStream *bodyStream = [[CMISMultipartFormDataStream alloc] initWithBoundary:@"B"];
+    [bodyStream addFieldWithName:@"cmisaction" value:@"createDocument"];
+    [bodyStream addPartWithContentDisposition:@"form-data; name=\"content\"; filename=\"a.txt\""
+                                    mediaType:@"text/plain"
+                                  inputStream:[NSInputStream inputStreamWithData:[@"first" dataUsingEncoding:NSUTF8StringEncoding]]
+                                       length:5];
+    [bodyStream addPartWithContentDisposition:@"form-data; name=\"content2\"; filename=\"b.txt\""
+                                    mediaType:@"text/plain"
+                                  inputStream:[NSInputStream inputStreamWithData:[@"second" dataUsingEncoding:NSUTF8StringEncoding]]
+                                       length:6];
+    XCTAssertEqualObjects(bodyStream.contentType, @"multipart/form-data; boundary=B");
+    
+    NSString *expectedBody = @"\r\n"
+        "--B\r\nContent-Disposition: form-data; name=\"cmisaction\"\r\nContent-Type: text/plain; charset=utf-8\r\n\r\ncreateDocument\r\n"
+        "--B\r\nContent-Disposition: form-data; name=\"content\"; filename=\"a.txt\"\r\nContent-Type: text/plain\r\nContent-Transfer-Encoding: binary\r\n\r\nfirst\r\n"
+        "--B\r\nContent-Disposition: form-data; name=\"content2\"; filename=\"b.txt\"\r\nContent-Type: text/plain\r\nContent-Transfer-Encoding: binary\r\n\r\nsecond\r\n"
+        "--B--\r\n";
+    XCTAssertEqual(bodyStream.length, (long long)[expectedBody dataUsingEncoding:NSUTF8StringEncoding].length);
+    NSData *body = [self dataByReadingStream:bodyStream bufferSize:7];
+    XCTAssertEqualObjects([[NSString alloc] initWithData:body encoding:NSUTF8StringEncoding], expectedBody);
+    XCTAssertEqual(bodyStream.streamStatus, NSStreamStatusAtEnd);
+    
+    // a content part of unknown length makes the length of the body unknown
+    CMISMultipartFormDataStream *unknownLengthStream = [[CMISMultipartFormDataStream alloc] initWithBoundary:@"B"];
+    [unknownLengthStream addPartWithContentDisposition:@"form-data; name=\"content\"" mediaType:@"text/plain"
+                                           inputStream:[NSInputStream inputStreamWithData:[NSData data]] length:-1];
+    XCTAssertEqual(unknownLengthStream.length, -1LL);
+    
+    // content that does not match the announced length fails the body
+    CMISMultipartFormDataStream *shortStream = [[CMISMultipartFormDataStream alloc] initWithBoundary:@"B"];
+    [shortStream addPartWithContentDisposition:@"form-data; name=\"content\"" mediaType:@"text/plain"
+                                   inputStream:[NSInputStream inputStreamWithData:[@"abc" dataUsingEncoding:NSUTF8StringEncoding]] length:4];
+    XCTAssertNil([self dataByReadingStream:shortStream bufferSize:64]);
+    XCTAssertNotNil(shortStream.streamError);
+}
+
+- (void)testFormDataWriterBodyStream
+{
+    NSData *content = [@"form data content" dataUsingEncoding:NSUTF8StringEncoding];
+    CMISProperties *properties = [[CMISProperties alloc] init];
+    [properties addProperty:[CMISPropertyData createPropertyForId:kCMISPropertyName stringValue:@"name.txt"]];
+    
+    CMISBroswerFormDataWriter *formData = [[CMISBroswerFormDataWriter alloc] initWithAction:@"createDocument"
+                                                                              contentStream:[NSInputStream inputStreamWithData:content]
+                                                                                  mediaType:@"text/plain"];
+    [formData addPropertiesParameters:properties];
+    [formData addSuccinctFlag:YES];
+    
+    // the streamed body is the same as the body built around the content
+    NSMutableData *expectedBody = [NSMutableData dataWithData:formData.startData];
+    [expectedBody appendData:content];
+    [expectedBody appendData:formData.endData];
+    
+    CMISMultipartFormDataStream *bodyStream = [formData bodyStreamWithContentLength:content.length];
+    XCTAssertEqual(bodyStream.length, (long long)expectedBody.length);
+    XCTAssertEqualObjects([self dataByReadingStream:bodyStream bufferSize:1024], expectedBody);
+    XCTAssertTrue([formData.headers[@"Content-Type"] hasSuffix:bodyStream.boundary]);
+}
+
+- (void)testChunkedUploadParts
+{
+    NSArray *parts = [CMISChunkedUpload partsForContentLength:10 partSize:4];
+    NSArray *expectedParts = @[@[@0, @4], @[@4, @4], @[@8, @2]];
+    XCTAssertEqualObjects(parts, expectedParts, @"Unexpected parts");
+    XCTAssertEqualObjects([CMISChunkedUpload partsForContentLength:8 partSize:4], (@[@[@0, @4], @[@4, @4]]), @"Unexpected parts");
+    XCTAssertEqualObjects([CMISChunkedUpload partsForContentLength:0 partSize:4], (@[@[@0, @0]]), @"Empty content should be a single empty part");
+    
+    // the repository stored exactly the acknowledged parts
+    XCTAssertEqual([CMISChunkedUpload resumePartIndexForParts:parts bytesAcknowledged:4 storedLength:4], (NSUInteger)1);
+    // the part after the checkpoint was stored but not acknowledged
+    XCTAssertEqual([CMISChunkedUpload resumePartIndexForParts:parts bytesAcknowledged:4 storedLength:8], (NSUInteger)2);
+    // the last part was stored, nothing is left to send
+    XCTAssertEqual([CMISChunkedUpload resumePartIndexForParts:parts bytesAcknowledged:8 storedLength:10], (NSUInteger)3);
+    // partially stored parts or content changed by someone else mean starting over
+    XCTAssertEqual([CMISChunkedUpload resumePartIndexForParts:parts bytesAcknowledged:4 storedLength:6], (NSUInteger)NSNotFound);
+    XCTAssertEqual([CMISChunkedUpload resumePartIndexForParts:parts bytesAcknowledged:4 storedLength:0], (NSUInteger)NSNotFound);
+    XCTAssertEqual([CMISChunkedUpload resumePartIndexForParts:parts bytesAcknowledged:0 storedLength:0], (NSUInteger)NSNotFound);
+    XCTAssertEqual([CMISChunkedUpload resumePartIndexForParts:parts bytesAcknowledged:5 storedLength:5], (NSUInteger)NSNotFound);
+}
+
+- (void)testBandwidthLimiter
+{
+    CMISBandwidthLimiter *limiter = [[CMISBandwidthLimiter alloc] initWithBytesPerSecond:1000];
+    // a second worth of data is available right away, more has to wait
+    XCTAssertEqual([limiter reserveBytes:1000], 0.0, @"Expected no delay within the burst");
+    XCTAssertEqualWithAccuracy([limiter reserveBytes:500], 0.5, 0.05, @"Expected delay for data beyond the burst");
+    XCTAssertEqualWithAccuracy([limiter reserveBytes:500], 1.0, 0.05, @"Expected transfers to queue up behind each other");
+    limiter.bytesPerSecond = 0;
+    XCTAssertEqual([limiter reserveBytes:1000000], 0.0, @"Expected no delay without a limit");
+    XCTAssertEqual(limiter.maximumChunkLength, NSUIntegerMax, @"Expected no chunking without a limit");
+    
+    // reading beyond the burst takes time
+    NSData *data = [self randomDataOfLength:3072];
+    limiter = [[CMISBandwidthLimiter alloc] initWithBytesPerSecond:2048];
+    CMISThrottledInputStream *inputStream = [[CMISThrottledInputStream alloc] initWithInputStream:[NSInputStream inputStreamWithData:data]
+                                                                               bandwidthLimiter:limiter];
+    NSDate *start = [NSDate date];
+    NSData *readData = [self dataByReadingStream:inputStream bufferSize:4096];
+    [inputStream close];
+    XCTAssertEqualObjects(readData, data, @"Throttled stream changed the data");
+    XCTAssertEqual(inputStream.bytesRead, (unsigned long long)data.length, @"Unexpected number of bytes read");
+    XCTAssertTrue(-[start timeIntervalSinceNow] >= 0.4, @"Expected reading to be throttled");
+}
+
+- (void)testContentHasher
+{
+    NSData *data = [@"abc" dataUsingEncoding:NSUTF8StringEncoding];
+    CMISContentHasher *hasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmMD5];
+    [hasher updateWithData:data];
+    XCTAssertEqualObjects([hasher finish], @"{md5}900150983cd24fb0d6963f7d28e17f72", @"Wrong MD5 hash");
+    XCTAssertNil([hasher finish], @"A finished hasher should not return a hash again");
+    
+    hasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmSHA1];
+    [hasher updateWithData:data];
+    XCTAssertEqualObjects([hasher finish], @"{sha-1}a9993e364706816aba3e25717850c26c9cd0d89d", @"Wrong SHA-1 hash");
+    
+    // content hashed in pieces gives the same hash as the whole content
+    hasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmSHA256];
+    [hasher updateWithBytes:data.bytes length:1];
+    [hasher updateWithBytes:(const uint8_t *)data.bytes + 1 length:2];
+    XCTAssertEqual(hasher.length, (unsigned long long)3, @"Unexpected number of bytes hashed");
+    NSString *hash = [hasher finish];
+    XCTAssertEqualObjects(hash, @"{sha-256}ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", @"Wrong SHA-256 hash");
+    
+    hasher = [[CMISContentHasher alloc] initWithAlgorithm:CMISContentHashAlgorithmSHA256];
+    XCTAssertEqualObjects([hasher finish], @"{sha-256}e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", @"Wrong hash of empty content");
+    
+    // only values for the same algorithm are compared
+    XCTAssertTrue([CMISContentHasher hash:hash matchesContentStreamHashes:nil]);
+    XCTAssertTrue([CMISContentHasher hash:hash matchesContentStreamHashes:@[@"{md5}00000000000000000000000000000000"]]);
+    XCTAssertTrue([CMISContentHasher hash:hash matchesContentStreamHashes:@[@"{SHA-256}BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"]]);
+    XCTAssertFalse([CMISContentHasher hash:hash matchesContentStreamHashes:@[@"{sha-256}0000000000000000000000000000000000000000000000000000000000000000"]]);
+}
+
 - (void)testAuthenticateHeaderParameters {
     NSDictionary *challenges = nil;
     